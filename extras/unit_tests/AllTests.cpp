@@ -27,6 +27,7 @@ TODO: About that... This program is presumably being run under linux, and so we
 
 #include "Console/C3PConsole.h"
 #include "ElementPool.h"
+#include "SlabAllocator.h"
 #include "C3PNumericPlane.h"
 #include "C3PValue/KeyValuePair.h"
 #include "TimeSeries/TimeSeries.h"
@@ -1252,6 +1252,89 @@ int c3p_value_test_packing_parsing(const TCode FORMAT) {
 
 
 
+/*
+* Memory that values allocate for themselves should come from a SlabAllocator,
+*   once one is given.
+*/
+int c3p_value_test_allocator() {
+  int ret = -1;
+  const uint16_t COUNTS[] = { 8, 8, 8, 8 };   // 16 to 128 bytes.
+  SlabAllocator slab(COUNTS, (sizeof(COUNTS) / sizeof(COUNTS[0])));
+  slab.heapFallback(false);
+  const char* TEST_STR = "A string that the value will copy.";
+  Vector3f64  test_vect(0.25, -3.5, 1e9);
+  uint8_t     test_blob[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+  printf("Testing SlabAllocator as a source of memory for C3PValue...\n");
+  C3PValue::allocator(&slab);
+  printf("\tValues take their memory from the slab... ");
+  C3PValue* val_str  = new C3PValue((char*) TEST_STR);
+  C3PValue* val_vect = new C3PValue(&test_vect);
+  C3PValue* val_blob = new C3PValue(test_blob, sizeof(test_blob));
+  uint32_t in_use = 0;
+  for (uint8_t c = 0; c < slab.classCount(); c++) {  in_use += slab.inUse(c);  }
+  if ((3 == in_use) && (0 == slab.overdraws()) && (0 == slab.failures())) {
+    printf("Pass.\n\tThe values read back correctly... ");
+    char*      ret_str  = nullptr;
+    Vector3f64 ret_vect;
+    uint8_t*   ret_blob = nullptr;
+    uint32_t   ret_len  = 0;
+    val_str->get_as(&ret_str);
+    val_vect->get_as(&ret_vect);
+    val_blob->get_as(&ret_blob, &ret_len);
+    const bool STR_OK  = ((nullptr != ret_str) && (0 == strcmp(ret_str, TEST_STR)) && slab.inPool(ret_str));
+    const bool BLOB_OK = ((sizeof(test_blob) == ret_len) && (test_blob == ret_blob));
+    if (STR_OK && (test_vect == ret_vect) && BLOB_OK) {
+      printf("Pass.\n\tThe allocator can't be changed while values hold blocks... ");
+      if ((-1 == C3PValue::allocator(nullptr)) && (&slab == C3PValue::allocator())) {
+        printf("Pass.\n\tDecoded CBOR bytes are drawn from the slab... ");
+        const uint8_t CBOR_BYTES[] = { 0x48, 1, 2, 3, 4, 5, 6, 7, 8 };   // Untagged byte string.
+        StringBuilder packed(CBOR_BYTES, sizeof(CBOR_BYTES));
+        C3PValue* deser_blob = C3PValue::deserialize(&packed, TCode::CBOR);
+        if (nullptr != deser_blob) {
+          uint8_t* deser_buf = nullptr;
+          uint32_t deser_len = 0;
+          deser_blob->get_as(&deser_buf, &deser_len);
+          const bool DESER_OK = ((sizeof(test_blob) == deser_len) && (0 == memcmp(deser_buf, test_blob, deser_len)));
+          if (DESER_OK && slab.inPool(deser_buf)) {
+            ret = 0;
+          }
+          delete deser_blob;
+        }
+      }
+    }
+    if (0 == ret) {
+      ret = -1;
+      printf("Pass.\n\tDestruction returns every block... ");
+      delete val_str;
+      delete val_vect;
+      delete val_blob;
+      val_str  = nullptr;
+      val_vect = nullptr;
+      val_blob = nullptr;
+      in_use = 0;
+      for (uint8_t c = 0; c < slab.classCount(); c++) {  in_use += slab.inUse(c);  }
+      if ((0 == in_use) && (0 == slab.overdrawsFreed())) {
+        printf("Pass.\n\tThe allocator can be changed once they are gone... ");
+        if ((0 == C3PValue::allocator(nullptr)) && (nullptr == C3PValue::allocator())) {
+          printf("Pass.\n");
+          ret = 0;
+        }
+      }
+    }
+  }
+  if (nullptr != val_str) {   delete val_str;   }
+  if (nullptr != val_vect) {  delete val_vect;  }
+  if (nullptr != val_blob) {  delete val_blob;  }
+  C3PValue::allocator(nullptr);
+
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
+  return ret;
+}
+
+
+
 /*******************************************************************************
 * C3PValue test plan
 *******************************************************************************/
@@ -1266,6 +1349,7 @@ int c3p_value_test_packing_parsing(const TCode FORMAT) {
 #define CHKLST_C3PVAL_TEST_ALIGNMENT       0x00000100  //
 #define CHKLST_C3PVAL_TEST_LINKING         0x00000200  //
 #define CHKLST_C3PVAL_TEST_ARRAYS          0x00000400  //
+#define CHKLST_C3PVAL_TEST_ALLOCATOR       0x00000800  // Memory from a SlabAllocator.
 
 #define CHKLST_C3PVAL_TESTS_BASICS ( \
   CHKLST_C3PVAL_TEST_NUMERICS | CHKLST_C3PVAL_TEST_VECTORS | \
@@ -1275,7 +1359,8 @@ int c3p_value_test_packing_parsing(const TCode FORMAT) {
 
 #define CHKLST_C3PVAL_TESTS_ALL ( \
   CHKLST_C3PVAL_TESTS_BASICS | CHKLST_C3PVAL_TEST_CONVERSION | \
-  CHKLST_C3PVAL_TEST_LINKING | CHKLST_C3PVAL_TEST_PACK_PARSE_CBOR)
+  CHKLST_C3PVAL_TEST_LINKING | CHKLST_C3PVAL_TEST_PACK_PARSE_CBOR | \
+  CHKLST_C3PVAL_TEST_ALLOCATOR)
 
 const StepSequenceList TOP_LEVEL_C3PVALUE_TEST_LIST[] = {
   { .FLAG         = CHKLST_C3PVAL_TEST_NUMERICS,
@@ -1353,6 +1438,13 @@ const StepSequenceList TOP_LEVEL_C3PVALUE_TEST_LIST[] = {
     .DISPATCH_FXN = []() { return 1;  },
     .POLL_FXN     = []() { return ((0 == c3p_value_test_packing_parsing(TCode::CBOR)) ? 1:-1);  }
   },
+
+  { .FLAG         = CHKLST_C3PVAL_TEST_ALLOCATOR,
+    .LABEL        = "Allocation from a SlabAllocator",
+    .DEP_MASK     = (CHKLST_C3PVAL_TESTS_BASICS),
+    .DISPATCH_FXN = []() { return 1;  },
+    .POLL_FXN     = []() { return ((0 == c3p_value_test_allocator()) ? 1:-1);  }
+  },
 };
 
 AsyncSequencer c3pvalue_test_plan(TOP_LEVEL_C3PVALUE_TEST_LIST, (sizeof(TOP_LEVEL_C3PVALUE_TEST_LIST) / sizeof(TOP_LEVEL_C3PVALUE_TEST_LIST[0])));
@@ -146,6 +146,43 @@ int enum_wrapper_abbreviated_tests() {
 }
 
 
+/*
+* Lists in ascending order are searched by bisection. The outcome of any lookup
+*   should not depend on which search was used.
+*/
+int enum_wrapper_sorted_lookup_tests() {
+  int ret = -1;
+  printf("Running sorted lookup tests...\n");
+  printf("\tOrdered lists are detected as such... ");
+  if (EWT_LIST0.SORTED && !EWT_LIST1.SORTED && EWT_LIST2.SORTED) {
+    printf("Pass.\n\tLookups by value agree between ordered and unordered lists... ");
+    bool agree = true;
+    for (uint8_t i = 0; i <= (uint8_t) EWrapTestType::TRUE_INVALD; i++) {
+      const EWrapTestType E = (EWrapTestType) i;
+      agree &= (0 == strcmp(EWT_LIST0.enumStr(E), EWT_LIST1.enumStr(E)));
+      agree &= (E == EWT_LIST0.enumDef(E)->VAL);
+      agree &= (E == EWT_LIST1.enumDef(E)->VAL);
+      agree &= EWT_LIST0.enumValid(E);
+    }
+    if (agree) {
+      printf("Pass.\n\tAn abbreviated ordered list finds only what it holds... ");
+      if ((nullptr != EWT_LIST2.enumDef(EWrapTestType::VAL_2)) && (nullptr == EWT_LIST2.enumDef(EWrapTestType::VAL_3)) && !EWT_LIST2.enumValid(EWrapTestType::TRUE_INVALD) && (0 == strcmp("<NO ENUM>", EWT_LIST2.enumStr(EWrapTestType::VAL_5)))) {
+        printf("Pass.\n\tAn invalid value outside the enum finds nothing... ");
+        if ((nullptr == EWT_LIST0.enumDef((EWrapTestType) 200)) && !EWT_LIST0.enumValid((EWrapTestType) 200)) {
+          printf("Pass.\n");
+          ret = 0;
+        }
+      }
+    }
+  }
+
+  if (0 != ret) {
+    printf(" Fail.\n");
+  }
+  return ret;
+}
+
+
 /*******************************************************************************
 * The main function.
 *******************************************************************************/
@@ -157,7 +194,9 @@ int c3p_enum_wrapper_test_main() {
   if (0 == enum_wrapper_isotropic_tests()) {
     if (0 == enum_wrapper_anisotropic_tests()) {
       if (0 == enum_wrapper_abbreviated_tests()) {
-        ret = 0;
+        if (0 == enum_wrapper_sorted_lookup_tests()) {
+          ret = 0;
+        }
       }
     }
   }
@@ -48,11 +48,61 @@ int sensor_filter_initial_conditions() {
 
 
 /*
-* TODO
+* The moving median is kept by a running median, and so must agree with a
+*   median selected from a copy of the window after every sample. The window is
+*   larger than was practical when each median was found by sorting.
 */
 int sensor_filter_stats_tests() {
+  const uint32_t TEST_WINDOW = 1025;
+  const uint32_t TEST_FEEDS  = 4000;
+  printf("Testing the MOVING_MED strategy with a window of %u...\n", TEST_WINDOW);
   int ret = -1;
-  ret = 0;
+  SensorFilter<int32_t> filter(TEST_WINDOW, FilteringStrategy::MOVING_MED);
+  int32_t copy[TEST_WINDOW];
+  printf("\tinit() succeeds... ");
+  if (0 == filter.init()) {
+    printf("Pass.\n\tvalue() is the median, and minValue() and maxValue() the extremes, after every sample... ");
+    bool all_ok = true;
+    for (uint32_t i = 0; all_ok & (i < TEST_FEEDS); i++) {
+      filter.feedFilter((int32_t) (randomUInt32() % 5000) - 2500);
+      memcpy(copy, filter.memPtr(), sizeof(copy));
+      const int32_t EXPECTED = c3p_median(copy, TEST_WINDOW);
+      all_ok = ((EXPECTED == filter.value()) && (EXPECTED == filter.median()));
+      if (!all_ok) {
+        printf("Fail on sample %u (got %d, expected %d).\n", i, filter.value(), EXPECTED);
+      }
+      else if (filter.windowFull()) {
+        const int32_t* WINDOW = filter.memPtr();
+        int32_t expected_min = WINDOW[0];
+        int32_t expected_max = WINDOW[0];
+        for (uint32_t j = 1; j < TEST_WINDOW; j++) {
+          if (WINDOW[j] < expected_min) expected_min = WINDOW[j];
+          if (WINDOW[j] > expected_max) expected_max = WINDOW[j];
+        }
+        all_ok = ((expected_min == filter.minValue()) && (expected_max == filter.maxValue()));
+        if (!all_ok) {
+          printf("Fail on sample %u (min %d vs %d, max %d vs %d).\n", i, filter.minValue(), expected_min, filter.maxValue(), expected_max);
+        }
+      }
+    }
+    if (all_ok) {
+      printf("Pass.\n\tmedian() is correct after the window is changed in bulk... ");
+      int32_t* buf = filter.memPtr();
+      for (uint32_t i = 0; i < TEST_WINDOW; i++) {
+        buf[i] = (int32_t) i;
+      }
+      filter.feedFilter();
+      if ((int32_t) (TEST_WINDOW >> 1) == filter.median()) {
+        printf("Pass.\n\tmedian() is zero after purge()... ");
+        filter.purge();
+        if (0 == filter.median()) {
+          printf("Pass.\n");
+          ret = 0;
+        }
+      }
+    }
+  }
+  printf("%s.\n", ((0 != ret) ? "Fail" : "PASS"));
   return ret;
 }
 
@@ -143,6 +193,8 @@ void print_types_sensorfilter() {
 *******************************************************************************/
 int sensor_filter_tests_main() {
   int ret = 0;   // Failure is the default result.
-
+  if (0 != sensor_filter_stats_tests()) {
+    ret = 1;
+  }
   return ret;
 }
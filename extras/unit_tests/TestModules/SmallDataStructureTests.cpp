@@ -17,9 +17,13 @@ This program tests several basic data structure templates in the library
   that are widely relied upon.
 
 RingBuffer<T>
+MPMCQueue<T>
 LinkedList<T>
 ElementPool<T>
+ConcurrentElementPool<T>
+SlabAllocator
 PriorityQueue<T>
+PriorityHeap<T>
 C3PStack<T>
 C3PStatBlock<T>
 C3PNumericPlane<T>
@@ -28,10 +32,21 @@ C3PNumericVolume<T>
 
 #include "C3PNumericPlane.h"
 #include "C3PNumericVolume.h"
+#include <pthread.h>
+#include <sched.h>
 #include "C3PStack.h"
 #include "C3PStatBlock.h"
+#include "C3PMedian.h"
+#include "C3PSlidingMinMax.h"
 #include "RingBuffer.h"
+#include "MPMCQueue.h"
+#include "ConcurrentElementPool.h"
+#include "SlabAllocator.h"
+#include "C3PBitfield.h"
+#include "C3PHashMap.h"
+#include "C3PFlatMap.h"
 #include "PriorityQueue.h"
+#include "PriorityHeap.h"
 #include "LightLinkedList.h"
 
 
@@ -225,6 +240,239 @@ int test_PriorityQueue1() {
 
 
 
+/*******************************************************************************
+* PriorityHeap test routines
+*******************************************************************************/
+
+/*
+* Drain a heap of uint32_t, where each value is its own insertion order and
+*   PRIS holds its priority. The output must run from high priority to low, and
+*   be in insertion order within each priority.
+*
+* @return the number of elements drained, or -1 if the order was wrong.
+*/
+static int test_PriorityHeap_drain_in_order(PriorityHeap<uint32_t>* heap, const int* PRIS) {
+  int count = 0;
+  bool have_last = false;
+  uint32_t last = 0;
+  while (heap->hasNext()) {
+    const int TOP_PRI = heap->getPriority(0);
+    const uint32_t VAL = heap->dequeue();
+    if (TOP_PRI != PRIS[VAL]) {
+      printf("(priority mismatch for %u: %d vs %d) ", VAL, TOP_PRI, PRIS[VAL]);
+      return -1;
+    }
+    if (have_last) {
+      if ((PRIS[VAL] > PRIS[last]) || ((PRIS[VAL] == PRIS[last]) && (VAL < last))) {
+        printf("(%u (pri %d) came out after %u (pri %d)) ", VAL, PRIS[VAL], last, PRIS[last]);
+        return -1;
+      }
+    }
+    last = VAL;
+    have_last = true;
+    count++;
+  }
+  return count;
+}
+
+
+/*
+* The parts of the API that PriorityHeap shares with PriorityQueue.
+*/
+int test_PriorityHeap_api(const bool INDEXED) {
+  int ret = -1;
+  printf("Testing PriorityHeap<uint32_t> (%sindexed) general API...\n", (INDEXED ? "" : "not "));
+  PriorityHeap<uint32_t> heap(INDEXED, 2);   // Small, to force growth.
+  const int TEST_COUNT = 200;
+  int pris[TEST_COUNT];
+  printf("\tA new heap is empty... ");
+  if ((0 == heap.size()) && !heap.hasNext() && (0 == heap.get()) && (0 == heap.dequeue()) && !heap.contains(5)) {
+    printf("Pass.\n\tThe heap takes %d elements with a few distinct priorities... ", TEST_COUNT);
+    bool all_taken = true;
+    for (int i = 0; i < TEST_COUNT; i++) {
+      pris[i] = (int) (randomUInt32() % 5);
+      all_taken &= (0 <= heap.insert((uint32_t) i, pris[i]));
+    }
+    if (all_taken && (TEST_COUNT == heap.size()) && heap.hasNext()) {
+      printf("Pass.\n\tcontains() finds every element, and nothing else... ");
+      bool all_found = !heap.contains(TEST_COUNT + 1);
+      for (int i = 0; i < TEST_COUNT; i++) {  all_found &= heap.contains((uint32_t) i);  }
+      if (all_found) {
+        printf("Pass.\n\tinsertIfAbsent() refuses an element that is present... ");
+        if ((-1 == heap.insertIfAbsent(17, 9)) && (TEST_COUNT == heap.size())) {
+          printf("Pass.\n\tgetPriority(0) is the highest priority present... ");
+          int max_pri = 0;
+          for (int i = 0; i < TEST_COUNT; i++) {  max_pri = strict_max(max_pri, pris[i]);  }
+          if (max_pri == heap.getPriority(0)) {
+            printf("Pass.\n\tremove(T) removes an element... ");
+            if (heap.remove(17) && !heap.contains(17) && !heap.remove(17) && ((TEST_COUNT - 1) == heap.size())) {
+              printf("Pass.\n\tremove(T) removes every copy of a duplicated element... ");
+              heap.insert(23, 0);
+              heap.insert(23, 4);
+              if (heap.remove(23) && !heap.contains(23) && ((TEST_COUNT - 2) == heap.size())) {
+                printf("Pass.\n\tElements come out by priority, and FIFO within a priority... ");
+                if ((TEST_COUNT - 2) == test_PriorityHeap_drain_in_order(&heap, pris)) {
+                  printf("Pass.\n\tclear() empties the heap... ");
+                  for (int i = 0; i < 10; i++) {  heap.insert((uint32_t) i, 1);  }
+                  if ((10 == heap.clear()) && (0 == heap.size()) && !heap.contains(3)) {
+                    printf("Pass.\n\tThe heap is usable after clear()... ");
+                    if ((0 <= heap.insertIfAbsent(3, 1)) && (3 == heap.dequeue()) && !heap.hasNext()) {
+                      printf("Pass.\n");
+                      ret = 0;
+                    }
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
+  return ret;
+}
+
+
+/*
+* Handles, and changing priorities.
+*/
+int test_PriorityHeap_handles(const bool INDEXED) {
+  int ret = -1;
+  printf("Testing PriorityHeap<uint32_t> (%sindexed) handles...\n", (INDEXED ? "" : "not "));
+  PriorityHeap<uint32_t> heap(INDEXED);
+  const int TEST_COUNT = 300;
+  int pris[TEST_COUNT];
+  int handles[TEST_COUNT];
+  printf("\tInvalid handles are refused... ");
+  if ((-1 == heap.priority(0)) && (0 != heap.setPriority(0, 5)) && !heap.removeByHandle(-1) && !heap.validHandle(0)) {
+    printf("Pass.\n\tEach insert() returns a distinct valid handle... ");
+    bool handles_ok = true;
+    for (int i = 0; i < TEST_COUNT; i++) {
+      pris[i] = (int) (randomUInt32() % 8);
+      handles[i] = heap.insert((uint32_t) i, pris[i]);
+      handles_ok &= heap.validHandle(handles[i]);
+      for (int j = 0; j < i; j++) {  handles_ok &= (handles[i] != handles[j]);  }
+    }
+    if (handles_ok) {
+      printf("Pass.\n\tHandles lead back to their elements... ");
+      for (int i = 0; i < TEST_COUNT; i++) {
+        handles_ok &= ((uint32_t) i == heap.getByHandle(handles[i]));
+        handles_ok &= (pris[i] == heap.priority(handles[i]));
+        handles_ok &= (handles[i] == heap.find((uint32_t) i));
+      }
+      if (handles_ok) {
+        printf("Pass.\n\tsetPriority() moves elements in both directions... ");
+        for (int n = 0; n < 1000; n++) {
+          const int IDX = (int) (randomUInt32() % TEST_COUNT);
+          pris[IDX] = (int) (randomUInt32() % 12) - 2;
+          handles_ok &= (0 == heap.setPriority(handles[IDX], pris[IDX]));
+        }
+        if (handles_ok && (heap.getPriority(0) == heap.priority(heap.find(heap.get())))) {
+          printf("Pass.\n\tincrementPriority() and decrementPriority()... ");
+          heap.incrementPriority(7);
+          pris[7]++;
+          heap.decrementPriority(8);
+          pris[8]--;
+          if ((pris[7] == heap.priority(handles[7])) && (pris[8] == heap.priority(handles[8])) && !heap.incrementPriority(TEST_COUNT + 5)) {
+            printf("Pass.\n\tremoveByHandle() removes only its element... ");
+            int removed = 0;
+            for (int i = 0; i < TEST_COUNT; i += 3) {
+              handles_ok &= heap.removeByHandle(handles[i]);
+              handles_ok &= !heap.validHandle(handles[i]) && !heap.contains((uint32_t) i);
+              removed++;
+            }
+            for (int i = 1; i < TEST_COUNT; i += 3) {
+              handles_ok &= ((uint32_t) i == heap.getByHandle(handles[i]));
+            }
+            if (handles_ok && ((TEST_COUNT - removed) == heap.size())) {
+              printf("Pass.\n\tThe heap drains in order after all of that... ");
+              if ((TEST_COUNT - removed) == test_PriorityHeap_drain_in_order(&heap, pris)) {
+                printf("Pass.\n\tFreed handles are reused... ");
+                const int H0 = heap.insert(5000, 0);
+                if ((0 <= H0) && (H0 < TEST_COUNT) && (5000 == heap.getByHandle(H0))) {
+                  printf("Pass.\n");
+                  ret = 0;
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
+  return ret;
+}
+
+
+/*
+* Randomized comparison against PriorityQueue, which is the reference for
+*   ordering semantics. Also reports the time taken by each, but doesn't judge.
+*/
+int test_PriorityHeap_vs_PriorityQueue() {
+  int ret = -1;
+  const int DEPTH  = 400;
+  const int ROUNDS = 20000;
+  PriorityHeap<uint32_t>  heap(true);
+  PriorityQueue<uint32_t> queue;
+  uint32_t next_val = 1;   // PriorityQueue can't tell a 0 from an empty queue.
+  unsigned long t_heap  = 0;
+  unsigned long t_queue = 0;
+  printf("Testing PriorityHeap against PriorityQueue with a depth of ~%d over %d rounds...\n", DEPTH, ROUNDS);
+  printf("\tBoth containers produce the same sequence... ");
+  bool matched = true;
+  for (int n = 0; (n < ROUNDS) && matched; n++) {
+    const bool DO_INSERT = ((heap.size() < (DEPTH / 2)) || ((heap.size() < DEPTH) && (0 == (randomUInt32() & 1))));
+    if (DO_INSERT) {
+      const int PRI = (int) (randomUInt32() % 6);
+      unsigned long t0 = micros();
+      const bool HEAP_OK = (0 <= heap.insertIfAbsent(next_val, PRI));
+      unsigned long t1 = micros();
+      const bool QUEUE_OK = (0 <= queue.insertIfAbsent(next_val, PRI));
+      unsigned long t2 = micros();
+      t_heap  += (t1 - t0);
+      t_queue += (t2 - t1);
+      matched &= (HEAP_OK == QUEUE_OK);
+      next_val++;
+    }
+    else {
+      unsigned long t0 = micros();
+      const uint32_t FROM_HEAP = heap.dequeue();
+      unsigned long t1 = micros();
+      const uint32_t FROM_QUEUE = queue.dequeue();
+      unsigned long t2 = micros();
+      t_heap  += (t1 - t0);
+      t_queue += (t2 - t1);
+      matched &= (FROM_HEAP == FROM_QUEUE);
+    }
+    matched &= (heap.size() == queue.size());
+  }
+  if (matched) {
+    printf("Pass.\n\tBoth containers drain identically... ");
+    while (matched && heap.hasNext()) {
+      matched &= (heap.dequeue() == queue.dequeue());
+    }
+    if (matched && !queue.hasNext()) {
+      printf("Pass.\n\tTime spent: PriorityHeap %lu us, PriorityQueue %lu us.\n", t_heap, t_queue);
+      ret = 0;
+    }
+  }
+
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
+  return ret;
+}
+
+
+
 /*******************************************************************************
 * LinkedList test routines
 *******************************************************************************/
@@ -292,6 +540,183 @@ int test_LinkedList() {
 }
 
 
+/*******************************************************************************
+* Node pools for LinkedList and PriorityQueue
+*******************************************************************************/
+
+/*
+* LinkedList with an ElementPool of nodes, shared between two lists.
+*/
+int test_LinkedList_node_pool() {
+  int ret = -1;
+  const uint32_t POOL_SIZE = 8;
+  uint32_t vals[POOL_SIZE + 2];
+  for (uint32_t i = 0; i < (POOL_SIZE + 2); i++) {  vals[i] = randomUInt32();  }
+  ElementPool<Node<uint32_t*>> pool(POOL_SIZE, 4);
+  LinkedList<uint32_t*> a(&pool);
+  LinkedList<uint32_t*> b;
+  printf("Testing LinkedList<T> with a shared node pool...\n");
+  printf("\tA list can be given a pool while empty... ");
+  if ((0 == b.nodePool(&pool)) && (&pool == b.nodePool())) {
+    printf("Pass.\n\tTwo lists draw %u nodes from the pool without a miss... ", POOL_SIZE);
+    for (uint32_t i = 0; i < 6; i++) {  a.insert(&vals[i]);  }
+    b.insertAtHead(&vals[7]);
+    b.insertAtHead(&vals[6]);
+    if ((0 == pool.available()) && (0 == pool.overdraws())) {
+      printf("Pass.\n\tA dry pool is overdrawn from the heap, and counts the miss... ");
+      if ((1 == b.insert(&vals[8])) && (1 == pool.overdraws())) {
+        printf("Pass.\n\tA list can't change pools while it has nodes... ");
+        if (-1 == b.nodePool(nullptr)) {
+          printf("Pass.\n\tThe lists hold their elements in order... ");
+          bool in_order = ((6 == a.size()) && (3 == b.size()));
+          for (uint32_t i = 0; i < 6; i++) {  in_order &= (a.get(i) == &vals[i]);  }
+          for (uint32_t i = 0; i < 3; i++) {  in_order &= (b.get(i) == &vals[6 + i]);  }
+          if (in_order) {
+            printf("Pass.\n\tremove() of each flavor returns nodes to their source... ");
+            a.remove(&vals[2]);
+            a.remove((int) 0);
+            a.remove();
+            b.remove((int) 2);   // The overdrawn node.
+            if ((3 == pool.available()) && (1 == pool.overdrawsFreed())) {
+              printf("Pass.\n\tclear() returns all nodes to the pool... ");
+              a.clear();
+              b.clear();
+              if ((POOL_SIZE == pool.available()) && (0 == b.nodePool(nullptr))) {
+                printf("Pass.\n\tSteady-state churn never misses the pool... ");
+                const uint32_t MISSES = pool.overdraws();
+                for (uint32_t n = 0; n < 10000; n++) {
+                  if ((a.size() < (int) POOL_SIZE) && (0 == (randomUInt32() & 1))) {
+                    a.insert(&vals[n % POOL_SIZE]);
+                  }
+                  else {
+                    a.remove();
+                  }
+                }
+                a.clear();
+                if ((MISSES == pool.overdraws()) && (POOL_SIZE == pool.available())) {
+                  printf("Pass.\n");
+                  ret = 0;
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
+  return ret;
+}
+
+
+/*
+* PriorityQueue with an ElementPool of nodes.
+*/
+int test_PriorityQueue_node_pool() {
+  int ret = -1;
+  const uint32_t POOL_SIZE = 8;
+  uint32_t vals[POOL_SIZE + 2];
+  for (uint32_t i = 0; i < (POOL_SIZE + 2); i++) {  vals[i] = i;  }
+  ElementPool<PriorityNode<uint32_t*>> pool(POOL_SIZE, 4);
+  PriorityQueue<uint32_t*> queue(&pool);
+  printf("Testing PriorityQueue<T> with a node pool...\n");
+  printf("\tThe queue fills the pool without a miss... ");
+  bool all_taken = true;
+  for (uint32_t i = 0; i < POOL_SIZE; i++) {
+    all_taken &= (0 <= queue.insertIfAbsent(&vals[i], (int) (i & 3)));
+  }
+  if (all_taken && (0 == pool.available()) && (0 == pool.overdraws())) {
+    printf("Pass.\n\tinsertIfAbsent() doesn't draw a node for a duplicate... ");
+    if ((-1 == queue.insertIfAbsent(&vals[3], 0)) && (0 == pool.overdraws())) {
+      printf("Pass.\n\tA dry pool is overdrawn from the heap, and counts the miss... ");
+      if ((0 <= queue.insert(&vals[POOL_SIZE], 3)) && (1 == pool.overdraws())) {
+        printf("Pass.\n\tA queue can't change pools while it has nodes... ");
+        if (-1 == queue.nodePool(nullptr)) {
+          printf("Pass.\n\tPriority order is unchanged by pooling... ");
+          bool in_order = true;
+          int last_pri = queue.getPriority((int) 0);
+          for (int i = 1; i < queue.size(); i++) {
+            in_order &= (last_pri >= queue.getPriority(i));
+            last_pri = queue.getPriority(i);
+          }
+          if (in_order && (3 == queue.getPriority((int) 0))) {
+            printf("Pass.\n\tremove() and dequeue() return nodes to their source... ");
+            queue.remove(&vals[POOL_SIZE]);   // The overdrawn node.
+            queue.remove((int) 1);
+            queue.dequeue();
+            if ((2 == pool.available()) && (1 == pool.overdrawsFreed())) {
+              printf("Pass.\n\tclear() returns all nodes to the pool... ");
+              queue.clear();
+              if ((POOL_SIZE == pool.available()) && (0 == queue.size())) {
+                printf("Pass.\n");
+                ret = 0;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
+  return ret;
+}
+
+
+/*
+* Benchmark: Steady-state churn of a queue, with and without a node pool.
+*   Without a pool, every insertion is a malloc() and every removal is a free().
+*   With a pool, the only heap activity is pool misses, which the pool counts.
+*   Timing is reported, but not judged.
+*/
+int test_node_pool_benchmark() {
+  int ret = -1;
+  const uint32_t DEPTH = 32;
+  const uint32_t OPS   = 200000;
+  uint32_t vals[DEPTH];
+  ElementPool<PriorityNode<uint32_t*>> pool(DEPTH, DEPTH);
+  PriorityQueue<uint32_t*> pooled(&pool);
+  PriorityQueue<uint32_t*> unpooled;
+  unsigned long t_pooled   = 0;
+  unsigned long t_unpooled = 0;
+  printf("Benchmarking PriorityQueue<T> churn at a depth of %u (%u operations)...\n", DEPTH, OPS);
+  for (uint32_t pass = 0; pass < 2; pass++) {
+    PriorityQueue<uint32_t*>* q = ((0 == pass) ? &unpooled : &pooled);
+    const unsigned long T0 = micros();
+    for (uint32_t n = 0; n < OPS; n++) {
+      if ((q->size() < (int) (DEPTH / 2)) || ((q->size() < (int) DEPTH) && (n & 1))) {
+        q->insert(&vals[n % DEPTH], (int) (n & 7));
+      }
+      else {
+        q->dequeue();
+      }
+    }
+    q->clear();
+    const unsigned long ELAPSED = (micros() - T0);
+    if (0 == pass) {  t_unpooled = ELAPSED;  }
+    else {            t_pooled   = ELAPSED;  }
+  }
+  printf("\t          | Time (us)\n");
+  printf("\t----------+----------\n");
+  printf("\tmalloc()  | %9lu\n", t_unpooled);
+  printf("\tPool      | %9lu\n", t_pooled);
+  printf("\tThe pooled queue never touched the heap (%u pool misses)... ", pool.overdraws());
+  if ((0 == pool.overdraws()) && (DEPTH == pool.available())) {
+    printf("Pass.\n");
+    ret = 0;
+  }
+  else {
+    printf("Fail.\n");
+  }
+  return ret;
+}
+
+
 /*******************************************************************************
 * RingBuffer test routines
 *******************************************************************************/
@@ -523,35 +948,1422 @@ int test_RingBuffer_general() {
             for (unsigned int i = 0; i < TEST_SIZE; i++) {
               val = a.get();
             }
-            if (0 == a.count()) {
-              printf("done.\n\tTrying to drive count negative... ");
-              if (0 == a.get()) {
-                if (0 == a.count()) {
-                  printf("done.\n\tEnsuring that OOB get() returns the trivial value... ");
-                  uint32_t should_be_zero = a.peek(a.capacity() + 10);
-                  if (0 == should_be_zero) {
-                    printf("it does.\n");
-                    return_value = 0;
-                  }
-                  else printf("Fail. Returned %08x instead.\n", should_be_zero);
-                }
-                else printf("Count should still be 0 but is %u\n", a.count());
-              }
-              else printf("Get on an empty buffer should return 0.\n");
+            if (0 == a.count()) {
+              printf("done.\n\tTrying to drive count negative... ");
+              if (0 == a.get()) {
+                if (0 == a.count()) {
+                  printf("done.\n\tEnsuring that OOB get() returns the trivial value... ");
+                  uint32_t should_be_zero = a.peek(a.capacity() + 10);
+                  if (0 == should_be_zero) {
+                    printf("it does.\n");
+                    return_value = 0;
+                  }
+                  else printf("Fail. Returned %08x instead.\n", should_be_zero);
+                }
+                else printf("Count should still be 0 but is %u\n", a.count());
+              }
+              else printf("Get on an empty buffer should return 0.\n");
+            }
+            else printf("Count should have been 0 but is %u\n", a.count());
+          }
+          else printf("Sadly worked. Count is %u\n", a.count());
+        }
+        else printf("Count mismatch. Got %u but was expecting %u.\n", a.count(), TEST_SIZE);
+      }
+      else printf("Fairly certain we inserted %u elements, but the count says %u.\n", test_num, a.count());
+    }
+    else printf("Newly created RingBuffers ought to be empty. This one reports %u.\n", a.count());
+  }
+  else printf("Failed to allocate.\n");
+
+  return return_value;
+}
+
+
+
+/*
+* Zero-copy API: reserve()/commit() and peekContiguous()/consume() must describe
+*   the ring as two spans when the data wraps, and one span when it doesn't.
+*/
+int test_RingBuffer_zero_copy(const unsigned int CAPACITY) {
+  int ret = -1;
+  const unsigned int OFFSET = (CAPACITY - 5);   // Puts the indices near the end of memory.
+  RingBuffer<uint16_t> a(CAPACITY);
+  RingBufferSpan<uint16_t> spans[2];
+  uint16_t check[64];   // No smaller than the capacity under test.
+  printf("Testing the zero-copy API of RingBuffer<uint16_t>(%u)...\n", CAPACITY);
+  printf("\tAn empty ring has nothing to see... ");
+  if ((0 == a.peekContiguous(spans)) && (0 == spans[0].len) && (0 == spans[1].len)) {
+    printf("Pass.\n\tThe ring was allocated on demand... ");
+    if (a.allocated()) {
+      printf("Pass.\n\tAn empty ring reserves one span of the whole capacity... ");
+      if ((CAPACITY == (unsigned int) a.reserve(spans, CAPACITY + 10)) && (CAPACITY == spans[0].len) && (0 == spans[1].len)) {
+        printf("Pass.\n\tReserving doesn't make anything visible... ");
+        if (a.isEmpty()) {
+          // Move the indices close to the end.
+          for (unsigned int i = 0; i < OFFSET; i++) {  spans[0].ptr[i] = 0xFFFF;  }
+          a.commit(OFFSET);
+          a.consume(OFFSET);
+          printf("Pass.\n\tReserving across the end of memory gives two spans... ");
+          const unsigned int N = (CAPACITY - 2);
+          if ((N == (unsigned int) a.reserve(spans, N)) && (5 == spans[0].len) && ((N - 5) == spans[1].len)) {
+            for (unsigned int i = 0; i < spans[0].len; i++) {  spans[0].ptr[i] = i;  }
+            for (unsigned int i = 0; i < spans[1].len; i++) {  spans[1].ptr[i] = (spans[0].len + i);  }
+            printf("Pass.\n\tcommit() refuses more than there is room for... ");
+            if (-1 == a.commit(CAPACITY + 1)) {
+              printf("Pass.\n\tcommit(%u) publishes the elements... ", N);
+              if ((N == (unsigned int) a.commit(N)) && (N == a.count()) && (2 == a.vacancy())) {
+                printf("Pass.\n\tpeekContiguous() sees them as two spans... ");
+                if ((N == (unsigned int) a.peekContiguous(spans)) && (5 == spans[0].len) && ((N - 5) == spans[1].len)) {
+                  printf("Pass.\n\tThe spans hold the sequence in order... ");
+                  bool in_order = true;
+                  for (unsigned int i = 0; i < spans[0].len; i++) {  in_order &= (spans[0].ptr[i] == i);  }
+                  for (unsigned int i = 0; i < spans[1].len; i++) {  in_order &= (spans[1].ptr[i] == (spans[0].len + i));  }
+                  if (in_order) {
+                    printf("Pass.\n\tpeekContiguous() respects its limit... ");
+                    if ((3 == a.peekContiguous(spans, 3)) && (3 == spans[0].len) && (0 == spans[1].len)) {
+                      printf("Pass.\n\tconsume(7) releases elements from the front... ");
+                      if ((7 == a.consume(7)) && ((N - 7) == a.count()) && (7 == a.peek())) {
+                        printf("Pass.\n\tWhat is left can be seen as one span... ");
+                        if (((N - 7) == (unsigned int) a.peekContiguous(spans)) && ((N - 7) == spans[0].len) && (0 == spans[1].len)) {
+                          printf("Pass.\n\tBulk insert() across the end of memory... ");
+                          for (unsigned int i = 0; i < CAPACITY; i++) {  check[i] = (1000 + i);  }
+                          a.consume(a.count() - 1);   // Leave one element near the end of memory.
+                          if ((int) (CAPACITY - 1) == a.insert(check, CAPACITY)) {
+                            printf("Pass.\n\tBulk get() across the end of memory... ");
+                            a.cull(1);
+                            memset(check, 0, sizeof(check));
+                            if ((int) (CAPACITY - 1) == a.get(check, CAPACITY)) {
+                              printf("Pass.\n\tBulk get() preserves order... ");
+                              in_order = a.isEmpty();
+                              for (unsigned int i = 0; i < (CAPACITY - 1); i++) {  in_order &= (check[i] == (1000 + i));  }
+                              if (in_order) {
+                                printf("Pass.\n");
+                                ret = 0;
+                              }
+                            }
+                          }
+                        }
+                      }
+                    }
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
+  return ret;
+}
+
+
+/*
+* Concurrency: A producer thread and a consumer thread push a numbered sequence
+*   through the ring with a mix of single and bulk calls. The consumer checks
+*   that nothing was lost, duplicated, or re-ordered.
+*/
+struct RingBufferStressArgs {
+  RingBuffer<uint32_t>* ring;
+  uint32_t total;       // How many elements will pass through the ring.
+  uint32_t seed;        // Each thread gets its own PRNG, since the platform's might not be re-entrant.
+  uint32_t errors;      // Set by the consumer.
+};
+
+static uint32_t test_RingBuffer_xorshift(uint32_t* state) {
+  *state ^= (*state << 13);
+  *state ^= (*state >> 17);
+  *state ^= (*state << 5);
+  return *state;
+}
+
+static void* test_RingBuffer_spsc_producer(void* arg) {
+  RingBufferStressArgs* args = (RingBufferStressArgs*) arg;
+  uint32_t seed = args->seed;
+  uint32_t next = 0;
+  uint32_t batch[32];
+  while (next < args->total) {
+    int taken = 0;
+    const uint32_t BATCH_LEN = strict_min((uint32_t) (1 + (test_RingBuffer_xorshift(&seed) % 32)), (uint32_t) (args->total - next));
+    switch (test_RingBuffer_xorshift(&seed) % 3) {
+      case 0:
+        taken = ((0 == args->ring->insert(next)) ? 1 : 0);
+        break;
+      case 1:
+        for (uint32_t i = 0; i < BATCH_LEN; i++) {  batch[i] = (next + i);  }
+        taken = strict_max((int32_t) 0, (int32_t) args->ring->insert(batch, BATCH_LEN));
+        break;
+      default:
+        {
+          // Write in place, and then publish.
+          RingBufferSpan<uint32_t> spans[2];
+          taken = strict_max((int32_t) 0, (int32_t) args->ring->reserve(spans, BATCH_LEN));
+          for (uint32_t i = 0; i < spans[0].len; i++) {  spans[0].ptr[i] = (next + i);  }
+          for (uint32_t i = 0; i < spans[1].len; i++) {  spans[1].ptr[i] = (next + spans[0].len + i);  }
+          if ((0 < taken) && (taken != args->ring->commit(taken))) {
+            taken = 0;   // The consumer will notice the gap.
+          }
+        }
+        break;
+    }
+    if (0 == taken) {
+      sched_yield();   // The ring is full.
+    }
+    next += taken;
+  }
+  return nullptr;
+}
+
+static void* test_RingBuffer_spsc_consumer(void* arg) {
+  RingBufferStressArgs* args = (RingBufferStressArgs*) arg;
+  uint32_t seed = args->seed;
+  uint32_t expected = 0;
+  uint32_t batch[32];
+  while ((expected < args->total) && (0 == args->errors)) {
+    int count = 0;
+    switch (test_RingBuffer_xorshift(&seed) % 4) {
+      case 0:
+        if (!args->ring->isEmpty()) {
+          batch[0] = args->ring->get();
+          count = 1;
+        }
+        break;
+      case 1:
+        count = strict_max((int32_t) 0, (int32_t) args->ring->get(batch, (1 + (test_RingBuffer_xorshift(&seed) % 32))));
+        break;
+      case 2:
+        {
+          // Read in place, and then release what was seen.
+          RingBufferSpan<uint32_t> spans[2];
+          count = strict_max((int32_t) 0, (int32_t) args->ring->peekContiguous(spans, (1 + (test_RingBuffer_xorshift(&seed) % 32))));
+          if (count != (int) (spans[0].len + spans[1].len)) {
+            args->errors++;
+            count = 0;
+          }
+          memcpy(batch, spans[0].ptr, (spans[0].len * sizeof(uint32_t)));
+          memcpy((batch + spans[0].len), spans[1].ptr, (spans[1].len * sizeof(uint32_t)));
+          if ((0 < count) && (count != args->ring->consume(count))) {
+            args->errors++;
+          }
+        }
+        break;
+      default:
+        // Peek first, and then discard what was seen.
+        count = strict_max((int32_t) 0, (int32_t) args->ring->peek(batch, (1 + (test_RingBuffer_xorshift(&seed) % 32))));
+        if ((0 < count) && (count != args->ring->cull(count))) {
+          args->errors++;
+        }
+        break;
+    }
+    for (int i = 0; i < count; i++) {
+      if (batch[i] != expected) {
+        args->errors++;
+      }
+      expected++;
+    }
+    if (0 == count) {
+      sched_yield();   // The ring is empty.
+    }
+  }
+  return nullptr;
+}
+
+int test_RingBuffer_spsc_stress(const unsigned int CAPACITY) {
+  int ret = -1;
+  const uint32_t TOTAL = (1 << 20);
+  printf("Testing RingBuffer<uint32_t>(%u) with a producer thread and a consumer thread (%u elements)...\n", CAPACITY, TOTAL);
+  RingBuffer<uint32_t> ring(CAPACITY);
+  RingBufferStressArgs producer_args = { .ring = &ring, .total = TOTAL, .seed = (randomUInt32() | 1), .errors = 0 };
+  RingBufferStressArgs consumer_args = { .ring = &ring, .total = TOTAL, .seed = (randomUInt32() | 1), .errors = 0 };
+  pthread_t producer;
+  pthread_t consumer;
+  printf("\tStarting threads... ");
+  if (0 == pthread_create(&consumer, nullptr, test_RingBuffer_spsc_consumer, &consumer_args)) {
+    if (0 == pthread_create(&producer, nullptr, test_RingBuffer_spsc_producer, &producer_args)) {
+      pthread_join(producer, nullptr);
+      pthread_join(consumer, nullptr);
+      printf("Pass.\n\tThe consumer saw the sequence unbroken... ");
+      if (0 == consumer_args.errors) {
+        printf("Pass.\n\tThe ring is empty afterward... ");
+        if (ring.isEmpty() && (0 == ring.count()) && (CAPACITY == ring.vacancy())) {
+          printf("Pass.\n");
+          ret = 0;
+        }
+      }
+      else {
+        printf("(%u errors) ", consumer_args.errors);
+      }
+    }
+    else {
+      // Unblock the consumer, which is waiting for elements that will never come.
+      consumer_args.errors++;
+      pthread_join(consumer, nullptr);
+    }
+  }
+
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
+  return ret;
+}
+
+
+/*******************************************************************************
+* MPMCQueue
+*******************************************************************************/
+
+/*
+* Single-threaded checks of the API and its edge cases.
+*/
+int test_MPMCQueue_api() {
+  int ret = -1;
+  MPMCQueue<uint32_t> a(10);
+  uint32_t val = 0;
+  uint32_t buf[8];
+  printf("Testing MPMCQueue<uint32_t> API...\n");
+  printf("\tCapacity is rounded up to a power of two... ");
+  MPMCQueue<uint32_t> tiny(0);
+  if ((16 == a.capacity()) && (2 == tiny.capacity())) {
+    printf("Pass.\n\tA new queue is empty... ");
+    if (a.isEmpty() && (0 == a.count()) && !a.tryPop(&val)) {
+      printf("Pass.\n\tThe empty pop was counted... ");
+      if (1 == a.emptyCount()) {
+        printf("Pass.\n\tThe queue takes %u elements... ", a.capacity());
+        bool all_taken = true;
+        for (uint32_t i = 0; i < a.capacity(); i++) {  all_taken &= a.tryPush(i);  }
+        if (all_taken && (a.capacity() == a.count())) {
+          printf("Pass.\n\tThe queue refuses a push when full... ");
+          if (!a.tryPush(99) && (1 == a.fullCount())) {
+            printf("Pass.\n\tElements come out in FIFO order... ");
+            bool in_order = true;
+            for (uint32_t i = 0; i < a.capacity(); i++) {  in_order &= (a.tryPop(&val) && (i == val));  }
+            if (in_order && a.isEmpty()) {
+              printf("Pass.\n\tOrder holds across several laps of the ring... ");
+              uint32_t next_in  = 0;
+              uint32_t next_out = 0;
+              for (uint32_t lap = 0; lap < 20; lap++) {
+                for (uint32_t i = 0; i < 7; i++) {  in_order &= a.tryPush(next_in++);  }
+                for (uint32_t i = 0; i < 7; i++) {  in_order &= (a.tryPop(&val) && (next_out++ == val));  }
+              }
+              if (in_order) {
+                printf("Pass.\n\tdrain() rejects bad arguments... ");
+                if ((-1 == a.drain(nullptr, 4)) && (-1 == a.drain(buf, 0))) {
+                  printf("Pass.\n\tdrain() takes what is waiting, up to its limit... ");
+                  for (uint32_t i = 0; i < 5; i++) {  a.tryPush(100 + i);  }
+                  if ((3 == a.drain(buf, 3)) && (100 == buf[0]) && (102 == buf[2])) {
+                    printf("Pass.\n\tdrain() stops when the queue is empty... ");
+                    if ((2 == a.drain(buf, 8)) && (103 == buf[0]) && (104 == buf[1]) && (0 == a.drain(buf, 8))) {
+                      printf("Pass.\n\tThere was no contention without other threads... ");
+                      if ((0 == a.pushRetries()) && (0 == a.popRetries())) {
+                        printf("Pass.\n\tresetCounters() zeros the counters... ");
+                        a.resetCounters();
+                        if ((0 == a.fullCount()) && (0 == a.emptyCount())) {
+                          printf("Pass.\n");
+                          ret = 0;
+                        }
+                      }
+                    }
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
+  return ret;
+}
+
+
+/*
+* The benchmark baseline: the pattern that the library currently uses to move
+*   pointers between threads. A PriorityQueue guarded by a pthread mutex, with
+*   its depth capped to match the MPMCQueue under comparison.
+*/
+class MutexPriorityQueue {
+  public:
+    MutexPriorityQueue(const unsigned int DEPTH) : _DEPTH(DEPTH) {
+      pthread_mutex_init(&_mutex, nullptr);
+    };
+    ~MutexPriorityQueue() {  pthread_mutex_destroy(&_mutex);  };
+
+    bool tryPush(const uint32_t d) {
+      bool ret = false;
+      pthread_mutex_lock(&_mutex);
+      if (_DEPTH > (unsigned int) _q.size()) {
+        ret = (0 <= _q.insert(d));
+      }
+      pthread_mutex_unlock(&_mutex);
+      return ret;
+    };
+
+    bool tryPop(uint32_t* d) {
+      bool ret = false;
+      pthread_mutex_lock(&_mutex);
+      if (0 < _q.size()) {
+        *d = _q.dequeue();
+        ret = true;
+      }
+      pthread_mutex_unlock(&_mutex);
+      return ret;
+    };
+
+  private:
+    const unsigned int _DEPTH;
+    pthread_mutex_t _mutex;
+    PriorityQueue<uint32_t> _q;
+};
+
+
+/*
+* Concurrency: Several producers push tagged sequences, and several consumers
+*   pop them. Every element must arrive exactly once, and each consumer must see
+*   each producer's elements in the order they were pushed.
+*/
+#define MPMC_STRESS_MAX_THREADS   8
+
+template <class Q> struct MPMCStressArgs {
+  Q*       queue;
+  uint8_t* seen;             // One byte per element, shared by all consumers.
+  uint32_t per_producer;     // How many elements each producer pushes.
+  uint32_t total;            // How many elements will pass through the queue.
+  uint32_t consumed;         // Shared by all consumers.
+  uint32_t errors;           // Shared by all consumers.
+  uint32_t producer_id;      // Only meaningful in a producer's copy.
+};
+
+template <class Q> static void* test_MPMCQueue_producer(void* arg) {
+  MPMCStressArgs<Q>* args = (MPMCStressArgs<Q>*) arg;
+  uint32_t i = 0;
+  while (i < args->per_producer) {
+    if (args->queue->tryPush((args->producer_id << 24) | i)) {
+      i++;
+    }
+    else {
+      sched_yield();   // The queue is full.
+    }
+  }
+  return nullptr;
+}
+
+template <class Q> static void* test_MPMCQueue_consumer(void* arg) {
+  MPMCStressArgs<Q>* args = (MPMCStressArgs<Q>*) arg;
+  int32_t last_seen[MPMC_STRESS_MAX_THREADS];
+  for (uint32_t i = 0; i < MPMC_STRESS_MAX_THREADS; i++) {  last_seen[i] = -1;  }
+  while (__atomic_load_n(&args->consumed, __ATOMIC_RELAXED) < args->total) {
+    uint32_t val = 0;
+    if (args->queue->tryPop(&val)) {
+      const uint32_t PRODUCER = (val >> 24);
+      const int32_t  SEQ      = (int32_t) (val & 0x00FFFFFF);
+      if ((PRODUCER >= MPMC_STRESS_MAX_THREADS) || (SEQ <= last_seen[PRODUCER])) {
+        __atomic_fetch_add(&args->errors, 1, __ATOMIC_RELAXED);
+      }
+      else {
+        last_seen[PRODUCER] = SEQ;
+        __atomic_fetch_add(&args->seen[(PRODUCER * args->per_producer) + SEQ], 1, __ATOMIC_RELAXED);
+      }
+      __atomic_fetch_add(&args->consumed, 1, __ATOMIC_RELAXED);
+    }
+    else {
+      sched_yield();   // The queue is empty.
+    }
+  }
+  return nullptr;
+}
+
+/*
+* Runs the workload against a queue.
+*
+* @return the wall time taken in microseconds, or 0 on failure.
+*/
+template <class Q> unsigned long test_MPMCQueue_workload(Q* queue, const uint32_t PRODUCERS, const uint32_t CONSUMERS, const uint32_t PER_PRODUCER) {
+  unsigned long ret = 0;
+  const uint32_t TOTAL = (PRODUCERS * PER_PRODUCER);
+  uint8_t* seen = (uint8_t*) malloc(TOTAL);
+  if (nullptr == seen) {
+    return ret;
+  }
+  memset(seen, 0, TOTAL);
+  MPMCStressArgs<Q> shared = { .queue = queue, .seen = seen, .per_producer = PER_PRODUCER, .total = TOTAL, .consumed = 0, .errors = 0, .producer_id = 0 };
+  MPMCStressArgs<Q> producer_args[MPMC_STRESS_MAX_THREADS];
+  pthread_t producers[MPMC_STRESS_MAX_THREADS];
+  pthread_t consumers[MPMC_STRESS_MAX_THREADS];
+  uint32_t producers_started = 0;
+  uint32_t consumers_started = 0;
+
+  const unsigned long T_START = micros();
+  while (consumers_started < CONSUMERS) {
+    if (0 != pthread_create(&consumers[consumers_started], nullptr, test_MPMCQueue_consumer<Q>, &shared)) {
+      break;
+    }
+    consumers_started++;
+  }
+  while (producers_started < PRODUCERS) {
+    // Built from the fixed fields only. The running consumers are writing to
+    //   the shared counters, so copying the whole struct would race.
+    producer_args[producers_started] = { .queue = queue, .seen = seen, .per_producer = PER_PRODUCER, .total = TOTAL, .consumed = 0, .errors = 0, .producer_id = producers_started };
+    if (0 != pthread_create(&producers[producers_started], nullptr, test_MPMCQueue_producer<Q>, &producer_args[producers_started])) {
+      break;
+    }
+    producers_started++;
+  }
+  for (uint32_t i = 0; i < producers_started; i++) {  pthread_join(producers[i], nullptr);  }
+  if (producers_started < PRODUCERS) {
+    // Unblock the consumers, which are waiting for elements that will never come.
+    __atomic_fetch_add(&shared.consumed, TOTAL, __ATOMIC_RELAXED);
+  }
+  for (uint32_t i = 0; i < consumers_started; i++) {  pthread_join(consumers[i], nullptr);  }
+  const unsigned long T_END = micros();
+
+  if ((PRODUCERS == producers_started) && (CONSUMERS == consumers_started) && (0 == shared.errors)) {
+    bool all_once = true;
+    for (uint32_t i = 0; i < TOTAL; i++) {  all_once &= (1 == seen[i]);  }
+    if (all_once) {
+      ret = strict_max((unsigned long) 1, (T_END - T_START));
+    }
+  }
+  else {
+    printf("(%u errors, %u/%u producers, %u/%u consumers) ", shared.errors, producers_started, PRODUCERS, consumers_started, CONSUMERS);
+  }
+  free(seen);
+  return ret;
+}
+
+
+int test_MPMCQueue_concurrency(const uint32_t PRODUCERS, const uint32_t CONSUMERS) {
+  int ret = -1;
+  const uint32_t PER_PRODUCER = (1 << 16);
+  MPMCQueue<uint32_t> queue(64);
+  printf("Testing MPMCQueue<uint32_t>(%u) with %u producers and %u consumers (%u elements each)...\n", queue.capacity(), PRODUCERS, CONSUMERS, PER_PRODUCER);
+  printf("\tEvery element arrives exactly once, in per-producer order... ");
+  const unsigned long ELAPSED = test_MPMCQueue_workload(&queue, PRODUCERS, CONSUMERS, PER_PRODUCER);
+  if (0 < ELAPSED) {
+    printf("Pass (%lu us).\n\tThe queue is empty afterward... ", ELAPSED);
+    uint32_t val = 0;
+    if (queue.isEmpty() && !queue.tryPop(&val)) {
+      printf("Pass.\n\tContention: %u push retries, %u pop retries, %u full, %u empty.\n", queue.pushRetries(), queue.popRetries(), queue.fullCount(), queue.emptyCount());
+      ret = 0;
+    }
+  }
+
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
+  return ret;
+}
+
+
+/*
+* Benchmark: The same workload through MPMCQueue and through a mutex-guarded
+*   PriorityQueue. This only fails if either queue mishandles the data. Timing
+*   is reported, but not judged, since it depends on the host.
+*/
+int test_MPMCQueue_benchmark() {
+  const uint32_t PER_PRODUCER = (1 << 14);
+  const uint32_t DEPTH        = 64;
+  const uint32_t SHAPES[][2]  = { {1, 1}, {2, 2}, {4, 4}, {4, 1}, {1, 4} };
+  printf("Benchmarking MPMCQueue<uint32_t> against a mutex-guarded PriorityQueue<uint32_t> (depth %u, %u elements per producer)...\n", DEPTH, PER_PRODUCER);
+  printf("\t Prod | Cons | MPMCQueue (us) | Mutex+PQ (us)\n");
+  printf("\t------+------+----------------+---------------\n");
+  for (uint32_t i = 0; i < (sizeof(SHAPES) / sizeof(SHAPES[0])); i++) {
+    MPMCQueue<uint32_t> mpmc(DEPTH);
+    MutexPriorityQueue  mpq(DEPTH);
+    const unsigned long T_MPMC = test_MPMCQueue_workload(&mpmc, SHAPES[i][0], SHAPES[i][1], PER_PRODUCER);
+    const unsigned long T_MPQ  = test_MPMCQueue_workload(&mpq,  SHAPES[i][0], SHAPES[i][1], PER_PRODUCER);
+    printf("\t %4u | %4u | %14lu | %13lu\n", SHAPES[i][0], SHAPES[i][1], T_MPMC, T_MPQ);
+    if ((0 == T_MPMC) || (0 == T_MPQ)) {
+      printf("Fail.\n");
+      return -1;
+    }
+  }
+  return 0;
+}
+
+
+/*******************************************************************************
+* ConcurrentElementPool
+*******************************************************************************/
+
+/* Elements know who holds them, so that double-issue can be caught. */
+struct PoolTestElement {
+  uint32_t owner;       // Zero when the element is on the shelf.
+  uint32_t payload[3];
+};
+
+/*
+* The benchmark baseline: the existing ElementPool behind a pthread mutex.
+*/
+class MutexElementPool {
+  public:
+    MutexElementPool(const uint32_t COUNT, const uint32_t OD_LIMIT) : _pool(COUNT, OD_LIMIT) {
+      pthread_mutex_init(&_mutex, nullptr);
+    };
+    ~MutexElementPool() {  pthread_mutex_destroy(&_mutex);  };
+
+    PoolTestElement* take() {
+      pthread_mutex_lock(&_mutex);
+      PoolTestElement* ret = _pool.take();
+      pthread_mutex_unlock(&_mutex);
+      return ret;
+    };
+
+    int8_t give(PoolTestElement* e) {
+      pthread_mutex_lock(&_mutex);
+      const int8_t ret = _pool.give(e);
+      pthread_mutex_unlock(&_mutex);
+      return ret;
+    };
+
+  private:
+    ElementPool<PoolTestElement> _pool;
+    pthread_mutex_t _mutex;
+};
+
+
+template <class P> struct PoolStressArgs {
+  P*       pool;
+  uint32_t id;          // Non-zero. Marks the elements this thread holds.
+  uint32_t rounds;      // How many take-then-give rounds to run.
+  uint32_t hold;        // The most elements a thread will hold at once.
+  uint32_t seed;
+  uint32_t errors;
+};
+
+/*
+* Each round takes a random number of elements, marks them, and gives them back
+*   after checking that nobody else touched them in the meantime.
+*/
+template <class P> static void* test_pool_worker(void* arg) {
+  PoolStressArgs<P>* args = (PoolStressArgs<P>*) arg;
+  PoolTestElement* held[16];
+  const uint32_t HOLD = strict_min((uint32_t) 16, args->hold);
+  for (uint32_t r = 0; r < args->rounds; r++) {
+    const uint32_t N = 1 + (test_RingBuffer_xorshift(&args->seed) % HOLD);
+    for (uint32_t i = 0; i < N; i++) {
+      held[i] = args->pool->take();
+      uint32_t expected = 0;
+      if ((nullptr == held[i]) || !__atomic_compare_exchange_n(&held[i]->owner, &expected, args->id, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        args->errors++;   // Two threads were handed the same element.
+        return nullptr;
+      }
+      held[i]->payload[0] = args->id;
+      held[i]->payload[1] = r;
+      held[i]->payload[2] = i;
+    }
+    for (uint32_t i = 0; i < N; i++) {
+      if ((args->id != held[i]->payload[0]) || (r != held[i]->payload[1]) || (i != held[i]->payload[2])) {
+        args->errors++;
+      }
+      __atomic_store_n(&held[i]->owner, 0, __ATOMIC_RELEASE);
+      args->pool->give(held[i]);
+    }
+  }
+  return nullptr;
+}
+
+
+/*
+* Runs the worker on the given number of threads.
+*
+* @return the elapsed time in microseconds, or 0 on failure.
+*/
+template <class P> unsigned long test_pool_workload(P* pool, const uint32_t THREADS, const uint32_t ROUNDS, const uint32_t HOLD) {
+  pthread_t threads[8];
+  PoolStressArgs<P> args[8];
+  uint32_t started = 0;
+  const unsigned long T_START = micros();
+  while (started < strict_min((uint32_t) 8, THREADS)) {
+    args[started] = { .pool = pool, .id = (started + 1), .rounds = ROUNDS, .hold = HOLD, .seed = (randomUInt32() | 1), .errors = 0 };
+    if (0 != pthread_create(&threads[started], nullptr, test_pool_worker<P>, &args[started])) {
+      break;
+    }
+    started++;
+  }
+  for (uint32_t i = 0; i < started; i++) {  pthread_join(threads[i], nullptr);  }
+  const unsigned long T_END = micros();
+  uint32_t errors = 0;
+  for (uint32_t i = 0; i < started; i++) {  errors += args[i].errors;  }
+  if ((THREADS != started) || (0 != errors)) {
+    printf("(%u of %u threads started, %u errors) ", started, THREADS, errors);
+    return 0;
+  }
+  return strict_max((unsigned long) 1, (T_END - T_START));
+}
+
+
+/*
+* Single-threaded behavior should match ElementPool.
+*/
+int test_ConcurrentElementPool_api() {
+  int ret = -1;
+  const uint32_t POOL_SIZE = 12;
+  ConcurrentElementPool<PoolTestElement, 4> pool(POOL_SIZE, 4, nullptr, 2);
+  PoolTestElement* held[POOL_SIZE + 2];
+  printf("Testing ConcurrentElementPool<T> API (%u elements, %u magazines)...\n", POOL_SIZE, pool.magazines());
+  printf("\tThe pool allocates on first use... ");
+  if ((0 == pool.available()) & (POOL_SIZE == pool.capacity()) & pool.allocated()) {
+    printf("Pass.\n\tAll elements are available... ");
+    if (POOL_SIZE == pool.available()) {
+      printf("Pass.\n\tDraining the pool yields distinct pooled elements... ");
+      bool distinct = true;
+      for (uint32_t i = 0; i < POOL_SIZE; i++) {
+        held[i] = pool.take();
+        distinct &= pool.inPool(held[i]);
+        for (uint32_t j = 0; j < i; j++) {  distinct &= (held[i] != held[j]);  }
+      }
+      if (distinct & (0 == pool.available()) & (0 == pool.lowWaterMark()) & (0 == pool.overdraws())) {
+        printf("Pass.\n\tTaking from an empty pool overdraws to the heap... ");
+        held[POOL_SIZE]     = pool.take();
+        held[POOL_SIZE + 1] = pool.take();
+        if ((nullptr != held[POOL_SIZE]) && !pool.inPool(held[POOL_SIZE]) && (2 == pool.overdraws())) {
+          printf("Pass.\n\tOverdrawn elements are deleted when given back... ");
+          if ((0 == pool.give(held[POOL_SIZE])) & (0 == pool.give(held[POOL_SIZE + 1])) & (2 == pool.overdrawsFreed())) {
+            printf("Pass.\n\tPooled elements are reclaimed when given back... ");
+            int8_t gives = 0;
+            for (uint32_t i = 0; i < POOL_SIZE; i++) {  gives += pool.give(held[i]);  }
+            if ((POOL_SIZE == (uint32_t) gives) & (POOL_SIZE == pool.available()) & (0 == pool.lowWaterMark())) {
+              printf("Pass.\n\tThe pool can be drained again without overdraw... ");
+              for (uint32_t i = 0; i < POOL_SIZE; i++) {  held[i] = pool.take();  }
+              const uint32_t AFTER_DRAIN = pool.overdraws();
+              for (uint32_t i = 0; i < POOL_SIZE; i++) {  pool.give(held[i]);  }
+              if ((2 == AFTER_DRAIN) & (POOL_SIZE == pool.available())) {
+                printf("Pass.\n\tA caller-supplied pool is used in place... ");
+                PoolTestElement backing[4];
+                ConcurrentElementPool<PoolTestElement> ext_pool(4, 0, backing);
+                PoolTestElement* ext = ext_pool.take();
+                if ((ext >= &backing[0]) && (ext <= &backing[3]) && (3 == ext_pool.available())) {
+                  ext_pool.give(ext);
+                  printf("Pass.\n");
+                  ret = 0;
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
+  return ret;
+}
+
+
+/*
+* Concurrency: Several threads churn a pool that is smaller than their
+*   combined appetite, so the stack, the magazines, stealing, and overdraw all
+*   get exercised. No element may be held by two threads at once, and the books
+*   must balance afterward.
+*/
+int test_ConcurrentElementPool_threads(const uint32_t THREADS) {
+  int ret = -1;
+  const uint32_t POOL_SIZE = 32;
+  const uint32_t ROUNDS    = 20000;
+  const uint32_t HOLD      = 8;
+  ConcurrentElementPool<PoolTestElement> pool(POOL_SIZE, 16);
+  printf("Testing ConcurrentElementPool<T>(%u) with %u threads holding up to %u elements each...\n", POOL_SIZE, THREADS, HOLD);
+  printf("\tNo element is ever handed to two threads... ");
+  const unsigned long ELAPSED = test_pool_workload(&pool, THREADS, ROUNDS, HOLD);
+  if (0 < ELAPSED) {
+    printf("Pass (%lu us).\n\tEvery pooled element came back... ", ELAPSED);
+    if (POOL_SIZE == pool.available()) {
+      printf("Pass.\n\tEvery overdraw was freed (%u)... ", pool.overdraws());
+      if (pool.overdraws() == pool.overdrawsFreed()) {
+        printf("Pass.\n\tThe low watermark is sane (%u)... ", pool.lowWaterMark());
+        const uint32_t MIN_LOW = (POOL_SIZE > (THREADS * HOLD)) ? (POOL_SIZE - (THREADS * HOLD)) : 0;
+        if ((pool.lowWaterMark() < POOL_SIZE) && (pool.lowWaterMark() >= MIN_LOW)) {
+          printf("Pass.\n");
+          ret = 0;
+        }
+      }
+    }
+  }
+
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
+  return ret;
+}
+
+
+/*
+* Benchmark: The same workload through ConcurrentElementPool and through a
+*   mutex-guarded ElementPool. Timing is reported, but not judged.
+*/
+int test_ConcurrentElementPool_benchmark() {
+  const uint32_t POOL_SIZE = 64;
+  const uint32_t ROUNDS    = 10000;
+  const uint32_t HOLD      = 4;
+  const uint32_t SHAPES[]  = { 1, 2, 4, 8 };
+  printf("Benchmarking ConcurrentElementPool<T> against a mutex-guarded ElementPool<T> (%u elements, %u rounds per thread)...\n", POOL_SIZE, ROUNDS);
+  printf("\t Threads | Concurrent (us) | Mutex (us)\n");
+  printf("\t---------+-----------------+-----------\n");
+  for (uint32_t i = 0; i < (sizeof(SHAPES) / sizeof(SHAPES[0])); i++) {
+    ConcurrentElementPool<PoolTestElement> c_pool(POOL_SIZE, POOL_SIZE);
+    MutexElementPool m_pool(POOL_SIZE, POOL_SIZE);
+    const unsigned long T_CONC  = test_pool_workload(&c_pool, SHAPES[i], ROUNDS, HOLD);
+    const unsigned long T_MUTEX = test_pool_workload(&m_pool, SHAPES[i], ROUNDS, HOLD);
+    printf("\t %7u | %15lu | %10lu\n", SHAPES[i], T_CONC, T_MUTEX);
+    if ((0 == T_CONC) || (0 == T_MUTEX)) {
+      printf("Fail.\n");
+      return -1;
+    }
+  }
+  return 0;
+}
+
+
+/*******************************************************************************
+* SlabAllocator
+*******************************************************************************/
+
+/*
+* Size classes of 16, 32, 64, and 128 bytes, in an arena supplied by the test.
+*/
+int test_SlabAllocator() {
+  int ret = -1;
+  const uint16_t COUNTS[] = { 4, 4, 2, 2 };
+  const uint8_t  CLASSES  = (sizeof(COUNTS) / sizeof(COUNTS[0]));
+  const uint32_t ARENA_SZ = SlabAllocator::arenaSize(COUNTS, CLASSES);
+  uint8_t* arena = (uint8_t*) malloc(ARENA_SZ);
+  SlabAllocator slab(COUNTS, CLASSES, 4, arena);
+  void* held[6];
+  printf("Testing SlabAllocator with %u classes in a %u-byte arena...\n", CLASSES, ARENA_SZ);
+  printf("\tThe allocator reports the arena size it was built with... ");
+  if ((ARENA_SZ == slab.arenaSize()) && (CLASSES == slab.classCount()) && (128 == slab.classSize(3)) && slab.allocated()) {
+    printf("Pass.\n\tRequests land in the smallest class that fits... ");
+    held[0] = slab.take(10);
+    held[1] = slab.take(17);
+    held[2] = slab.take(100);
+    if ((16 == slab.usableSize(held[0])) && (32 == slab.usableSize(held[1])) && (128 == slab.usableSize(held[2]))) {
+      printf("Pass.\n\tBlocks are within the caller's arena... ");
+      const bool IN_ARENA = (((uint8_t*) held[2] >= arena) && ((uint8_t*) held[2] < (arena + ARENA_SZ)));
+      if (IN_ARENA && slab.inPool(held[0]) && (1 == slab.inUse(0)) && (1 == slab.inUse(3))) {
+        printf("Pass.\n\tAligned requests are honored... ");
+        held[3] = slab.take(8, 64);
+        if ((nullptr != held[3]) && (0 == ((uintptr_t) held[3] % 64)) && (64 == slab.usableSize(held[3]))) {
+          printf("Pass.\n\tBad alignments are refused... ");
+          const uint32_t FAILURES_0 = slab.failures();
+          if ((nullptr == slab.take(8, 24)) && (nullptr == slab.take(8, 128)) && ((FAILURES_0 + 2) == slab.failures())) {
+            printf("Pass.\n\tAn empty class spills into the next larger one... ");
+            void* smalls[3];
+            for (uint32_t i = 0; i < 3; i++) {  smalls[i] = slab.take(10);  }
+            held[4] = slab.take(10);
+            if ((4 == slab.inUse(0)) && (32 == slab.usableSize(held[4])) && (1 == slab.spills(1))) {
+              printf("Pass.\n\tFragmentation is reported (%u%%)... ", slab.fragmentation(0));
+              if (37 == slab.fragmentation(0)) {
+                printf("Pass.\n\tWith heap fallback disabled, exhaustion is a failure... ");
+                slab.heapFallback(false);
+                if ((nullptr == slab.take(1000)) && (0 == slab.overdraws())) {
+                  printf("Pass.\n\tWith heap fallback enabled, it is an overdraw... ");
+                  slab.heapFallback(true);
+                  held[5] = slab.take(1000);
+                  if ((nullptr != held[5]) && !slab.inPool(held[5]) && (1 == slab.overdraws())) {
+                    printf("Pass.\n\tOverdrawn memory is freed when given back... ");
+                    if ((0 == slab.give(held[5])) && (1 == slab.overdrawsFreed())) {
+                      printf("Pass.\n\tPointers into the middle of a block are refused... ");
+                      if ((-1 == slab.give((uint8_t*) held[2] + 4)) && (-1 == slab.give(nullptr))) {
+                        printf("Pass.\n\tEverything else goes back to its class... ");
+                        int gives = 0;
+                        for (uint32_t i = 0; i < 5; i++) {  gives += slab.give(held[i]);   }
+                        for (uint32_t i = 0; i < 3; i++) {  gives += slab.give(smalls[i]); }
+                        bool all_free = true;
+                        for (uint8_t c = 0; c < CLASSES; c++) {  all_free &= (0 == slab.inUse(c));  }
+                        if ((8 == gives) && all_free && (4 == slab.highWater(0)) && (0 == slab.fragmentation(0))) {
+                          printf("Pass.\n\tprintDebug() renders the classes... ");
+                          StringBuilder output;
+                          slab.printDebug(&output);
+                          if (output.contains("SlabAllocator (Ready)") && output.contains("(external)")) {
+                            printf("Pass.\n%s\n", (const char*) output.string());
+                            ret = 0;
+                          }
+                        }
+                      }
+                    }
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
+  free(arena);
+  return ret;
+}
+
+
+/*******************************************************************************
+* C3PBitfield
+*******************************************************************************/
+
+/*
+* Edge cases around word boundaries, on a field whose length isn't a multiple
+*   of 64.
+*/
+int test_C3PBitfield_api() {
+  int ret = -1;
+  C3PBitfield field(130);
+  printf("Testing C3PBitfield API with %u bits...\n", field.bitCount());
+  printf("\tAn untouched field is all clear... ");
+  if ((0 == field.totalSet()) && (130 == field.totalClear()) && (UINT32_MAX == field.idxFirstSet()) && (0 == field.idxFirstClear())) {
+    printf("Pass.\n\tOut-of-bounds ranges are rejected... ");
+    if ((-1 == field.setRange(130, 1)) && (-1 == field.setRange(120, 11)) && (0 == field.setRange(129, 0)) && (0 == field.totalSet())) {
+      printf("Pass.\n\tsetRange() across two word boundaries... ");
+      if ((0 == field.setRange(60, 70)) && (70 == field.totalSet()) && (60 == field.idxFirstSet()) && !field.bitValue(59) && field.bitValue(129)) {
+        printf("Pass.\n\tfindNextClear() does not report bits past the end... ");
+        if ((UINT32_MAX == field.findNextClear(60)) && (59 == field.findNextClear(59)) && (UINT32_MAX == field.findNextClear(130))) {
+          printf("Pass.\n\tclearRange() inside a single word... ");
+          if ((0 == field.clearRange(64, 3)) && (67 == field.totalSet()) && (64 == field.findNextClear(60)) && (67 == field.findNextSet(64))) {
+            printf("Pass.\n\tflipRange() over the whole field... ");
+            if ((0 == field.flipRange(0, 130)) && (63 == field.totalSet()) && (0 == field.idxFirstSet()) && (64 == field.findNextSet(60)) && (UINT32_MAX == field.findNextSet(67))) {
+              C3PBitfield other(70);
+              other.setRange(0, 70);
+              printf("Pass.\n\tandWith() a shorter field clears the bits past its end... ");
+              if ((0 == field.andWith(&other)) && (63 == field.totalSet()) && (UINT32_MAX == field.findNextSet(67))) {
+                printf("Pass.\n\torWith() a longer field doesn't set bits past our end... ");
+                C3PBitfield longer(256);
+                longer.setRange(100, 156);
+                if ((0 == field.orWith(&longer)) && (93 == field.totalSet()) && (UINT32_MAX == field.findNextClear(100))) {
+                  printf("Pass.\n\txorWith() a field with itself's contents clears it... ");
+                  C3PBitfield copy(130);
+                  copy.orWith(&field);
+                  if ((0 == field.xorWith(&copy)) && (0 == field.totalSet())) {
+                    printf("Pass.\n\tandNotWith() clears only the bits set in the other... ");
+                    field.setRange(0, 130);
+                    if ((0 == field.andNotWith(&other)) && (60 == field.totalSet()) && (70 == field.idxFirstSet())) {
+                      printf("Pass.\n\tField operations reject nullptr... ");
+                      if (-1 == field.andWith(nullptr)) {
+                        printf("Pass.\n");
+                        ret = 0;
+                      }
+                    }
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
+  return ret;
+}
+
+
+/*
+* Random operations on a large field, checked against an array of bools. Then
+*   time a full set-bit iteration, which is the case that matters for
+*   allocation maps.
+*/
+int test_C3PBitfield_reference() {
+  const uint32_t BIT_COUNT = 100003;
+  const uint32_t ROUNDS    = 200;
+  int ret = 0;
+  uint32_t xs = randomUInt32() | 1;
+  bool* ref = (bool*) malloc(BIT_COUNT);
+  C3PBitfield field(BIT_COUNT);
+  C3PBitfield mask(BIT_COUNT);
+  memset(ref, 0, BIT_COUNT);
+  printf("Testing C3PBitfield against a reference with %u bits and %u rounds... ", BIT_COUNT, ROUNDS);
+
+  for (uint32_t r = 0; ((0 == ret) && (r < ROUNDS)); r++) {
+    const uint32_t FIRST = (test_RingBuffer_xorshift(&xs) % BIT_COUNT);
+    const uint32_t COUNT = (test_RingBuffer_xorshift(&xs) % (BIT_COUNT - FIRST + 1));
+    switch (test_RingBuffer_xorshift(&xs) % 5) {
+      case 0:
+        field.setRange(FIRST, COUNT);
+        for (uint32_t i = FIRST; i < (FIRST + COUNT); i++) {  ref[i] = true;     }
+        break;
+      case 1:
+        field.clearRange(FIRST, COUNT);
+        for (uint32_t i = FIRST; i < (FIRST + COUNT); i++) {  ref[i] = false;    }
+        break;
+      case 2:
+        field.flipRange(FIRST, COUNT);
+        for (uint32_t i = FIRST; i < (FIRST + COUNT); i++) {  ref[i] = !ref[i];  }
+        break;
+      case 3:   // Single bits, to break up the runs.
+        for (uint32_t i = 0; i < 64; i++) {
+          const uint32_t IDX = (test_RingBuffer_xorshift(&xs) % BIT_COUNT);
+          const bool     VAL = (0 != (i & 1));
+          field.bitValue(IDX, VAL);
+          ref[IDX] = VAL;
+        }
+        break;
+      default:   // AND-NOT with a sparse mask.
+        mask.clearRange(0, BIT_COUNT);
+        for (uint32_t i = 0; i < 256; i++) {
+          mask.bitValue(test_RingBuffer_xorshift(&xs) % BIT_COUNT, true);
+        }
+        field.andNotWith(&mask);
+        for (uint32_t i = 0; i < BIT_COUNT; i++) {
+          if (mask.bitValue(i)) {  ref[i] = false;  }
+        }
+        break;
+    }
+
+    // Walk both set and clear bits, and compare the counts.
+    uint32_t ref_set   = 0;
+    uint32_t next_set  = field.findNextSet(0);
+    uint32_t next_clr  = field.findNextClear(0);
+    for (uint32_t i = 0; ((0 == ret) && (i < BIT_COUNT)); i++) {
+      if (ref[i] != field.bitValue(i)) {
+        printf("Bit %u mismatch in round %u.\n", i, r);
+        ret = -1;
+      }
+      else if (ref[i]) {
+        ref_set++;
+        if (next_set != i) {
+          printf("findNextSet() returned %u, but expected %u in round %u.\n", next_set, i, r);
+          ret = -1;
+        }
+        next_set = field.findNextSet(i + 1);
+      }
+      else {
+        if (next_clr != i) {
+          printf("findNextClear() returned %u, but expected %u in round %u.\n", next_clr, i, r);
+          ret = -1;
+        }
+        next_clr = field.findNextClear(i + 1);
+      }
+    }
+    if ((0 == ret) && ((UINT32_MAX != next_set) || (UINT32_MAX != next_clr))) {
+      printf("Search did not end at the end of the field in round %u.\n", r);
+      ret = -1;
+    }
+    if ((0 == ret) && ((ref_set != field.totalSet()) || ((BIT_COUNT - ref_set) != field.totalClear()))) {
+      printf("totalSet() returned %u, but expected %u in round %u.\n", field.totalSet(), ref_set, r);
+      ret = -1;
+    }
+  }
+
+  if (0 == ret) {
+    printf("Pass.\n\tTiming set-bit iteration over a sparse field... ");
+    field.clearRange(0, BIT_COUNT);
+    for (uint32_t i = 0; i < BIT_COUNT; i += 997) {
+      field.bitValue(i, true);
+    }
+    uint32_t found_fast = 0;
+    uint32_t found_slow = 0;
+    const unsigned long T0 = micros();
+    for (uint32_t i = field.idxFirstSet(); i != UINT32_MAX; i = field.findNextSet(i + 1)) {
+      found_fast++;
+    }
+    const unsigned long T1 = micros();
+    for (uint32_t i = 0; i < BIT_COUNT; i++) {
+      if (field.bitValue(i)) {  found_slow++;  }
+    }
+    const unsigned long T2 = micros();
+    if ((found_fast == found_slow) && (found_fast == field.totalSet())) {
+      printf("Pass.\n\t%u bits found in %luus by findNextSet(), and %luus by bitValue().\n", found_fast, (T1 - T0), (T2 - T1));
+    }
+    else {
+      ret = -1;
+    }
+  }
+
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
+  free(ref);
+  return ret;
+}
+
+
+/*******************************************************************************
+* C3PHashMap and C3PHashSet
+*******************************************************************************/
+
+/*
+* A fixed-size map in memory supplied by the test, filled until it refuses.
+*/
+int test_C3PHashMap_api() {
+  int ret = -1;
+  const uint32_t SLOTS  = 64;
+  const uint32_t MEM_SZ = C3PHashMap<uint32_t, uint32_t>::memoryCost(SLOTS);
+  uint8_t* mem = (uint8_t*) malloc(MEM_SZ);
+  C3PHashMap<uint32_t, uint32_t> map(SLOTS, mem);
+  map.growable(false);
+  printf("Testing C3PHashMap with %u slots in %u bytes of external memory...\n", SLOTS, MEM_SZ);
+  printf("\tAn empty map finds nothing... ");
+  if ((0 == map.count()) && !map.contains(1) && (nullptr == map.get(1)) && (-1 == map.remove(1))) {
+    printf("Pass.\n\tCan fill every slot... ");
+    bool fill_ok = true;
+    for (uint32_t i = 0; i < SLOTS; i++) {
+      // Multiples of the slot count all want the same home slot.
+      fill_ok &= (0 == map.insert(((i & 1) ? (i * SLOTS) : (i * 7919)), i));
+    }
+    if (fill_ok && (SLOTS == map.count()) && (100 == map.loadFactor())) {
+      printf("Pass.\n\tA full map refuses a new key... ");
+      if (-1 == map.insert(12345678, 0)) {
+        printf("Pass.\n\tA full map still replaces the value of a present key... ");
+        if ((1 == map.insert(3 * SLOTS, 1000)) && (1000 == *map.get(3 * SLOTS)) && (SLOTS == map.count())) {
+          printf("Pass.\n\tEvery key can be found... ");
+          bool find_ok = true;
+          for (uint32_t i = 0; i < SLOTS; i++) {
+            const uint32_t KEY = ((i & 1) ? (i * SLOTS) : (i * 7919));
+            uint32_t* val = map.get(KEY);
+            find_ok &= ((nullptr != val) && (*val == ((3 == i) ? 1000 : i)));
+          }
+          if (find_ok) {
+            printf("Pass.\n\tRemoving half of the keys leaves the rest findable... ");
+            bool remove_ok = true;
+            for (uint32_t i = 0; i < SLOTS; i += 2) {
+              remove_ok &= (0 == map.remove(i * 7919));
+            }
+            for (uint32_t i = 0; i < SLOTS; i++) {
+              const uint32_t KEY = ((i & 1) ? (i * SLOTS) : (i * 7919));
+              remove_ok &= (map.contains(KEY) == (0 != (i & 1)));
+            }
+            if (remove_ok && ((SLOTS >> 1) == map.count())) {
+              printf("Pass.\n\tIteration by slot visits every key once... ");
+              uint32_t seen = 0;
+              for (uint32_t s = 0; s < map.capacity(); s++) {
+                uint32_t* key = map.keyAt(s);
+                const uint32_t EXPECTED = ((nullptr == key) || ((3 * SLOTS) == *key)) ? 1000 : (*key / SLOTS);
+                if ((nullptr != key) && (0 == (*key % SLOTS)) && (*map.valueAt(s) == EXPECTED)) {
+                  seen++;
+                }
+              }
+              if ((SLOTS >> 1) == seen) {
+                printf("Pass.\n\tclear() empties the map... ");
+                map.clear();
+                if ((0 == map.count()) && !map.contains(SLOTS)) {
+                  StringBuilder output;
+                  map.printDebug(&output);
+                  printf("Pass.\n\tprintDebug() reports the table... ");
+                  if (output.contains("C3PHashMap (Ready)") && output.contains("(external)") && output.contains("Growth is disallowed")) {
+                    printf("Pass.\n%s\n", (const char*) output.string());
+                    ret = 0;
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
+  free(mem);
+  return ret;
+}
+
+
+/*
+* String keys, and the set.
+*/
+int test_C3PHashMap_strings() {
+  int ret = -1;
+  const char* WORDS[] = { "info", "help", "reboot", "sensors", "pins", "ls", "conf", "uptime", "i2c", "spi" };
+  const uint32_t WORD_COUNT = (sizeof(WORDS) / sizeof(WORDS[0]));
+  C3PHashMap<const char*, uint32_t> map(4);   // Too small, on purpose.
+  C3PHashSet<const char*> set(4);
+  map.growable(true);
+  set.growable(true);
+  printf("Testing C3PHashMap and C3PHashSet with C-string keys...\n");
+  printf("\tInserting %u words... ", WORD_COUNT);
+  bool insert_ok = true;
+  for (uint32_t i = 0; i < WORD_COUNT; i++) {
+    insert_ok &= (0 == map.insert(WORDS[i], i));
+    insert_ok &= (0 == set.insert(WORDS[i]));
+  }
+  if (insert_ok && (WORD_COUNT == map.count()) && (WORD_COUNT == set.count())) {
+    printf("Pass.\n\tKeys compare by content, not by pointer... ");
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%s", "sensors");
+    uint32_t* val = map.get(buf);
+    if ((nullptr != val) && (3 == *val) && set.contains(buf) && (1 == set.insert(buf))) {
+      printf("Pass.\n\tAbsent strings are not found... ");
+      if (!map.contains("sensor") && !set.contains("") && !map.contains("sensorss")) {
+        printf("Pass.\n\tThe set removes by content... ");
+        if ((0 == set.remove(buf)) && !set.contains("sensors") && (-1 == set.remove("sensors")) && set.contains("spi")) {
+          printf("Pass.\n\tThe tables grew to fit... ");
+          if ((0 < map.grows()) && (0 < set.grows()) && (map.loadFactor() <= 88)) {
+            printf("Pass.\n");
+            ret = 0;
+          }
+        }
+      }
+    }
+  }
+
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
+  return ret;
+}
+
+
+/*
+* Random operations on a growing map, checked against a reference array over a
+*   small key space. Then compare lookup time against a linear scan.
+*/
+int test_C3PHashMap_reference() {
+  const uint32_t KEY_SPACE = 4096;
+  const uint32_t OPS       = 50000;
+  int ret = 0;
+  uint32_t xs = randomUInt32() | 1;
+  int32_t* ref = (int32_t*) malloc(KEY_SPACE * sizeof(int32_t));
+  uint32_t ref_count = 0;
+  C3PHashMap<uint32_t, int32_t> map(8);
+  map.growable(true);
+  for (uint32_t i = 0; i < KEY_SPACE; i++) {  ref[i] = -1;  }
+  printf("Testing C3PHashMap against a reference with %u random operations... ", OPS);
+
+  for (uint32_t i = 0; ((0 == ret) && (i < OPS)); i++) {
+    const uint32_t KEY = (test_RingBuffer_xorshift(&xs) % KEY_SPACE);
+    const int32_t  VAL = (int32_t) (i & 0x7FFFFFFF);
+    switch (test_RingBuffer_xorshift(&xs) % 3) {
+      case 0:
+      case 1:   // Inserts outnumber removals, so the map grows.
+        if (map.insert(KEY, VAL) != ((-1 == ref[KEY]) ? 0 : 1)) {
+          printf("insert(%u) returned the wrong code at op %u.\n", KEY, i);
+          ret = -1;
+        }
+        if (-1 == ref[KEY]) {  ref_count++;  }
+        ref[KEY] = VAL;
+        break;
+      default:
+        if (map.remove(KEY) != ((-1 == ref[KEY]) ? -1 : 0)) {
+          printf("remove(%u) returned the wrong code at op %u.\n", KEY, i);
+          ret = -1;
+        }
+        if (-1 != ref[KEY]) {  ref_count--;  }
+        ref[KEY] = -1;
+        break;
+    }
+  }
+  for (uint32_t k = 0; ((0 == ret) && (k < KEY_SPACE)); k++) {
+    int32_t* val = map.get(k);
+    if ((-1 == ref[k]) ? (nullptr != val) : ((nullptr == val) || (*val != ref[k]))) {
+      printf("Key %u disagrees with the reference.\n", k);
+      ret = -1;
+    }
+  }
+  if ((0 == ret) && (ref_count != map.count())) {
+    printf("count() is %u, but expected %u.\n", map.count(), ref_count);
+    ret = -1;
+  }
+
+  if (0 == ret) {
+    printf("Pass.\n\tTiming lookups against a linear scan... ");
+    // Pack the present keys into an array, as a linear-scan table would.
+    uint32_t* keys = (uint32_t*) malloc(ref_count * sizeof(uint32_t));
+    uint32_t  n    = 0;
+    for (uint32_t k = 0; k < KEY_SPACE; k++) {
+      if (-1 != ref[k]) {  keys[n++] = k;  }
+    }
+    const uint32_t LOOKUPS = 20000;
+    uint32_t hits_hash = 0;
+    uint32_t hits_scan = 0;
+    const unsigned long T0 = micros();
+    for (uint32_t i = 0; i < LOOKUPS; i++) {
+      if (map.contains((i * 2654435761UL) % KEY_SPACE)) {  hits_hash++;  }
+    }
+    const unsigned long T1 = micros();
+    for (uint32_t i = 0; i < LOOKUPS; i++) {
+      const uint32_t KEY = ((i * 2654435761UL) % KEY_SPACE);
+      for (uint32_t j = 0; j < n; j++) {
+        if (keys[j] == KEY) {  hits_scan++;  break;  }
+      }
+    }
+    const unsigned long T2 = micros();
+    free(keys);
+    if (hits_hash == hits_scan) {
+      StringBuilder output;
+      map.printDebug(&output);
+      printf("Pass.\n\t%u lookups over %u keys: %luus hashed, %luus scanned.\n%s\n", LOOKUPS, n, (T1 - T0), (T2 - T1), (const char*) output.string());
+    }
+    else {
+      ret = -1;
+    }
+  }
+
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
+  free(ref);
+  return ret;
+}
+
+/*******************************************************************************
+* C3PFlatMap and C3PFlatSet
+*******************************************************************************/
+
+// Tables that are fully constexpr can be checked at build time.
+static constexpr C3PFlatEntry<const char*, uint8_t> FLAT_TEST_CMDS[] = {
+  { "conf",    3 }, { "help",   0 }, { "i2c",    6 }, { "info",   1 },
+  { "ls",      5 }, { "pins",   4 }, { "reboot", 2 }, { "spi",    7 },
+  { "uptime",  8 }
+};
+static constexpr C3PFlatMap<const char*, uint8_t> FLAT_TEST_CMD_MAP(FLAT_TEST_CMDS, (sizeof(FLAT_TEST_CMDS) / sizeof(FLAT_TEST_CMDS[0])));
+static_assert(FLAT_TEST_CMD_MAP.valid(), "FLAT_TEST_CMDS must be sorted.");
+
+static constexpr uint16_t FLAT_TEST_PRIMES[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41 };
+static constexpr C3PFlatSet<uint16_t> FLAT_TEST_PRIME_SET(FLAT_TEST_PRIMES, (sizeof(FLAT_TEST_PRIMES) / sizeof(FLAT_TEST_PRIMES[0])));
+static_assert(FLAT_TEST_PRIME_SET.valid(), "FLAT_TEST_PRIMES must be sorted.");
+
+// An unordered table is caught by the same check.
+static constexpr uint16_t FLAT_TEST_UNSORTED[] = { 2, 3, 7, 5 };
+static_assert(!C3PFlatSet<uint16_t>(FLAT_TEST_UNSORTED, 4).valid(), "valid() should reject unordered tables.");
+
+
+/*
+* The constexpr tables above, with both layouts.
+*/
+int test_C3PFlatMap_api() {
+  int ret = -1;
+  const uint32_t CMD_COUNT = FLAT_TEST_CMD_MAP.count();
+  C3PFlatEntry<const char*, uint8_t> eyt_cmds[CMD_COUNT];
+  c3p_flat_eytzinger(FLAT_TEST_CMDS, eyt_cmds, CMD_COUNT);
+  C3PFlatMap<const char*, uint8_t> eyt_map(eyt_cmds, CMD_COUNT, C3PFlatLayout::EYTZINGER);
+  printf("Testing C3PFlatMap and C3PFlatSet...\n");
+  printf("\tEvery key in the map is found with its value... ");
+  bool found_all = true;
+  for (uint32_t i = 0; i < CMD_COUNT; i++) {
+    const uint8_t* val = FLAT_TEST_CMD_MAP.get(FLAT_TEST_CMDS[i].KEY);
+    found_all &= ((nullptr != val) && (*val == FLAT_TEST_CMDS[i].VAL) && ((int32_t) i == FLAT_TEST_CMD_MAP.indexOf(FLAT_TEST_CMDS[i].KEY)));
+  }
+  if (found_all) {
+    printf("Pass.\n\tString keys compare by content... ");
+    char buf[8];
+    snprintf(buf, sizeof(buf), "%s", "reboot");
+    if ((2 == FLAT_TEST_CMD_MAP.get(buf, 0xFF)) && (0xFF == FLAT_TEST_CMD_MAP.get("reboo", 0xFF)) && !FLAT_TEST_CMD_MAP.contains("rebooot")) {
+      printf("Pass.\n\tKeys before, between, and after the table are absent... ");
+      if (!FLAT_TEST_CMD_MAP.contains("a") && !FLAT_TEST_CMD_MAP.contains("j") && !FLAT_TEST_CMD_MAP.contains("zzz")) {
+        printf("Pass.\n\tThe Eytzinger copy is valid, and finds the same things... ");
+        bool eyt_ok = eyt_map.valid() && (C3PFlatLayout::EYTZINGER == eyt_map.layout());
+        for (uint32_t i = 0; i < CMD_COUNT; i++) {
+          eyt_ok &= (FLAT_TEST_CMDS[i].VAL == eyt_map.get(FLAT_TEST_CMDS[i].KEY, 0xFF));
+        }
+        eyt_ok &= (!eyt_map.contains("a") && !eyt_map.contains("j") && !eyt_map.contains("zzz"));
+        if (eyt_ok) {
+          printf("Pass.\n\tThe set agrees with trial division... ");
+          bool set_ok = true;
+          for (uint16_t n = 0; n < 50; n++) {
+            bool prime = (n > 1);
+            for (uint16_t d = 2; (d * d) <= n; d++) {
+              if (0 == (n % d)) {  prime = false;  }
+            }
+            set_ok &= (FLAT_TEST_PRIME_SET.contains(n) == ((n <= 41) && prime));
+          }
+          if (set_ok) {
+            printf("Pass.\n\tAn empty table finds nothing... ");
+            C3PFlatSet<uint16_t> empty(FLAT_TEST_PRIMES, 0);
+            if (empty.valid() && !empty.contains(2) && (nullptr == empty.at(0))) {
+              printf("Pass.\n");
+              ret = 0;
             }
-            else printf("Count should have been 0 but is %u\n", a.count());
           }
-          else printf("Sadly worked. Count is %u\n", a.count());
         }
-        else printf("Count mismatch. Got %u but was expecting %u.\n", a.count(), TEST_SIZE);
       }
-      else printf("Fairly certain we inserted %u elements, but the count says %u.\n", test_num, a.count());
     }
-    else printf("Newly created RingBuffers ought to be empty. This one reports %u.\n", a.count());
   }
-  else printf("Failed to allocate.\n");
 
-  return return_value;
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
+  return ret;
+}
+
+
+/*
+* Every size up to a limit, with both layouts, against a linear search. Then
+*   time the three searches on a larger table.
+*/
+int test_C3PFlatMap_sizes() {
+  const uint32_t MAX_COUNT = 300;
+  int ret = 0;
+  uint32_t* sorted = (uint32_t*) malloc(MAX_COUNT * sizeof(uint32_t));
+  uint32_t* eyt    = (uint32_t*) malloc(MAX_COUNT * sizeof(uint32_t));
+  printf("Testing C3PFlatSet at every size from 0 to %u... ", MAX_COUNT);
+  for (uint32_t n = 0; ((0 == ret) && (n <= MAX_COUNT)); n++) {
+    for (uint32_t i = 0; i < n; i++) {  sorted[i] = (i * 3) + 1;  }   // Gaps on both sides of every key.
+    c3p_flat_eytzinger(sorted, eyt, n);
+    C3PFlatSet<uint32_t> s_set(sorted, n);
+    C3PFlatSet<uint32_t> e_set(eyt, n, C3PFlatLayout::EYTZINGER);
+    if (!s_set.valid() || !e_set.valid()) {
+      printf("Table of %u was not valid.\n", n);
+      ret = -1;
+    }
+    for (uint32_t k = 0; ((0 == ret) && (k <= ((n * 3) + 1))); k++) {
+      const bool EXPECTED = ((1 == (k % 3)) && (k < ((n * 3) + 1)));
+      const int32_t S_IDX = s_set.indexOf(k);
+      const int32_t E_IDX = e_set.indexOf(k);
+      if ((EXPECTED != (0 <= S_IDX)) || (EXPECTED != (0 <= E_IDX))) {
+        printf("Key %u in a table of %u: expected %c, found %d/%d.\n", k, n, (EXPECTED ? 'y' : 'n'), S_IDX, E_IDX);
+        ret = -1;
+      }
+      else if (EXPECTED && ((k != *s_set.at(S_IDX)) || (k != *e_set.at(E_IDX)))) {
+        printf("Key %u in a table of %u was found at the wrong index.\n", k, n);
+        ret = -1;
+      }
+    }
+  }
+
+  if (0 == ret) {
+    printf("Pass.\n\tTiming searches of %u keys... ", MAX_COUNT);
+    C3PFlatSet<uint32_t> s_set(sorted, MAX_COUNT);
+    C3PFlatSet<uint32_t> e_set(eyt, MAX_COUNT, C3PFlatLayout::EYTZINGER);
+    const uint32_t LOOKUPS = 20000;
+    const uint32_t KEY_SPAN = (MAX_COUNT * 3);
+    uint32_t hits[3] = { 0, 0, 0 };
+    const unsigned long T0 = micros();
+    for (uint32_t i = 0; i < LOOKUPS; i++) {
+      const uint32_t KEY = ((i * 2654435761UL) % KEY_SPAN);
+      for (uint32_t j = 0; j < MAX_COUNT; j++) {
+        if (sorted[j] == KEY) {  hits[0]++;  break;  }
+      }
+    }
+    const unsigned long T1 = micros();
+    for (uint32_t i = 0; i < LOOKUPS; i++) {
+      if (s_set.contains((i * 2654435761UL) % KEY_SPAN)) {  hits[1]++;  }
+    }
+    const unsigned long T2 = micros();
+    for (uint32_t i = 0; i < LOOKUPS; i++) {
+      if (e_set.contains((i * 2654435761UL) % KEY_SPAN)) {  hits[2]++;  }
+    }
+    const unsigned long T3 = micros();
+    if ((hits[0] == hits[1]) && (hits[0] == hits[2])) {
+      printf("Pass.\n\t%u lookups: %luus linear, %luus sorted, %luus Eytzinger.\n", LOOKUPS, (T1 - T0), (T2 - T1), (T3 - T2));
+    }
+    else {
+      ret = -1;
+    }
+  }
+
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
+  free(sorted);
+  free(eyt);
+  return ret;
 }
 
 
@@ -1398,6 +3210,504 @@ int test_c3pstatblock() {
 }
 
 
+/* Known-good reduction by the obvious loop, for comparison. */
+template <class T> void test_reduce_reference(const T* SRC, const uint32_t N, T* min_val, T* max_val, double* sum, double* sum_sq) {
+  *min_val = SRC[0];
+  *max_val = SRC[0];
+  *sum     = 0.0;
+  *sum_sq  = 0.0;
+  for (uint32_t i = 0; i < N; i++) {
+    if (SRC[i] < *min_val) *min_val = SRC[i];
+    if (SRC[i] > *max_val) *max_val = SRC[i];
+    *sum    += (double) SRC[i];
+    *sum_sq += ((double) SRC[i] * (double) SRC[i]);
+  }
+}
+
+
+/*
+* Checks c3p_reduce() against the reference for every length up to a few
+*   vectors, from each misalignment. Floating sums are allowed to differ from
+*   the reference by the reordering of the additions.
+*/
+template <class T, class ACC> bool test_reduce_pairing(T (*GEN)(), const double PRECISION) {
+  const uint32_t MAX_LEN = 100;
+  T buf[MAX_LEN + 3];
+  bool all_ok = true;
+  for (uint32_t n = 1; all_ok & (n <= MAX_LEN); n++) {
+    for (uint32_t offset = 0; all_ok & (offset < 4); offset++) {
+      for (uint32_t i = 0; i < (n + offset); i++) {
+        buf[i] = GEN();
+      }
+      C3PReduction<T, ACC> result;
+      T ref_min;
+      T ref_max;
+      double ref_sum;
+      double ref_sum_sq;
+      test_reduce_reference((buf + offset), n, &ref_min, &ref_max, &ref_sum, &ref_sum_sq);
+      all_ok = (0 == c3p_reduce<T, ACC>((buf + offset), n, &result));
+      all_ok &= ((ref_min == result.min_value) && (ref_max == result.max_value));
+      all_ok &= ((0 == PRECISION) ? (ref_sum == (double) result.sum) : nearly_equal(ref_sum, (double) result.sum, PRECISION));
+      all_ok &= ((0 == PRECISION) ? (ref_sum_sq == (double) result.sum_sq) : nearly_equal(ref_sum_sq, (double) result.sum_sq, PRECISION));
+      if (!all_ok) {
+        printf("Fail at length %u, offset %u. ", n, offset);
+      }
+    }
+  }
+  return all_ok;
+}
+
+float   test_reduce_gen_flt() {  return ((float) (randomUInt32() % 2000001) / 1000.0f) - 1000.0f;  }
+double  test_reduce_gen_dbl() {  return ((double) (int32_t) randomUInt32() / (double) 7);  }
+int16_t test_reduce_gen_i16() {  return (int16_t) randomUInt32();  }
+int32_t test_reduce_gen_i32() {  return (int32_t) randomUInt32();  }
+uint8_t test_reduce_gen_u8() {   return (uint8_t) randomUInt32();  }
+
+
+/*
+* The fused reduction kernels behind C3PStatBlock.
+*/
+int test_c3p_reduce() {
+  int ret = -1;
+  printf("Testing c3p_reduce()...\n");
+  printf("\tc3p_reduce() rejects bad arguments... ");
+  float dummy = 1.0f;
+  C3PReduction<float, double> result_flt;
+  if ((-1 == c3p_reduce<float, double>(nullptr, 4, &result_flt)) && (-1 == c3p_reduce<float, double>(&dummy, 0, &result_flt)) && (-1 == c3p_reduce<float, double>(&dummy, 1, nullptr))) {
+    printf("Pass.\n\tfloat with float sums agrees with the reference... ");
+    if (test_reduce_pairing<float, float>(test_reduce_gen_flt, 0.001)) {
+      printf("Pass.\n\tfloat with double sums agrees with the reference... ");
+      if (test_reduce_pairing<float, double>(test_reduce_gen_flt, 0.0000001)) {
+        printf("Pass.\n\tdouble with double sums agrees with the reference... ");
+        if (test_reduce_pairing<double, double>(test_reduce_gen_dbl, 0.0000001)) {
+          printf("Pass.\n\tint16_t with int64_t sums is exact... ");
+          if (test_reduce_pairing<int16_t, int64_t>(test_reduce_gen_i16, 0.0)) {
+            printf("Pass.\n\tint32_t with double sums agrees with the reference... ");
+            if (test_reduce_pairing<int32_t, double>(test_reduce_gen_i32, 0.0000001)) {
+              printf("Pass.\n\tuint8_t (with no vector kernel) with int64_t sums is exact... ");
+              if (test_reduce_pairing<uint8_t, int64_t>(test_reduce_gen_u8, 0.0)) {
+                printf("Pass.\n\tint16_t sums are exact at the extremes of the type... ");
+                int16_t extremes[1000];
+                for (uint32_t i = 0; i < 1000; i++) {
+                  extremes[i] = ((i & 1) ? -32768 : -32767);
+                }
+                C3PReduction<int16_t, int64_t> result_i16;
+                c3p_reduce<int16_t, int64_t>(extremes, 1000, &result_i16);
+                if ((-32767500LL == result_i16.sum) && (1073709056500LL == result_i16.sum_sq)) {
+                  ret = 0;
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  if (0 == ret) {
+    printf("Pass.\n\tC3PStatBlock<float> stdev holds precision with a large mean... ");
+    ret = -1;
+    const uint32_t OFFSET_COUNT = 1000;
+    float offset_data[OFFSET_COUNT];
+    for (uint32_t i = 0; i < OFFSET_COUNT; i++) {
+      offset_data[i] = (100000.0f + (float) (i % 10));   // stdev of exactly sqrt(8.25).
+    }
+    C3PStatBlockTestShim<float> offset_block(offset_data, OFFSET_COUNT);
+    if (nearly_equal(sqrt((double) 8.25), offset_block.stdev(), (double) 0.000001) && nearly_equal((double) 100004.5, offset_block.mean(), (double) 0.000001)) {
+      printf("Pass.\n\tC3PStatBlock<int16_t> agrees with exact integer math... ");
+      int16_t i16_data[OFFSET_COUNT];
+      int64_t sum = 0;
+      for (uint32_t i = 0; i < OFFSET_COUNT; i++) {
+        i16_data[i] = (int16_t) (((int32_t) i * 37) - 20000);
+        sum += i16_data[i];
+      }
+      C3PStatBlockTestShim<int16_t> i16_block(i16_data, OFFSET_COUNT);
+      if ((-20000 == i16_block.minValue()) && (16963 == i16_block.maxValue()) && ((double) sum / OFFSET_COUNT == i16_block.mean())) {
+        printf("Pass.\n");
+        ret = 0;
+      }
+    }
+  }
+
+  if (0 == ret) {
+    // Compare with the loops this replaced, on a buffer the size of a megapixel plane.
+    const uint32_t BENCH_COUNT = (1024 * 1024);
+    float* bench = (float*) malloc(BENCH_COUNT * sizeof(float));
+    if (nullptr != bench) {
+      for (uint32_t i = 0; i < BENCH_COUNT; i++) {
+        bench[i] = test_reduce_gen_flt();
+      }
+      const uint32_t T0 = micros();
+      float  old_min = bench[0];
+      float  old_max = bench[0];
+      double old_sum = 0.0;
+      double old_sq  = 0.0;
+      for (uint32_t i = 1; i < BENCH_COUNT; i++) {
+        if (bench[i] > old_max) old_max = bench[i];
+        else if (bench[i] < old_min) old_min = bench[i];
+      }
+      for (uint32_t i = 0; i < BENCH_COUNT; i++) {
+        old_sum += (double) bench[i];
+      }
+      for (uint32_t i = 0; i < BENCH_COUNT; i++) {
+        old_sq += pow((double) bench[i], 2.0);
+      }
+      const uint32_t T1 = micros();
+      C3PReduction<float, double> fused;
+      c3p_reduce<float, double>(bench, BENCH_COUNT, &fused);
+      const uint32_t T2 = micros();
+      printf("\t%u floats: separate scalar loops took %uus, the fused pass took %uus.\n", BENCH_COUNT, (T1 - T0), (T2 - T1));
+      printf("\t\t(min %.3f/%.3f, max %.3f/%.3f, sum %.3f/%.3f)\n", (double) old_min, (double) fused.min_value, (double) old_max, (double) fused.max_value, old_sum, fused.sum);
+      free(bench);
+    }
+  }
+
+  printf("%s.\n", ((0 != ret) ? "Fail" : "PASS"));
+  return ret;
+}
+
+
+
+/*******************************************************************************
+* C3PMedian
+*******************************************************************************/
+
+/* Reference ordering for qsort(). */
+int test_median_cmp_int32(const void* a, const void* b) {
+  const int32_t A = *((const int32_t*) a);
+  const int32_t B = *((const int32_t*) b);
+  return ((A < B) ? -1 : ((B < A) ? 1 : 0));
+}
+
+
+/* The median of a sorted copy, by the same rule as c3p_median(). */
+int32_t test_median_reference(const int32_t* SRC, const uint32_t N) {
+  int32_t sorted[N];
+  memcpy(sorted, SRC, (N * sizeof(int32_t)));
+  qsort(sorted, N, sizeof(int32_t), test_median_cmp_int32);
+  return ((N & 1) ? sorted[N >> 1] : ((sorted[(N >> 1) - 1] + sorted[N >> 1]) / 2));
+}
+
+
+/*
+* Selection against a sorted reference, for every rank of many small buffers.
+*   Then the adversarial orders for quicksort, at a size where a quadratic
+*   partition would be obvious.
+*/
+int test_C3PMedian_select() {
+  int ret = -1;
+  printf("Testing c3p_select_nth() and c3p_median()...\n");
+  printf("\tc3p_select_nth() finds every rank, and partitions around it... ");
+  bool all_ok = true;
+  for (uint32_t n = 1; all_ok & (n < 70); n++) {
+    int32_t src[n];
+    int32_t sorted[n];
+    int32_t work[n];
+    for (uint32_t i = 0; i < n; i++) {
+      src[i] = (int32_t) (randomUInt32() % 24) - 12;   // Lots of duplicates.
+    }
+    memcpy(sorted, src, sizeof(src));
+    qsort(sorted, n, sizeof(int32_t), test_median_cmp_int32);
+    for (uint32_t k = 0; all_ok & (k < n); k++) {
+      memcpy(work, src, sizeof(src));
+      const int32_t RESULT = c3p_select_nth(work, n, k);
+      all_ok = ((RESULT == sorted[k]) & (work[k] == RESULT));
+      for (uint32_t i = 0; all_ok & (i < n); i++) {
+        all_ok = ((i < k) ? (work[i] <= RESULT) : (work[i] >= RESULT));
+      }
+      if (!all_ok) {
+        printf("Fail at N=%u K=%u (got %d, expected %d).\n", n, k, RESULT, sorted[k]);
+      }
+    }
+  }
+  if (all_ok) {
+    printf("Pass.\n\tc3p_median() matches a sorted copy for odd and even counts... ");
+    for (uint32_t trial = 0; all_ok & (trial < 400); trial++) {
+      const uint32_t N = (1 + (randomUInt32() % 500));
+      int32_t src[N];
+      for (uint32_t i = 0; i < N; i++) {
+        src[i] = (int32_t) (randomUInt32() % 2000) - 1000;
+      }
+      const int32_t EXPECTED = test_median_reference(src, N);
+      const int32_t RESULT   = c3p_median(src, N);
+      all_ok = (EXPECTED == RESULT);
+      if (!all_ok) {
+        printf("Fail at N=%u (got %d, expected %d).\n", N, RESULT, EXPECTED);
+      }
+    }
+  }
+  if (all_ok) {
+    printf("Pass.\n\tc3p_median() of a double buffer is the mean of the middle pair... ");
+    double dbl_vals[6] = { 4.5, -1.0, 9.25, 3.0, 100.0, 3.5 };
+    if ((double) 4 == c3p_median(dbl_vals, 6)) {
+      printf("Pass.\n\tc3p_median() of nothing is zero... ");
+      if (0 == c3p_median((int32_t*) nullptr, 10)) {
+        printf("Pass.\n");
+        ret = 0;
+      }
+    }
+  }
+
+  if (0 == ret) {
+    const uint32_t BIG_N = 100001;
+    int32_t* big = (int32_t*) malloc(BIG_N * sizeof(int32_t));
+    if (nullptr != big) {
+      const char* const ORDER_NAMES[3] = { "ascending", "descending", "constant" };
+      for (uint8_t order = 0; (0 == ret) & (order < 3); order++) {
+        printf("\tc3p_median() of %u %s values... ", BIG_N, ORDER_NAMES[order]);
+        for (uint32_t i = 0; i < BIG_N; i++) {
+          switch (order) {
+            case 0:   big[i] = (int32_t) i;             break;
+            case 1:   big[i] = (int32_t) (BIG_N - i);   break;
+            default:  big[i] = 7;                       break;
+          }
+        }
+        const uint32_t T0 = micros();
+        const int32_t  RESULT = c3p_median(big, BIG_N);
+        const uint32_t T1 = micros();
+        const int32_t  EXPECTED = ((2 == order) ? 7 : (int32_t) ((0 == order) ? (BIG_N >> 1) : ((BIG_N >> 1) + 1)));
+        if (EXPECTED == RESULT) {
+          printf("Pass (%uus).\n", (T1 - T0));
+        }
+        else {
+          printf("Fail (got %d, expected %d).\n", RESULT, EXPECTED);
+          ret = -1;
+        }
+      }
+      free(big);
+    }
+  }
+  printf("%s.\n", ((0 != ret) ? "Fail" : "PASS"));
+  return ret;
+}
+
+
+/*
+* The running median is checked against selection from a copy of the window,
+*   after every sample, for windows of many shapes.
+*/
+int test_C3PMedian_running() {
+  int ret = -1;
+  printf("Testing C3PRunningMedian...\n");
+  printf("\tinit() rejects bad arguments... ");
+  C3PRunningMedian<int32_t> run_med;
+  int32_t dummy_buf[4] = { 0, 0, 0, 0 };
+  if ((0 != run_med.init(nullptr, 4)) && (0 != run_med.init(dummy_buf, 0)) && !run_med.initialized()) {
+    printf("Pass.\n\tmedian() of an uninitialized instance is zero... ");
+    if (0 == run_med.median()) {
+      printf("Pass.\n\tThe running median tracks a sliding window after every sample... ");
+      const uint32_t WINDOWS[] = { 1, 2, 3, 4, 5, 8, 17, 64, 255, 256 };
+      bool all_ok = true;
+      for (uint32_t w = 0; all_ok & (w < (sizeof(WINDOWS) / sizeof(WINDOWS[0]))); w++) {
+        const uint32_t N = WINDOWS[w];
+        int32_t ring[N];
+        int32_t copy[N];
+        for (uint32_t i = 0; i < N; i++) {
+          ring[i] = (int32_t) (randomUInt32() % 100) - 50;
+        }
+        all_ok = ((0 == run_med.init(ring, N)) && (N == run_med.count()));
+        for (uint32_t i = 0; all_ok & (i < (N * 6 + 20)); i++) {
+          const uint32_t SLOT = (i % N);
+          const int32_t  OLD_VAL = ring[SLOT];
+          // Runs of one value, then wide swings, to exercise both heaps.
+          ring[SLOT] = ((i & 0x20) ? 5 : ((int32_t) (randomUInt32() % 100) - 50));
+          run_med.replace(SLOT, OLD_VAL);
+          memcpy(copy, ring, sizeof(ring));
+          const int32_t EXPECTED = c3p_median(copy, N);
+          all_ok = (EXPECTED == run_med.median());
+          if (!all_ok) {
+            printf("Fail with window %u on sample %u (got %d, expected %d).\n", N, i, run_med.median(), EXPECTED);
+          }
+        }
+      }
+      if (all_ok) {
+        printf("Pass.\n\tlowerMedian() and upperMedian() straddle the median of an even window... ");
+        int32_t even_buf[4] = { 10, 40, 20, 30 };
+        run_med.init(even_buf, 4);
+        if ((20 == run_med.lowerMedian()) && (30 == run_med.upperMedian()) && (25 == run_med.median())) {
+          printf("Pass.\n\tA window with a stride tracks one member of a struct... ");
+          Vector3<float> vects[99];
+          float axis_copy[99];
+          for (uint32_t i = 0; i < 99; i++) {
+            vects[i].set((float) (randomUInt32() % 1000), (float) i, -1.0f);
+          }
+          C3PRunningMedian<float> run_med_f;
+          all_ok = (0 == run_med_f.init(&vects[0].x, 99, 3));
+          for (uint32_t i = 0; all_ok & (i < 500); i++) {
+            const uint32_t SLOT = (i % 99);
+            const float OLD_VAL = vects[SLOT].x;
+            vects[SLOT].x = (float) (randomUInt32() % 1000) / 7.0f;
+            run_med_f.replace(SLOT, OLD_VAL);
+            for (uint32_t j = 0; j < 99; j++) {  axis_copy[j] = vects[j].x;  }
+            all_ok = (c3p_median(axis_copy, 99) == run_med_f.median());
+          }
+          if (all_ok) {
+            printf("Pass.\n");
+            ret = 0;
+          }
+        }
+      }
+    }
+  }
+
+  if (0 == ret) {
+    // Compare the costs of a median after every sample, at a window size that
+    //   was impractical before.
+    const uint32_t BIG_N = 4096;
+    const uint32_t FEEDS = 20000;
+    int32_t* big  = (int32_t*) malloc(BIG_N * sizeof(int32_t));
+    int32_t* copy = (int32_t*) malloc(BIG_N * sizeof(int32_t));
+    if ((nullptr != big) & (nullptr != copy)) {
+      for (uint32_t i = 0; i < BIG_N; i++) {  big[i] = (int32_t) randomUInt32();  }
+      int64_t checksum_run = 0;
+      int64_t checksum_sel = 0;
+      const uint32_t T0 = micros();
+      run_med.init(big, BIG_N);
+      for (uint32_t i = 0; i < FEEDS; i++) {
+        const uint32_t SLOT = (i % BIG_N);
+        const int32_t  OLD_VAL = big[SLOT];
+        big[SLOT] = (int32_t) randomUInt32();
+        run_med.replace(SLOT, OLD_VAL);
+        checksum_run += run_med.median();
+      }
+      const uint32_t T1 = micros();
+      for (uint32_t i = 0; i < (FEEDS / 100); i++) {
+        memcpy(copy, big, (BIG_N * sizeof(int32_t)));
+        checksum_sel += c3p_median(copy, BIG_N);
+      }
+      const uint32_t T2 = micros();
+      printf("\tWindow of %u: %u samples with a running median took %uus (%.3fus each).\n", BIG_N, FEEDS, (T1 - T0), ((double) (T1 - T0) / FEEDS));
+      printf("\t\tSelection from a copy took %.3fus per median. (checksums %lld, %lld)\n", ((double) (T2 - T1) / (FEEDS / 100)), (long long) checksum_run, (long long) checksum_sel);
+    }
+    if (nullptr != big) {   free(big);   }
+    if (nullptr != copy) {  free(copy);  }
+  }
+  printf("%s.\n", ((0 != ret) ? "Fail" : "PASS"));
+  return ret;
+}
+
+
+
+
+/*******************************************************************************
+* C3PSlidingMinMax
+*******************************************************************************/
+
+/*
+* The sliding min/max is checked against a scan of the window after every
+*   sample. Monotonic runs fill the deques, and plateaus test the handling of
+*   ties.
+*/
+int test_C3PSlidingMinMax() {
+  int ret = -1;
+  printf("Testing C3PSlidingMinMax...\n");
+  printf("\tinit() rejects bad arguments... ");
+  C3PSlidingMinMax<int32_t> run_mm;
+  int32_t dummy_buf[4] = { 0, 0, 0, 0 };
+  if ((0 != run_mm.init(nullptr, 4)) && (0 != run_mm.init(dummy_buf, 0)) && (0 != run_mm.init(dummy_buf, 4, 4)) && !run_mm.initialized()) {
+    printf("Pass.\n\tminValue() and maxValue() of an uninitialized instance are zero... ");
+    if ((0 == run_mm.minValue()) && (0 == run_mm.maxValue())) {
+      printf("Pass.\n\tThe extremes track a sliding window after every sample... ");
+      const uint32_t WINDOWS[] = { 1, 2, 3, 7, 64, 257 };
+      bool all_ok = true;
+      for (uint32_t w = 0; all_ok & (w < (sizeof(WINDOWS) / sizeof(WINDOWS[0]))); w++) {
+        const uint32_t N = WINDOWS[w];
+        int32_t ring[N];
+        for (uint32_t i = 0; i < N; i++) {
+          ring[i] = (int32_t) (randomUInt32() % 100) - 50;
+        }
+        // Start somewhere other than slot zero, as a ring buffer would.
+        uint32_t slot = (N >> 1);
+        all_ok = (0 == run_mm.init(ring, N, slot));
+        for (uint32_t i = 0; all_ok & (i < (N * 8 + 40)); i++) {
+          int32_t new_val;
+          switch ((i >> 4) & 3) {
+            case 0:   new_val = (int32_t) i;                                 break;  // Rising
+            case 1:   new_val = -((int32_t) i);                              break;  // Falling
+            case 2:   new_val = 3;                                           break;  // Plateau
+            default:  new_val = (int32_t) (randomUInt32() % 100) - 50;       break;
+          }
+          ring[slot] = new_val;
+          run_mm.push(slot);
+          slot = (((slot + 1) >= N) ? 0 : (slot + 1));
+          int32_t expected_min = ring[0];
+          int32_t expected_max = ring[0];
+          for (uint32_t j = 1; j < N; j++) {
+            if (ring[j] < expected_min) expected_min = ring[j];
+            if (ring[j] > expected_max) expected_max = ring[j];
+          }
+          all_ok = ((expected_min == run_mm.minValue()) && (expected_max == run_mm.maxValue()));
+          if (!all_ok) {
+            printf("Fail with window %u on sample %u (min %d vs %d, max %d vs %d).\n", N, i, run_mm.minValue(), expected_min, run_mm.maxValue(), expected_max);
+          }
+        }
+      }
+      if (all_ok) {
+        printf("Pass.\n\tA window with a stride tracks one member of a struct... ");
+        Vector3<float> vects[50];
+        for (uint32_t i = 0; i < 50; i++) {
+          vects[i].set(-100.0f, (float) (randomUInt32() % 1000), 100.0f);
+        }
+        C3PSlidingMinMax<float> run_mm_f;
+        all_ok = (0 == run_mm_f.init(&vects[0].y, 50, 0, 3));
+        for (uint32_t i = 0; all_ok & (i < 300); i++) {
+          const uint32_t SLOT = (i % 50);
+          vects[SLOT].y = (float) (randomUInt32() % 1000) / 3.0f;
+          run_mm_f.push(SLOT);
+          float expected_min = vects[0].y;
+          float expected_max = vects[0].y;
+          for (uint32_t j = 1; j < 50; j++) {
+            if (vects[j].y < expected_min) expected_min = vects[j].y;
+            if (vects[j].y > expected_max) expected_max = vects[j].y;
+          }
+          all_ok = ((expected_min == run_mm_f.minValue()) && (expected_max == run_mm_f.maxValue()));
+        }
+        if (all_ok) {
+          printf("Pass.\n");
+          ret = 0;
+        }
+      }
+    }
+  }
+
+  if (0 == ret) {
+    // Compare the costs of the extremes after every sample against a scan.
+    const uint32_t BIG_N = 4096;
+    const uint32_t FEEDS = 100000;
+    int32_t* big = (int32_t*) malloc(BIG_N * sizeof(int32_t));
+    if (nullptr != big) {
+      for (uint32_t i = 0; i < BIG_N; i++) {  big[i] = (int32_t) randomUInt32();  }
+      int64_t checksum_run  = 0;
+      int64_t checksum_scan = 0;
+      const uint32_t T0 = micros();
+      run_mm.init(big, BIG_N);
+      for (uint32_t i = 0; i < FEEDS; i++) {
+        const uint32_t SLOT = (i % BIG_N);
+        big[SLOT] = (int32_t) randomUInt32();
+        run_mm.push(SLOT);
+        checksum_run += ((int64_t) run_mm.maxValue() - run_mm.minValue());
+      }
+      const uint32_t T1 = micros();
+      for (uint32_t i = 0; i < (FEEDS / 100); i++) {
+        int32_t lo = big[0];
+        int32_t hi = big[0];
+        for (uint32_t j = 1; j < BIG_N; j++) {
+          if (big[j] < lo) lo = big[j];
+          if (big[j] > hi) hi = big[j];
+        }
+        checksum_scan += ((int64_t) hi - lo);
+      }
+      const uint32_t T2 = micros();
+      printf("\tWindow of %u: %u samples with sliding extremes took %uus (%.3fus each).\n", BIG_N, FEEDS, (T1 - T0), ((double) (T1 - T0) / FEEDS));
+      printf("\t\tA scan of the window took %.3fus. (checksums %lld, %lld)\n", ((double) (T2 - T1) / (FEEDS / 100)), (long long) checksum_run, (long long) checksum_scan);
+      free(big);
+    }
+  }
+  printf("%s.\n", ((0 != ret) ? "Fail" : "PASS"));
+  return ret;
+}
+
+
 
 
 /*******************************************************************************
@@ -1407,6 +3717,13 @@ int test_c3pstatblock() {
 #define CHKLST_C3PDS_TEST_RINGBUFFER_GENERAL     0x00000001  //
 #define CHKLST_C3PDS_TEST_RINGBUFFER_CONTAINS    0x00000002  //
 #define CHKLST_C3PDS_TEST_RINGBUFFER_API_GENERAL 0x00000004  //
+#define CHKLST_C3PDS_TEST_RINGBUFFER_SPSC        0x00000040  // Lock-free single-producer/single-consumer.
+#define CHKLST_C3PDS_TEST_RINGBUFFER_ZERO_COPY   0x00000080  // reserve()/commit() and peekContiguous()/consume().
+
+// MPMCQueue moves things between any number of threads without a mutex.
+#define CHKLST_C3PDS_TEST_MPMC_QUEUE_API         0x00020000  //
+#define CHKLST_C3PDS_TEST_MPMC_QUEUE_THREADS     0x00040000  // Correctness under contention.
+#define CHKLST_C3PDS_TEST_MPMC_QUEUE_BENCHMARK   0x00080000  // Compared to a mutex-guarded PriorityQueue.
 
 // LinkedList and Priority queue are sister templates with _almost_ matching
 //   APIs and implementations. Both are heap-resident.
@@ -1415,6 +3732,10 @@ int test_c3pstatblock() {
 #define CHKLST_C3PDS_TEST_LINKED_LIST_API_0      0x00000008  //
 #define CHKLST_C3PDS_TEST_PRI_QUEUE_API_0        0x00000010  //
 #define CHKLST_C3PDS_TEST_PRI_QUEUE_API_1        0x00000020  //
+#define CHKLST_C3PDS_TEST_NODE_POOLS             0x01000000  // Optional node pools for lists and queues.
+#define CHKLST_C3PDS_TEST_PRI_HEAP_API           0x00200000  // The API shared with PriorityQueue.
+#define CHKLST_C3PDS_TEST_PRI_HEAP_HANDLES       0x00400000  // Handles and reprioritization.
+#define CHKLST_C3PDS_TEST_PRI_HEAP_VS_QUEUE      0x00800000  // Same results as PriorityQueue.
 
 // NumericPlane is a template for handling a cartesian plane of number data.
 #define CHKLST_C3PDS_TEST_PLANE_ALLOCATION       0x00000100  // Tests the constructors and allocation semantics.
@@ -1430,9 +3751,20 @@ int test_c3pstatblock() {
 // Many classes in C3P hold aggregates of numbers from which we often want to
 //   collect statistical measurements.
 #define CHKLST_C3PDS_TEST_STAT_CONTAINER         0x00001000  //
+#define CHKLST_C3PDS_TEST_MEDIAN                 0x40000000  // Selection, and medians of sliding windows.
+#define CHKLST_C3PDS_TEST_SLIDING_MINMAX         0x80000000  // Extremes of sliding windows.
 
 // Creating shared allocation pools of elements is fairly common.
 #define CHKLST_C3PDS_TEST_ELEMENT_POOL           0x00010000  //
+#define CHKLST_C3PDS_TEST_CONCURRENT_POOL        0x02000000  // Lock-free pool with per-thread magazines.
+#define CHKLST_C3PDS_TEST_SLAB_ALLOCATOR         0x04000000  // Size-classed pools for variable-length memory.
+
+// Large bitfields track block allocation and presence.
+#define CHKLST_C3PDS_TEST_BITFIELD               0x08000000  // Word-parallel searches, ranges, and field ops.
+
+// Associative containers.
+#define CHKLST_C3PDS_TEST_HASH_MAP               0x10000000  // Open addressing with Robin Hood probing.
+#define CHKLST_C3PDS_TEST_FLAT_MAP               0x20000000  // Read-only sorted tables.
 
 // It is less common to need a stack, but here is one anyhow.
 #define CHKLST_C3PDS_TEST_STACK                  0x00100000  //
@@ -1440,9 +3772,18 @@ int test_c3pstatblock() {
 
 #define CHKLST_C3PDS_TESTS_ALL ( \
   CHKLST_C3PDS_TEST_RINGBUFFER_GENERAL | CHKLST_C3PDS_TEST_RINGBUFFER_CONTAINS | \
-  CHKLST_C3PDS_TEST_RINGBUFFER_API_GENERAL | CHKLST_C3PDS_TEST_LINKED_LIST_API_0 | \
+  CHKLST_C3PDS_TEST_RINGBUFFER_API_GENERAL | CHKLST_C3PDS_TEST_RINGBUFFER_SPSC | \
+  CHKLST_C3PDS_TEST_RINGBUFFER_ZERO_COPY | \
+  CHKLST_C3PDS_TEST_MPMC_QUEUE_API | CHKLST_C3PDS_TEST_MPMC_QUEUE_THREADS | \
+  CHKLST_C3PDS_TEST_MPMC_QUEUE_BENCHMARK | \
+  CHKLST_C3PDS_TEST_LINKED_LIST_API_0 | \
   CHKLST_C3PDS_TEST_PRI_QUEUE_API_0 | CHKLST_C3PDS_TEST_PRI_QUEUE_API_1 | \
-  CHKLST_C3PDS_TEST_STAT_CONTAINER | \
+  CHKLST_C3PDS_TEST_PRI_HEAP_API | CHKLST_C3PDS_TEST_PRI_HEAP_HANDLES | \
+  CHKLST_C3PDS_TEST_PRI_HEAP_VS_QUEUE | CHKLST_C3PDS_TEST_NODE_POOLS | \
+  CHKLST_C3PDS_TEST_STAT_CONTAINER | CHKLST_C3PDS_TEST_CONCURRENT_POOL | \
+  CHKLST_C3PDS_TEST_SLAB_ALLOCATOR | CHKLST_C3PDS_TEST_BITFIELD | \
+  CHKLST_C3PDS_TEST_HASH_MAP | CHKLST_C3PDS_TEST_FLAT_MAP | \
+  CHKLST_C3PDS_TEST_MEDIAN | CHKLST_C3PDS_TEST_SLIDING_MINMAX | \
   CHKLST_C3PDS_TEST_PLANE_ALLOCATION | CHKLST_C3PDS_TEST_PLANE_SET_BUF_BY_COPY | \
   CHKLST_C3PDS_TEST_PLANE_PARSE_PACK | \
   CHKLST_C3PDS_TEST_NUMVOL_ALLOCATION | CHKLST_C3PDS_TEST_NUMVOL_SET_BUF_BY_COPY | \
@@ -1468,6 +3809,38 @@ const StepSequenceList TOP_LEVEL_C3PDS_TEST_LIST[] = {
     .DISPATCH_FXN = []() { return 1;  },
     .POLL_FXN     = []() { return ((0 == test_RingBuffer_multiple_element_api()) ? 1:-1);  }
   },
+  { .FLAG         = CHKLST_C3PDS_TEST_RINGBUFFER_ZERO_COPY,
+    .LABEL        = "RingBuffer<T>: zero-copy API",
+    .DEP_MASK     = (CHKLST_C3PDS_TEST_RINGBUFFER_API_GENERAL),
+    .DISPATCH_FXN = []() { return 1;  },
+    .POLL_FXN     = []() { return (((0 == test_RingBuffer_zero_copy(32)) && (0 == test_RingBuffer_zero_copy(23))) ? 1:-1);  }
+  },
+  { .FLAG         = CHKLST_C3PDS_TEST_RINGBUFFER_SPSC,
+    .LABEL        = "RingBuffer<T>: SPSC concurrency",
+    .DEP_MASK     = (CHKLST_C3PDS_TEST_RINGBUFFER_ZERO_COPY),
+    .DISPATCH_FXN = []() { return 1;  },
+    // One power-of-two capacity, and one that isn't.
+    .POLL_FXN     = []() { return (((0 == test_RingBuffer_spsc_stress(64)) && (0 == test_RingBuffer_spsc_stress(37))) ? 1:-1);  }
+  },
+
+  { .FLAG         = CHKLST_C3PDS_TEST_MPMC_QUEUE_API,
+    .LABEL        = "MPMCQueue<T>: API",
+    .DEP_MASK     = (0),
+    .DISPATCH_FXN = []() { return 1;  },
+    .POLL_FXN     = []() { return ((0 == test_MPMCQueue_api()) ? 1:-1);  }
+  },
+  { .FLAG         = CHKLST_C3PDS_TEST_MPMC_QUEUE_THREADS,
+    .LABEL        = "MPMCQueue<T>: MPMC concurrency",
+    .DEP_MASK     = (CHKLST_C3PDS_TEST_MPMC_QUEUE_API),
+    .DISPATCH_FXN = []() { return 1;  },
+    .POLL_FXN     = []() { return (((0 == test_MPMCQueue_concurrency(1, 1)) && (0 == test_MPMCQueue_concurrency(4, 4)) && (0 == test_MPMCQueue_concurrency(3, 1))) ? 1:-1);  }
+  },
+  { .FLAG         = CHKLST_C3PDS_TEST_MPMC_QUEUE_BENCHMARK,
+    .LABEL        = "MPMCQueue<T>: Benchmark",
+    .DEP_MASK     = (CHKLST_C3PDS_TEST_MPMC_QUEUE_THREADS | CHKLST_C3PDS_TEST_PRI_QUEUE_API_1),
+    .DISPATCH_FXN = []() { return 1;  },
+    .POLL_FXN     = []() { return ((0 == test_MPMCQueue_benchmark()) ? 1:-1);  }
+  },
 
   { .FLAG         = CHKLST_C3PDS_TEST_LINKED_LIST_API_0,
     .LABEL        = "tLinkedList<T>: general API",
@@ -1488,6 +3861,65 @@ const StepSequenceList TOP_LEVEL_C3PDS_TEST_LIST[] = {
     .DISPATCH_FXN = []() { return 1;  },
     .POLL_FXN     = []() { return ((0 == test_PriorityQueue1()) ? 1:-1);  }
   },
+  { .FLAG         = CHKLST_C3PDS_TEST_NODE_POOLS,
+    .LABEL        = "Node pools for LinkedList<T> and PriorityQueue<T>",
+    .DEP_MASK     = (CHKLST_C3PDS_TEST_LINKED_LIST_API_0 | CHKLST_C3PDS_TEST_PRI_QUEUE_API_1),
+    .DISPATCH_FXN = []() { return 1;  },
+    .POLL_FXN     = []() { return (((0 == test_LinkedList_node_pool()) && (0 == test_PriorityQueue_node_pool()) && (0 == test_node_pool_benchmark())) ? 1:-1);  }
+  },
+  { .FLAG         = CHKLST_C3PDS_TEST_PRI_HEAP_API,
+    .LABEL        = "PriorityHeap<T>: API",
+    .DEP_MASK     = (0),
+    .DISPATCH_FXN = []() { return 1;  },
+    .POLL_FXN     = []() { return (((0 == test_PriorityHeap_api(false)) && (0 == test_PriorityHeap_api(true))) ? 1:-1);  }
+  },
+  { .FLAG         = CHKLST_C3PDS_TEST_PRI_HEAP_HANDLES,
+    .LABEL        = "PriorityHeap<T>: Handles",
+    .DEP_MASK     = (CHKLST_C3PDS_TEST_PRI_HEAP_API),
+    .DISPATCH_FXN = []() { return 1;  },
+    .POLL_FXN     = []() { return (((0 == test_PriorityHeap_handles(false)) && (0 == test_PriorityHeap_handles(true))) ? 1:-1);  }
+  },
+  { .FLAG         = CHKLST_C3PDS_TEST_PRI_HEAP_VS_QUEUE,
+    .LABEL        = "PriorityHeap<T> vs PriorityQueue<T>",
+    .DEP_MASK     = (CHKLST_C3PDS_TEST_PRI_HEAP_HANDLES | CHKLST_C3PDS_TEST_PRI_QUEUE_API_1),
+    .DISPATCH_FXN = []() { return 1;  },
+    .POLL_FXN     = []() { return ((0 == test_PriorityHeap_vs_PriorityQueue()) ? 1:-1);  }
+  },
+
+  { .FLAG         = CHKLST_C3PDS_TEST_CONCURRENT_POOL,
+    .LABEL        = "ConcurrentElementPool<T>",
+    .DEP_MASK     = (0),
+    .DISPATCH_FXN = []() { return 1;  },
+    .POLL_FXN     = []() { return (((0 == test_ConcurrentElementPool_api()) && (0 == test_ConcurrentElementPool_threads(2)) && (0 == test_ConcurrentElementPool_threads(6)) && (0 == test_ConcurrentElementPool_benchmark())) ? 1:-1);  }
+  },
+
+  { .FLAG         = CHKLST_C3PDS_TEST_SLAB_ALLOCATOR,
+    .LABEL        = "SlabAllocator",
+    .DEP_MASK     = (0),
+    .DISPATCH_FXN = []() { return 1;  },
+    .POLL_FXN     = []() { return ((0 == test_SlabAllocator()) ? 1:-1);  }
+  },
+
+  { .FLAG         = CHKLST_C3PDS_TEST_BITFIELD,
+    .LABEL        = "C3PBitfield",
+    .DEP_MASK     = (0),
+    .DISPATCH_FXN = []() { return 1;  },
+    .POLL_FXN     = []() { return (((0 == test_C3PBitfield_api()) && (0 == test_C3PBitfield_reference())) ? 1:-1);  }
+  },
+
+  { .FLAG         = CHKLST_C3PDS_TEST_HASH_MAP,
+    .LABEL        = "C3PHashMap<K, V>",
+    .DEP_MASK     = (0),
+    .DISPATCH_FXN = []() { return 1;  },
+    .POLL_FXN     = []() { return (((0 == test_C3PHashMap_api()) && (0 == test_C3PHashMap_strings()) && (0 == test_C3PHashMap_reference())) ? 1:-1);  }
+  },
+
+  { .FLAG         = CHKLST_C3PDS_TEST_FLAT_MAP,
+    .LABEL        = "C3PFlatMap<K, V>",
+    .DEP_MASK     = (0),
+    .DISPATCH_FXN = []() { return 1;  },
+    .POLL_FXN     = []() { return (((0 == test_C3PFlatMap_api()) && (0 == test_C3PFlatMap_sizes())) ? 1:-1);  }
+  },
 
   { .FLAG         = CHKLST_C3PDS_TEST_STACK,
     .LABEL        = "C3PStack<t>: General API",
@@ -1500,7 +3932,19 @@ const StepSequenceList TOP_LEVEL_C3PDS_TEST_LIST[] = {
     .LABEL        = "C3PStatBlock<T>: General API",
     .DEP_MASK     = (0),
     .DISPATCH_FXN = []() { return 1;  },
-    .POLL_FXN     = []() { return ((0 == test_c3pstatblock()) ? 1:-1);  }
+    .POLL_FXN     = []() { return (((0 == test_c3pstatblock()) && (0 == test_c3p_reduce())) ? 1:-1);  }
+  },
+  { .FLAG         = CHKLST_C3PDS_TEST_MEDIAN,
+    .LABEL        = "C3PMedian",
+    .DEP_MASK     = (0),
+    .DISPATCH_FXN = []() { return 1;  },
+    .POLL_FXN     = []() { return (((0 == test_C3PMedian_select()) && (0 == test_C3PMedian_running())) ? 1:-1);  }
+  },
+  { .FLAG         = CHKLST_C3PDS_TEST_SLIDING_MINMAX,
+    .LABEL        = "C3PSlidingMinMax",
+    .DEP_MASK     = (0),
+    .DISPATCH_FXN = []() { return 1;  },
+    .POLL_FXN     = []() { return ((0 == test_C3PSlidingMinMax()) ? 1:-1);  }
   },
 
   { .FLAG         = CHKLST_C3PDS_TEST_PLANE_ALLOCATION,
@@ -1565,6 +4009,8 @@ void print_types_small_ds() {
   printf("\tRingBuffer<uint8_t>      %u\t%u\n", sizeof(RingBuffer<uint8_t>),     alignof(RingBuffer<uint8_t>));
   printf("\tRingBuffer<uint32_t>     %u\t%u\n", sizeof(RingBuffer<uint32_t>),    alignof(RingBuffer<uint32_t>));
   printf("\tRingBuffer<void*>        %u\t%u\n", sizeof(RingBuffer<void*>),       alignof(RingBuffer<void*>));
+  printf("\tMPMCQueue<void*>         %u\t%u\n", sizeof(MPMCQueue<void*>),        alignof(MPMCQueue<void*>));
+  printf("\tConcurrentElementPool<void*> %u\t%u\n", sizeof(ConcurrentElementPool<void*>), alignof(ConcurrentElementPool<void*>));
   printf("\tLinkedList<uint8_t>      %u\t%u\n", sizeof(LinkedList<uint8_t>),     alignof(LinkedList<uint8_t>));
   printf("\tLinkedList<void*>        %u\t%u\n", sizeof(LinkedList<void*>),       alignof(LinkedList<void*>));
   printf("\tPriorityQueue<uint8_t>   %u\t%u\n", sizeof(PriorityQueue<uint8_t>),  alignof(PriorityQueue<uint8_t>));
@@ -405,6 +405,163 @@ int test_stringbuilder_case_shifter() {
 }
 
 
+/*
+* The byte-wise string kernels are checked against the ctype functions, over
+*   random content that is fragmented at random points. Lengths are chosen to
+*   exercise both the wide paths and the tails.
+*/
+int test_stringbuilder_byte_kernels() {
+  int ret = 0;
+  printf("Testing byte-wise transforms...\n");
+  const int TEST_LEN = (67 + (randomUInt32() % 61));
+  uint8_t src[TEST_LEN];
+  uint8_t ref_upper[TEST_LEN];
+  uint8_t ref_lower[TEST_LEN];
+  random_fill(src, TEST_LEN);
+  for (int i = 0; i < TEST_LEN; i++) {
+    // Make sure that letters are well-represented, but keep some high bytes.
+    if (0 == (i & 1)) {  src[i] = (0x40 + (src[i] % 0x40));  }
+    ref_upper[i] = ((src[i] < 0x80) ? toupper(src[i]) : src[i]);
+    ref_lower[i] = ((src[i] < 0x80) ? tolower(src[i]) : src[i]);
+  }
+
+  printf("\ttoUpper() and toLower() agree with ctype for all byte values... ");
+  StringBuilder frag_str;
+  int offset = 0;
+  while (offset < TEST_LEN) {
+    const int PIECE_LEN = strict_min((int32_t) (TEST_LEN - offset), (int32_t) (1 + (randomUInt32() % 23)));
+    frag_str.concat((src + offset), PIECE_LEN);
+    offset += PIECE_LEN;
+  }
+  frag_str.toUpper();
+  if (frag_str.cmpBinString(ref_upper, TEST_LEN) && (TEST_LEN == frag_str.length())) {
+    frag_str.toLower();
+    if (frag_str.cmpBinString(ref_lower, TEST_LEN)) {
+      printf("Pass.\n\tEvery byte value is handled correctly in both directions... ");
+      uint8_t all_bytes[256];
+      for (int i = 0; i < 256; i++) {  all_bytes[i] = (uint8_t) i;  }
+      StringBuilder all_str(all_bytes, 256);
+      all_str.toUpper();
+      uint8_t* all_ptr = all_str.string();
+      for (int i = 0; i < 256; i++) {
+        const uint8_t EXPECTED = ((i < 0x80) ? toupper(i) : i);
+        if (*(all_ptr + i) != EXPECTED) {
+          ret = -1;
+        }
+      }
+      all_str.toLower();
+      all_ptr = all_str.string();
+      for (int i = 0; i < 256; i++) {
+        const uint8_t EXPECTED = ((i < 0x80) ? tolower(i) : i);
+        if (*(all_ptr + i) != EXPECTED) {
+          ret = -1;
+        }
+      }
+    }
+    else {  ret = -1;  }
+  }
+  else {  ret = -1;  }
+
+  if (0 == ret) {
+    printf("Pass.\n\ttrim(char*) removes exactly the leading and trailing whitespace... ");
+    const char* const WS_CHARS = " \t\r\n\v\f";
+    for (int n = 0; n < 40; n++) {
+      const int LEAD  = (randomUInt32() % 20);
+      const int BODY  = ((0 == (n % 8)) ? 0 : (1 + (randomUInt32() % 40)));
+      const int TRAIL = (randomUInt32() % 20);
+      char work[LEAD + BODY + TRAIL + 1];
+      for (int i = 0; i < LEAD; i++) {   work[i] = WS_CHARS[randomUInt32() % 6];         }
+      for (int i = 0; i < BODY; i++) {   work[LEAD + i] = (0x21 + (randomUInt32() % 0x5E));  }
+      if (BODY > 2) {                    work[LEAD + (BODY >> 1)] = ' ';                  }
+      for (int i = 0; i < TRAIL; i++) {  work[LEAD + BODY + i] = WS_CHARS[randomUInt32() % 6];  }
+      work[LEAD + BODY + TRAIL] = '\0';
+      char expected[BODY + 1];
+      memcpy(expected, (work + LEAD), BODY);
+      expected[BODY] = '\0';
+
+      StringBuilder trimmed_obj((uint8_t*) work, (LEAD + BODY + TRAIL));
+      char* trimmed = StringBuilder::trim(work);
+      if ((0 != strcmp(trimmed, expected)) | ((int) strlen(trimmed) != BODY)) {
+        ret = -1;
+      }
+      trimmed_obj.trim();
+      if ((BODY != trimmed_obj.length()) || ((0 < BODY) && !trimmed_obj.cmpBinString((uint8_t*) expected, BODY))) {
+        ret = -1;
+      }
+    }
+  }
+
+  if (0 == ret) {
+    printf("Pass.\n\tisPrintable() is true for an empty string... ");
+    StringBuilder printable_str;
+    if (printable_str.isPrintable()) {
+      printf("Pass.\n\tisPrintable() is true for a fragmented printable string... ");
+      for (int i = 0; i < 9; i++) {
+        printable_str.concatf("%d: The quick brown fox. ", i);
+        printable_str.concat("~");
+      }
+      if (printable_str.isPrintable()) {
+        printf("Pass.\n\tisPrintable() finds a single bad byte anywhere in the string... ");
+        const int PRINTABLE_LEN = printable_str.length();
+        const uint8_t BAD_BYTES[4] = {0x00, 0x1F, 0x7F, 0x80};
+        for (int n = 0; n < 16; n++) {
+          const int BAD_IDX = (randomUInt32() % PRINTABLE_LEN);
+          StringBuilder tainted;
+          tainted.concat(printable_str.string(), BAD_IDX);
+          tainted.concat(BAD_BYTES[n & 3]);
+          tainted.concat((printable_str.string() + BAD_IDX + 1), (PRINTABLE_LEN - (BAD_IDX + 1)));
+          if (tainted.isPrintable()) {
+            ret = -1;
+          }
+        }
+      }
+      else {  ret = -1;  }
+    }
+    else {  ret = -1;  }
+  }
+
+  if (0 == ret) {
+    printf("Pass.\n\tHex tokens of any case parse back into the bytes that made them... ");
+    for (int n = 0; n < 16; n++) {
+      const int BIN_LEN = (1 + (randomUInt32() % TEST_LEN));
+      char hex_str[(BIN_LEN * 2) + 1];
+      for (int i = 0; i < BIN_LEN; i++) {
+        sprintf((hex_str + (i * 2)), ((n & 1) ? "%02X" : "%02x"), src[i]);
+      }
+      StringBuilder hex_obj(hex_str);
+      hex_obj.chunkViews(hex_obj.length());
+      uint8_t parsed[BIN_LEN];
+      if (BIN_LEN != hex_obj.view_as_bin(0, parsed, BIN_LEN)) {
+        ret = -1;
+      }
+      else if (0 != memcmp(parsed, src, BIN_LEN)) {
+        ret = -1;
+      }
+      else if (-1 != hex_obj.view_as_bin(0, parsed, (BIN_LEN - 1))) {
+        ret = -1;   // A short buffer should be refused.
+      }
+      else {
+        // A bad character anywhere should fail the parse.
+        hex_str[randomUInt32() % (BIN_LEN * 2)] = 'g';
+        StringBuilder bad_hex_obj(hex_str);
+        bad_hex_obj.chunkViews(bad_hex_obj.length());
+        if (-1 != bad_hex_obj.view_as_bin(0, parsed, BIN_LEN)) {
+          ret = -1;
+        }
+      }
+    }
+  }
+
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
+  else {
+    printf("Pass.\n");
+  }
+  return ret;
+}
+
+
 /*
   Tests byteAt(const int)
   (Needlesly) Depends on chunk() for inducing string fragmentation.
@@ -493,6 +650,73 @@ int test_stringbuilder_locate() {
 }
 
 
+/*
+* Reference implementation for checking locate() against.
+*/
+int sb_naive_locate(const uint8_t* haystack, const int H_LEN, const uint8_t* needle, const int N_LEN, const int START) {
+  for (int i = START; i <= (H_LEN - N_LEN); i++) {
+    if (0 == memcmp((haystack + i), needle, N_LEN)) {  return i;  }
+  }
+  return -1;
+}
+
+
+/*
+* locate() on fragmented strings, with needles of every length class, compared
+*   against a naive search of the same content.
+*/
+int test_stringbuilder_locate_fragmented() {
+  int ret = 0;
+  printf("Testing locate() on fragmented strings...\n");
+  // A small alphabet forces lots of partial matches.
+  const char* ALPHABET = "aab";
+  const int HAYSTACK_LEN = (300 + (randomUInt32() % 200));
+  uint8_t haystack[HAYSTACK_LEN];
+  for (int i = 0; i < HAYSTACK_LEN; i++) {
+    haystack[i] = ALPHABET[randomUInt32() % 3];
+  }
+  StringBuilder frag_obj(haystack, HAYSTACK_LEN);
+  const int CHUNK_SIZE = (1 + (randomUInt32() % 7));
+  frag_obj.chunk(CHUNK_SIZE);
+  printf("\tHaystack is %d bytes in %d fragments.\n", frag_obj.length(), frag_obj.count());
+
+  int trial = 0;
+  while ((0 == ret) & (trial < 400)) {
+    uint8_t needle[40];
+    const int N_LEN   = (1 + (randomUInt32() % sizeof(needle)));
+    const int START   = (randomUInt32() % HAYSTACK_LEN);
+    if (trial & 1) {  // Half of the needles are known to be present.
+      const int N_SRC = (randomUInt32() % (HAYSTACK_LEN - N_LEN));
+      memcpy(needle, (haystack + N_SRC), N_LEN);
+    }
+    else {
+      for (int i = 0; i < N_LEN; i++) {  needle[i] = ALPHABET[randomUInt32() % 3];  }
+    }
+    const int EXPECTED = sb_naive_locate(haystack, HAYSTACK_LEN, needle, N_LEN, START);
+    const int ACTUAL   = frag_obj.locate(needle, N_LEN, START);
+    if (EXPECTED != ACTUAL) {
+      printf("\tlocate() with a %d-byte needle from offset %d returned %d, but %d was expected.\n", N_LEN, START, ACTUAL, EXPECTED);
+      ret = -1;
+    }
+    trial++;
+  }
+  if (0 == ret) {
+    printf("\tResults match a naive search (%d trials)... ", trial);
+    ret = -1;
+    printf("Pass.\n\tThe string was not collapsed by searching... ");
+    if (1 < frag_obj.count()) {
+      printf("Pass.\n\tNegative start offsets fail... ");
+      if (-1 == frag_obj.locate("a", -1)) {
+        ret = 0;
+      }
+    }
+  }
+
+  printf((0 != ret) ? "Fail.\n" : "Pass.\n");
+  return ret;
+}
+
+
 
 int test_stringbuilder_split() {
   const char* DELIM_STR = "\n\t";
@@ -549,6 +773,119 @@ int test_stringbuilder_split() {
 }
 
 
+/*
+* splitViews(const char*), chunkViews(int), and the view_as_*() accessors.
+*/
+int test_stringbuilder_split_views() {
+  int ret = -1;
+  printf("Testing zero-copy tokenization...\n");
+  const char* SENTENCE = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,-46,0x2F,,DEADbeef";
+  const int SENTENCE_TOKENS = 14;   // The empty field is skipped, as strtok() would.
+  StringBuilder viewed;
+  StringBuilder cut;
+  viewed.concat("$GPGGA,123519,");   // Start fragmented.
+  viewed.concat(SENTENCE + 14);
+  cut.concat(SENTENCE);
+  printf("\tsplitViews() finds the same tokens as split()... ");
+  const int VIEW_COUNT = viewed.splitViews(",");
+  const int CUT_COUNT  = cut.split(",");
+  bool tokens_match = (SENTENCE_TOKENS == VIEW_COUNT) && (VIEW_COUNT == CUT_COUNT) && (VIEW_COUNT == viewed.viewCount());
+  for (int i = 0; tokens_match && (i < VIEW_COUNT); i++) {
+    int len_v = 0;
+    int len_c = 0;
+    const uint8_t* VIEW_TOK = viewed.view(i, &len_v);
+    const uint8_t* CUT_TOK  = cut.position(i, &len_c);
+    tokens_match = (len_v == len_c) && (0 == memcmp(VIEW_TOK, CUT_TOK, len_c));
+  }
+  if (tokens_match) {
+    printf("Pass.\n\tThe string was collapsed, but not cut... ");
+    if ((1 == viewed.count()) && (0 == strcmp(SENTENCE, (char*) viewed.string()))) {
+      printf("Pass.\n\tview() returns nullptr out of range... ");
+      int len = 0;
+      if ((nullptr == viewed.view(VIEW_COUNT, &len)) && (0 == len) && (nullptr == viewed.view(-1, &len))) {
+        printf("Pass.\n\tview_as_int() agrees with position_as_int()... ");
+        bool ints_match = true;
+        for (int i = 0; ints_match && (i < VIEW_COUNT); i++) {
+          ints_match = (viewed.view_as_int(i) == cut.position_as_int(i));
+        }
+        if (ints_match && (-46 == viewed.view_as_int(11)) && (0x2F == viewed.view_as_int(12))) {
+          printf("Pass.\n\tview_as_uint64() agrees with position_as_uint64()... ");
+          bool u64s_match = true;
+          for (int i = 0; u64s_match && (i < VIEW_COUNT); i++) {
+            u64s_match = (viewed.view_as_uint64(i) == cut.position_as_uint64(i));
+          }
+          if (u64s_match) {
+            printf("Pass.\n\tview_as_double() parses without running into the next token... ");
+            bool doubles_match = (atof("4807.038") == viewed.view_as_double(2));
+            for (int i = 0; doubles_match && (i < VIEW_COUNT); i++) {
+              doubles_match = (viewed.view_as_double(i) == cut.position_as_double(i));
+            }
+            if (doubles_match) {
+              printf("Pass.\n\tview_as_bool() agrees with position_as_bool()... ");
+              if (viewed.view_as_bool(6) && cut.position_as_bool(6) && !viewed.view_as_bool(3)) {
+                printf("Pass.\n\tview_as_bin() parses hex in place... ");
+                uint8_t bin_buf[4] = {0, 0, 0, 0};
+                const uint8_t BIN_EXPECTED[4] = {0xDE, 0xAD, 0xBE, 0xEF};
+                if ((4 == viewed.view_as_bin(13, bin_buf, 4)) && (0 == memcmp(bin_buf, BIN_EXPECTED, 4))) {
+                  printf("Pass.\n\tview_as_bin() refuses short buffers and non-hex tokens... ");
+                  if ((-1 == viewed.view_as_bin(13, bin_buf, 3)) && (-1 == viewed.view_as_bin(0, bin_buf, 4))) {
+                    printf("Pass.\n\tThe hex token in the string is unchanged... ");
+                    if (0 == strcmp(SENTENCE, (char*) viewed.string())) {
+                      printf("Pass.\n\tAppends preserve the views, even if they grow the arena... ");
+                      viewed.concat(",*47");
+                      StringBuilder grown;
+                      grown.bindArena(8);
+                      grown.concat(SENTENCE);
+                      grown.splitViews(",");
+                      const int ARENA_CAP_0 = grown.arenaCapacity();
+                      for (int i = 0; i < 4; i++) {  grown.concat(",appended to outgrow the arena");  }
+                      const bool ARENA_GREW = (ARENA_CAP_0 < grown.arenaCapacity()) && (1 == grown.count());
+                      if ((SENTENCE_TOKENS == viewed.viewCount()) && (123519 == viewed.view_as_int(1)) && ARENA_GREW && (SENTENCE_TOKENS == grown.viewCount()) && (123519 == grown.view_as_int(1)) && (0x2F == grown.view_as_int(12))) {
+                        printf("Pass.\n\tOther mutations discard the views... ");
+                        viewed.cull(1, 10);
+                        if (0 == viewed.viewCount()) {
+                          printf("Pass.\n\tchunkViews() finds the same tokens as chunk()... ");
+                          StringBuilder chunk_v(SENTENCE);
+                          StringBuilder chunk_c(SENTENCE);
+                          const int CHUNK_COUNT_V = chunk_v.chunkViews(9);
+                          const int CHUNK_COUNT_C = chunk_c.chunk(9);
+                          bool chunks_match = (CHUNK_COUNT_V == CHUNK_COUNT_C) && (0 < CHUNK_COUNT_V);
+                          for (int i = 0; chunks_match && (i < CHUNK_COUNT_V); i++) {
+                            int len_v = 0;
+                            int len_c = 0;
+                            const uint8_t* VIEW_TOK = chunk_v.view(i, &len_v);
+                            const uint8_t* CUT_TOK  = chunk_c.position(i, &len_c);
+                            chunks_match = (len_v == len_c) && (0 == memcmp(VIEW_TOK, CUT_TOK, len_c));
+                          }
+                          if (chunks_match) {
+                            printf("Pass.\n\tchunkViews() rejects a zero length... ");
+                            if ((-1 == chunk_v.chunkViews(0)) && (0 == chunk_v.viewCount())) {
+                              printf("Pass.\n\tdropViews() frees the views... ");
+                              const int COST_WITH_VIEWS = chunk_v.memoryCost();
+                              chunk_v.chunkViews(9);
+                              chunk_v.dropViews();
+                              if ((0 == chunk_v.viewCount()) && (COST_WITH_VIEWS > chunk_v.memoryCost())) {
+                                ret = 0;
+                              }
+                            }
+                          }
+                        }
+                      }
+                    }
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  printf((0 != ret) ? "Fail.\n" : "Pass.\n");
+  return ret;
+}
+
 /*
 * A one-off struct to hold test cases for replace(). Each input case is thrice
 *   mutated to test behavior on each string under both collapsed and fragmentary
@@ -968,6 +1305,32 @@ int test_stringbuilder_contains_1() {
   return (continue_test ? 0 : -1);
 }
 
+/*
+  bool contains(char)
+*/
+int test_stringbuilder_contains_2() {
+  int ret = -1;
+  printf("Testing contains(char)...\n");
+  StringBuilder haystack("ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+  haystack.chunk(3);
+  printf("\tcontains(char) finds the first byte... ");
+  if (haystack.contains('A')) {
+    printf("Pass.\n\tcontains(char) finds the last byte... ");
+    if (haystack.contains('Z')) {
+      printf("Pass.\n\tcontains(char) finds a byte on a fragment boundary... ");
+      if (haystack.contains('D')) {
+        printf("Pass.\n\tcontains(char) returns false for absent bytes... ");
+        if (!haystack.contains('a') && !haystack.contains('\n')) {
+          ret = 0;
+        }
+      }
+    }
+  }
+  printf((0 != ret) ? "Fail.\n" : "Pass.\n");
+  return ret;
+}
+
+
 
 /*
 * Taking ownership of a buffer malloc'd from elsewhere.
@@ -1120,15 +1483,98 @@ int test_stringbuilder_concat_handoff() {
 * printBuffer(StringBuilder*, uint8_t*, uint32_t, const char*)
 */
 int test_stringbuilder_print_buffer() {
-  int ret = 0;
+  int ret = -1;
   printf("Testing printBuffer(StringBuilder*, uint8_t*, uint32_t, const char*)...\n");
   const uint32_t TEST_LENGTH_BYTES = (83 + (randomUInt32() % 14));
   StringBuilder log;
+  StringBuilder ref;
   uint8_t buf[TEST_LENGTH_BYTES];
   random_fill(buf, TEST_LENGTH_BYTES);
+  // Render the reference the slow way, one byte at a time.
+  uint32_t i = 0;
+  while (i < TEST_LENGTH_BYTES) {
+    ref.concatf("\t0x%04x:", i);
+    const uint32_t LINE_END = strict_min((uint32_t) (i + 16), TEST_LENGTH_BYTES);
+    const bool WHOLE_LINE = ((LINE_END - i) == 16);
+    while (i < LINE_END) {
+      ref.concatf(" %02x", *(buf + i));
+      i++;
+    }
+    ref.concat(WHOLE_LINE ? "\n" : " \n");
+  }
+
+  printf("\tprintBuffer() renders a NULL buffer as such... ");
   StringBuilder::printBuffer(&log, nullptr, 0, "\t");
-  StringBuilder::printBuffer(&log, buf, TEST_LENGTH_BYTES, "\t");
-  printf("%s\n", (const char*) log.string());
+  if (0 == StringBuilder::strcasecmp((const char*) log.string(), "\t(NULL BUFFER)\n")) {
+    printf("Pass.\n\tprintBuffer() output matches a reference rendering... ");
+    log.clear();
+    log.concat("prefix");
+    StringBuilder::printBuffer(&log, buf, TEST_LENGTH_BYTES, "\t");
+    ref.prepend("prefix");
+    if ((log.length() == ref.length()) && (0 == strcmp((const char*) log.string(), (const char*) ref.string()))) {
+      printf("Pass.\n\tOffsets wider than four digits are rendered in full... ");
+      const uint32_t BIG_LENGTH = (0x10000 + 24);
+      uint8_t* big_buf = (uint8_t*) malloc(BIG_LENGTH);
+      if (nullptr != big_buf) {
+        memset(big_buf, 0xA5, BIG_LENGTH);
+        log.clear();
+        StringBuilder::printBuffer(&log, big_buf, BIG_LENGTH, "");
+        free(big_buf);
+        if (0 < log.locate("\n0x10000: a5 a5 a5 a5 a5 a5 a5 a5 a5 a5 a5 a5 a5 a5 a5 a5\n0x10010: a5 a5 a5 a5 a5 a5 a5 a5 \n")) {
+          printf("Pass.\n");
+          printf("%s\n", (const char*) ref.string());
+          ret = 0;
+        }
+      }
+    }
+  }
+
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
+  return ret;
+}
+
+
+/*
+* printDebug(StringBuilder*)
+*/
+int test_stringbuilder_print_debug() {
+  int ret = -1;
+  printf("Testing printDebug(StringBuilder*)...\n");
+  const uint32_t TEST_LENGTH_BYTES = (29 + (randomUInt32() % 14));
+  uint8_t buf[TEST_LENGTH_BYTES];
+  random_fill(buf, TEST_LENGTH_BYTES);
+  StringBuilder content;
+  content.concat(buf, 11);
+  content.concat((buf + 11), (TEST_LENGTH_BYTES - 11));
+  StringBuilder ref;
+  for (uint32_t i = 0; i < TEST_LENGTH_BYTES; i++) {
+    ref.concatf("%02x ", buf[i]);
+  }
+  StringBuilder log;
+  printf("\tprintDebug() does nothing for an empty string... ");
+  StringBuilder empty;
+  empty.printDebug(&log);
+  if (0 == log.length()) {
+    printf("Pass.\n\tprintDebug() output matches a reference rendering... ");
+    content.printDebug(&log);
+    if ((log.length() == ref.length()) && (0 == strcmp((const char*) log.string(), (const char*) ref.string()))) {
+      printf("Pass.\n\tprintDebug() output parses back into the original bytes... ");
+      uint8_t parsed[TEST_LENGTH_BYTES];
+      log.chunkViews(log.length());
+      if ((int) TEST_LENGTH_BYTES == log.view_as_bin(0, parsed, TEST_LENGTH_BYTES)) {
+        if (0 == memcmp(parsed, buf, TEST_LENGTH_BYTES)) {
+          printf("Pass.\n");
+          ret = 0;
+        }
+      }
+    }
+  }
+
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
   return ret;
 }
 
@@ -1282,9 +1728,33 @@ int test_stringbuilder_concat_handoff_range() {
                 printf("Pass.\n\tdest.count() returns the balance... ");
                 const uint32_t COUNT_D_0 = dest.count();
                 if (RANDOM_COUNT == COUNT_D_0) {
-                  printf("PASS.\n");
-                  // TODO: Content check. We can already rely on chunk() and count().
-                  ret = 0;
+                  printf("PASS.\n\tA donor that was indexed before the handoff reflects the loss... ");
+                  StringBuilder indexed_src;
+                  indexed_src.concat("aaaa");
+                  indexed_src.concat("bbbb");
+                  indexed_src.concat("cccc");
+                  indexed_src.concat("dddd");
+                  if ((4 == indexed_src.count()) && (0 == strcmp("bbbb", (const char*) indexed_src.position(1)))) {
+                    int handoff_ret = 0;
+                    {
+                      StringBuilder indexed_dest;
+                      handoff_ret = indexed_dest.concatHandoffPositions(&indexed_src, 1, 2);
+                    }  // The fragments that moved are freed here.
+                    if (2 == handoff_ret) {
+                      printf("Pass.\n\t\tcount() is 2... ");
+                      if (2 == indexed_src.count()) {
+                        printf("Pass.\n\t\tlength() is 8... ");
+                        if (8 == indexed_src.length()) {
+                          printf("Pass.\n\t\tposition(1) is \"dddd\"... ");
+                          if (0 == strcmp("dddd", (const char*) indexed_src.position(1))) {
+                            printf("PASS.\n");
+                            // TODO: Content check. We can already rely on chunk() and count().
+                            ret = 0;
+                          }
+                        }
+                      }
+                    }
+                  }
                 }
               }
             }
@@ -1301,6 +1771,118 @@ int test_stringbuilder_concat_handoff_range() {
 }
 
 
+/*
+* concatShared(StringBuilder*, int, int)
+*/
+/*
+* Returns the address of a fragment's bytes, without the side-effects of position().
+*/
+static const uint8_t* sb_frag_ptr(StringBuilder* sb, const int IDX) {
+  StrLLIterator iter(sb);
+  const uint8_t* buf = nullptr;
+  int len = 0;
+  for (int i = 0; i <= IDX; i++) {
+    if (!iter.next(&buf, &len)) {
+      return nullptr;
+    }
+  }
+  return buf;
+}
+
+
+int test_stringbuilder_concat_shared() {
+  int ret = -1;
+  printf("Testing concatShared()...\n");
+  const int MERGED_LEN = (100 + (randomUInt32() % 50));
+  const int EXT_LEN    = 64;
+  uint8_t merged_buf[MERGED_LEN];
+  random_fill(merged_buf, MERGED_LEN);
+  uint8_t* ext_buf = (uint8_t*) malloc(EXT_LEN + 1);
+  random_fill(ext_buf, EXT_LEN);
+  *(ext_buf + EXT_LEN) = 0;
+
+  StringBuilder* src = new StringBuilder(merged_buf, MERGED_LEN);
+  src->concatHandoff(ext_buf, EXT_LEN);
+  src->concat("tiny");
+  const int SRC_LEN   = src->length();
+  const int SRC_COUNT = src->count();
+  uint8_t ref_buf[SRC_LEN];
+  src->copyToBuffer(ref_buf, SRC_LEN);
+
+  StringBuilder whole;
+  StringBuilder range;
+  const int RANGE_OFFSET = 10;
+  const int RANGE_LEN    = (MERGED_LEN + 20 - RANGE_OFFSET);
+  printf("\tconcatShared() rejects bad parameters... ");
+  if ((-1 == whole.concatShared(nullptr)) && (-1 == whole.concatShared(&whole)) && (-1 == whole.concatShared(src, -1))) {
+    printf("Pass.\n\tconcatShared() from beyond the end takes nothing... ");
+    if ((0 == whole.concatShared(src, SRC_LEN)) && whole.isEmpty(true)) {
+      printf("Pass.\n\tconcatShared() takes the whole string by default (%d bytes)... ", SRC_LEN);
+      if ((SRC_LEN == whole.concatShared(src)) && (SRC_LEN == whole.length())) {
+        printf("Pass.\n\tThe source string is unchanged... ");
+        uint8_t cmp_buf[SRC_LEN];
+        src->copyToBuffer(cmp_buf, SRC_LEN);
+        if ((SRC_LEN == src->length()) && (SRC_COUNT == src->count()) && (0 == memcmp(cmp_buf, ref_buf, SRC_LEN))) {
+          printf("Pass.\n\tThe large fragments were shared, rather than copied... ");
+          if ((sb_frag_ptr(src, 0) == sb_frag_ptr(&whole, 0)) && (sb_frag_ptr(src, 1) == sb_frag_ptr(&whole, 1))) {
+            printf("Pass.\n\tThe small fragment was copied... ");
+            if (sb_frag_ptr(&whole, 2) != sb_frag_ptr(src, 2)) {
+              printf("Pass.\n\tThe shared content matches... ");
+              whole.copyToBuffer(cmp_buf, SRC_LEN);
+              if (0 == memcmp(cmp_buf, ref_buf, SRC_LEN)) {
+                printf("Pass.\n\tconcatShared() takes a range that spans fragments... ");
+                if ((RANGE_LEN == range.concatShared(src, RANGE_OFFSET, RANGE_LEN)) && (2 == range.count())) {
+                  printf("Pass.\n\tMutating the copy does not affect the source (copy-on-write)... ");
+                  whole.toUpper();
+                  src->copyToBuffer(cmp_buf, SRC_LEN);
+                  if ((0 == memcmp(cmp_buf, ref_buf, SRC_LEN)) && (sb_frag_ptr(&whole, 0) != sb_frag_ptr(src, 0))) {
+                    printf("Pass.\n\tThe ranged copy survives the destruction of the source... ");
+                    delete src;
+                    src = nullptr;
+                    if ((RANGE_LEN == range.length()) && (0 == memcmp(range.string(), (ref_buf + RANGE_OFFSET), RANGE_LEN))) {
+                      printf("Pass.\n\tThe mutated copy is also intact... ");
+                      whole.toLower();
+                      bool case_insensitive_match = (SRC_LEN == whole.length());
+                      for (int i = 0; case_insensitive_match && (i < SRC_LEN); i++) {
+                        case_insensitive_match = (tolower(ref_buf[i]) == whole.byteAt(i));
+                      }
+                      if (case_insensitive_match) {
+                        printf("Pass.\n\tposition_trimmed() on a shared token leaves the other sharers intact... ");
+                        const char* PADDED = "      A padded token, long enough to be shared.      ";
+                        StringBuilder pad_src(PADDED);
+                        StringBuilder pad_a;
+                        StringBuilder pad_b;
+                        pad_a.concatShared(&pad_src);
+                        pad_b.concatShared(&pad_src);
+                        const bool TRIMMED = (0 == strcmp("A padded token, long enough to be shared.", pad_a.position_trimmed(0)));
+                        if (TRIMMED && (0 == strcmp(PADDED, pad_b.position(0))) && (0 == strcmp(PADDED, (char*) pad_src.string()))) {
+                          printf("Pass.\n\tA shared slice parses and reads as its own length... ");
+                          StringBuilder num_src("00000000000000000000000000000000000042427777777777777777777777777");
+                          StringBuilder slice;
+                          slice.concatShared(&num_src, 0, 40);
+                          if ((4242 == slice.position_as_int(0)) && (4242 == slice.position_as_uint64(0)) && (40 == (int) strlen(slice.position(0)))) {
+                            ret = 0;
+                          }
+                        }
+                      }
+                    }
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  if (nullptr != src) {
+    delete src;
+  }
+
+  printf((0 != ret) ? "Fail.\n" : "Pass.\n");
+  return ret;
+}
+
 /*
 * position(int)
 */
@@ -1404,6 +1986,554 @@ int test_StringBuilder_hex_to_bin() {
 
 
 
+/*
+* Zero-copy fragment access: StrLLIterator, toIOVec(), and consume().
+*/
+int test_stringbuilder_fragment_export() {
+  int ret = -1;
+  printf("Testing zero-copy fragment export...\n");
+  const int TEST_LEN = (200 + (randomUInt32() % 100));
+  uint8_t test_buf[TEST_LEN];
+  random_fill(test_buf, TEST_LEN);
+  StringBuilder frag_obj(test_buf, TEST_LEN);
+  frag_obj.chunk(17);
+  uint8_t* handoff_buf = (uint8_t*) malloc(31);
+  random_fill(handoff_buf, 31);
+  frag_obj.concatHandoff(handoff_buf, 31);   // A fragment of the other kind.
+  const int FRAG_COUNT  = frag_obj.count();
+  const int ORIG_LEN    = frag_obj.length();
+  const int ORIG_COST   = frag_obj.memoryCost(true);
+
+  // Build a reference copy by iterating.
+  StringBuilder reference;
+  StrLLIterator iter(&frag_obj);
+  const uint8_t* frag_buf = nullptr;
+  int frag_len = 0;
+  int iter_count = 0;
+  while (iter.next(&frag_buf, &frag_len)) {
+    reference.concat(frag_buf, frag_len);
+    iter_count++;
+  }
+  printf("\tStrLLIterator visits every fragment (%d)... ", FRAG_COUNT);
+  if ((FRAG_COUNT == iter_count) && (ORIG_LEN == reference.length())) {
+    printf("Pass.\n\ttoIOVec() respects MAX_VECS... ");
+    SBIOVec vecs[8];
+    if (8 == frag_obj.toIOVec(vecs, 8)) {
+      printf("Pass.\n\ttoIOVec() spans match the content when started mid-fragment... ");
+      const int START_OFFSET = 20;
+      const int VEC_COUNT = frag_obj.toIOVec(vecs, 8, START_OFFSET);
+      int vec_offset = START_OFFSET;
+      bool vecs_match = (0 < VEC_COUNT) && ((17 - (START_OFFSET % 17)) == (int) vecs[0].iov_len);
+      for (int i = 0; vecs_match && (i < VEC_COUNT); i++) {
+        uint8_t cmp_buf[vecs[i].iov_len];
+        frag_obj.copyToBuffer(cmp_buf, vecs[i].iov_len, vec_offset);
+        vecs_match = (0 == memcmp(cmp_buf, vecs[i].iov_base, vecs[i].iov_len));
+        vec_offset += vecs[i].iov_len;
+      }
+      if (vecs_match) {
+        printf("Pass.\n\tExport did not mutate the layout... ");
+        if ((FRAG_COUNT == frag_obj.count()) && (ORIG_COST == frag_obj.memoryCost(true))) {
+          printf("Pass.\n\tconsume() within a fragment leaves the fragment count intact... ");
+          const int CONSUME_0 = 5;
+          if ((CONSUME_0 == frag_obj.consume(CONSUME_0)) && (FRAG_COUNT == frag_obj.count())) {
+            printf("Pass.\n\tconsume() across fragments frees the ones consumed... ");
+            const int CONSUME_1 = 40;
+            if ((CONSUME_1 == frag_obj.consume(CONSUME_1)) && (FRAG_COUNT > frag_obj.count())) {
+              printf("Pass.\n\tThe remaining content is correct... ");
+              const int CONSUMED = (CONSUME_0 + CONSUME_1);
+              if (0 == memcmp(frag_obj.string(), (reference.string() + CONSUMED), (ORIG_LEN - CONSUMED))) {
+                printf("Pass.\n\tconsume() into a handoff fragment is safe... ");
+                frag_obj.consume(frag_obj.length() - 7);
+                if ((7 == frag_obj.length()) && (0 == memcmp(frag_obj.string(), (reference.string() + (ORIG_LEN - 7)), 7))) {
+                  printf("Pass.\n\tconsume() of more than the length empties the string... ");
+                  if ((7 == frag_obj.consume(100)) && frag_obj.isEmpty()) {
+                    ret = 0;
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  printf((0 != ret) ? "Fail.\n" : "Pass.\n");
+  return ret;
+}
+
+
+/*
+* Compares an indexed string against an unindexed twin without changing the
+*   layout of either. Returns 0 if they agree.
+*/
+int sb_compare_index_twins(StringBuilder* indexed, StringBuilder* plain) {
+  const int LEN   = plain->length();
+  const int COUNT = plain->count();
+  if ((LEN != indexed->length()) || (COUNT != indexed->count())) {
+    printf("(length %d vs %d, count %d vs %d) ", indexed->length(), LEN, indexed->count(), COUNT);
+    return -1;
+  }
+  for (int i = 0; i <= COUNT; i++) {
+    int len_i = 0;
+    int len_p = 0;
+    uint8_t* pos_i = indexed->position(i, &len_i);
+    uint8_t* pos_p = plain->position(i, &len_p);
+    if ((len_i != len_p) || ((nullptr == pos_i) != (nullptr == pos_p))) {
+      printf("(position %d differs) ", i);
+      return -1;
+    }
+    if ((nullptr != pos_i) && (0 != memcmp(pos_i, pos_p, len_p))) {
+      printf("(position %d content differs) ", i);
+      return -1;
+    }
+  }
+  for (int i = 0; i < LEN; i += (1 + (LEN / 37))) {
+    if (indexed->byteAt(i) != plain->byteAt(i)) {
+      printf("(byteAt(%d) differs) ", i);
+      return -1;
+    }
+  }
+  if (LEN > 0) {
+    uint8_t buf_i[LEN];
+    uint8_t buf_p[LEN];
+    const int START = (LEN / 3);
+    const int COPY_I = indexed->copyToBuffer(buf_i, LEN, START);
+    const int COPY_P = plain->copyToBuffer(buf_p, LEN, START);
+    if ((COPY_I != COPY_P) || (0 != memcmp(buf_i, buf_p, COPY_P))) {
+      printf("(copyToBuffer() differs) ");
+      return -1;
+    }
+  }
+  return 0;
+}
+
+
+/*
+* count(), with and without the fragment index. Every mutation is applied to
+*   an indexed string and to an unindexed twin, and the results compared.
+*/
+int test_stringbuilder_count() {
+  int ret = -1;
+  printf("Testing count() and the fragment index...\n");
+  StringBuilder indexed;
+  StringBuilder plain;
+  printf("\tindexFragments(true) succeeds on an empty string... ");
+  if ((0 == indexed.indexFragments(true)) && indexed.fragmentsIndexed() && !plain.fragmentsIndexed()) {
+    printf("Pass.\n\tEmpty strings agree... ");
+    if ((0 == indexed.count()) && (0 == indexed.length()) && (0 == sb_compare_index_twins(&indexed, &plain))) {
+      printf("Pass.\n\tconcat() of many tokens... ");
+      for (int i = 0; i < 100; i++) {
+        const int TOK_LEN = (1 + (randomUInt32() % 23));
+        uint8_t tok[TOK_LEN];
+        random_fill(tok, TOK_LEN);
+        indexed.concat(tok, TOK_LEN);
+        plain.concat(tok, TOK_LEN);
+      }
+      if ((100 == indexed.count()) && (0 == sb_compare_index_twins(&indexed, &plain))) {
+        printf("Pass.\n\tStream appends into tail slack... ");
+        for (int i = 0; i < 50; i++) {
+          indexed.concat((uint8_t) ('a' + (i % 26)));
+          plain.concat((uint8_t) ('a' + (i % 26)));
+        }
+        indexed.concatf("%d-%s", 1234, "ABC");
+        plain.concatf("%d-%s", 1234, "ABC");
+        if (0 == sb_compare_index_twins(&indexed, &plain)) {
+          printf("Pass.\n\tprepend()... ");
+          indexed.prepend("HEAD");
+          plain.prepend("HEAD");
+          if (0 == sb_compare_index_twins(&indexed, &plain)) {
+            printf("Pass.\n\tdrop_position()... ");
+            indexed.drop_position(7);
+            plain.drop_position(7);
+            if (0 == sb_compare_index_twins(&indexed, &plain)) {
+              printf("Pass.\n\tconsume()... ");
+              indexed.consume(31);
+              plain.consume(31);
+              if (0 == sb_compare_index_twins(&indexed, &plain)) {
+                printf("Pass.\n\tconcatHandoff() from an unindexed donar... ");
+                StringBuilder donar_0("donated ");
+                StringBuilder donar_1("donated ");
+                donar_0.concat("twice");
+                donar_1.concat("twice");
+                indexed.concatHandoff(&donar_0);
+                plain.concatHandoff(&donar_1);
+                if (donar_0.isEmpty(true) && (0 == sb_compare_index_twins(&indexed, &plain))) {
+                  printf("Pass.\n\tAn indexed donar is left consistent... ");
+                  StringBuilder recipient;
+                  recipient.concatHandoff(&indexed);
+                  if ((0 == indexed.count()) && (0 == indexed.length())) {
+                    indexed.concatHandoff(&recipient);
+                    printf("Pass.\n\tcull()... ");
+                    indexed.cull(5, (plain.length() - 20));
+                    plain.cull(5, (plain.length() - 20));
+                    if (0 == sb_compare_index_twins(&indexed, &plain)) {
+                      printf("Pass.\n\tsplit()... ");
+                      const char* CSV = "alpha,beta,gamma,delta,epsilon,zeta,eta,theta,iota,kappa";
+                      indexed.clear();
+                      plain.clear();
+                      indexed.concat(CSV);
+                      plain.concat(CSV);
+                      const int SPLIT_I = indexed.split(",");
+                      const int SPLIT_P = plain.split(",");
+                      if ((10 == SPLIT_I) && (SPLIT_I == SPLIT_P) && (0 == sb_compare_index_twins(&indexed, &plain))) {
+                        printf("Pass.\n\tposition() after split() returns the right token... ");
+                        if (0 == strcmp("kappa", indexed.position(9))) {
+                          printf("Pass.\n\tchunk()... ");
+                          indexed.chunk(4);
+                          plain.chunk(4);
+                          if (0 == sb_compare_index_twins(&indexed, &plain)) {
+                            printf("Pass.\n\tDisabling the index leaves the string intact... ");
+                            indexed.indexFragments(false);
+                            if (!indexed.fragmentsIndexed() && (0 == sb_compare_index_twins(&indexed, &plain))) {
+                              ret = 0;
+                            }
+                          }
+                        }
+                      }
+                    }
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  printf((0 != ret) ? "Fail.\n" : "Pass.\n");
+  return ret;
+}
+
+/*
+* concatf(), and small streaming appends.
+*/
+int test_stringbuilder_concatf() {
+  int ret = -1;
+  printf("Testing concatf() and small appends...\n");
+  StringBuilder sb_0;
+  StringBuilder sb_1;
+  uint8_t buf[64];
+  random_fill(buf, sizeof(buf));
+  for (uint32_t i = 0; i < sizeof(buf); i++) {
+    sb_0.concatf("%02x", buf[i]);
+    sb_0.concat(' ');
+  }
+  printf("\tByte-wise output is written into fragment slack (%d fragments)... ", sb_0.count());
+  if ((3 * sizeof(buf)) > (uint32_t) (8 * sb_0.count())) {
+    printf("Pass.\n\tLength is correct... ");
+    if ((3 * sizeof(buf)) == (uint32_t) sb_0.length()) {
+      printf("Pass.\n\tContent matches the same string built by concat(const char*)... ");
+      // Same content, prepared a different way.
+      for (uint32_t i = 0; i < sizeof(buf); i++) {
+        char tmp[4];
+        sprintf(tmp, "%02x ", buf[i]);
+        sb_1.concat(tmp);
+      }
+      if ((0 == StringBuilder::strcasecmp((char*) sb_0.string(), (char*) sb_1.string()))) {
+        printf("Pass.\n\tmemoryCost() accounts for slack... ");
+        StringBuilder sb_2;
+        sb_2.concat('a');
+        if ((int) (sizeof(StrLL) + CONFIG_C3P_STRLL_INLINE_LEN + 1) == sb_2.memoryCost()) {
+          printf("Pass.\n\tconcat(const char*) still produces discrete tokens... ");
+          sb_2.concat("b");
+          sb_2.concat("c");
+          sb_2.concat('d');
+          sb_2.concat('e');
+          if ((4 == sb_2.count()) && (0 == StringBuilder::strcasecmp(sb_2.position(1), "b")) && (0 == StringBuilder::strcasecmp(sb_2.position(3), "de"))) {
+            printf("Pass.\n\tconcat((char) 0) appends nothing... ");
+            sb_2.concat((char) 0);
+            if (5 == sb_2.length()) {
+              printf("Pass.\n\tconcatf() does not truncate long output... ");
+              const int LONG_LEN = 1500;
+              char long_str[LONG_LEN + 1];
+              memset(long_str, 'x', LONG_LEN);
+              long_str[LONG_LEN] = 0;
+              StringBuilder sb_3("0123");
+              const int LONG_RET = sb_3.concatf("%s%d%s", long_str, 42, long_str);
+              if (((2 * LONG_LEN) + 2) == LONG_RET) {
+                printf("Pass.\n\tconcatf() output is intact (%d bytes)... ", sb_3.length());
+                if ((((2 * LONG_LEN) + 6) == sb_3.length()) && ('4' == sb_3.byteAt(LONG_LEN + 4)) && ('x' == sb_3.byteAt(sb_3.length() - 1))) {
+                  printf("Pass.\n\tconcatf() into a full arena fails cleanly... ");
+                  uint8_t arena_buf[64];
+                  StringBuilder sb_4;
+                  sb_4.bindArena(arena_buf, sizeof(arena_buf));
+                  const int ARENA_RET = sb_4.concatf("%s", long_str);
+                  if ((0 > ARENA_RET) && sb_4.isEmpty() && (8 == sb_4.concatf("%08x", 0xC0FFEE))) {
+                    printf("Pass.\n\tconcatf() into an arena lands in place... ");
+                    const uint8_t* STR_PTR = sb_4.string();
+                    if ((STR_PTR > arena_buf) && (STR_PTR < (arena_buf + sizeof(arena_buf))) && (0 == strcmp((const char*) STR_PTR, "00c0ffee"))) {
+                      printf("Pass.\n\tconcatf() may take arguments from its own string... ");
+                      StringBuilder self_slack;
+                      StringBuilder self_arena;
+                      StringBuilder self_long;
+                      self_slack.concat("abc");   // Leaves slack in the tail.
+                      self_slack.concatf("%s%s", (char*) self_slack.string(), (char*) self_slack.string());
+                      self_arena.bindArena(16);   // Must grow to fit.
+                      self_arena.concat("0123456789");
+                      self_arena.concatf("%s-%s", (char*) self_arena.string(), (char*) self_arena.string());
+                      self_long.bindArena(16);
+                      self_long.concat(long_str);
+                      self_long.concatf("|%s", (char*) self_long.string());
+                      const bool SLACK_OK = (0 == strcmp((const char*) self_slack.string(), "abcabcabc"));
+                      const bool ARENA_OK = (0 == strcmp((const char*) self_arena.string(), "01234567890123456789-0123456789"));
+                      const bool LONG_OK  = (((2 * LONG_LEN) + 1) == self_long.length()) && ('|' == self_long.byteAt(LONG_LEN)) && (0 == memcmp(self_long.string(), (self_long.string() + LONG_LEN + 1), LONG_LEN));
+                      if (SLACK_OK && ARENA_OK && LONG_OK) {
+                        StringBuilder report;
+                        StringBuilder::printMemoryStats(&report);
+                        printf("Pass.\n%s", (char*) report.string());
+                        ret = 0;
+                      }
+                    }
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  printf((0 != ret) ? "Fail.\n" : "Pass.\n");
+  return ret;
+}
+
+
+/*
+* Arena memory model.
+*/
+int test_stringbuilder_arena() {
+  int ret = -1;
+  printf("Testing arena binding...\n");
+  uint8_t arena_buf[96];
+  const uint8_t* ARENA_END = (arena_buf + sizeof(arena_buf));
+  StringBuilder sb_0;
+  StringBuilder sb_1;
+  StringBuilder sb_2("Pre-existing, ");
+  printf("\tbindArena() rejects the GROW policy for caller-supplied memory... ");
+  if (0 != sb_0.bindArena(arena_buf, sizeof(arena_buf), SBArenaPolicy::GROW)) {
+    printf("Pass.\n\tbindArena() copies existing content into the arena... ");
+    if ((0 == sb_2.bindArena(arena_buf, sizeof(arena_buf))) && sb_2.arenaBound()) {
+      sb_2.concat("and then some.");
+      sb_2.concat(',');
+      sb_2.concatf("%d", 42);
+      uint8_t* str_ptr = sb_2.string();
+      printf("Pass.\n\tConcats are written in place (%d)... ", sb_2.count());
+      if ((1 == sb_2.count()) && (str_ptr > arena_buf) && (str_ptr < ARENA_END)) {
+        printf("Pass.\n\tContent matches expectations... ");
+        if (0 == StringBuilder::strcasecmp((char*) str_ptr, "Pre-existing, and then some.,42")) {
+          const int LEN_BEFORE_OVERFLOW = sb_2.length();
+          sb_2.concat("This string is too long for what remains of the arena. Far too long.");
+          StringBuilder dbg_src("This renders to three times its own length in hex.");
+          dbg_src.printDebug(&sb_2);
+          printf("Pass.\n\tThe REFUSE policy drops overflowing writes, including from printDebug()... ");
+          if ((LEN_BEFORE_OVERFLOW == sb_2.length()) && (1 == sb_2.count()) && sb_2.arenaOverflowed()) {
+            printf("Pass.\n\tsplit() works on an arena... ");
+            if (3 == sb_2.split(",")) {
+              printf("Pass.\n\tposition() returns the expected tokens... ");
+              if ((0 == StringBuilder::strcasecmp(sb_2.position(1), " and then some.")) && (42 == sb_2.position_as_int(2))) {
+                str_ptr = sb_2.string();
+                printf("Pass.\n\tstring() re-collapses into the arena... ");
+                if ((1 == sb_2.count()) && (str_ptr > arena_buf) && (str_ptr < ARENA_END)) {
+                  sb_2.cull(4, 8);
+                  str_ptr = sb_2.string();
+                  printf("Pass.\n\tcull() works in place... ");
+                  if ((str_ptr > arena_buf) && (str_ptr < ARENA_END) && (0 == StringBuilder::strcasecmp((char*) str_ptr, "existing"))) {
+                    sb_2.prepend("Pre-");
+                    printf("Pass.\n\tprepend() works in place... ");
+                    if ((1 == sb_2.count()) && (0 == StringBuilder::strcasecmp((char*) sb_2.string(), "Pre-existing"))) {
+                      sb_1.concatHandoff(&sb_2);
+                      printf("Pass.\n\tconcatHandoff() moves arena content to the recipient... ");
+                      if (sb_2.isEmpty() && (0 == StringBuilder::strcasecmp((char*) sb_1.string(), "Pre-existing"))) {
+                        sb_2.concat("Reuse");
+                        str_ptr = sb_2.string();
+                        printf("Pass.\n\tThe arena is reusable after handoff... ");
+                        if ((str_ptr > arena_buf) && (str_ptr < ARENA_END) && (5 == sb_2.length())) {
+                          printf("Pass.\n\tunbindArena() leaves the content on the heap... ");
+                          if ((0 == sb_2.unbindArena()) && !sb_2.arenaBound() && (0 == StringBuilder::strcasecmp((char*) sb_2.string(), "Reuse"))) {
+                            printf("Pass.\n\tThe SPILL policy moves overflowing writes to the heap... ");
+                            if (0 == sb_0.bindArena(arena_buf, (sizeof(StrLL) + 24), SBArenaPolicy::SPILL)) {
+                              const char* SPILL_STR = "This won't all fit in 24 bytes, and will spill onto the heap.";
+                              sb_0.concat(SPILL_STR);
+                              if (sb_0.arenaOverflowed() && (0 == StringBuilder::strcasecmp((char*) sb_0.string(), SPILL_STR))) {
+                                printf("Pass.\n\tA heap arena grows to fit its content... ");
+                                StringBuilder sb_3;
+                                if (0 == sb_3.bindArena(8)) {
+                                  for (int i = 0; i < 40; i++) {  sb_3.concat("0123456789");  }
+                                  if ((400 == sb_3.length()) && (1 == sb_3.count()) && (400 <= sb_3.arenaCapacity()) && !sb_3.arenaOverflowed()) {
+                                    printf("Pass.\n\tmemoryCost() counts the arena once... ");
+                                    if (sb_3.memoryCost() == (int) (sizeof(StrLL) + sb_3.arenaCapacity() + 1)) {
+                                      printf("Pass.\n\tclear() empties the arena and resets overflow... ");
+                                      sb_0.clear();
+                                      if (sb_0.isEmpty() && !sb_0.arenaOverflowed() && (24 > sb_0.arenaCapacity())) {
+                                        ret = 0;
+                                      }
+                                    }
+                                  }
+                                }
+                              }
+                            }
+                          }
+                        }
+                      }
+                    }
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  printf((0 != ret) ? "Fail.\n" : "Pass.\n");
+  return ret;
+}
+
+
+/*
+* Fragment pool. If the build doesn't enable it, the counters should never move.
+*/
+int test_stringbuilder_pool() {
+  int ret = -1;
+  printf("Testing fragment pool...\n");
+  const uint32_t HITS_0   = StringBuilder::poolHits();
+  const uint32_t MISSES_0 = StringBuilder::poolMisses();
+  uint8_t big_buf[300];
+  random_fill(big_buf, sizeof(big_buf));
+  #if defined(CONFIG_C3P_STRLL_POOL)
+    const int FRAG_COUNT = ((3 * CONFIG_C3P_STRLL_POOL_COUNT) + 8);
+    printf("\tA small fragment is drawn from the pool... ");
+    StringBuilder sb_small("tiny");
+    if ((HITS_0 + 1) == StringBuilder::poolHits()) {
+      printf("Pass.\n\tA fragment too large for any size class is a miss... ");
+      sb_small.concat(big_buf, sizeof(big_buf));
+      if (((HITS_0 + 1) == StringBuilder::poolHits()) && ((MISSES_0 + 1) == StringBuilder::poolMisses())) {
+        printf("Pass.\n\tExhausting the pool falls back to the heap (%d fragments)... ", FRAG_COUNT);
+        StringBuilder sb_many;
+        const uint32_t HITS_1   = StringBuilder::poolHits();
+        const uint32_t MISSES_1 = StringBuilder::poolMisses();
+        for (int i = 0; i < FRAG_COUNT; i++) {
+          sb_many.concat("x");
+        }
+        const uint32_t HIT_DELTA  = (StringBuilder::poolHits() - HITS_1);
+        const uint32_t MISS_DELTA = (StringBuilder::poolMisses() - MISSES_1);
+        if ((FRAG_COUNT == (int) (HIT_DELTA + MISS_DELTA)) && (8 <= MISS_DELTA) && (FRAG_COUNT == sb_many.count())) {
+          printf("Pass.\n\tFreed fragments go back to the pool for re-use... ");
+          sb_many.clear();
+          const uint32_t HITS_2 = StringBuilder::poolHits();
+          for (int i = 0; i < FRAG_COUNT; i++) {
+            sb_many.concat("y");
+          }
+          if (HIT_DELTA == (StringBuilder::poolHits() - HITS_2)) {
+            printf("Pass.\n\tContent survives in pooled fragments... ");
+            sb_small.concatHandoff(&sb_many);
+            if ((4 + sizeof(big_buf) + FRAG_COUNT) == (uint32_t) sb_small.length()) {
+              if ((0 == memcmp(sb_small.string(), "tiny", 4)) && (0 == memcmp((sb_small.string() + 4), big_buf, sizeof(big_buf)))) {
+                printf("Pass.\n\tprintMemoryStats() reports on the pools... ");
+                StringBuilder output;
+                StringBuilder::printMemoryStats(&output);
+                if (output.contains("256-byte ElementPool")) {
+                  printf("Pass.\n");
+                  printf("%s\n", (const char*) output.string());
+                  ret = 0;
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  #else
+    printf("\tThe pool counters don't move when the pool is disabled... ");
+    StringBuilder sb_small("tiny");
+    sb_small.concat(big_buf, sizeof(big_buf));
+    sb_small.string();
+    if ((HITS_0 == StringBuilder::poolHits()) && (MISSES_0 == StringBuilder::poolMisses())) {
+      printf("Pass.\n");
+      ret = 0;
+    }
+  #endif
+
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
+  return ret;
+}
+
+
+/*
+* Fragments that the pool can't serve (if it is enabled at all) should come
+*   from a SlabAllocator, once one is given.
+*/
+int test_stringbuilder_slab() {
+  int ret = -1;
+  const uint16_t COUNTS[] = { 8, 8, 8, 8, 8, 8, 8, 4 };   // 16 to 2048 bytes.
+  SlabAllocator slab(COUNTS, (sizeof(COUNTS) / sizeof(COUNTS[0])));
+  slab.heapFallback(false);
+  uint8_t big_buf[300];
+  random_fill(big_buf, sizeof(big_buf));
+  printf("Testing SlabAllocator as a fragment source...\n");
+  StringBuilder::allocator(&slab);
+  printf("\tLarge fragments are drawn from the slab... ");
+  {
+    StringBuilder sb_big;
+    for (uint32_t i = 0; i < 4; i++) {
+      sb_big.concat(big_buf, sizeof(big_buf));
+    }
+    const uint32_t IN_USE = (slab.inUse(5) + slab.inUse(6));
+    if ((4 <= IN_USE) && (0 == slab.overdraws())) {
+      printf("Pass.\n\tContent survives in slab fragments... ");
+      bool content_matches = (sb_big.length() == (int) (4 * sizeof(big_buf)));
+      for (uint32_t i = 0; i < 4; i++) {
+        content_matches &= (0 == memcmp((sb_big.string() + (i * sizeof(big_buf))), big_buf, sizeof(big_buf)));
+      }
+      if (content_matches) {
+        printf("Pass.\n\tprintMemoryStats() reports on the slab... ");
+        StringBuilder output;
+        StringBuilder::printMemoryStats(&output);
+        if (output.contains("SlabAllocator")) {
+          printf("Pass.\n\tShared bytes are drawn from the slab... ");
+          StringBuilder sb_shared;
+          sb_shared.concatShared(&sb_big, 0, sizeof(big_buf));
+          if (slab.inPool((void*) sb_frag_ptr(&sb_shared, 0))) {
+            printf("Pass.\n\tUnshared bytes are drawn from the slab... ");
+            if (slab.inPool((void*) sb_shared.position(0))) {
+              printf("Pass.\n\tThe allocator can't be changed while it has blocks out... ");
+              if ((-1 == StringBuilder::allocator(nullptr)) && (&slab == StringBuilder::allocator())) {
+                printf("Pass.\n");
+                ret = 0;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  if (0 == ret) {
+    ret = -1;
+    printf("\tEvery block is returned when the strings are gone... ");
+    bool all_free = (0 == slab.blocksInUse());
+    if (all_free && (0 == slab.failures())) {
+      printf("Pass.\n\tThe allocator can be changed once they are... ");
+      if ((0 == StringBuilder::allocator(nullptr)) && (nullptr == StringBuilder::allocator())) {
+        printf("Pass.\n");
+        ret = 0;
+      }
+    }
+  }
+  StringBuilder::allocator(nullptr);
+
+  if (0 != ret) {
+    printf("Fail.\n");
+  }
+  return ret;
+}
+
+
 /*
 * StringBuilder is a big API. It's easy to make mistakes or under-estimate
 *   memory impact.
@@ -1533,7 +2663,7 @@ int test_StringBuilder_trim() {
 #define CHKLST_SB_TEST_HANDOFFS_1     0x00010000  // concatHandoff(StringBuilder*), prependHandoff(StringBuilder*)
 #define CHKLST_SB_TEST_HANDOFFS_2     0x00020000  // concatHandoff(uint8_t*, int)
 #define CHKLST_SB_TEST_HANDOFFS_3     0x00040000  // concatHandoffLimit(uint8_t*, int)
-#define CHKLST_SB_TEST_HANDOFFS_4     0x00080000  // concatHandoffPositions(StringBuilder*, unsigned int, unsigned int)
+#define CHKLST_SB_TEST_HANDOFFS_4     0x00080000  // concatHandoffPositions(StringBuilder*, unsigned int, unsigned int), concatShared()
 #define CHKLST_SB_TEST_POSITION       0x00100000  // position(int) functions, and drop_position(unsigned int)
 #define CHKLST_SB_TEST_CONCATF        0x00200000  // concatf(const char* format, va_list)
 #define CHKLST_SB_TEST_PRINTDEBUG     0x00400000  // printDebug(StringBuilder*)
@@ -1545,6 +2675,7 @@ int test_StringBuilder_trim() {
 #define CHKLST_SB_TEST_TRIM           0x10000000  // Whitespace trim fxns.
 #define CHKLST_SB_TEST_COUNT          0x20000000  // count()
 #define CHKLST_SB_TEST_HEX_TO_BIN     0x40000000  // hex_to_bin(int pos)
+#define CHKLST_SB_TEST_ARENA          0x80000000  // bindArena(), and operation within an arena.
 //#define CHKLST_SB_TEST_NUMERIC_PARSE  0x40000000  //
 //#define CHKLST_SB_TEST_MEM_SEMANTICS  0x80000000  // Deep-copy versus transfer.
 
@@ -1560,7 +2691,7 @@ int test_StringBuilder_trim() {
   CHKLST_SB_TEST_PRINTDEBUG | CHKLST_SB_TEST_PRINTBUFFER | \
   CHKLST_SB_TEST_MEM_MUTATION | CHKLST_SB_TEST_VIVISECTION | \
   CHKLST_SB_TEST_MISUSE | CHKLST_SB_TEST_MISCELLANEOUS | CHKLST_SB_TEST_TRIM | \
-  CHKLST_SB_TEST_HEX_TO_BIN)
+  CHKLST_SB_TEST_HEX_TO_BIN | CHKLST_SB_TEST_ARENA)
 
 
 
@@ -1593,7 +2724,7 @@ const StepSequenceList TOP_LEVEL_SB_TEST_LIST[] = {
     .LABEL        = "toUpper() and toLower()",
     .DEP_MASK     = (CHKLST_SB_TEST_CMPBINSTRING),
     .DISPATCH_FXN = []() { return 1;  },
-    .POLL_FXN     = []() { return ((0 == test_stringbuilder_case_shifter()) ? 1:-1);  }
+    .POLL_FXN     = []() { return (((0 == test_stringbuilder_case_shifter()) && (0 == test_stringbuilder_byte_kernels())) ? 1:-1);  }
   },
   { .FLAG         = CHKLST_SB_TEST_BYTEAT,
     .LABEL        = "byteAt(const int)",
@@ -1611,7 +2742,7 @@ const StepSequenceList TOP_LEVEL_SB_TEST_LIST[] = {
     .LABEL        = "locate(const uint8_t*, int len, int)",
     .DEP_MASK     = (CHKLST_SB_TEST_ISEMPTY),
     .DISPATCH_FXN = []() { return 1;  },
-    .POLL_FXN     = []() { return ((0 == test_stringbuilder_locate()) ? 1:-1);  }
+    .POLL_FXN     = []() { return (((0 == test_stringbuilder_locate()) && (0 == test_stringbuilder_locate_fragmented())) ? 1:-1);  }
   },
   { .FLAG         = CHKLST_SB_TEST_CONTAINS_1,
     .LABEL        = "contains(const char*)",
@@ -1621,9 +2752,9 @@ const StepSequenceList TOP_LEVEL_SB_TEST_LIST[] = {
   },
   { .FLAG         = CHKLST_SB_TEST_CONTAINS_2,
     .LABEL        = "contains(char)",
-    .DEP_MASK     = (CHKLST_SB_TEST_LOCATE),
+    .DEP_MASK     = (CHKLST_SB_TEST_LOCATE | CHKLST_SB_TEST_CHUNK),
     .DISPATCH_FXN = []() { return 1;  },
-    .POLL_FXN     = []() { return 1;  }    // TODO: Separate
+    .POLL_FXN     = []() { return ((0 == test_stringbuilder_contains_2()) ? 1:-1);  }
   },
   { .FLAG         = CHKLST_SB_TEST_CULL_1,
     .LABEL        = "cull(int)",
@@ -1641,7 +2772,7 @@ const StepSequenceList TOP_LEVEL_SB_TEST_LIST[] = {
     .LABEL        = "split(const char*)",
     .DEP_MASK     = (CHKLST_SB_TEST_COUNT),
     .DISPATCH_FXN = []() { return 1;  },
-    .POLL_FXN     = []() { return 1;  }    // TODO: Separate
+    .POLL_FXN     = []() { return (((0 == test_stringbuilder_split()) && (0 == test_stringbuilder_split_views())) ? 1:-1);  }
   },
   { .FLAG         = CHKLST_SB_TEST_IMPLODE,
     .LABEL        = "implode(const char*)",
@@ -1680,17 +2811,17 @@ const StepSequenceList TOP_LEVEL_SB_TEST_LIST[] = {
     .POLL_FXN     = []() { return ((0 == test_stringbuilder_concat_handoff_limit()) ? 1:-1);  }
   },
   { .FLAG         = CHKLST_SB_TEST_HANDOFFS_4,
-    .LABEL        = "concatHandoffPositions(StringBuilder*, unsigned int, unsigned int)",
+    .LABEL        = "concatHandoffPositions(StringBuilder*, unsigned int, unsigned int), concatShared()",
     .DEP_MASK     = (CHKLST_SB_TEST_HANDOFFS_3 | CHKLST_SB_TEST_CHUNK | CHKLST_SB_TEST_COUNT),
     .DISPATCH_FXN = []() { return 1;  },
-    .POLL_FXN     = []() { return ((0 == test_stringbuilder_concat_handoff_range()) ? 1:-1);  }
+    .POLL_FXN     = []() { return (((0 == test_stringbuilder_concat_handoff_range()) && (0 == test_stringbuilder_concat_shared())) ? 1:-1);  }
   },
 
   { .FLAG         = CHKLST_SB_TEST_COUNT,
     .LABEL        = "count()",
     .DEP_MASK     = (CHKLST_SB_TEST_BASICS),
     .DISPATCH_FXN = []() { return 1;  },
-    .POLL_FXN     = []() { return 1;  }    // TODO: Separate
+    .POLL_FXN     = []() { return ((0 == test_stringbuilder_count()) ? 1:-1);  }
   },
   { .FLAG         = CHKLST_SB_TEST_POSITION,
     .LABEL        = "position(int) / drop_position(unsigned int)",
@@ -1701,15 +2832,15 @@ const StepSequenceList TOP_LEVEL_SB_TEST_LIST[] = {
 
   { .FLAG         = CHKLST_SB_TEST_CONCATF,
     .LABEL        = "concatf(const char*, va_list)",
-    .DEP_MASK     = (CHKLST_SB_TEST_BASICS),
+    .DEP_MASK     = (CHKLST_SB_TEST_BASICS | CHKLST_SB_TEST_POSITION),
     .DISPATCH_FXN = []() { return 1;  },
-    .POLL_FXN     = []() { return 1;  }    // TODO: Separate
+    .POLL_FXN     = []() { return ((0 == test_stringbuilder_concatf()) ? 1:-1);  }
   },
   { .FLAG         = CHKLST_SB_TEST_PRINTDEBUG,
     .LABEL        = "printDebug(StringBuilder*)",
     .DEP_MASK     = (CHKLST_SB_TEST_BASICS),
     .DISPATCH_FXN = []() { return 1;  },
-    .POLL_FXN     = []() { return 1;  }    // TODO: Separate
+    .POLL_FXN     = []() { return ((0 == test_stringbuilder_print_debug()) ? 1:-1);  }
   },
   { .FLAG         = CHKLST_SB_TEST_PRINTBUFFER,
     .LABEL        = "printBuffer(StringBuilder*, uint8*, uint32, const char*)",
@@ -1719,9 +2850,9 @@ const StepSequenceList TOP_LEVEL_SB_TEST_LIST[] = {
   },
   { .FLAG         = CHKLST_SB_TEST_MEM_MUTATION,
     .LABEL        = "Memory layout non-mutation assurances",
-    .DEP_MASK     = (CHKLST_SB_TEST_COUNT),
+    .DEP_MASK     = (CHKLST_SB_TEST_COUNT | CHKLST_SB_TEST_CHUNK | CHKLST_SB_TEST_HANDOFFS_2),
     .DISPATCH_FXN = []() { return 1;  },
-    .POLL_FXN     = []() { return 1;  }    // TODO: Separate
+    .POLL_FXN     = []() { return ((0 == test_stringbuilder_fragment_export()) ? 1:-1);  }
   },
   { .FLAG         = CHKLST_SB_TEST_VIVISECTION,
     .LABEL        = "Section copy with non-mutation assurances",
@@ -1753,6 +2884,12 @@ const StepSequenceList TOP_LEVEL_SB_TEST_LIST[] = {
     .DISPATCH_FXN = []() { return 1;  },
     .POLL_FXN     = []() { return ((0 == test_StringBuilder_hex_to_bin()) ? 1:-1);  }
   },
+  { .FLAG         = CHKLST_SB_TEST_ARENA,
+    .LABEL        = "Arena memory model",
+    .DEP_MASK     = (CHKLST_SB_TEST_SPLIT | CHKLST_SB_TEST_POSITION | CHKLST_SB_TEST_CULL_2 | CHKLST_SB_TEST_HANDOFFS_1),
+    .DISPATCH_FXN = []() { return 1;  },
+    .POLL_FXN     = []() { return (((0 == test_stringbuilder_arena()) && (0 == test_stringbuilder_pool()) && (0 == test_stringbuilder_slab())) ? 1:-1);  }
+  },
 
 };
 
@@ -268,6 +268,528 @@ int timeseries_stats_tests() {
 
 
 
+/*
+* Naive two-pass reference for the running statistics. The window is always
+*   full when this is called, so the order of samples doesn't matter.
+*/
+template <class T> void timeseries_helper_naive_stats(T* buf, const uint32_t N, double* mean, double* rms, double* stdev) {
+  double sum = 0.0;
+  double sqr = 0.0;
+  for (uint32_t i = 0; i < N; i++) {
+    sum += (double) buf[i];
+    sqr += ((double) buf[i] * (double) buf[i]);
+  }
+  *mean = (sum / N);
+  double dev = 0.0;
+  for (uint32_t i = 0; i < N; i++) {
+    dev += (((double) buf[i] - *mean) * ((double) buf[i] - *mean));
+  }
+  *rms   = sqrt(sqr / N);
+  *stdev = sqrt(dev / N);
+}
+
+
+template <class T> bool timeseries_helper_stats_match(TimeSeries<T>* series, const double PRECISION) {
+  double ref_mean, ref_rms, ref_stdev;
+  timeseries_helper_naive_stats(series->memPtr(), series->windowSize(), &ref_mean, &ref_rms, &ref_stdev);
+  const double MEAN  = series->mean();
+  const double RMS   = series->rms();
+  const double STDEV = series->stdev();
+  const bool RET = (nearly_equal(ref_mean, MEAN, PRECISION) && nearly_equal(ref_rms, RMS, PRECISION) && nearly_equal(ref_stdev, STDEV, PRECISION));
+  if (!RET) {
+    printf("\n\t\tmean  %.12f vs %.12f\n\t\trms   %.12f vs %.12f\n\t\tstdev %.12f vs %.12f\n\t\t", ref_mean, MEAN, ref_rms, RMS, ref_stdev, STDEV);
+  }
+  return RET;
+}
+
+
+/*
+* Mean, RMS, and stdev are kept by running accumulators as samples arrive. The
+*   test values sit on a large offset, with the window sliding many times over,
+*   to show that rounding error doesn't build up. Every result is checked
+*   against a naive two-pass calculation over the same window.
+*/
+int timeseries_running_stats() {
+  const uint32_t TEST_SAMPLE_COUNT = 1000;
+  const uint32_t TEST_FEED_COUNT   = 250000;
+  const uint32_t TEST_CHECK_EVERY  = 4999;
+  const double   TEST_PRECISION    = 0.000000001D;
+  printf("Running statistics over %u samples, with a window of %u...\n", TEST_FEED_COUNT, TEST_SAMPLE_COUNT);
+  int ret = -1;
+  TimeSeries<double>  series_dbl(TEST_SAMPLE_COUNT);
+  TimeSeries<int32_t> series_int(TEST_SAMPLE_COUNT);
+  TimeSeries3<float>  series_v3(TEST_SAMPLE_COUNT);
+  series_dbl.init();
+  series_int.init();
+  series_v3.init();
+
+  printf("\tThe running results match a two-pass calculation as the window slides... ");
+  bool all_matched = true;
+  for (uint32_t i = 0; all_matched & (i < TEST_FEED_COUNT); i++) {
+    const double TEST_VAL = ((double) 1000000 + (randomUInt32() % 20000) - 10000 + ((randomUInt32() % 1000) / (double) 1000));
+    series_dbl.feedSeries(TEST_VAL);
+    series_int.feedSeries((int32_t) (TEST_VAL * 100));
+    if ((i >= TEST_SAMPLE_COUNT) & (0 == (i % TEST_CHECK_EVERY))) {
+      all_matched = (timeseries_helper_stats_match(&series_dbl, TEST_PRECISION) && timeseries_helper_stats_match(&series_int, TEST_PRECISION));
+    }
+  }
+  if (all_matched) {
+    printf("Pass.\n\tThe results are still correct after bulk changes with feedSeries()... ");
+    double* buf = series_dbl.memPtr();
+    for (uint32_t i = 0; i < TEST_SAMPLE_COUNT; i++) {
+      buf[i] = (double) (randomUInt32() % 5000);
+    }
+    series_dbl.feedSeries();
+    if (timeseries_helper_stats_match(&series_dbl, TEST_PRECISION)) {
+      printf("Pass.\n\texactInterval() defaults to zero... ");
+      if (0 == series_dbl.exactInterval()) {
+        printf("Pass.\n\tThe results are correct with a periodic exact recalculation... ");
+        series_dbl.exactInterval(TEST_SAMPLE_COUNT);
+        all_matched = (TEST_SAMPLE_COUNT == series_dbl.exactInterval());
+        for (uint32_t i = 0; all_matched & (i < (TEST_SAMPLE_COUNT * 10)); i++) {
+          series_dbl.feedSeries((double) (randomUInt32() % 5000) - 2500);
+          if (0 == (i % 331)) {
+            all_matched = timeseries_helper_stats_match(&series_dbl, TEST_PRECISION);
+          }
+        }
+        if (all_matched) {
+          printf("Pass.\n\tTimeSeries3 running results match a two-pass calculation on each axis... ");
+          float ax[3][TEST_SAMPLE_COUNT];
+          for (uint32_t i = 0; i < (TEST_SAMPLE_COUNT * 3); i++) {
+            series_v3.feedSeries((float) (randomUInt32() % 1000), (float) (randomUInt32() % 1000) - 500.0f, 7.5f);
+          }
+          Vector3<float>* v3_buf = series_v3.memPtr();
+          for (uint32_t i = 0; i < TEST_SAMPLE_COUNT; i++) {
+            ax[0][i] = v3_buf[i].x;
+            ax[1][i] = v3_buf[i].y;
+            ax[2][i] = v3_buf[i].z;
+          }
+          const Vector3f64 V3_MEAN  = series_v3.mean();
+          const Vector3f64 V3_RMS   = series_v3.rms();
+          const Vector3f64 V3_STDEV = series_v3.stdev();
+          const double RESULTS[3][3] = {
+            { V3_MEAN.x, V3_RMS.x, V3_STDEV.x },
+            { V3_MEAN.y, V3_RMS.y, V3_STDEV.y },
+            { V3_MEAN.z, V3_RMS.z, V3_STDEV.z }
+          };
+          for (uint8_t a = 0; all_matched & (a < 3); a++) {
+            double ref_mean, ref_rms, ref_stdev;
+            timeseries_helper_naive_stats(ax[a], TEST_SAMPLE_COUNT, &ref_mean, &ref_rms, &ref_stdev);
+            all_matched = (nearly_equal(ref_mean, RESULTS[a][0], TEST_PRECISION) && nearly_equal(ref_rms, RESULTS[a][1], TEST_PRECISION) && nearly_equal(ref_stdev, RESULTS[a][2], TEST_PRECISION));
+          }
+          if (all_matched) {
+            printf("Pass.\n\tA constant axis has zero stdev... ");
+            if (0 == V3_STDEV.z) {
+              printf("Pass.\n");
+              ret = 0;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  if (0 == ret) {
+    // Report the cost of keeping the stats current with every sample.
+    const uint32_t TIMING_FEEDS = 100000;
+    series_dbl.exactInterval(0);
+    double dummy = 0.0;
+    const uint32_t T0 = micros();
+    for (uint32_t i = 0; i < TIMING_FEEDS; i++) {
+      series_dbl.feedSeries((double) i);
+      dummy += series_dbl.stdev();
+    }
+    const uint32_t T1 = micros();
+    printf("\t%u feeds with a stdev() query after each took %uus (%.3fus each). Checksum %.1f\n", TIMING_FEEDS, (T1 - T0), ((double) (T1 - T0) / TIMING_FEEDS), dummy);
+  }
+
+  printf("%s.\n", ((0 != ret) ? "Fail" : "PASS"));
+  return ret;
+}
+
+
+
+/*
+* The median is kept by a running median once it has been asked for. It must
+*   agree with a median selected from a copy of the window as the window slides,
+*   and after the sorts of changes that force it to be rebuilt.
+*/
+int timeseries_running_median() {
+  const uint32_t TEST_SAMPLE_COUNT = 999;
+  const uint32_t TEST_FEED_COUNT   = 20000;
+  printf("Running median over %u samples, with a window of %u...\n", TEST_FEED_COUNT, TEST_SAMPLE_COUNT);
+  int ret = -1;
+  TimeSeries<int32_t> series_odd(TEST_SAMPLE_COUNT);
+  TimeSeries<float>   series_even(TEST_SAMPLE_COUNT + 1);
+  TimeSeries3<uint8_t> series_v3(TEST_SAMPLE_COUNT);
+  series_odd.init();
+  series_even.init();
+  series_v3.init();
+  int32_t copy_int[TEST_SAMPLE_COUNT + 1];
+  float   copy_flt[TEST_SAMPLE_COUNT + 1];
+  uint8_t copy_u8[TEST_SAMPLE_COUNT];
+
+  printf("\tmedian() agrees with selection from a copy as the window slides... ");
+  bool all_ok = true;
+  for (uint32_t i = 0; all_ok & (i < TEST_FEED_COUNT); i++) {
+    const int32_t TEST_VAL = (int32_t) (randomUInt32() % 3000) - 1500;
+    series_odd.feedSeries(TEST_VAL);
+    series_even.feedSeries((float) TEST_VAL / 3.0f);
+    if (series_odd.windowFull() & (0 == (i % 7))) {
+      memcpy(copy_int, series_odd.memPtr(), (TEST_SAMPLE_COUNT * sizeof(int32_t)));
+      memcpy(copy_flt, series_even.memPtr(), ((TEST_SAMPLE_COUNT + 1) * sizeof(float)));
+      const int32_t EXPECTED_INT = c3p_median(copy_int, TEST_SAMPLE_COUNT);
+      const float   EXPECTED_FLT = c3p_median(copy_flt, (TEST_SAMPLE_COUNT + 1));
+      all_ok = ((EXPECTED_INT == series_odd.median()) && (EXPECTED_FLT == series_even.median()));
+      if (!all_ok) {
+        printf("Fail on sample %u (%d vs %d, %f vs %f).\n", i, series_odd.median(), EXPECTED_INT, (double) series_even.median(), (double) EXPECTED_FLT);
+      }
+    }
+  }
+  if (all_ok) {
+    printf("Pass.\n\tmedian() is correct after bulk changes with feedSeries()... ");
+    int32_t* buf = series_odd.memPtr();
+    for (uint32_t i = 0; i < TEST_SAMPLE_COUNT; i++) {
+      buf[i] = (int32_t) (TEST_SAMPLE_COUNT - i);
+    }
+    series_odd.feedSeries();
+    if ((int32_t) ((TEST_SAMPLE_COUNT >> 1) + 1) == series_odd.median()) {
+      printf("Pass.\n\tmedian() is correct after purge() and refill... ");
+      series_odd.purge();
+      for (uint32_t i = 0; i < TEST_SAMPLE_COUNT; i++) {
+        series_odd.feedSeries((int32_t) i * 2);
+      }
+      if ((int32_t) (TEST_SAMPLE_COUNT - 1) == series_odd.median()) {
+        printf("Pass.\n\tTimeSeries3 median() agrees with selection on each axis... ");
+        for (uint32_t i = 0; i < (TEST_SAMPLE_COUNT * 3); i++) {
+          series_v3.feedSeries((uint8_t) (randomUInt32() % 100), (uint8_t) randomUInt32(), (uint8_t) i);
+          if (0 == (i % 97)) {
+            series_v3.median();   // Keep the running median built as we go.
+          }
+        }
+        const Vector3<uint8_t> RESULT = series_v3.median();
+        const uint8_t RESULTS[3] = { RESULT.x, RESULT.y, RESULT.z };
+        Vector3<uint8_t>* v3_buf = series_v3.memPtr();
+        for (uint8_t a = 0; all_ok & (a < 3); a++) {
+          for (uint32_t i = 0; i < TEST_SAMPLE_COUNT; i++) {
+            copy_u8[i] = ((0 == a) ? v3_buf[i].x : ((1 == a) ? v3_buf[i].y : v3_buf[i].z));
+          }
+          all_ok = (c3p_median(copy_u8, TEST_SAMPLE_COUNT) == RESULTS[a]);
+        }
+        if (all_ok) {
+          printf("Pass.\n");
+          ret = 0;
+        }
+      }
+    }
+  }
+
+  if (0 == ret) {
+    const uint32_t TIMING_FEEDS = 100000;
+    int64_t checksum = 0;
+    const uint32_t T0 = micros();
+    for (uint32_t i = 0; i < TIMING_FEEDS; i++) {
+      series_odd.feedSeries((int32_t) randomUInt32());
+      checksum += series_odd.median();
+    }
+    const uint32_t T1 = micros();
+    printf("\t%u feeds with a median() query after each took %uus (%.3fus each). Checksum %lld\n", TIMING_FEEDS, (T1 - T0), ((double) (T1 - T0) / TIMING_FEEDS), (long long) checksum);
+  }
+
+  printf("%s.\n", ((0 != ret) ? "Fail" : "PASS"));
+  return ret;
+}
+
+
+
+/*
+* Once the extremes have been asked for, they are kept by a pair of monotonic
+*   deques. They must agree with a scan of the window as it slides, and after the
+*   sorts of changes that force the deques to be rebuilt.
+*/
+int timeseries_sliding_minmax() {
+  const uint32_t TEST_SAMPLE_COUNT = 500;
+  const uint32_t TEST_FEED_COUNT   = 20000;
+  printf("Sliding min/max over %u samples, with a window of %u...\n", TEST_FEED_COUNT, TEST_SAMPLE_COUNT);
+  int ret = -1;
+  TimeSeries<int32_t> series(TEST_SAMPLE_COUNT);
+  series.init();
+
+  printf("\tminValue() and maxValue() agree with a scan as the window slides... ");
+  bool all_ok = true;
+  for (uint32_t i = 0; all_ok & (i < TEST_FEED_COUNT); i++) {
+    // Slow drift with noise gives both long runs and frequent turnover.
+    const int32_t TEST_VAL = (int32_t) ((i / 50) % 200) + (int32_t) (randomUInt32() % 64);
+    series.feedSeries(TEST_VAL);
+    if (series.windowFull()) {
+      const int32_t* WINDOW = series.memPtr();
+      int32_t expected_min = WINDOW[0];
+      int32_t expected_max = WINDOW[0];
+      for (uint32_t j = 1; j < TEST_SAMPLE_COUNT; j++) {
+        if (WINDOW[j] < expected_min) expected_min = WINDOW[j];
+        if (WINDOW[j] > expected_max) expected_max = WINDOW[j];
+      }
+      all_ok = ((expected_min == series.minValue()) && (expected_max == series.maxValue()));
+      if (!all_ok) {
+        printf("Fail on sample %u (min %d vs %d, max %d vs %d).\n", i, series.minValue(), expected_min, series.maxValue(), expected_max);
+      }
+    }
+  }
+  if (all_ok) {
+    printf("Pass.\n\tThe extremes are correct after bulk changes with feedSeries()... ");
+    int32_t* buf = series.memPtr();
+    for (uint32_t i = 0; i < TEST_SAMPLE_COUNT; i++) {
+      buf[i] = (int32_t) i - 1000;
+    }
+    series.feedSeries();
+    if ((-1000 == series.minValue()) && ((int32_t) (TEST_SAMPLE_COUNT - 1001) == series.maxValue())) {
+      printf("Pass.\n\tThe extremes are correct after purge() and refill... ");
+      series.purge();
+      for (uint32_t i = 0; i < TEST_SAMPLE_COUNT; i++) {
+        series.feedSeries((int32_t) (i * 3) + 7);
+      }
+      if ((7 == series.minValue()) && ((int32_t) ((TEST_SAMPLE_COUNT - 1) * 3) + 7 == series.maxValue())) {
+        printf("Pass.\n");
+        ret = 0;
+      }
+    }
+  }
+
+  if (0 == ret) {
+    const uint32_t TIMING_FEEDS = 100000;
+    int64_t checksum = 0;
+    const uint32_t T0 = micros();
+    for (uint32_t i = 0; i < TIMING_FEEDS; i++) {
+      series.feedSeries((int32_t) (randomUInt32() >> 8));
+      checksum += series.maxValue() - series.minValue();
+    }
+    const uint32_t T1 = micros();
+    printf("\t%u feeds with min/max queries after each took %uus (%.3fus each). Checksum %lld\n", TIMING_FEEDS, (T1 - T0), ((double) (T1 - T0) / TIMING_FEEDS), (long long) checksum);
+  }
+
+  printf("%s.\n", ((0 != ret) ? "Fail" : "PASS"));
+  return ret;
+}
+
+
+
+/*
+* Brute-force summary of positions [FIRST, END) of a full window, where 0 is the
+*   oldest sample.
+*/
+template <class T> void timeseries_downsample_reference(TimeSeries<T>* series, const uint32_t FIRST, const uint32_t END, C3PBucketSummary<T>* out) {
+  const uint32_t N      = series->windowSize();
+  const uint32_t OLDEST = series->lastIndex();
+  c3p_bucket_clear(out);
+  for (uint32_t i = FIRST; i < END; i++) {
+    c3p_bucket_add(out, series->memPtr()[(OLDEST + i) % N], i);
+  }
+}
+
+
+/*
+* Checks every summary from downsample() against a brute-force summary of the
+*   same span.
+*/
+template <class T> bool timeseries_downsample_check(TimeSeries<T>* series, const uint32_t COUNT) {
+  const uint32_t N = series->windowSize();
+  C3PBucketSummary<T> result[COUNT];
+  bool all_ok = (0 == series->downsample(result, COUNT));
+  for (uint32_t i = 0; all_ok & (i < COUNT); i++) {
+    C3PBucketSummary<T> expected;
+    timeseries_downsample_reference(series, (uint32_t) (((uint64_t) i * N) / COUNT), (uint32_t) (((uint64_t) (i + 1) * N) / COUNT), &expected);
+    all_ok = ((expected.count == result[i].count) && (expected.min_value == result[i].min_value) && (expected.max_value == result[i].max_value));
+    all_ok &= ((expected.min_idx == result[i].min_idx) && (expected.max_idx == result[i].max_idx));
+    all_ok &= nearly_equal(expected.mean(), result[i].mean(), (double) 0.000001);
+    if (!all_ok) {
+      printf("Fail on span %u of %u (window %u, oldest at %u). ", i, COUNT, N, series->lastIndex());
+    }
+  }
+  return all_ok;
+}
+
+
+/*
+* Checks the invariants of LTTB output: the ends are kept, positions increase,
+*   and each value is the sample at its position.
+*/
+template <class T> bool timeseries_lttb_check(TimeSeries<T>* series, const T* VALUES, const uint32_t* POSITIONS, const uint32_t COUNT) {
+  const uint32_t N      = series->windowSize();
+  const uint32_t OLDEST = series->lastIndex();
+  bool all_ok = ((0 == POSITIONS[0]) && ((N - 1) == POSITIONS[COUNT - 1]));
+  for (uint32_t i = 0; all_ok & (i < COUNT); i++) {
+    all_ok = (VALUES[i] == series->memPtr()[(OLDEST + POSITIONS[i]) % N]);
+    if (all_ok & (0 < i)) {
+      all_ok = (POSITIONS[i - 1] < POSITIONS[i]);
+    }
+  }
+  return all_ok;
+}
+
+
+/*
+* Once asked for, downsampled summaries of the window are kept by a decimation
+*   pyramid. They must agree with brute-force summaries of the same spans as the
+*   window slides, and after the sorts of changes that force a rebuild. LTTB
+*   must keep exactly the number of points asked for, and the features that
+*   matter.
+*/
+int timeseries_downsampling() {
+  const uint32_t TEST_SAMPLE_COUNT = 4099;   // Not a multiple of the fanout.
+  const uint32_t TEST_FEED_COUNT   = 10000;
+  const uint32_t TEST_BUCKETS[]    = { 1, 7, 300, 4099 };
+  printf("Downsampling with a window of %u...\n", TEST_SAMPLE_COUNT);
+  int ret = -1;
+  TimeSeries<int32_t> series(TEST_SAMPLE_COUNT);
+  series.init();
+  C3PBucketSummary<int32_t> dummy;
+
+  printf("\tdownsample() and downsampleLTTB() fail before the window is full... ");
+  int32_t  lttb_vals[300];
+  uint32_t lttb_pos[300];
+  series.feedSeries(1);
+  if ((-1 == series.downsample(&dummy, 1)) && (-1 == series.downsampleLTTB(lttb_vals, lttb_pos, 10))) {
+    printf("Pass.\n\tThey reject bad arguments... ");
+    for (uint32_t i = 0; i < TEST_SAMPLE_COUNT; i++) {
+      series.feedSeries((int32_t) (randomUInt32() % 1000));
+    }
+    bool bad_args_ok = ((-1 == series.downsample(nullptr, 1)) && (-1 == series.downsample(&dummy, 0)));
+    bad_args_ok &= (-1 == series.downsample(&dummy, (TEST_SAMPLE_COUNT + 1)));
+    bad_args_ok &= ((-1 == series.downsampleLTTB(nullptr, lttb_pos, 10)) && (-1 == series.downsampleLTTB(lttb_vals, lttb_pos, 2)));
+    if (bad_args_ok) {
+      printf("Pass.\n\tdownsample() agrees with brute force as the window slides... ");
+      bool all_ok = true;
+      for (uint32_t i = 0; all_ok & (i < TEST_FEED_COUNT); i++) {
+        // Slow drift with noise, and plenty of ties.
+        series.feedSeries((int32_t) ((i / 64) % 50) + (int32_t) (randomUInt32() % 16));
+        if (0 == (i % 331)) {
+          for (uint32_t j = 0; all_ok & (j < (sizeof(TEST_BUCKETS) / sizeof(TEST_BUCKETS[0]))); j++) {
+            all_ok = timeseries_downsample_check(&series, TEST_BUCKETS[j]);
+          }
+        }
+      }
+      if (all_ok) {
+        printf("Pass.\n\tdownsample() is correct after bulk changes with feedSeries()... ");
+        int32_t* buf = series.memPtr();
+        for (uint32_t i = 0; i < TEST_SAMPLE_COUNT; i++) {
+          buf[i] = (int32_t) (randomUInt32() % 100000);
+        }
+        series.feedSeries();
+        if (timeseries_downsample_check(&series, 300)) {
+          printf("Pass.\n\tdownsample() is correct after purge() and refill... ");
+          series.purge();
+          for (uint32_t i = 0; i < (TEST_SAMPLE_COUNT + 77); i++) {
+            series.feedSeries((int32_t) i);
+          }
+          if (timeseries_downsample_check(&series, 300) && timeseries_downsample_check(&series, 1)) {
+            printf("Pass.\n\tdownsampleLTTB() keeps the ends, in order, for small and large windows... ");
+            TimeSeries<int32_t> series_small(600);
+            series_small.init();
+            for (uint32_t i = 0; i < 700; i++) {
+              series_small.feedSeries((int32_t) (randomUInt32() % 1000));
+            }
+            all_ok = (0 == series_small.downsampleLTTB(lttb_vals, lttb_pos, 300));
+            all_ok &= timeseries_lttb_check(&series_small, lttb_vals, lttb_pos, 300);
+            all_ok &= (0 == series.downsampleLTTB(lttb_vals, lttb_pos, 300));
+            all_ok &= timeseries_lttb_check(&series, lttb_vals, lttb_pos, 300);
+            if (all_ok) {
+              printf("Pass.\n\tdownsampleLTTB() keeps a lone spike in flat noise... ");
+              for (uint32_t i = 0; i < TEST_SAMPLE_COUNT; i++) {
+                series.feedSeries((int32_t) (randomUInt32() % 10) + ((1234 == i) ? 5000 : 0));
+              }
+              all_ok = (0 == series.downsampleLTTB(lttb_vals, lttb_pos, 50));
+              all_ok &= timeseries_lttb_check(&series, lttb_vals, lttb_pos, 50);
+              bool spike_kept = false;
+              for (uint32_t i = 0; i < 50; i++) {
+                spike_kept |= ((1234 == lttb_pos[i]) && (5000 <= lttb_vals[i]));
+              }
+              if (all_ok & spike_kept) {
+                printf("Pass.\n\tc3p_lttb() copies a series no longer than COUNT... ");
+                const float TINY[4] = { 1.0f, -2.0f, 3.0f, 0.5f };
+                float    tiny_out[4];
+                uint32_t tiny_pos[4];
+                all_ok = (0 == c3p_lttb((const uint32_t*) nullptr, TINY, 4, 10, tiny_pos, tiny_out));
+                for (uint32_t i = 0; all_ok & (i < 4); i++) {
+                  all_ok = ((i == tiny_pos[i]) && (TINY[i] == tiny_out[i]));
+                }
+                if (all_ok) {
+                  printf("Pass.\n\tc3p_lttb() keeps the corners of a triangle wave... ");
+                  // Peaks at 0, 100, 200, ..., 900 alternate with troughs. With one
+                  //   bucket per edge, each corner is the largest triangle.
+                  float wave[1001];
+                  for (uint32_t i = 0; i < 1001; i++) {
+                    const uint32_t PHASE = (i % 200);
+                    wave[i] = (float) ((PHASE <= 100) ? PHASE : (200 - PHASE));
+                  }
+                  float    wave_out[11];
+                  uint32_t wave_pos[11];
+                  all_ok = (0 == c3p_lttb((const uint32_t*) nullptr, wave, 1001, 11, wave_pos, wave_out));
+                  for (uint32_t i = 0; all_ok & (i < 11); i++) {
+                    all_ok = ((i * 100) == wave_pos[i]);
+                  }
+                  if (all_ok) {
+                    printf("Pass.\n");
+                    ret = 0;
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  if (0 == ret) {
+    const uint32_t BENCH_WINDOW = (1 << 20);
+    const uint32_t BENCH_COUNT  = 300;
+    const uint32_t BENCH_ROUNDS = 20;
+    TimeSeries<float> bench(BENCH_WINDOW);
+    bench.init();
+    for (uint32_t i = 0; i < BENCH_WINDOW; i++) {
+      bench.feedSeries((float) (randomUInt32() % 10000) / 7.0f);
+    }
+    C3PBucketSummary<float> buckets[BENCH_COUNT];
+    float    bench_vals[BENCH_COUNT];
+    uint32_t bench_pos[BENCH_COUNT];
+    bench.downsample(buckets, BENCH_COUNT);   // Builds the pyramid.
+    double checksum = 0.0;
+    const uint32_t T0 = micros();
+    for (uint32_t r = 0; r < BENCH_ROUNDS; r++) {
+      bench.feedSeries((float) r);
+      bench.downsample(buckets, BENCH_COUNT);
+      checksum += buckets[r % BENCH_COUNT].mean();
+    }
+    const uint32_t T1 = micros();
+    for (uint32_t r = 0; r < BENCH_ROUNDS; r++) {
+      bench.feedSeries((float) r);
+      bench.downsampleLTTB(bench_vals, bench_pos, BENCH_COUNT);
+      checksum += (double) bench_vals[r % BENCH_COUNT];
+    }
+    const uint32_t T2 = micros();
+    for (uint32_t r = 0; r < BENCH_ROUNDS; r++) {
+      const float* MEM = bench.memPtr();
+      float lo = MEM[0];
+      float hi = MEM[0];
+      for (uint32_t i = 1; i < BENCH_WINDOW; i++) {
+        if (MEM[i] < lo) lo = MEM[i];
+        if (MEM[i] > hi) hi = MEM[i];
+      }
+      checksum += (double) (hi - lo);
+    }
+    const uint32_t T3 = micros();
+    printf("\tWindow of %u to %u points: downsample() took %.1fus, downsampleLTTB() took %.1fus, and a scan of the window took %.1fus. (checksum %.3f)\n",
+      BENCH_WINDOW, BENCH_COUNT,
+      ((double) (T1 - T0) / BENCH_ROUNDS), ((double) (T2 - T1) / BENCH_ROUNDS), ((double) (T3 - T2) / BENCH_ROUNDS), checksum
+    );
+  }
+
+  printf("%s.\n", ((0 != ret) ? "Fail" : "PASS"));
+  return ret;
+}
+
+
+
 /*
 * Re-windowing is the act of changing the sample capacity of the TimeSeries.
 * Doing this will cause all existing class state as it pertains to samples being
@@ -697,6 +1219,10 @@ void print_types_timeseries() {
 #define CHKLST_TIMESERIES_TEST_ABUSE          0x00000040  //
 #define CHKLST_TIMESERIES_TEST_PARSE_PACK     0x00000080  //
 #define CHKLST_TIMESERIES_TEST_SHARING        0x00000100  //
+#define CHKLST_TIMESERIES_TEST_RUNNING_STATS  0x00000200  //
+#define CHKLST_TIMESERIES_TEST_RUNNING_MEDIAN 0x00000400  //
+#define CHKLST_TIMESERIES_TEST_SLIDING_MINMAX 0x00000800  //
+#define CHKLST_TIMESERIES_TEST_DOWNSAMPLING   0x00200000  //
 
 #define CHKLST_TIMESERIES3_TEST_CONSTRUCTION  0x00001000  //
 #define CHKLST_TIMESERIES3_TEST_INITIAL_COND  0x00002000  //
@@ -713,7 +1239,9 @@ void print_types_timeseries() {
   CHKLST_TIMESERIES_TEST_STATS | CHKLST_TIMESERIES_TEST_REWINDOWING | \
   CHKLST_TIMESERIES_TEST_NORMAL_OP_0 | CHKLST_TIMESERIES_TEST_NORMAL_OP_1 | \
   CHKLST_TIMESERIES_TEST_ABUSE | CHKLST_TIMESERIES_TEST_PARSE_PACK | \
-  CHKLST_TIMESERIES_TEST_SHARING)
+  CHKLST_TIMESERIES_TEST_SHARING | CHKLST_TIMESERIES_TEST_RUNNING_STATS | \
+  CHKLST_TIMESERIES_TEST_RUNNING_MEDIAN | CHKLST_TIMESERIES_TEST_SLIDING_MINMAX | \
+  CHKLST_TIMESERIES_TEST_DOWNSAMPLING)
   // CHKLST_TIMESERIES_TEST_SHARING | \
   // CHKLST_TIMESERIES3_TEST_CONSTRUCTION | CHKLST_TIMESERIES3_TEST_INITIAL_COND | \
   // CHKLST_TIMESERIES3_TEST_STATS | CHKLST_TIMESERIES3_TEST_REWINDOWING | \
@@ -741,6 +1269,30 @@ const StepSequenceList TIMESERIES_TEST_LIST[] = {
     .DISPATCH_FXN = []() { return 1;  },
     .POLL_FXN     = []() { return ((0 == timeseries_stats_tests()) ? 1:-1);  }
   },
+  { .FLAG         = CHKLST_TIMESERIES_TEST_RUNNING_STATS,
+    .LABEL        = "Running statistics",
+    .DEP_MASK     = (CHKLST_TIMESERIES_TEST_STATS),
+    .DISPATCH_FXN = []() { return 1;  },
+    .POLL_FXN     = []() { return ((0 == timeseries_running_stats()) ? 1:-1);  }
+  },
+  { .FLAG         = CHKLST_TIMESERIES_TEST_RUNNING_MEDIAN,
+    .LABEL        = "Running median",
+    .DEP_MASK     = (CHKLST_TIMESERIES_TEST_STATS),
+    .DISPATCH_FXN = []() { return 1;  },
+    .POLL_FXN     = []() { return ((0 == timeseries_running_median()) ? 1:-1);  }
+  },
+  { .FLAG         = CHKLST_TIMESERIES_TEST_SLIDING_MINMAX,
+    .LABEL        = "Sliding min/max",
+    .DEP_MASK     = (CHKLST_TIMESERIES_TEST_STATS),
+    .DISPATCH_FXN = []() { return 1;  },
+    .POLL_FXN     = []() { return ((0 == timeseries_sliding_minmax()) ? 1:-1);  }
+  },
+  { .FLAG         = CHKLST_TIMESERIES_TEST_DOWNSAMPLING,
+    .LABEL        = "Downsampling",
+    .DEP_MASK     = (CHKLST_TIMESERIES_TEST_STATS),
+    .DISPATCH_FXN = []() { return 1;  },
+    .POLL_FXN     = []() { return ((0 == timeseries_downsampling()) ? 1:-1);  }
+  },
   { .FLAG         = CHKLST_TIMESERIES_TEST_REWINDOWING,
     .LABEL        = "Re-windowing",
     .DEP_MASK     = (CHKLST_TIMESERIES_TEST_INITIAL_COND),
@@ -27,8 +27,11 @@ TODO: Finish conversion to RingBuffer, and put constraints on BusAdapter's init
 
 #include "../Meta/Rationalizer.h"
 #include "../CppPotpourri.h"
-#include "../PriorityQueue.h"
+#include "../PriorityHeap.h"
 #include "../ElementPool.h"
+#if defined(__BUILD_HAS_THREADS)
+  #include "../ConcurrentElementPool.h"
+#endif
 #include "../AbstractPlatform.h"
 #include "../FlagContainer.h"
 #include "../C3PLogger.h"
@@ -428,7 +431,8 @@ template <class T> class BusAdapter : public BusOpCallback, public C3PPollable {
     */
     int8_t purge_queued_work_by_dev(BusOpCallback* cb_obj) {
       int8_t ret = 0;
-      for (int i = 0; i < work_queue.size(); i++) {
+      int i = 0;
+      while (i < work_queue.size()) {
         T* current = work_queue.get(i);
         if ((nullptr != current) && (current->callback == cb_obj)) {
           ret++;
@@ -438,6 +442,10 @@ template <class T> class BusAdapter : public BusOpCallback, public C3PPollable {
             current->callback->io_op_callback(current);
           }
           _reclaim_queue_item(current);   // Delete the queued work AND its buffer.
+          i = 0;   // Removal reorders the heap. Start over.
+        }
+        else {
+          i++;
         }
       }
       return ret;
@@ -478,7 +486,7 @@ template <class T> class BusAdapter : public BusOpCallback, public C3PPollable {
       int wqs = work_queue.size();
       if (wqs > 0) {
         int print_depth = strict_min((int8_t) wqs, max_print);
-        output->concatf("-- Queue Listing (top %d of %d total)\n", print_depth, wqs);
+        output->concatf("-- Queue Listing (%d of %d total, heap order)\n", print_depth, wqs);
         for (int i = 0; i < print_depth; i++) {
           work_queue.get(i)->printDebug(output);
         }
@@ -495,12 +503,17 @@ template <class T> class BusAdapter : public BusOpCallback, public C3PPollable {
     const uint8_t  MAX_Q_DEPTH;     // Maximum tolerable queue depth.
     uint16_t _queue_floods;         // How many times has the queue rejected work?
     T*       current_job;
-    PriorityQueue<T*> work_queue;   // A work queue to keep transactions in order.
-    ElementPool<T> preallocated;    //
+    PriorityHeap<T*> work_queue;    // A work queue to keep transactions in order.
+    #if defined(__BUILD_HAS_THREADS)
+      // new_op() and reclamation might happen on different threads.
+      ConcurrentElementPool<T> preallocated;
+    #else
+      ElementPool<T> preallocated;
+    #endif
 
     BusAdapter(uint8_t anum, uint32_t PA_COUNT, uint8_t maxq) :
       ADAPTER_NUM(anum), MAX_Q_DEPTH(maxq), _queue_floods(0),
-      current_job(nullptr), preallocated(PA_COUNT, MAX_Q_DEPTH) {};
+      current_job(nullptr), work_queue(true, maxq), preallocated(PA_COUNT, MAX_Q_DEPTH) {};
 
 
     /*
@@ -5,6 +5,7 @@
 #include <inttypes.h>
 #include <stdint.h>
 #include "BusQueue.h"
+#include "../PriorityQueue.h"
 #include "../StringBuilder.h"
 #include "../AbstractPlatform.h"
 
@@ -193,26 +193,28 @@ int8_t UARTAdapter::pushBuffer(StringBuilder* buf) {
     //   and some free buffer to accept it.
     const int32_t BYTES_TO_TAKE = strict_min(TXBUF_AVAILBLE, FULL_BUFFER_LEN);
     if (0 < BYTES_TO_TAKE) {
-      // Iterate through each fragment in the StringBuilder and bulk-insert each
-      //   into the RingBuffer, freeing them as we go.
+      // Gather the fragments of the StringBuilder a few at a time, bulk-insert
+      //   each into the RingBuffer, and then consume what was taken.
       // If we were to call StringBuilder::string(), there is an excellent
       //   chance of needlessly forcing reallocation in StringBuilder. So this
       //   is not only safer, but faster.
       int32_t bytes_taken  = 0;
       bool    bail_on_loop = false;
       while (!bail_on_loop & (bytes_taken < BYTES_TO_TAKE)) {
-        int frag_len = 0;
-        uint8_t* frag_ptr = buf->position(0, &frag_len);
-        bail_on_loop = (nullptr == frag_ptr) & (frag_len > 0);
-        if (!bail_on_loop) {
-          const int32_t BYTES_REMAINING = (BYTES_TO_TAKE - bytes_taken);
-          const int32_t BYTES_TO_INSERT = strict_min((int32_t) frag_len, BYTES_REMAINING);
-          const uint32_t BYTES_INSERTED = _tx_buffer.insert(frag_ptr, BYTES_TO_INSERT);
-          bytes_taken += BYTES_INSERTED;
-          // Drop the entire fragment (if possible) or cull the bytes we took.
-          if ((int32_t) BYTES_INSERTED == frag_len) {  buf->drop_position(0);      }
-          else {                                       buf->cull(BYTES_INSERTED);  }
+        SBIOVec frags[4];
+        const int FRAG_COUNT = buf->toIOVec(frags, 4);
+        int32_t bytes_this_pass = 0;
+        bail_on_loop = (0 == FRAG_COUNT);
+        for (int i = 0; (!bail_on_loop & (i < FRAG_COUNT)); i++) {
+          const int32_t BYTES_REMAINING = (BYTES_TO_TAKE - (bytes_taken + bytes_this_pass));
+          const int32_t BYTES_TO_INSERT = strict_min((int32_t) frags[i].iov_len, BYTES_REMAINING);
+          // NOTE: insert() returns negative when it takes nothing.
+          const int32_t BYTES_INSERTED  = strict_max((int32_t) 0, (int32_t) _tx_buffer.insert((uint8_t*) frags[i].iov_base, BYTES_TO_INSERT));
+          bytes_this_pass += BYTES_INSERTED;
+          bail_on_loop = (BYTES_INSERTED < (int32_t) frags[i].iov_len);
         }
+        bytes_taken += buf->consume(bytes_this_pass);
+        bail_on_loop |= (0 == bytes_this_pass);
       }
       ret = (FULL_BUFFER_LEN > bytes_taken) ? 0 : 1;
     }
@@ -280,13 +282,7 @@ uint32_t UARTAdapter::write(char c) {
 * Read from the class buffer.
 */
 uint32_t UARTAdapter::read(uint8_t* buf, uint32_t len) {
-  uint32_t XFER_LEN = strict_min(len, (uint32_t) _rx_buffer.count());
-  if (0 < XFER_LEN) {
-    for (uint32_t i = 0; i < XFER_LEN; i++) {
-      *(buf + i) = _rx_buffer.get();
-    }
-  }
-  return XFER_LEN;
+  return (uint32_t) strict_max((int32_t) 0, (int32_t) _rx_buffer.get(buf, len));
 }
 
 
@@ -294,14 +290,16 @@ uint32_t UARTAdapter::read(uint8_t* buf, uint32_t len) {
 * Read from the class buffer.
 */
 uint32_t UARTAdapter::read(StringBuilder* buf) {
-  const uint32_t RX_COUNT = _rx_buffer.count();
+  RingBufferSpan<uint8_t> spans[2];
   uint32_t ret = 0;
-  if (0 < RX_COUNT) {
-    uint8_t* _temp_buf = (uint8_t*) malloc(RX_COUNT);
-    if (nullptr != _temp_buf) {
-      ret = _rx_buffer.get(_temp_buf, RX_COUNT);
-      buf->concatHandoff(_temp_buf, ret);
+  if (0 < _rx_buffer.peekContiguous(spans)) {
+    for (uint8_t i = 0; i < 2; i++) {
+      if (0 < spans[i].len) {
+        buf->concat(spans[i].ptr, spans[i].len);
+        ret += spans[i].len;
+      }
     }
+    _rx_buffer.consume(ret);
   }
   return ret;
 }
@@ -324,14 +322,20 @@ int UARTAdapter::_handle_rx_push() {
       const uint32_t BUF_AVAILABLE = _read_cb_obj->bufferAvailable();
       const uint32_t SAFE_RX_COUNT = strict_min(BUF_AVAILABLE, RX_COUNT);
       if (SAFE_RX_COUNT) {
+        // Copy straight out of the ring. The bytes stay there until we know how
+        //   many of them the sink accepted.
         StringBuilder  unpushed_rx;
-        uint8_t* temp_buf = (uint8_t*) malloc(SAFE_RX_COUNT);
-        if (nullptr != temp_buf) {
-          const uint32_t RX_BYTES_FROM_RB = _rx_buffer.peek(temp_buf, SAFE_RX_COUNT);
-          unpushed_rx.concatHandoff(temp_buf, RX_BYTES_FROM_RB);
+        RingBufferSpan<uint8_t> spans[2];
+        const int RX_BYTES_FROM_RB = _rx_buffer.peekContiguous(spans, SAFE_RX_COUNT);
+        if (0 < RX_BYTES_FROM_RB) {
+          for (uint8_t i = 0; i < 2; i++) {
+            if (0 < spans[i].len) {
+              unpushed_rx.concat(spans[i].ptr, spans[i].len);
+            }
+          }
           _read_cb_obj->pushBuffer(&unpushed_rx);
           ret = (RX_BYTES_FROM_RB - unpushed_rx.length());
-          _rx_buffer.cull(ret);
+          _rx_buffer.consume(ret);
         }
       }
     }
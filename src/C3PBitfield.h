@@ -19,6 +19,12 @@ limitations under the License.
 
 
 A class for efficient aggregation of a large number of bits.
+
+Bits are stored in 64-bit words, so that searches and counts can skip over
+  64 bits at a time, and use the compiler's count-trailing-zeros and popcount
+  builtins on the words that matter.
+Any bits in the last word beyond BITS are kept clear, so that whole-word
+  operations never need to mask them on the way out.
 */
 #ifndef __DS_C3P_BITFIELD_H
 #define __DS_C3P_BITFIELD_H
@@ -34,6 +40,8 @@ class C3PBitfield {
     C3PBitfield(const uint32_t BIT_COUNT) : BITS(BIT_COUNT), _mem(nullptr) {};
     ~C3PBitfield();
 
+    inline uint32_t bitCount() const {   return BITS;   };
+
     bool     bitValue(const uint32_t BIT_IDX);
     void     bitValue(const uint32_t BIT_IDX, const bool VAL);
     uint32_t idxFirstSet();    // The index of the first bit that is set.
@@ -41,38 +49,60 @@ class C3PBitfield {
     uint32_t totalSet();       // The total number of set bits.
     uint32_t totalClear();     // The total number of cleared bits.
 
+    /* Searches. These return UINT32_MAX if there is no such bit. */
+    uint32_t findNextSet(const uint32_t FROM);    // The first set bit at or after FROM.
+    uint32_t findNextClear(const uint32_t FROM);  // The first clear bit at or after FROM.
 
-  private:
-    const uint32_t BITS;
-    uint8_t* _mem;
+    /* Range operations on [FIRST, FIRST + COUNT). Return -1 if out of bounds. */
+    int8_t   setRange(const uint32_t FIRST, const uint32_t COUNT);
+    int8_t   clearRange(const uint32_t FIRST, const uint32_t COUNT);
+    int8_t   flipRange(const uint32_t FIRST, const uint32_t COUNT);
 
-    inline uint32_t _byte_idx(const uint32_t BIT_IDX) const {  return (BIT_IDX >> 3);  };
-    inline uint32_t _byte_count() const {   return ((BITS + 7) >> 3);   };
+    /*
+    * Whole-field operations with another bitfield. Bits beyond the end of the
+    *   other field are treated as clear. Return -1 on allocation failure.
+    */
+    int8_t   andWith(C3PBitfield*);
+    int8_t   orWith(C3PBitfield*);
+    int8_t   xorWith(C3PBitfield*);
+    int8_t   andNotWith(C3PBitfield*);   // Clears every bit that is set in the other.
 
-    bool allocated();   // Lazy allocator. Inits all bits to zero.
+
+  private:
+    const uint32_t BITS;
+    uint64_t* _mem;
+
+    inline uint32_t _word_idx(const uint32_t BIT_IDX) const {  return (BIT_IDX >> 6);           };
+    inline uint32_t _word_count() const {                      return ((BITS + 63) >> 6);       };
+    inline uint64_t _bit_mask(const uint32_t BIT_IDX) const {  return ((uint64_t) 1 << (BIT_IDX & 63));  };
+    inline uint64_t _tail_mask() const {
+      return ((0 == (BITS & 63)) ? ~((uint64_t) 0) : (((uint64_t) 1 << (BITS & 63)) - 1));
+    };
+
+    bool   allocated();   // Lazy allocator. Inits all bits to zero.
+    int8_t _range_op(const uint32_t FIRST, const uint32_t COUNT, const uint8_t OP);
+    int8_t _field_op(C3PBitfield*, const uint8_t OP);
 };
 
 
 
 
 
-C3PBitfield::~C3PBitfield() {
+inline C3PBitfield::~C3PBitfield() {
   if (nullptr != _mem) {
-    uint8_t* tmp = _mem;
+    uint64_t* tmp = _mem;
     _mem = nullptr;
     free(tmp);
   }
 }
 
 
-bool C3PBitfield::allocated() {
+inline bool C3PBitfield::allocated() {
   if ((nullptr == _mem) && (BITS > 0)) {
-    if (nullptr == _mem) {
-      const uint32_t MEM_COST = _byte_count();
-      _mem = (uint8_t*) malloc(MEM_COST);
-      if (nullptr != _mem) {
-        memset(_mem, 0, MEM_COST);
-      }
+    const uint32_t MEM_COST = (_word_count() * sizeof(uint64_t));
+    _mem = (uint64_t*) malloc(MEM_COST);
+    if (nullptr != _mem) {
+      memset(_mem, 0, MEM_COST);
     }
   }
   return (nullptr != _mem);
@@ -83,89 +113,78 @@ bool C3PBitfield::allocated() {
 
 
 
-bool C3PBitfield::bitValue(const uint32_t BIT_IDX) {
-  if (allocated()) {
-    const uint8_t MASK = (1 << (BIT_IDX & 7));
-    return (0 < (*(_mem + _byte_idx(BIT_IDX)) & MASK));
+inline bool C3PBitfield::bitValue(const uint32_t BIT_IDX) {
+  if ((BIT_IDX < BITS) && allocated()) {
+    return (0 != (_mem[_word_idx(BIT_IDX)] & _bit_mask(BIT_IDX)));
   }
   return false;
 }
 
-void C3PBitfield::bitValue(const uint32_t BIT_IDX, const bool VAL) {
-  if (allocated()) {
-    const uint32_t BYTE_IDX = _byte_idx(BIT_IDX);
-    const uint8_t  MASK     = (1 << (BIT_IDX & 7));
-    const uint8_t  OLD_VAL  = *(_mem + BYTE_IDX);
-    *(_mem + BYTE_IDX) = (OLD_VAL & ~MASK) | (VAL ? MASK : 0);
+inline void C3PBitfield::bitValue(const uint32_t BIT_IDX, const bool VAL) {
+  if ((BIT_IDX < BITS) && allocated()) {
+    const uint32_t WORD_IDX = _word_idx(BIT_IDX);
+    const uint64_t MASK     = _bit_mask(BIT_IDX);
+    _mem[WORD_IDX] = (_mem[WORD_IDX] & ~MASK) | (VAL ? MASK : 0);
   }
 }
 
 
+inline uint32_t C3PBitfield::idxFirstSet() {     return findNextSet(0);     }
+inline uint32_t C3PBitfield::idxFirstClear() {   return findNextClear(0);   }
 
 
-// Add these inside the class (public section), replacing the TODOs:
-
-uint32_t C3PBitfield::idxFirstSet() {     // index of first bit that is set
-  if (!allocated()) {
+/*
+* Find the first set bit at or after the given index. Whole words of zeros are
+*   skipped without looking at their bits.
+*
+* @param FROM is the index to start the search.
+* @return the index of the bit, or UINT32_MAX if there is none.
+*/
+inline uint32_t C3PBitfield::findNextSet(const uint32_t FROM) {
+  if ((FROM >= BITS) || !allocated()) {
     return UINT32_MAX;
   }
-
-  const uint32_t BYTE_COUNT = ((BITS + 7) >> 3);
-  const uint32_t FULL_BYTES = (BITS >> 3);
-  const uint32_t TAIL_BITS  = (BITS & 7);
-
-  for (uint32_t b = 0; b < BYTE_COUNT; b++) {
-    uint8_t v = _mem[b];
-
-    // Mask out unused bits in the last byte (they should not count as set).
-    if ((b == FULL_BYTES) && (TAIL_BITS != 0)) {
-      const uint8_t VALID_MASK = (uint8_t)((1u << TAIL_BITS) - 1u);
-      v &= VALID_MASK;
-    }
-
-    if (v) {
-      // find first set bit in v
-      for (uint8_t bit = 0; bit < 8; bit++) {
-        if (v & (1u << bit)) {
-          const uint32_t idx = (b << 3) + bit;
-          return (idx < BITS) ? idx : UINT32_MAX;
-        }
-      }
+  const uint32_t WORD_COUNT = _word_count();
+  uint32_t w = _word_idx(FROM);
+  // Ignore the bits in the first word that come before FROM.
+  uint64_t v = (_mem[w] & (~((uint64_t) 0) << (FROM & 63)));
+  while (0 == v) {
+    if (++w >= WORD_COUNT) {
+      return UINT32_MAX;
     }
+    v = _mem[w];
   }
-
-  return UINT32_MAX;
+  // Bits past the end are always clear, so this can't exceed BITS.
+  return ((w << 6) + (uint32_t) __builtin_ctzll(v));
 }
 
 
-uint32_t C3PBitfield::idxFirstClear() {   // index of first bit that is clear
-  if (!allocated()) {  return UINT32_MAX;  }
-
-  const uint32_t BYTE_COUNT = ((BITS + 7) >> 3);
-  const uint32_t FULL_BYTES = (BITS >> 3);
-  const uint32_t TAIL_BITS  = (BITS & 7);
-
-  for (uint32_t b = 0; b < BYTE_COUNT; b++) {
-    uint8_t v = _mem[b];
-
-    // For the last byte, force unused bits to 1 so they don't appear "clear".
-    if ((b == FULL_BYTES) && (TAIL_BITS != 0)) {
-      const uint8_t VALID_MASK = (uint8_t)((1u << TAIL_BITS) - 1u);
-      v |= (uint8_t)~VALID_MASK;
-    }
-
-    if (v != 0xFF) {
-      // find first clear bit in v
-      for (uint8_t bit = 0; bit < 8; bit++) {
-        if (!(v & (1u << bit))) {
-          const uint32_t idx = (b << 3) + bit;
-          return (idx < BITS) ? idx : UINT32_MAX;
-        }
-      }
+/*
+* Find the first clear bit at or after the given index. Whole words of ones are
+*   skipped without looking at their bits.
+*
+* @param FROM is the index to start the search.
+* @return the index of the bit, or UINT32_MAX if there is none.
+*/
+inline uint32_t C3PBitfield::findNextClear(const uint32_t FROM) {
+  if (FROM >= BITS) {
+    return UINT32_MAX;
+  }
+  if (!allocated()) {
+    return FROM;   // Nothing can be set.
+  }
+  const uint32_t WORD_COUNT = _word_count();
+  uint32_t w = _word_idx(FROM);
+  uint64_t v = (~_mem[w] & (~((uint64_t) 0) << (FROM & 63)));
+  while (0 == v) {
+    if (++w >= WORD_COUNT) {
+      return UINT32_MAX;
     }
+    v = ~_mem[w];
   }
-
-  return UINT32_MAX;
+  // The bits past the end are clear, and so would look like a hit.
+  const uint32_t IDX = ((w << 6) + (uint32_t) __builtin_ctzll(v));
+  return ((IDX < BITS) ? IDX : UINT32_MAX);
 }
 
 
@@ -173,28 +192,13 @@ uint32_t C3PBitfield::idxFirstClear() {   // index of first bit that is clear
 *
 * @return Total number of set bits.
 */
-uint32_t C3PBitfield::totalSet() {
+inline uint32_t C3PBitfield::totalSet() {
   if (!allocated()) {  return 0;  }
-
-  static const uint8_t POP4[16] = {  0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4  };
-
-  const uint32_t BYTE_COUNT = ((BITS + 7) >> 3);
-  const uint32_t FULL_BYTES = (BITS >> 3);
-  const uint32_t TAIL_BITS  = (BITS & 7);
-
+  const uint32_t WORD_COUNT = _word_count();
   uint32_t total = 0;
-  for (uint32_t b = 0; b < BYTE_COUNT; b++) {
-    uint8_t v = _mem[b];
-
-    // Mask out unused bits in the last byte.
-    if ((b == FULL_BYTES) && (TAIL_BITS != 0)) {
-      const uint8_t VALID_MASK = (uint8_t)((1u << TAIL_BITS) - 1u);
-      v &= VALID_MASK;
-    }
-
-    total += POP4[v & 0x0F] + POP4[v >> 4];
+  for (uint32_t w = 0; w < WORD_COUNT; w++) {
+    total += (uint32_t) __builtin_popcountll(_mem[w]);
   }
-
   return total;
 }
 
@@ -203,7 +207,7 @@ uint32_t C3PBitfield::totalSet() {
 *
 * @return Total number of cleared bits.
 */
-uint32_t C3PBitfield::totalClear() {      // total number of cleared bits
+inline uint32_t C3PBitfield::totalClear() {      // total number of cleared bits
   // Only count bits inside [0, BITS). Unallocated implies all-zero -> all clear.
   if (BITS == 0) {
     return 0;
@@ -214,4 +218,76 @@ uint32_t C3PBitfield::totalClear() {      // total number of cleared bits
   return (BITS - totalSet());
 }
 
+
+inline int8_t C3PBitfield::setRange(const uint32_t FIRST, const uint32_t COUNT) {     return _range_op(FIRST, COUNT, 0);  }
+inline int8_t C3PBitfield::clearRange(const uint32_t FIRST, const uint32_t COUNT) {   return _range_op(FIRST, COUNT, 1);  }
+inline int8_t C3PBitfield::flipRange(const uint32_t FIRST, const uint32_t COUNT) {    return _range_op(FIRST, COUNT, 2);  }
+
+inline int8_t C3PBitfield::andWith(C3PBitfield* other) {      return _field_op(other, 0);  }
+inline int8_t C3PBitfield::orWith(C3PBitfield* other) {       return _field_op(other, 1);  }
+inline int8_t C3PBitfield::xorWith(C3PBitfield* other) {      return _field_op(other, 2);  }
+inline int8_t C3PBitfield::andNotWith(C3PBitfield* other) {   return _field_op(other, 3);  }
+
+
+/*
+* Apply an operation to a range of bits, a word at a time. Only the first and
+*   last words need a partial mask.
+*
+* @param OP is 0 to set, 1 to clear, and 2 to flip.
+* @return 0 on success, or -1 if the range is out of bounds.
+*/
+inline int8_t C3PBitfield::_range_op(const uint32_t FIRST, const uint32_t COUNT, const uint8_t OP) {
+  if ((FIRST >= BITS) || (COUNT > (BITS - FIRST)) || !allocated()) {
+    return -1;
+  }
+  if (0 == COUNT) {
+    return 0;
+  }
+  const uint32_t LAST   = (FIRST + COUNT - 1);
+  const uint32_t W_LAST = _word_idx(LAST);
+  for (uint32_t w = _word_idx(FIRST); w <= W_LAST; w++) {
+    uint64_t mask = ~((uint64_t) 0);
+    if (w == _word_idx(FIRST)) {  mask &= (~((uint64_t) 0) << (FIRST & 63));        }
+    if (w == W_LAST) {            mask &= (~((uint64_t) 0) >> (63 - (LAST & 63)));  }
+    switch (OP) {
+      case 0:   _mem[w] |= mask;    break;
+      case 1:   _mem[w] &= ~mask;   break;
+      default:  _mem[w] ^= mask;    break;
+    }
+  }
+  return 0;
+}
+
+
+/*
+* Combine another bitfield into this one, a word at a time.
+*
+* @param OP is 0 for AND, 1 for OR, 2 for XOR, and 3 for AND-NOT.
+* @return 0 on success, or -1 on bad argument or allocation failure.
+*/
+inline int8_t C3PBitfield::_field_op(C3PBitfield* other, const uint8_t OP) {
+  if ((nullptr == other) || !allocated() || ((0 < other->BITS) && !other->allocated())) {
+    return -1;
+  }
+  const uint32_t WORD_COUNT = _word_count();
+  const uint32_t SHARED     = ((other->_word_count() < WORD_COUNT) ? other->_word_count() : WORD_COUNT);
+  for (uint32_t w = 0; w < SHARED; w++) {
+    switch (OP) {
+      case 0:   _mem[w] &= other->_mem[w];    break;
+      case 1:   _mem[w] |= other->_mem[w];    break;
+      case 2:   _mem[w] ^= other->_mem[w];    break;
+      default:  _mem[w] &= ~other->_mem[w];   break;
+    }
+  }
+  if (0 == OP) {
+    // AND with the implied zeros past the end of the other field.
+    for (uint32_t w = SHARED; w < WORD_COUNT; w++) {
+      _mem[w] = 0;
+    }
+  }
+  // The other field might be longer than this one.
+  _mem[WORD_COUNT - 1] &= _tail_mask();
+  return 0;
+}
+
 #endif // __DS_C3P_BITFIELD_H
@@ -0,0 +1,390 @@
+/*
+File:   C3PDecimation.h
+Author: J. Ian Lindsay
+Date:   2026.10.16
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Tools for reducing a long run of samples to a few representative points, for
+  graphing or streaming.
+
+C3PBucketSummary holds the min, max, and sum of a range of samples, and where
+  the extremes were.
+
+C3PDecimationPyramid keeps summaries of a ring buffer at several resolutions.
+  Level 1 summarizes each run of FANOUT slots, level 2 each run of FANOUT
+  level-1 buckets, and so on. A bucket is recomputed from its children when the
+  ring writes the last slot it covers, so feeding costs amortized O(1). Any
+  range of slots that doesn't straddle the write position can then be
+  summarized in O(FANOUT * levels), regardless of its length. The buckets cost
+  about (32 / (FANOUT - 1)) bytes per slot, on the heap. The values are not
+  copied, so the caller's buffer must outlive the class. The caller must write
+  slots in ring order, calling push() after each, and must call init() again
+  after changing the buffer by any other means.
+
+c3p_lttb() is the largest-triangle-three-buckets downsampler (Steinarsson,
+  2013). It keeps the first and last points, and from each bucket in between,
+  the point that makes the largest triangle with the point kept before it and
+  the mean of the bucket after it. This tends to keep the peaks and the overall
+  shape that a reader would notice.
+*/
+
+#ifndef __C3P_DECIMATION_H__
+#define __C3P_DECIMATION_H__
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#define C3P_PYRAMID_MAX_LEVELS  12   // Enough for a FANOUT of 16 over any uint32_t window.
+
+
+/*******************************************************************************
+* Summary of a range of samples
+*******************************************************************************/
+template <class T> struct C3PBucketSummary {
+  T        min_value;
+  T        max_value;
+  uint32_t min_idx;    // Index of the earliest minimum.
+  uint32_t max_idx;    // Index of the earliest maximum.
+  uint32_t count;      // Samples summarized. Zero means the summary is empty.
+  double   sum;
+
+  inline double mean() const {  return ((0 < count) ? (sum / count) : 0);  };
+};
+
+
+template <class T> inline void c3p_bucket_clear(C3PBucketSummary<T>* b) {
+  b->min_value = T(0);
+  b->max_value = T(0);
+  b->min_idx   = 0;
+  b->max_idx   = 0;
+  b->count     = 0;
+  b->sum       = 0;
+}
+
+
+/* Adds one sample to a summary. Samples must be added in order. */
+template <class T> inline void c3p_bucket_add(C3PBucketSummary<T>* b, const T VAL, const uint32_t IDX) {
+  if ((0 == b->count) || (VAL < b->min_value)) {
+    b->min_value = VAL;
+    b->min_idx   = IDX;
+  }
+  if ((0 == b->count) || (b->max_value < VAL)) {
+    b->max_value = VAL;
+    b->max_idx   = IDX;
+  }
+  b->sum += (double) VAL;
+  b->count++;
+}
+
+
+/* Appends a summary of later samples to a summary. */
+template <class T> inline void c3p_bucket_merge(C3PBucketSummary<T>* b, const C3PBucketSummary<T>* LATER) {
+  if (0 < LATER->count) {
+    if ((0 == b->count) || (LATER->min_value < b->min_value)) {
+      b->min_value = LATER->min_value;
+      b->min_idx   = LATER->min_idx;
+    }
+    if ((0 == b->count) || (b->max_value < LATER->max_value)) {
+      b->max_value = LATER->max_value;
+      b->max_idx   = LATER->max_idx;
+    }
+    b->sum   += LATER->sum;
+    b->count += LATER->count;
+  }
+}
+
+
+/* Summarizes DATA[FIRST] through DATA[END-1] by brute force. */
+template <class T> inline void c3p_summarize(const T* DATA, const uint32_t FIRST, const uint32_t END, C3PBucketSummary<T>* out) {
+  c3p_bucket_clear(out);
+  for (uint32_t i = FIRST; i < END; i++) {
+    c3p_bucket_add(out, DATA[i], i);
+  }
+}
+
+
+
+/*******************************************************************************
+* Decimation pyramid over a ring buffer
+*******************************************************************************/
+template <class T> class C3PDecimationPyramid {
+  public:
+    C3PDecimationPyramid() {};
+    ~C3PDecimationPyramid();
+
+    int8_t init(const T* DATA, const uint32_t N, const uint32_t FANOUT = 16);
+    void   push(const uint32_t SLOT);
+    void   summarize(const uint32_t FIRST, const uint32_t END, C3PBucketSummary<T>* out);
+
+    inline bool    initialized() {   return (nullptr != _data);  };
+    inline uint8_t levels() {        return _levels;             };
+
+
+  private:
+    const T*             _data    = nullptr;
+    C3PBucketSummary<T>* _buckets = nullptr;   // Every level, finest first.
+    uint32_t*            _geom    = nullptr;   // Per-level tables, in the same allocation after _buckets.
+    uint32_t _n         = 0;
+    uint32_t _fanout    = 0;
+    uint8_t  _levels    = 0;                    // Levels of buckets above the samples.
+
+    /* The tables in _geom hold (_levels + 1) entries each. */
+    inline uint32_t& _span(const uint8_t L) {    return _geom[L];                      };  // Slots covered by one bucket.
+    inline uint32_t& _count(const uint8_t L) {   return _geom[(_levels + 1) + L];      };  // Buckets in the level.
+    inline uint32_t& _offset(const uint8_t L) {  return _geom[((_levels + 1) << 1) + L];  };  // Position of the level in _buckets.
+
+    inline C3PBucketSummary<T>* _bucket(const uint8_t LEVEL, const uint32_t IDX) {
+      return (_buckets + _offset(LEVEL) + IDX);
+    };
+    void _rebuild(const uint8_t LEVEL, const uint32_t IDX);
+};
+
+
+template <class T> C3PDecimationPyramid<T>::~C3PDecimationPyramid() {
+  _data = nullptr;
+  _geom = nullptr;
+  if (nullptr != _buckets) {
+    C3PBucketSummary<T>* tmp = _buckets;
+    _buckets = nullptr;
+    free(tmp);
+  }
+}
+
+
+/*
+* Take the values in a buffer as a new window, and build every level from them
+*   in O(n). Memory is only reallocated if the geometry changes. The buckets and
+*   the tables that describe their levels share one allocation, so a pyramid
+*   that is never built costs only its members.
+*
+* @param DATA is the caller's buffer.
+* @param N is the number of slots in the window.
+* @param FANOUT is the number of children summarized by each bucket.
+* @return 0 on success, or -1 on bad arguments or allocation failure.
+*/
+template <class T> int8_t C3PDecimationPyramid<T>::init(const T* DATA, const uint32_t N, const uint32_t FANOUT) {
+  _data = nullptr;
+  if ((nullptr == DATA) || (0 == N) || (2 > FANOUT) || (N > (0xFFFFFFFF / FANOUT))) {
+    return -1;
+  }
+  if ((N != _n) || (FANOUT != _fanout)) {
+    if (nullptr != _buckets) {
+      free(_buckets);
+      _buckets = nullptr;
+      _geom    = nullptr;
+    }
+    // Add levels until one bucket covers the whole window.
+    uint32_t total  = 0;
+    uint8_t  levels = 0;
+    for (uint32_t c = N; (1 < c) && (C3P_PYRAMID_MAX_LEVELS > levels); levels++) {
+      c = ((c + FANOUT - 1) / FANOUT);
+      total += c;
+    }
+    const uint32_t BUCKET_BYTES = (total * sizeof(C3PBucketSummary<T>));
+    uint8_t* mem = (uint8_t*) malloc(BUCKET_BYTES + (3 * (levels + 1) * sizeof(uint32_t)));
+    if (nullptr == mem) {
+      _n      = 0;
+      _fanout = 0;
+      _levels = 0;
+      return -1;
+    }
+    _buckets = (C3PBucketSummary<T>*) mem;
+    _geom    = (uint32_t*) (mem + BUCKET_BYTES);
+    _levels  = levels;
+    _span(0)   = 1;
+    _count(0)  = N;
+    _offset(0) = 0;
+    total = 0;
+    for (uint8_t level = 1; level <= _levels; level++) {
+      _span(level)   = (_span(level - 1) * FANOUT);
+      _count(level)  = ((_count(level - 1) + FANOUT - 1) / FANOUT);
+      _offset(level) = total;
+      total += _count(level);
+    }
+    _n      = N;
+    _fanout = FANOUT;
+  }
+  _data = DATA;
+  for (uint8_t level = 1; level <= _levels; level++) {
+    for (uint32_t i = 0; i < _count(level); i++) {
+      _rebuild(level, i);
+    }
+  }
+  return 0;
+}
+
+
+/*
+* Account for a new value that the caller has written into a slot. The slot
+*   must be the one that held the oldest value. Every bucket that the slot
+*   completes is recomputed from its children.
+*
+* @param SLOT is the index of the slot that was written.
+*/
+template <class T> void C3PDecimationPyramid<T>::push(const uint32_t SLOT) {
+  if ((nullptr == _data) || (SLOT >= _n)) {
+    return;
+  }
+  uint32_t idx = SLOT;
+  for (uint8_t level = 1; level <= _levels; level++) {
+    // idx is a child at the level below. Its parent is only complete once
+    //   its last child is.
+    if ((0 != ((idx + 1) % _fanout)) && ((idx + 1) != _count(level - 1))) {
+      return;
+    }
+    idx = (idx / _fanout);
+    _rebuild(level, idx);
+  }
+}
+
+
+/*
+* Summarize a range of slots, using the largest buckets that fit inside it.
+*   The range must not contain both the slot most recently written and the one
+*   after it. Extremes are reported by slot index.
+*
+* @param FIRST is the first slot in the range.
+* @param END is one past the last slot in the range.
+* @param out will hold the summary.
+*/
+template <class T> void C3PDecimationPyramid<T>::summarize(const uint32_t FIRST, const uint32_t END, C3PBucketSummary<T>* out) {
+  c3p_bucket_clear(out);
+  if ((nullptr == _data) || (END > _n)) {
+    return;
+  }
+  // Climb a level whenever pos is aligned to a bucket that ends within range,
+  //   and come down a level whenever the next bucket doesn't. Once on the way
+  //   down, no larger bucket can fit again.
+  uint32_t pos   = FIRST;
+  uint8_t  level = 0;
+  while (pos < END) {
+    if ((level < _levels) && (0 == (pos % _span(level + 1))) && ((_span(level + 1) <= (END - pos)) || (END == _n))) {
+      level++;
+      continue;
+    }
+    const uint32_t UNIT_END = ((_span(level) >= (_n - pos)) ? _n : (pos + _span(level)));
+    if (UNIT_END > END) {
+      level--;
+    }
+    else if (0 == level) {
+      c3p_bucket_add(out, _data[pos], pos);
+      pos++;
+    }
+    else {
+      c3p_bucket_merge(out, _bucket(level, (pos / _span(level))));
+      pos = UNIT_END;
+    }
+  }
+}
+
+
+/*
+* Recompute one bucket from the level below it.
+*/
+template <class T> void C3PDecimationPyramid<T>::_rebuild(const uint8_t LEVEL, const uint32_t IDX) {
+  C3PBucketSummary<T>* b = _bucket(LEVEL, IDX);
+  const uint32_t FIRST = (IDX * _fanout);
+  const uint32_t LIMIT = _count(LEVEL - 1);
+  const uint32_t END   = ((_fanout >= (LIMIT - FIRST)) ? LIMIT : (FIRST + _fanout));
+  if (1 == LEVEL) {
+    c3p_summarize(_data, FIRST, END, b);
+  }
+  else {
+    c3p_bucket_clear(b);
+    for (uint32_t i = FIRST; i < END; i++) {
+      c3p_bucket_merge(b, _bucket((LEVEL - 1), i));
+    }
+  }
+}
+
+
+
+/*******************************************************************************
+* Largest-triangle-three-buckets
+*******************************************************************************/
+
+/*
+* Downsample a series of points to COUNT points with LTTB.
+*
+* @param X are the horizontal positions of the points, which must increase. If
+*   nullptr, the positions are taken to be 0 through (N-1).
+* @param Y are the values of the points.
+* @param N is the number of points.
+* @param COUNT is the number of points to keep. If it is less than N, it must
+*   be at least 3.
+* @param out_x (optional) will hold the positions of the points kept.
+* @param out_y (optional) will hold the values of the points kept.
+* @return 0 on success, or -1 on bad arguments. On success, exactly COUNT
+*   points are written, or N if that is fewer.
+*/
+template <class T> int8_t c3p_lttb(const uint32_t* X, const T* Y, const uint32_t N, const uint32_t COUNT, uint32_t* out_x, T* out_y) {
+  if ((nullptr == Y) || (0 == N) || (0 == COUNT) || ((COUNT < N) & (3 > COUNT))) {
+    return -1;
+  }
+  if (COUNT >= N) {
+    for (uint32_t i = 0; i < N; i++) {
+      if (nullptr != out_x) {   out_x[i] = ((nullptr != X) ? X[i] : i);   }
+      if (nullptr != out_y) {   out_y[i] = Y[i];                          }
+    }
+    return 0;
+  }
+  // The first and last points are kept. The (N - 2) between them are divided
+  //   into (COUNT - 2) buckets, and bucket i is [bound(i), bound(i + 1)).
+  const uint32_t BUCKETS = (COUNT - 2);
+  uint32_t kept = 0;   // Index of the point most recently kept.
+  if (nullptr != out_x) {   out_x[0] = ((nullptr != X) ? X[0] : 0);   }
+  if (nullptr != out_y) {   out_y[0] = Y[0];                          }
+  for (uint32_t b = 0; b < BUCKETS; b++) {
+    const uint32_t FIRST     = (1 + (uint32_t) (((uint64_t) b * (N - 2)) / BUCKETS));
+    const uint32_t END       = (1 + (uint32_t) (((uint64_t) (b + 1) * (N - 2)) / BUCKETS));
+    const uint32_t NEXT_END  = (((b + 1) < BUCKETS) ? (1 + (uint32_t) (((uint64_t) (b + 2) * (N - 2)) / BUCKETS)) : N);
+    // The mean of the next bucket is the third corner of every triangle.
+    double next_x = 0;
+    double next_y = 0;
+    for (uint32_t i = END; i < NEXT_END; i++) {
+      next_x += (double) ((nullptr != X) ? X[i] : i);
+      next_y += (double) Y[i];
+    }
+    next_x /= (NEXT_END - END);
+    next_y /= (NEXT_END - END);
+
+    const double KEPT_X = (double) ((nullptr != X) ? X[kept] : kept);
+    const double KEPT_Y = (double) Y[kept];
+    double   best_area = -1;
+    uint32_t best_idx  = FIRST;
+    for (uint32_t i = FIRST; i < END; i++) {
+      const double PX = (double) ((nullptr != X) ? X[i] : i);
+      const double PY = (double) Y[i];
+      double area = (((KEPT_X - next_x) * (PY - KEPT_Y)) - ((KEPT_X - PX) * (next_y - KEPT_Y)));
+      if (area < 0) {
+        area = -area;
+      }
+      if (area > best_area) {
+        best_area = area;
+        best_idx  = i;
+      }
+    }
+    kept = best_idx;
+    if (nullptr != out_x) {   out_x[b + 1] = ((nullptr != X) ? X[kept] : kept);   }
+    if (nullptr != out_y) {   out_y[b + 1] = Y[kept];                             }
+  }
+  if (nullptr != out_x) {   out_x[COUNT - 1] = ((nullptr != X) ? X[N - 1] : (N - 1));   }
+  if (nullptr != out_y) {   out_y[COUNT - 1] = Y[N - 1];                                }
+  return 0;
+}
+
+#endif  // __C3P_DECIMATION_H__
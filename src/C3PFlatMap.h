@@ -0,0 +1,220 @@
+/*
+File:   C3PFlatMap.h
+Author: J. Ian Lindsay
+Date:   2026.10.16
+
+Copyright 2016 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Templates for read-only maps and sets over contiguous arrays.
+
+These are views. They neither allocate nor copy, and can be built at compile
+  time from static const arrays. So the table can live in flash, and be
+  searched in O(log n) with no heap. For tables that are written at runtime,
+  or that are large enough to want hashing, see C3PHashMap.
+
+Layouts:
+--------------------------------------------------------------------------------
+SORTED:    Keys in strictly ascending order. Searched by branchless binary
+             search. Iteration by index visits keys in order.
+EYTZINGER: Keys in breadth-first order of an implicit binary search tree, as
+             made by c3p_flat_eytzinger(). Searches touch memory in a more
+             predictable pattern, which helps tables larger than the cache.
+             Iteration by index does NOT visit keys in order.
+
+Constraints:
+--------------------------------------------------------------------------------
+1) The table must not contain duplicate keys. valid() will say so, and can be
+    used in a static_assert() for tables that are constexpr.
+2) C-string keys are compared by content, with a byte-wise strcmp().
+3) The table must outlive the view.
+*/
+
+#ifndef __C3P_FLAT_MAP_H
+#define __C3P_FLAT_MAP_H
+
+#include <stdint.h>
+#include <string.h>
+
+/* How a flat table is ordered. */
+enum class C3PFlatLayout : uint8_t {
+  SORTED    = 0,
+  EYTZINGER = 1
+};
+
+
+/* An entry in a flat map. Aggregate, so that tables can be brace-initialized. */
+template <class K, class V> struct C3PFlatEntry {
+  K KEY;
+  V VAL;
+};
+
+
+/*
+* How keys are ordered. Must be usable at compile time, so C-strings get a
+*   recursive comparison rather than strcmp().
+*/
+template <class K> struct C3PFlatOrder {
+  static constexpr bool less(const K& a, const K& b) {  return (a < b);  };
+};
+
+constexpr int c3p_flat_strcmp(const char* a, const char* b) {
+  return (((*a != *b) || (0 == *a)) ? ((int) (uint8_t) *a - (int) (uint8_t) *b) : c3p_flat_strcmp(a + 1, b + 1));
+}
+
+template <> struct C3PFlatOrder<const char*> {
+  static constexpr bool less(const char* const& a, const char* const& b) {  return (c3p_flat_strcmp(a, b) < 0);  };
+};
+
+
+
+/*******************************************************************************
+* The common view, on entries of type E with keys of type K.
+*******************************************************************************/
+template <class E, class K, class C> class C3PFlatView {
+  public:
+    constexpr C3PFlatView(const E* ENTRIES, const uint32_t COUNT, const C3PFlatLayout LAYOUT) :
+      _ENTRIES(ENTRIES), _COUNT(COUNT), _LAYOUT(LAYOUT) {};
+
+    inline constexpr uint32_t      count() const {    return _COUNT;    };
+    inline constexpr C3PFlatLayout layout() const {   return _LAYOUT;   };
+    inline const E* at(const uint32_t IDX) const {    return ((IDX < _COUNT) ? (_ENTRIES + IDX) : nullptr);  };
+
+    /* Is the table ordered as its layout requires, with no duplicate keys? */
+    constexpr bool valid() const {
+      return ((C3PFlatLayout::SORTED == _LAYOUT) ? _sorted(0, _COUNT) : _eytzinger(1, nullptr, nullptr));
+    };
+
+    /*
+    * Find a key.
+    *
+    * @return the index of the entry, or -1 if the key is absent.
+    */
+    int32_t indexOf(const K& KEY) const {
+      if (0 == _COUNT) {
+        return -1;
+      }
+      uint32_t idx = 0;
+      if (C3PFlatLayout::SORTED == _LAYOUT) {
+        // The loop has a fixed trip count for a given table, and the compiler
+        //   can make its only condition into a conditional move.
+        const E* base = _ENTRIES;
+        uint32_t n    = _COUNT;
+        while (n > 1) {
+          const uint32_t HALF = (n >> 1);
+          base = (C::less(_key(base[HALF]), KEY) ? (base + HALF) : base);
+          n -= HALF;
+        }
+        idx = (uint32_t) ((base - _ENTRIES) + (C::less(_key(*base), KEY) ? 1 : 0));
+      }
+      else {
+        // Descend the implicit tree. On the way out, k holds the path taken,
+        //   and the last left turn is the lower bound.
+        uint32_t k = 1;
+        while (k <= _COUNT) {
+          k = ((k << 1) + (C::less(_key(_ENTRIES[k - 1]), KEY) ? 1 : 0));
+        }
+        k >>= __builtin_ffs(~k);
+        if (0 == k) {
+          return -1;
+        }
+        idx = (k - 1);
+      }
+      return (((idx < _COUNT) && !C::less(KEY, _key(_ENTRIES[idx]))) ? (int32_t) idx : -1);
+    };
+
+    inline bool contains(const K& KEY) const {  return (0 <= indexOf(KEY));  };
+
+
+  protected:
+    const E*            _ENTRIES;
+    const uint32_t      _COUNT;
+    const C3PFlatLayout _LAYOUT;
+
+    static constexpr const K& _key(const K& ENTRY) {  return ENTRY;  };
+    template <class V> static constexpr const K& _key(const C3PFlatEntry<K, V>& ENTRY) {  return ENTRY.KEY;  };
+
+    /* Divide and conquer, to keep the recursion shallow for the compiler. */
+    constexpr bool _sorted(const uint32_t LO, const uint32_t HI) const {
+      return (((HI - LO) < 2) ||
+        (C::less(_key(_ENTRIES[((LO + HI) >> 1) - 1]), _key(_ENTRIES[(LO + HI) >> 1])) &&
+         _sorted(LO, ((LO + HI) >> 1)) && _sorted(((LO + HI) >> 1), HI)));
+    };
+
+    /* Every node must fall between the bounds set by its ancestors. */
+    constexpr bool _eytzinger(const uint32_t K_IDX, const E* LO, const E* HI) const {
+      return ((K_IDX > _COUNT) || (
+        ((nullptr == LO) || C::less(_key(*LO), _key(_ENTRIES[K_IDX - 1]))) &&
+        ((nullptr == HI) || C::less(_key(_ENTRIES[K_IDX - 1]), _key(*HI))) &&
+        _eytzinger((K_IDX << 1), LO, (_ENTRIES + K_IDX - 1)) &&
+        _eytzinger(((K_IDX << 1) + 1), (_ENTRIES + K_IDX - 1), HI)));
+    };
+};
+
+
+
+/*******************************************************************************
+* C3PFlatMap and C3PFlatSet
+*******************************************************************************/
+
+template <class K, class V, class C = C3PFlatOrder<K>> class C3PFlatMap : public C3PFlatView<C3PFlatEntry<K, V>, K, C> {
+  public:
+    constexpr C3PFlatMap(const C3PFlatEntry<K, V>* ENTRIES, const uint32_t COUNT, const C3PFlatLayout LAYOUT = C3PFlatLayout::SORTED) :
+      C3PFlatView<C3PFlatEntry<K, V>, K, C>(ENTRIES, COUNT, LAYOUT) {};
+
+    /*
+    * @return a pointer to the value for the given key, or nullptr if absent.
+    */
+    inline const V* get(const K& KEY) const {
+      const int32_t IDX = this->indexOf(KEY);
+      return ((0 <= IDX) ? &(this->_ENTRIES[IDX].VAL) : nullptr);
+    };
+
+    /*
+    * @return the value for the given key, or the fallback if absent.
+    */
+    inline V get(const K& KEY, const V FALLBACK) const {
+      const V* val = get(KEY);
+      return ((nullptr != val) ? *val : FALLBACK);
+    };
+};
+
+
+template <class K, class C = C3PFlatOrder<K>> class C3PFlatSet : public C3PFlatView<K, K, C> {
+  public:
+    constexpr C3PFlatSet(const K* KEYS, const uint32_t COUNT, const C3PFlatLayout LAYOUT = C3PFlatLayout::SORTED) :
+      C3PFlatView<K, K, C>(KEYS, COUNT, LAYOUT) {};
+};
+
+
+
+/*
+* Fill DEST with the Eytzinger layout of a SORTED table. The tables must not
+*   overlap. Used at build time by code generators, or at boot to copy a
+*   table from flash into RAM.
+*
+* @return the number of entries written.
+*/
+template <class E> uint32_t c3p_flat_eytzinger(const E* SORTED, E* DEST, const uint32_t COUNT, const uint32_t I = 0, const uint32_t K_IDX = 1) {
+  uint32_t i = I;
+  if (K_IDX <= COUNT) {
+    i = c3p_flat_eytzinger(SORTED, DEST, COUNT, i, (K_IDX << 1));
+    DEST[K_IDX - 1] = SORTED[i++];
+    i = c3p_flat_eytzinger(SORTED, DEST, COUNT, i, ((K_IDX << 1) + 1));
+  }
+  return i;
+}
+
+#endif  // __C3P_FLAT_MAP_H
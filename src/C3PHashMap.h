@@ -0,0 +1,531 @@
+/*
+File:   C3PHashMap.h
+Author: J. Ian Lindsay
+Date:   2026.10.16
+
+Copyright 2016 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Templates for a hash map and a hash set, with open addressing.
+
+Collisions are resolved by linear probing, with Robin Hood displacement: an
+  element that is further from its home slot takes the place of one that is
+  closer to its own. This keeps probe lengths short and even, and lets a
+  failed lookup stop early. Removal shifts the following run back by one
+  slot, so there are no tombstones.
+
+The table is three parallel arrays in a single allocation: the hashes, the
+  keys, and the values. Probing only touches the hashes until it finds a
+  likely match, and a hash of zero marks an empty slot.
+
+Constraints:
+--------------------------------------------------------------------------------
+1) Keys and values are copied by assignment, and should be plain data. String
+    keys are held by pointer, and the map does not own them. They must outlive
+    their place in the map.
+2) The slot count is rounded up to a power of two, with a minimum of 8.
+3) If a memory pointer was passed into the class constructor, this class will
+    not attempt to allocate. Otherwise, it will malloc() on first-use. The
+    required size for caller-supplied memory is given by memoryCost().
+4) A map that owns its memory may be allowed to grow. It will double its slot
+    count when it is 7/8 full. A map that does not grow will take elements
+    until every slot is full, and then refuse new keys.
+5) Pointers returned by get() are invalidated by any insert() or remove().
+*/
+
+#ifndef __C3P_HASH_MAP_H
+#define __C3P_HASH_MAP_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "StringBuilder.h"
+
+// Growth is the default on platforms where the heap is not a scarce resource.
+#if defined(__MANUVR_LINUX) || defined(__MANUVR_APPLE)
+  #define C3P_HASH_MAP_GROWS_BY_DEFAULT  true
+#else
+  #define C3P_HASH_MAP_GROWS_BY_DEFAULT  false
+#endif
+
+
+/*******************************************************************************
+* Hash functions
+*******************************************************************************/
+
+/* FNV-1a over a run of bytes. */
+inline uint32_t c3p_hash_bytes(const void* buf, const uint32_t LEN) {
+  const uint8_t* ptr = (const uint8_t*) buf;
+  uint32_t h = 2166136261UL;
+  for (uint32_t i = 0; i < LEN; i++) {
+    h = (h ^ *(ptr + i)) * 16777619UL;
+  }
+  return h;
+}
+
+/* FNV-1a over a null-terminated string, without a separate strlen(). */
+inline uint32_t c3p_hash_str(const char* str) {
+  uint32_t h = 2166136261UL;
+  if (nullptr != str) {
+    while (0 != *str) {
+      h = (h ^ (uint8_t) *str++) * 16777619UL;
+    }
+  }
+  return h;
+}
+
+/* Murmur3's finalizer. Integer keys are often sequential, and need mixing. */
+inline uint32_t c3p_hash_u32(uint32_t x) {
+  x ^= (x >> 16);
+  x *= 0x85EBCA6BUL;
+  x ^= (x >> 13);
+  x *= 0xC2B2AE35UL;
+  x ^= (x >> 16);
+  return x;
+}
+
+inline uint32_t c3p_hash_u64(uint64_t x) {
+  return c3p_hash_u32((uint32_t) x ^ c3p_hash_u32((uint32_t) (x >> 32)));
+}
+
+
+/*
+* How a key is hashed and compared. The default hashes the key's bytes, which
+*   suits plain structs without padding. Integers, pointers, and C-strings have
+*   specializations below. Other types may be specialized the same way.
+*/
+template <class K> struct C3PHashKey {
+  static inline uint32_t hash(const K& k) {                 return c3p_hash_bytes(&k, sizeof(K));  };
+  static inline bool     equal(const K& a, const K& b) {    return (a == b);                       };
+};
+
+#define __C3P_HASH_KEY_INT(TYPE, FXN) \
+  template <> struct C3PHashKey<TYPE> { \
+    static inline uint32_t hash(const TYPE& k) {               return FXN(k);    }; \
+    static inline bool     equal(const TYPE& a, const TYPE& b) {  return (a == b);  }; \
+  };
+
+__C3P_HASH_KEY_INT(uint8_t,  c3p_hash_u32)
+__C3P_HASH_KEY_INT(uint16_t, c3p_hash_u32)
+__C3P_HASH_KEY_INT(uint32_t, c3p_hash_u32)
+__C3P_HASH_KEY_INT(uint64_t, c3p_hash_u64)
+__C3P_HASH_KEY_INT(int8_t,   c3p_hash_u32)
+__C3P_HASH_KEY_INT(int16_t,  c3p_hash_u32)
+__C3P_HASH_KEY_INT(int32_t,  c3p_hash_u32)
+__C3P_HASH_KEY_INT(int64_t,  c3p_hash_u64)
+#undef __C3P_HASH_KEY_INT
+
+template <class T> struct C3PHashKey<T*> {
+  static inline uint32_t hash(T* const& k) {               return c3p_hash_u64((uint64_t) (uintptr_t) k);  };
+  static inline bool     equal(T* const& a, T* const& b) {  return (a == b);  };
+};
+
+template <> struct C3PHashKey<const char*> {
+  static inline uint32_t hash(const char* const& k) {  return c3p_hash_str(k);  };
+  static inline bool     equal(const char* const& a, const char* const& b) {
+    return ((a == b) || ((nullptr != a) && (nullptr != b) && (0 == strcmp(a, b))));
+  };
+};
+
+template <> struct C3PHashKey<char*> {
+  static inline uint32_t hash(char* const& k) {  return c3p_hash_str(k);  };
+  static inline bool     equal(char* const& a, char* const& b) {
+    return C3PHashKey<const char*>::equal(a, b);
+  };
+};
+
+
+/* The value type for a C3PHashSet. Takes no space in the table. */
+struct C3PHashNoValue {};
+
+template <class V> struct C3PHashValueSize {                  static const uint32_t SIZE = sizeof(V);  };
+template <> struct C3PHashValueSize<C3PHashNoValue> {         static const uint32_t SIZE = 0;          };
+
+
+
+/*******************************************************************************
+* C3PHashMap
+*******************************************************************************/
+
+template <class K, class V, class H = C3PHashKey<K>> class C3PHashMap {
+  public:
+    C3PHashMap(const uint32_t SLOTS, uint8_t* MEM = nullptr);
+    ~C3PHashMap();
+
+    bool     allocated();
+    int8_t   insert(const K&, const V&);   // 0 if added, 1 if replaced, -1 if no room.
+    V*       get(const K&);                // nullptr if absent.
+    int8_t   remove(const K&);             // 0 if removed, -1 if absent.
+    void     clear();
+
+    inline bool     contains(const K& k) {   return (_NONE != _find(k, _hash(k)));  };
+    inline uint32_t count() {                return _count;                         };
+    inline uint32_t capacity() {             return _slots;                         };
+    inline uint32_t grows() {                return _grows;                         };
+    inline uint32_t probeMax() {             return _probe_max;                     };
+    inline uint8_t  loadFactor() {           return (uint8_t) ((100ULL * _count) / _slots);  };
+    inline void     growable(bool x) {       _growable = x;                         };
+    inline bool     growable() {             return (_growable & (nullptr == _ext_mem));  };
+
+    /* Iteration by slot index. Empty slots return nullptr. */
+    inline K* keyAt(const uint32_t SLOT) {    return (_occupied(SLOT) ? (_keys + SLOT) : nullptr);  };
+    inline V* valueAt(const uint32_t SLOT) {  return ((_occupied(SLOT) && (0 < _V_SIZE)) ? (_vals + SLOT) : nullptr);  };
+
+    void printDebug(StringBuilder*);
+
+    static uint32_t memoryCost(const uint32_t SLOTS);
+
+
+  private:
+    static const uint32_t _NONE   = 0xFFFFFFFF;
+    static const uint32_t _V_SIZE = C3PHashValueSize<V>::SIZE;
+    uint8_t*  _ext_mem;       // Caller-supplied memory, if any.
+    uint8_t*  _mem;           // The table, as allocated or given.
+    uint32_t* _hashes;        // Zero if the slot is empty.
+    K*        _keys;
+    V*        _vals;          // nullptr if V takes no space.
+    uint32_t  _slots;         // Always a power of two.
+    uint32_t  _count;
+    uint32_t  _probe_max;     // The longest distance any element has been placed from home.
+    uint32_t  _grows;         // How many times has the table doubled?
+    bool      _growable;
+
+    static inline uint32_t _round_slots(const uint32_t SLOTS) {
+      uint32_t ret = 8;
+      while ((ret < SLOTS) && (ret < 0x80000000UL)) {  ret <<= 1;  }
+      return ret;
+    };
+    static inline uint32_t _pad(const uint32_t LEN) {  return ((LEN + 7) & ~((uint32_t) 7));  };
+
+    static inline uint32_t _hash(const K& k) {
+      const uint32_t HASH = H::hash(k);
+      return ((0 == HASH) ? 1 : HASH);   // Zero is reserved for empty slots.
+    };
+
+    /* How far the element in a slot is from the slot its hash maps to. */
+    inline uint32_t _dist(const uint32_t SLOT) {
+      return ((SLOT - _hashes[SLOT]) & (_slots - 1));
+    };
+    inline bool _occupied(const uint32_t SLOT) {
+      return ((SLOT < _slots) && (nullptr != _mem) && (0 != _hashes[SLOT]));
+    };
+
+    void     _carve(uint8_t* mem, const uint32_t SLOTS);
+    uint32_t _find(const K&, const uint32_t HASH);
+    void     _place(uint32_t hash, K key, V val);
+    int8_t   _grow();
+};
+
+
+/**
+* Constructor
+*
+* @param SLOTS is the number of slots, which will be rounded up to a power of two.
+* @param MEM is optional memory of at least memoryCost(SLOTS) bytes, aligned to 8.
+*/
+template <class K, class V, class H> C3PHashMap<K, V, H>::C3PHashMap(const uint32_t SLOTS, uint8_t* MEM) :
+  _ext_mem(MEM), _mem(nullptr), _hashes(nullptr), _keys(nullptr), _vals(nullptr),
+  _slots(_round_slots(SLOTS)), _count(0), _probe_max(0), _grows(0),
+  _growable(C3P_HASH_MAP_GROWS_BY_DEFAULT) {}
+
+
+/**
+* Destructor
+*/
+template <class K, class V, class H> C3PHashMap<K, V, H>::~C3PHashMap() {
+  if ((nullptr != _mem) & (_mem != _ext_mem)) {
+    free(_mem);
+  }
+  _mem = nullptr;
+}
+
+
+/**
+* How much memory a table of the given size requires.
+*
+* @param SLOTS is the number of slots, before rounding.
+* @return the number of bytes.
+*/
+template <class K, class V, class H> uint32_t C3PHashMap<K, V, H>::memoryCost(const uint32_t SLOTS) {
+  const uint32_t S = _round_slots(SLOTS);
+  return (_pad(S * sizeof(uint32_t)) + _pad(S * sizeof(K)) + (S * _V_SIZE));
+}
+
+
+/**
+* This class follows an allocate-on-demand pattern.
+*
+* @return true if the table is ready for use. False otherwise.
+*/
+template <class K, class V, class H> bool C3PHashMap<K, V, H>::allocated() {
+  if (nullptr == _mem) {
+    uint8_t* mem = _ext_mem;
+    if (nullptr == mem) {
+      mem = (uint8_t*) malloc(memoryCost(_slots));
+    }
+    if (nullptr != mem) {
+      _carve(mem, _slots);
+    }
+  }
+  return (nullptr != _mem);
+}
+
+
+/*
+* Point the arrays into the given memory, and mark every slot empty.
+*/
+template <class K, class V, class H> void C3PHashMap<K, V, H>::_carve(uint8_t* mem, const uint32_t SLOTS) {
+  _mem    = mem;
+  _slots  = SLOTS;
+  _hashes = (uint32_t*) mem;
+  _keys   = (K*) (mem + _pad(SLOTS * sizeof(uint32_t)));
+  _vals   = (0 < _V_SIZE) ? (V*) (mem + _pad(SLOTS * sizeof(uint32_t)) + _pad(SLOTS * sizeof(K))) : nullptr;
+  memset(_hashes, 0, (SLOTS * sizeof(uint32_t)));
+}
+
+
+/**
+* Empties the map without releasing its memory.
+*/
+template <class K, class V, class H> void C3PHashMap<K, V, H>::clear() {
+  if (nullptr != _mem) {
+    memset(_hashes, 0, (_slots * sizeof(uint32_t)));
+  }
+  _count     = 0;
+  _probe_max = 0;
+}
+
+
+/**
+* Adds a key to the map, or replaces the value of a key already present.
+*
+* @return 0 if the key was added, 1 if its value was replaced, or -1 if there was no room.
+*/
+template <class K, class V, class H> int8_t C3PHashMap<K, V, H>::insert(const K& key, const V& val) {
+  if (!allocated()) {
+    return -1;
+  }
+  const uint32_t HASH = _hash(key);
+  const uint32_t SLOT = _find(key, HASH);
+  if (_NONE != SLOT) {
+    if (0 < _V_SIZE) {
+      _vals[SLOT] = val;
+    }
+    return 1;
+  }
+  if (growable() && (_count >= (_slots - (_slots >> 3)))) {
+    _grow();   // Failure is not fatal while there is room.
+  }
+  if (_count >= _slots) {
+    return -1;
+  }
+  _place(HASH, key, val);
+  _count++;
+  return 0;
+}
+
+
+/**
+* Looks up a key.
+*
+* @return a pointer to the value in the table, or nullptr if the key is absent.
+*/
+template <class K, class V, class H> V* C3PHashMap<K, V, H>::get(const K& key) {
+  const uint32_t SLOT = _find(key, _hash(key));
+  return (((_NONE != SLOT) && (0 < _V_SIZE)) ? (_vals + SLOT) : nullptr);
+}
+
+
+/**
+* Removes a key, and shifts the rest of its probe run back by one slot.
+*
+* @return 0 if the key was removed, or -1 if it was absent.
+*/
+template <class K, class V, class H> int8_t C3PHashMap<K, V, H>::remove(const K& key) {
+  uint32_t slot = _find(key, _hash(key));
+  if (_NONE == slot) {
+    return -1;
+  }
+  const uint32_t MASK = (_slots - 1);
+  uint32_t nxt = ((slot + 1) & MASK);
+  while ((0 != _hashes[nxt]) && (0 != _dist(nxt))) {
+    _hashes[slot] = _hashes[nxt];
+    _keys[slot]   = _keys[nxt];
+    if (0 < _V_SIZE) {
+      _vals[slot] = _vals[nxt];
+    }
+    slot = nxt;
+    nxt  = ((nxt + 1) & MASK);
+  }
+  _hashes[slot] = 0;
+  _count--;
+  return 0;
+}
+
+
+/*
+* Find the slot holding a key. A run can be abandoned as soon as it reaches an
+*   element that is closer to home than the key would be, since the key would
+*   have displaced it.
+*
+* @return the slot index, or _NONE.
+*/
+template <class K, class V, class H> uint32_t C3PHashMap<K, V, H>::_find(const K& key, const uint32_t HASH) {
+  if ((0 == _count) || (nullptr == _mem)) {
+    return _NONE;
+  }
+  const uint32_t MASK = (_slots - 1);
+  uint32_t slot = (HASH & MASK);
+  for (uint32_t d = 0; d < _slots; d++) {
+    const uint32_t RESIDENT = _hashes[slot];
+    if ((0 == RESIDENT) || (_dist(slot) < d)) {
+      return _NONE;
+    }
+    if ((RESIDENT == HASH) && H::equal(_keys[slot], key)) {
+      return slot;
+    }
+    slot = ((slot + 1) & MASK);
+  }
+  return _NONE;
+}
+
+
+/*
+* Put an element into the table, which must have an empty slot and must not
+*   already hold the key. Whenever the element being carried is further from
+*   home than the resident, they trade places.
+*/
+template <class K, class V, class H> void C3PHashMap<K, V, H>::_place(uint32_t hash, K key, V val) {
+  const uint32_t MASK = (_slots - 1);
+  uint32_t slot = (hash & MASK);
+  uint32_t d    = 0;
+  while (0 != _hashes[slot]) {
+    const uint32_t RESIDENT_DIST = _dist(slot);
+    if (RESIDENT_DIST < d) {
+      if (d > _probe_max) {  _probe_max = d;  }
+      const uint32_t TMP_H = _hashes[slot];
+      const K        TMP_K = _keys[slot];
+      _hashes[slot] = hash;
+      _keys[slot]   = key;
+      hash = TMP_H;
+      key  = TMP_K;
+      if (0 < _V_SIZE) {
+        const V TMP_V = _vals[slot];
+        _vals[slot] = val;
+        val = TMP_V;
+      }
+      d = RESIDENT_DIST;
+    }
+    slot = ((slot + 1) & MASK);
+    d++;
+  }
+  if (d > _probe_max) {  _probe_max = d;  }
+  _hashes[slot] = hash;
+  _keys[slot]   = key;
+  if (0 < _V_SIZE) {
+    _vals[slot] = val;
+  }
+}
+
+
+/*
+* Double the table, and re-place everything in it. The stored hashes mean that
+*   no keys need to be hashed again.
+*
+* @return 0 on success, or -1 if the new table could not be allocated.
+*/
+template <class K, class V, class H> int8_t C3PHashMap<K, V, H>::_grow() {
+  const uint32_t NEW_SLOTS = (_slots << 1);
+  if (0 == NEW_SLOTS) {
+    return -1;
+  }
+  uint8_t* new_mem = (uint8_t*) malloc(memoryCost(NEW_SLOTS));
+  if (nullptr == new_mem) {
+    return -1;
+  }
+  uint8_t*  old_mem    = _mem;
+  uint32_t* old_hashes = _hashes;
+  K*        old_keys   = _keys;
+  V*        old_vals   = _vals;
+  const uint32_t OLD_SLOTS = _slots;
+  _carve(new_mem, NEW_SLOTS);
+  _probe_max = 0;
+  for (uint32_t i = 0; i < OLD_SLOTS; i++) {
+    if (0 != old_hashes[i]) {
+      _place(old_hashes[i], old_keys[i], ((0 < _V_SIZE) ? old_vals[i] : V()));
+    }
+  }
+  free(old_mem);   // Only growable tables get here, and they own their memory.
+  _grows++;
+  return 0;
+}
+
+
+/**
+* Prints the table's state and probe statistics.
+*/
+template <class K, class V, class H> void C3PHashMap<K, V, H>::printDebug(StringBuilder* output) {
+  output->concatf("C3PHashMap (%sReady)\n", allocated() ? "" : "Not ");
+  output->concatf("\tTable(%p): %u bytes (%s)\n", (uintptr_t) _mem, memoryCost(_slots), ((nullptr != _ext_mem) ? "external" : "heap"));
+  output->concatf("\tSlots:          %u/%u (%u%% load)\n", _count, _slots, loadFactor());
+  if (nullptr != _mem) {
+    uint32_t dist_sum = 0;
+    for (uint32_t i = 0; i < _slots; i++) {
+      if (0 != _hashes[i]) {  dist_sum += _dist(i);  }
+    }
+    output->concatf("\tProbe length:   %.2f mean, %u max\n", ((0 < _count) ? ((double) dist_sum / _count) : (double) 0), _probe_max);
+  }
+  if (growable()) {
+    output->concatf("\tGrows:          %u\n", _grows);
+  }
+  else {
+    output->concat("\tGrowth is disallowed.\n");
+  }
+}
+
+
+
+/*******************************************************************************
+* C3PHashSet
+*******************************************************************************/
+
+template <class K, class H = C3PHashKey<K>> class C3PHashSet {
+  public:
+    C3PHashSet(const uint32_t SLOTS, uint8_t* MEM = nullptr) : _map(SLOTS, MEM) {};
+    ~C3PHashSet() {};
+
+    inline bool     allocated() {             return _map.allocated();                       };
+    inline int8_t   insert(const K& k) {      return _map.insert(k, C3PHashNoValue());       };  // 0 if added, 1 if present, -1 if no room.
+    inline bool     contains(const K& k) {    return _map.contains(k);                       };
+    inline int8_t   remove(const K& k) {      return _map.remove(k);                         };
+    inline void     clear() {                 _map.clear();                                  };
+    inline uint32_t count() {                 return _map.count();                           };
+    inline uint32_t capacity() {              return _map.capacity();                        };
+    inline uint32_t grows() {                 return _map.grows();                           };
+    inline uint32_t probeMax() {              return _map.probeMax();                        };
+    inline uint8_t  loadFactor() {            return _map.loadFactor();                      };
+    inline void     growable(bool x) {        _map.growable(x);                              };
+    inline bool     growable() {              return _map.growable();                        };
+    inline K*       keyAt(const uint32_t S) { return _map.keyAt(S);                          };
+    inline void     printDebug(StringBuilder* output) {  _map.printDebug(output);            };
+
+    static uint32_t memoryCost(const uint32_t SLOTS) {  return C3PHashMap<K, C3PHashNoValue, H>::memoryCost(SLOTS);  };
+
+
+  private:
+    C3PHashMap<K, C3PHashNoValue, H> _map;
+};
+
+#endif  // __C3P_HASH_MAP_H
@@ -0,0 +1,363 @@
+/*
+File:   C3PMedian.h
+Author: J. Ian Lindsay
+Date:   2026.10.16
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Tools for finding the median of numeric data.
+
+c3p_median() is for one-shot blocks of data. It reorders the buffer it is
+  given, and finds the median in O(n) with quickselect.
+
+C3PRunningMedian is for sliding windows, such as ring buffers of samples. It
+  keeps a max-heap of the lower half of the window, and a min-heap of the upper
+  half, that share a root at the median. The heaps hold the indices of slots in
+  the caller's buffer, rather than copies of the values. When the caller
+  overwrites a slot, replace() restores the heaps in O(log n). The median can
+  then be read in O(1).
+  The heap arrays cost 8 bytes per slot, on the heap. The values themselves are
+  not copied, and so the caller's buffer must outlive the class, and must not
+  change without a call to replace() (for one slot) or init() (for many).
+
+For an even count, the median is the mean of the two middle values, taken in
+  the arithmetic of type T. This matches the rest of C3P.
+*/
+
+#ifndef __C3P_MEDIAN_H__
+#define __C3P_MEDIAN_H__
+
+#include <stdint.h>
+#include <stdlib.h>
+
+
+/*******************************************************************************
+* Selection on a one-shot block
+*******************************************************************************/
+
+/*
+* Partially order a buffer such that the value at index K is the one that would
+*   be there if the buffer were sorted. Everything before K will be no greater
+*   than it, and everything after K no less. O(n) on average.
+*
+* @param buf is the data to be reordered.
+* @param N is the number of values in the buffer.
+* @param K is the rank of the value sought, which must be less than N.
+* @return the value of rank K.
+*/
+template <class T> T c3p_select_nth(T* buf, const uint32_t N, const uint32_t K) {
+  int32_t lo = 0;
+  int32_t hi = (int32_t) N - 1;
+  while (lo < hi) {
+    // Median-of-three pivot. Sorting the three also leaves sentinels at either
+    //   end, so neither scan below can run off the partition.
+    const int32_t MID = lo + ((hi - lo) >> 1);
+    T swap;
+    if (buf[MID] < buf[lo]) {  swap = buf[MID];  buf[MID] = buf[lo];   buf[lo]  = swap;  }
+    if (buf[hi]  < buf[lo]) {  swap = buf[hi];   buf[hi]  = buf[lo];   buf[lo]  = swap;  }
+    if (buf[hi]  < buf[MID]) { swap = buf[hi];   buf[hi]  = buf[MID];  buf[MID] = swap;  }
+    const T PIVOT = buf[MID];
+    int32_t i = lo;
+    int32_t j = hi;
+    while (i <= j) {
+      // Stopping on equal values keeps runs of duplicates from degrading the
+      //   partition.
+      while (buf[i] < PIVOT) i++;
+      while (PIVOT < buf[j]) j--;
+      if (i <= j) {
+        swap = buf[i];  buf[i] = buf[j];  buf[j] = swap;
+        i++;
+        j--;
+      }
+    }
+    if ((int32_t) K <= j) {       hi = j;   }
+    else if ((int32_t) K >= i) {  lo = i;   }
+    else {                        break;    }  // K is among values equal to the pivot.
+  }
+  return buf[K];
+}
+
+
+/*
+* Find the two middle values of a buffer, reordering it in the process. For an
+*   odd count, both will be the same value.
+*
+* @param buf is the data to be reordered.
+* @param N is the number of values in the buffer, which must be nonzero.
+* @param lower will receive the lower middle value.
+* @param upper will receive the upper middle value.
+*/
+template <class T> void c3p_select_middles(T* buf, const uint32_t N, T* lower, T* upper) {
+  const uint32_t UPPER_IDX = (N >> 1);
+  *upper = c3p_select_nth(buf, N, UPPER_IDX);
+  *lower = *upper;
+  if (0 == (N & 1)) {
+    // Selection left everything below the upper middle no greater than it. So
+    //   the lower middle is the largest of those.
+    *lower = buf[0];
+    for (uint32_t i = 1; i < UPPER_IDX; i++) {
+      if (*lower < buf[i]) *lower = buf[i];
+    }
+  }
+}
+
+
+/*
+* Find the median of a buffer, reordering it in the process.
+*
+* @param buf is the data to be reordered.
+* @param N is the number of values in the buffer.
+* @return the median, or zero if the buffer is empty.
+*/
+template <class T> T c3p_median(T* buf, const uint32_t N) {
+  if ((nullptr == buf) || (0 == N)) {
+    return T(0);
+  }
+  T lower;
+  T upper;
+  c3p_select_middles(buf, N, &lower, &upper);
+  return ((N & 1) ? upper : (T) ((upper + lower) / 2));
+}
+
+
+
+/*******************************************************************************
+* Running median over a sliding window
+*******************************************************************************/
+
+template <class T> class C3PRunningMedian {
+  public:
+    C3PRunningMedian() {};
+    ~C3PRunningMedian();
+
+    int8_t init(const T* DATA, const uint32_t N, const uint32_t STRIDE = 1);
+    void   replace(const uint32_t SLOT, const T OLD_VAL);
+
+    inline bool     initialized() {  return (nullptr != _data);   };
+    inline uint32_t count() {        return _ct;                  };
+    inline T        upperMedian() {  return ((0 < _ct) ? _val(0) : T(0));  };
+    inline T        lowerMedian() {  return ((0 < _ct) ? _val((_ct & 1) ? 0 : -1) : T(0));  };
+    inline T        median() {
+      if (0 == _ct) {   return T(0);     }
+      if (_ct & 1) {    return _val(0);  }
+      return (T) ((_val(0) + _val(-1)) / 2);
+    };
+
+
+  private:
+    const T* _data   = nullptr;
+    int32_t* _mem    = nullptr;  // The allocation holding both arrays below.
+    int32_t* _pos    = nullptr;  // The heap position of each slot.
+    int32_t* _heap   = nullptr;  // Slots by heap position. Centered on the median.
+    uint32_t _n      = 0;        // Slots in the window.
+    uint32_t _stride = 1;        // Elements between successive slots in _data.
+    uint32_t _ct     = 0;        // Slots in the heaps. Equal to _n, outside of init().
+
+    /*
+    * Positive positions are the min-heap of the upper half, and negative ones
+    *   are the max-heap of the lower half. The children of position i are at
+    *   2i and 2i+1 (or 2i-1). Division truncates toward zero, so i/2 is the
+    *   parent on either side.
+    */
+    inline T       _val(const int32_t P) {   return _data[(uint32_t) _heap[P] * _stride];  };
+    inline bool    _less(const int32_t P0, const int32_t P1) {  return (_val(P0) < _val(P1));  };
+    inline int32_t _min_ct() {   return (((int32_t) _ct - 1) / 2);  };
+    inline int32_t _max_ct() {   return ((int32_t) _ct / 2);        };
+
+    bool _exchange_if_less(const int32_t P0, const int32_t P1);
+    void _min_sort_down(int32_t p);
+    void _max_sort_down(int32_t p);
+    bool _min_sort_up(int32_t p);
+    bool _max_sort_up(int32_t p);
+    void _sift(const int32_t P);
+};
+
+
+template <class T> C3PRunningMedian<T>::~C3PRunningMedian() {
+  _data = nullptr;
+  if (nullptr != _mem) {
+    int32_t* tmp = _mem;
+    _mem = nullptr;
+    free(tmp);
+  }
+}
+
+
+/*
+* Take the values in a buffer as a new window, and build the heaps from them.
+*   This costs O(n log n), and must be called again whenever the caller changes
+*   the buffer by means other than replace(). Memory is only reallocated if the
+*   window changes size.
+*
+* @param DATA is the caller's buffer.
+* @param N is the number of slots in the window.
+* @param STRIDE is the number of elements of type T between slots. Allows one
+*   axis of an array of vectors to be tracked in place.
+* @return 0 on success, or -1 on bad arguments or allocation failure.
+*/
+template <class T> int8_t C3PRunningMedian<T>::init(const T* DATA, const uint32_t N, const uint32_t STRIDE) {
+  _data = nullptr;
+  _ct   = 0;
+  if ((nullptr == DATA) || (0 == N) || (0 == STRIDE) || (N > (INT32_MAX >> 1))) {
+    return -1;
+  }
+  if (N != _n) {
+    if (nullptr != _mem) {
+      free(_mem);
+    }
+    _mem = (int32_t*) malloc((N << 1) * sizeof(int32_t));
+    if (nullptr == _mem) {
+      _n = 0;
+      return -1;
+    }
+    _n = N;
+  }
+  _data   = DATA;
+  _stride = STRIDE;
+  _pos    = _mem;
+  _heap   = (_mem + _n + (_n >> 1));   // Positions run from -(n/2) to (n-1)/2.
+
+  // Lay out the slots alternately around the median, so that each one fed
+  //   below lands at the edge of the heap that is growing.
+  for (uint32_t s = 0; s < _n; s++) {
+    const int32_t P = (int32_t) ((s + 1) >> 1) * ((s & 1) ? -1 : 1);
+    _pos[s]  = P;
+    _heap[P] = (int32_t) s;
+  }
+  for (uint32_t s = 0; s < _n; s++) {
+    _ct++;
+    _sift(_pos[s]);
+  }
+  return 0;
+}
+
+
+/*
+* Restore the heaps after the caller has written a new value into a slot.
+*
+* @param SLOT is the index of the slot that was written.
+* @param OLD_VAL is the value that the slot held before.
+*/
+template <class T> void C3PRunningMedian<T>::replace(const uint32_t SLOT, const T OLD_VAL) {
+  if ((nullptr == _data) || (SLOT >= _n)) {
+    return;
+  }
+  const int32_t P       = _pos[SLOT];
+  const T       NEW_VAL = _data[SLOT * _stride];
+  if (P > 0) {
+    // A value that grew can only move away from the median.
+    if (OLD_VAL < NEW_VAL) {    _min_sort_down(P * 2);    }
+    else {                      _sift(P);                 }
+  }
+  else if (P < 0) {
+    if (NEW_VAL < OLD_VAL) {    _max_sort_down(P * 2);    }
+    else {                      _sift(P);                 }
+  }
+  else {
+    _sift(P);
+  }
+}
+
+
+/*
+* Swap two heap positions if the value at the first is less than the value at
+*   the second, keeping the slot index current.
+*
+* @return true if a swap was made.
+*/
+template <class T> bool C3PRunningMedian<T>::_exchange_if_less(const int32_t P0, const int32_t P1) {
+  if (_less(P0, P1)) {
+    const int32_t SLOT = _heap[P0];
+    _heap[P0] = _heap[P1];
+    _heap[P1] = SLOT;
+    _pos[_heap[P0]] = P0;
+    _pos[_heap[P1]] = P1;
+    return true;
+  }
+  return false;
+}
+
+
+/* Restore the min-heap below a position, starting from the child given. */
+template <class T> void C3PRunningMedian<T>::_min_sort_down(int32_t p) {
+  for (; p <= _min_ct(); p *= 2) {
+    if ((p > 1) && (p < _min_ct()) && _less(p + 1, p)) {
+      p++;
+    }
+    if (!_exchange_if_less(p, p / 2)) {
+      break;
+    }
+  }
+}
+
+
+/* Restore the max-heap below a position, starting from the child given. */
+template <class T> void C3PRunningMedian<T>::_max_sort_down(int32_t p) {
+  for (; p >= -_max_ct(); p *= 2) {
+    if ((p < -1) && (p > -_max_ct()) && _less(p, p - 1)) {
+      p--;
+    }
+    if (!_exchange_if_less(p / 2, p)) {
+      break;
+    }
+  }
+}
+
+
+/*
+* Move a value in the min-heap toward the median, as far as it belongs.
+*
+* @return true if the value became the median.
+*/
+template <class T> bool C3PRunningMedian<T>::_min_sort_up(int32_t p) {
+  while ((p > 0) && _exchange_if_less(p, p / 2)) {
+    p /= 2;
+  }
+  return (0 == p);
+}
+
+
+/*
+* Move a value in the max-heap toward the median, as far as it belongs.
+*
+* @return true if the value became the median.
+*/
+template <class T> bool C3PRunningMedian<T>::_max_sort_up(int32_t p) {
+  while ((p < 0) && _exchange_if_less(p / 2, p)) {
+    p /= 2;
+  }
+  return (0 == p);
+}
+
+
+/*
+* Move a value toward the median. If it displaces the median, the old median
+*   is pushed down the other heap.
+*/
+template <class T> void C3PRunningMedian<T>::_sift(const int32_t P) {
+  if (P > 0) {
+    if (_min_sort_up(P)) {  _max_sort_down(-1);  }
+  }
+  else if (P < 0) {
+    if (_max_sort_up(P)) {  _min_sort_down(1);   }
+  }
+  else {
+    if (0 < _max_ct()) {    _max_sort_down(-1);  }
+    if (0 < _min_ct()) {    _min_sort_down(1);   }
+  }
+}
+
+#endif  // __C3P_MEDIAN_H__
@@ -0,0 +1,175 @@
+/*
+File:   C3PSlidingMinMax.h
+Author: J. Ian Lindsay
+Date:   2026.10.16
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+A template for the minimum and maximum of a sliding window, such as a ring
+  buffer of samples.
+
+Two monotonic deques hold the indices of slots in the caller's buffer, in the
+  order the slots were written. The min deque only holds slots whose values
+  rise from front to back, and the max deque only slots whose values fall. So
+  the extremes are always at the fronts. A slot is dropped from the back once a
+  newer value makes it irrelevant, and from the front once it is overwritten.
+  Each slot enters and leaves each deque at most once, so push() is amortized
+  O(1), and the extremes are read in O(1).
+
+The deques cost 8 bytes per slot, on the heap. The values are not copied, so
+  the caller's buffer must outlive the class. The caller must write slots in
+  ring order, calling push() after each, and must call init() again after
+  changing the buffer by any other means.
+*/
+
+#ifndef __C3P_SLIDING_MIN_MAX_H__
+#define __C3P_SLIDING_MIN_MAX_H__
+
+#include <stdint.h>
+#include <stdlib.h>
+
+
+template <class T> class C3PSlidingMinMax {
+  public:
+    C3PSlidingMinMax() {};
+    ~C3PSlidingMinMax();
+
+    int8_t init(const T* DATA, const uint32_t N, const uint32_t OLDEST_SLOT = 0, const uint32_t STRIDE = 1);
+    void   push(const uint32_t SLOT);
+
+    inline bool     initialized() {   return (nullptr != _data);   };
+    inline T        minValue() {      return ((nullptr != _data) ? _val(_min_q[_min_head]) : T(0));  };
+    inline T        maxValue() {      return ((nullptr != _data) ? _val(_max_q[_max_head]) : T(0));  };
+
+
+  private:
+    const T*  _data     = nullptr;
+    uint32_t* _min_q    = nullptr;  // Also the allocation that holds _max_q.
+    uint32_t* _max_q    = nullptr;
+    uint32_t  _n        = 0;        // Slots in the window, and the capacity of each deque.
+    uint32_t  _stride   = 1;        // Elements between successive slots in _data.
+    uint32_t  _min_head = 0;
+    uint32_t  _min_ct   = 0;
+    uint32_t  _max_head = 0;
+    uint32_t  _max_ct   = 0;
+
+    inline T        _val(const uint32_t SLOT) {   return _data[SLOT * _stride];  };
+    inline uint32_t _back(const uint32_t HEAD, const uint32_t CT) {
+      const uint32_t IDX = (HEAD + CT - 1);
+      return ((IDX >= _n) ? (IDX - _n) : IDX);
+    };
+    void _append(const uint32_t SLOT);
+};
+
+
+template <class T> C3PSlidingMinMax<T>::~C3PSlidingMinMax() {
+  _data = nullptr;
+  if (nullptr != _min_q) {
+    uint32_t* tmp = _min_q;
+    _min_q = nullptr;
+    _max_q = nullptr;
+    free(tmp);
+  }
+}
+
+
+/*
+* Take the values in a buffer as a new window, and build the deques from them in
+*   O(n). Memory is only reallocated if the window changes size.
+*
+* @param DATA is the caller's buffer.
+* @param N is the number of slots in the window.
+* @param OLDEST_SLOT is the slot holding the oldest value, which is the next
+*   one to be overwritten.
+* @param STRIDE is the number of elements of type T between slots.
+* @return 0 on success, or -1 on bad arguments or allocation failure.
+*/
+template <class T> int8_t C3PSlidingMinMax<T>::init(const T* DATA, const uint32_t N, const uint32_t OLDEST_SLOT, const uint32_t STRIDE) {
+  _data = nullptr;
+  if ((nullptr == DATA) || (0 == N) || (OLDEST_SLOT >= N) || (0 == STRIDE)) {
+    return -1;
+  }
+  if (N != _n) {
+    if (nullptr != _min_q) {
+      free(_min_q);
+    }
+    _min_q = (uint32_t*) malloc((N << 1) * sizeof(uint32_t));
+    if (nullptr == _min_q) {
+      _max_q = nullptr;
+      _n     = 0;
+      return -1;
+    }
+    _max_q = (_min_q + N);
+    _n     = N;
+  }
+  _data     = DATA;
+  _stride   = STRIDE;
+  _min_head = 0;
+  _min_ct   = 0;
+  _max_head = 0;
+  _max_ct   = 0;
+  for (uint32_t i = 0; i < _n; i++) {
+    const uint32_t SLOT = (OLDEST_SLOT + i);
+    _append((SLOT >= _n) ? (SLOT - _n) : SLOT);
+  }
+  return 0;
+}
+
+
+/*
+* Account for a new value that the caller has written into a slot. The slot
+*   must be the one that held the oldest value.
+*
+* @param SLOT is the index of the slot that was written.
+*/
+template <class T> void C3PSlidingMinMax<T>::push(const uint32_t SLOT) {
+  if ((nullptr == _data) || (SLOT >= _n)) {
+    return;
+  }
+  // The value that was overwritten was the oldest in the window. If it was
+  //   still in a deque, it was at the front.
+  if ((0 < _min_ct) && (SLOT == _min_q[_min_head])) {
+    _min_head = (((_min_head + 1) >= _n) ? 0 : (_min_head + 1));
+    _min_ct--;
+  }
+  if ((0 < _max_ct) && (SLOT == _max_q[_max_head])) {
+    _max_head = (((_max_head + 1) >= _n) ? 0 : (_max_head + 1));
+    _max_ct--;
+  }
+  _append(SLOT);
+}
+
+
+/*
+* Add the newest slot to the back of both deques, first dropping any slots that
+*   it outranks. Ties go to the newer slot, since it will stay in the window
+*   longer.
+*/
+template <class T> void C3PSlidingMinMax<T>::_append(const uint32_t SLOT) {
+  const T VAL = _val(SLOT);
+  while ((0 < _min_ct) && !(_val(_min_q[_back(_min_head, _min_ct)]) < VAL)) {
+    _min_ct--;
+  }
+  _min_q[_back(_min_head, _min_ct + 1)] = SLOT;
+  _min_ct++;
+  while ((0 < _max_ct) && !(VAL < _val(_max_q[_back(_max_head, _max_ct)]))) {
+    _max_ct--;
+  }
+  _max_q[_back(_max_head, _max_ct + 1)] = SLOT;
+  _max_ct++;
+}
+
+#endif  // __C3P_SLIDING_MIN_MAX_H__
@@ -10,6 +10,11 @@ This class was intended to be extended by a class that held arbitrarilly-sized
   collections of numeric elements. With a little cooperation from the child
   class, it avoids spending more time than strictly necessary to calculate
   stats. Given the datasets, that might be a substantial amount of time.
+
+Min, max, mean, RMS, and stdev all come from a single pass over the samples,
+  which is vectorized for the common types (see Meta/Intrinsics.h). The sums in
+  that pass are kept in type ACC, which defaults to an exact integer for narrow
+  integer types, and to double otherwise.
 */
 
 #ifndef __C3P_STATBLOCK_H__
@@ -17,6 +22,8 @@ This class was intended to be extended by a class that held arbitrarilly-sized
 
 #include "CppPotpourri.h"
 #include "StringBuilder.h"
+#include "C3PMedian.h"
+#include "Meta/Intrinsics.h"
 
 #define STATBLOCK_FLAG_VALID_SNR      0x04  // Statistical measurement is valid.
 #define STATBLOCK_FLAG_VALID_MINMAX   0x08  // Statistical measurement is valid.
@@ -32,7 +39,7 @@ This class was intended to be extended by a class that held arbitrarilly-sized
 
 
 
-template <class T> class C3PStatBlock {
+template <class T, class ACC = typename C3PReductionAccumulator<T>::type> class C3PStatBlock {
   public:
     inline void     invalidateStats() {    _set_flags(false, STATBLOCK_FLAG_MASK_ALL_STATS);  };
 
@@ -72,6 +79,7 @@ template <class T> class C3PStatBlock {
     int8_t  _calculate_stdev();
     int8_t  _calculate_median();
     int8_t  _calculate_snr();
+    int8_t  _calculate_fused();
 
     void _print_stats(StringBuilder*);
 
@@ -92,7 +100,7 @@ template <class T> class C3PStatBlock {
 
 
 
-template <class T> void C3PStatBlock<T>::_print_stats(StringBuilder* output) {
+template <class T, class ACC> void C3PStatBlock<T, ACC>::_print_stats(StringBuilder* output) {
   C3PType* t_helper = getTypeHelper(tcodeForType(T(0)));
   StringBuilder tmp_sb;
 
@@ -123,7 +131,7 @@ template <class T> void C3PStatBlock<T>::_print_stats(StringBuilder* output) {
 *   its memory range, this function will need to be called, or crashes will
 *   happen.
 */
-template <class T> int8_t C3PStatBlock<T>::_set_stat_source_data(T* buf, const uint32_t N_VAL) {
+template <class T, class ACC> int8_t C3PStatBlock<T, ACC>::_set_stat_source_data(T* buf, const uint32_t N_VAL) {
   _samples = buf;
   _n = N_VAL;
   return (((N_VAL > 1) && (nullptr != buf)) ? 0 : -1);
@@ -131,93 +139,85 @@ template <class T> int8_t C3PStatBlock<T>::_set_stat_source_data(T* buf, const u
 
 
 /**
-* Calulates the min/max over the entire sample window.
-* Updates the private cache variable.
+* Calulates the min/max, mean, RMS, and stdev in a single pass over the samples.
+* Updates the private cache variables.
 *
-* @return 0 on success, -1 if the window isn't full.
+* The stdev is taken from the same sums, unless the mean is so large compared
+*   to the spread that the subtraction would cancel away too much precision. In
+*   that case, a second pass is made around the mean.
+*
+* NOTE: Since it is not concerned with extimating stdev against a wider
+*   population, this implementation does not use Bessel's correction.
+*   https://en.wikipedia.org/wiki/Bessel%27s_correction
+*
+* @return 0 on success, -1 if there are no samples.
 */
-template <class T> int8_t C3PStatBlock<T>::_calculate_minmax() {
+template <class T, class ACC> int8_t C3PStatBlock<T, ACC>::_calculate_fused() {
   int8_t ret = -1;
-  if (nullptr != _samples) {
+  C3PReduction<T, ACC> result;
+  if (0 == c3p_reduce<T, ACC>(_samples, _n, &result)) {
     ret = 0;
-    _min_value = _samples[0];  // Start with a baseline.
-    _max_value = _samples[0];  // Start with a baseline.
-    for (uint32_t i = 1; i < _n; i++) {
-      if (_samples[i] > _max_value) _max_value = _samples[i];
-      else if (_samples[i] < _min_value) _min_value = _samples[i];
+    const double MEAN     = ((double) result.sum / _n);
+    const double MEAN_SQ  = ((double) result.sum_sq / _n);
+    const double VARIANCE = (MEAN_SQ - (MEAN * MEAN));
+    _min_value = result.min_value;
+    _max_value = result.max_value;
+    _mean      = MEAN;
+    _rms       = sqrt(MEAN_SQ);
+    if (VARIANCE > (MEAN_SQ / 10000)) {
+      _stdev = sqrt(VARIANCE);
     }
-    _set_flags(true, STATBLOCK_FLAG_VALID_MINMAX);
+    else {
+      double deviation_sum = 0.0;
+      for (uint32_t i = 0; i < _n; i++) {
+        const double DEV = ((double) _samples[i] - _mean);
+        deviation_sum += (DEV * DEV);
+      }
+      _stdev = sqrt(deviation_sum / _n);
+    }
+    _set_flags(true, (STATBLOCK_FLAG_VALID_MINMAX | STATBLOCK_FLAG_VALID_MEAN | STATBLOCK_FLAG_VALID_RMS | STATBLOCK_FLAG_VALID_STDEV));
   }
   return ret;
 }
 
 
+/**
+* Calulates the min/max over the entire sample window.
+*
+* @return 0 on success, -1 if there are no samples.
+*/
+template <class T, class ACC> int8_t C3PStatBlock<T, ACC>::_calculate_minmax() {
+  return _calculate_fused();
+}
+
+
 /**
 * Calulates the statistical mean over the entire sample window.
-* Updates the private cache variable.
 *
-* @return 0 on success, -1 if the window isn't full.
+* @return 0 on success, -1 if there are no samples.
 */
-template <class T> int8_t C3PStatBlock<T>::_calculate_mean() {
-  int8_t ret = -1;
-  if (nullptr != _samples) {
-    ret = 0;
-    double summed_samples = 0.0;
-    for (uint32_t i = 0; i < _n; i++) {
-      summed_samples += (double) _samples[i];
-    }
-    _mean = (summed_samples / _n);
-    _set_flags(true, STATBLOCK_FLAG_VALID_MEAN);
-  }
-  return ret;
+template <class T, class ACC> int8_t C3PStatBlock<T, ACC>::_calculate_mean() {
+  return _calculate_fused();
 }
 
 
 /**
 * Calulates the RMS over the entire sample window.
-* Updates the private cache variable.
 *
-* @return 0 on success, -1 if the window isn't full.
+* @return 0 on success, -1 if there are no samples.
 */
-template <class T> int8_t C3PStatBlock<T>::_calculate_rms() {
-  int8_t ret = -1;
-  if (nullptr != _samples) {
-    ret = 0;
-    double squared_samples = 0.0;
-    for (uint32_t i = 0; i < _n; i++) {
-      squared_samples += pow((double) _samples[i], 2.0);
-    }
-    _rms = sqrt(squared_samples / _n);
-    _set_flags(true, STATBLOCK_FLAG_VALID_RMS);
-  }
-  return ret;
+template <class T, class ACC> int8_t C3PStatBlock<T, ACC>::_calculate_rms() {
+  return _calculate_fused();
 }
 
 
 /**
 * Calulates the standard deviation of the samples.
-* Updates the private cache variable.
 *
-* NOTE: Since it is not concerned with extimating stdev against a wider
-*   population, this implementation does not use Bessel's correction.
-*   https://en.wikipedia.org/wiki/Bessel%27s_correction
-*
-* @return 0 on success, -1 if the window isn't full.
+* @return 0 on success, -1 if there are no samples.
 */
-template <class T> int8_t C3PStatBlock<T>::_calculate_stdev() {
-  int8_t ret = -1;
-  if (nullptr != _samples) {
-    ret = 0;
-    double deviation_sum = 0.0;
-    double cached_mean = mean();
-    for (uint32_t i = 0; i < _n; i++) {
-      double tmp = ((double) _samples[i] - cached_mean);
-      deviation_sum += pow((double) tmp, 2.0);
-    }
-    _stdev = sqrt(deviation_sum / _n);
-    _set_flags(true, STATBLOCK_FLAG_VALID_STDEV);
-  }
-  return ret;
+template <class T, class ACC> int8_t C3PStatBlock<T, ACC>::_calculate_stdev() {
+  return _calculate_fused();
 }
 
 
@@ -225,42 +225,22 @@ template <class T> int8_t C3PStatBlock<T>::_calculate_stdev() {
 * Calulates the median value of the samples.
 * Updates the private cache variable.
 *
-* @return 0 on success, -1 if the window isn't full.
+* The samples aren't ours to reorder, so this selects from a copy on the heap,
+*   in O(n).
+*
+* @return 0 on success, -1 if there are no samples, or no memory for the copy.
 */
-template <class T> int8_t C3PStatBlock<T>::_calculate_median() {
+template <class T, class ACC> int8_t C3PStatBlock<T, ACC>::_calculate_median() {
   int8_t ret = -1;
-  if (nullptr != _samples) {
-    ret = 0;
-    T sorted[_n];
-    for (uint32_t i = 0; i < _n; i++) {
-      sorted[i] = _samples[i];
-    }
-    // Selection sort.
-    uint32_t i  = 0;
-    T swap;
-    for (uint32_t c = 0; c < (_n - 1); c++) {
-      i = c;
-      for (uint32_t d = c + 1; d < _n; d++) {
-        if (sorted[i] > sorted[d]) i = d;
-      }
-      if (i != c) {
-        swap = sorted[c];
-        sorted[c] = sorted[i];
-        sorted[i] = swap;
-      }
-    }
-
-    if (_n & 0x01) {
-      // If there are an odd number of samples...
-      _median = sorted[(_n-1) >> 1];
-    }
-    else {
-      // ...otherwise, we take the mean to the two middle values.
-      uint32_t lower = (_n-1) >> 1;
-      uint32_t upper = lower + 1;
-      _median = (sorted[upper] + sorted[lower]) / 2;
+  if ((nullptr != _samples) && (0 < _n)) {
+    T* scratch = (T*) malloc(_n * sizeof(T));
+    if (nullptr != scratch) {
+      memcpy(scratch, _samples, (_n * sizeof(T)));
+      _median = c3p_median(scratch, _n);
+      free(scratch);
+      _set_flags(true, STATBLOCK_FLAG_VALID_MEDIAN);
+      ret = 0;
     }
-    _set_flags(true, STATBLOCK_FLAG_VALID_MEDIAN);
   }
   return ret;
 }
@@ -271,11 +251,13 @@ template <class T> int8_t C3PStatBlock<T>::_calculate_median() {
 *
 * @return 0 on success, -1 if the window isn't full.
 */
-template <class T> int8_t C3PStatBlock<T>::_calculate_snr() {
+template <class T, class ACC> int8_t C3PStatBlock<T, ACC>::_calculate_snr() {
   int8_t ret = -1;
   if (nullptr != _samples) {
     ret = 0;
-    _snr = (pow(mean(), 2.0) / pow(stdev(), 2.0));
+    const double MEAN  = mean();
+    const double STDEV = stdev();
+    _snr = ((MEAN * MEAN) / (STDEV * STDEV));
     _set_flags(true, STATBLOCK_FLAG_VALID_SNR);
   }
   return ret;
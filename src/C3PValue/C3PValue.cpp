@@ -21,6 +21,7 @@ limitations under the License.
 #include "C3PValue.h"
 #include "KeyValuePair.h"
 #include "../StringBuilder.h"
+#include "../SlabAllocator.h"
 #include "../TimerTools/TimerTools.h"
 #include "../Identity/Identity.h"
 #include "../AbstractPlatform.h"   // Only needed for logging.
@@ -48,6 +49,41 @@ const char* const LOCAL_LOG_TAG = "C3PValue";
 * Static members and initializers should be located here.
 *******************************************************************************/
 
+SlabAllocator* C3PValue::_allocator = nullptr;
+
+/**
+* Sets the optional source for the memory that values allocate for themselves.
+*   Memory is returned to whichever allocator is set when it is freed, so this
+*   will not change the allocator while the current one still has blocks out.
+*
+* @param x is the allocator to use, or nullptr for the heap.
+* @return 0 on success, or -1 if the current allocator has blocks in use.
+*/
+int8_t C3PValue::allocator(SlabAllocator* x) {
+  if ((nullptr != _allocator) && (x != _allocator) && (0 < _allocator->blocksInUse())) {
+    return -1;
+  }
+  _allocator = x;
+  return 0;
+}
+
+/*
+* All memory that values allocate for themselves comes through here. If an
+*   allocator was given, it is used. Otherwise, the heap.
+*/
+void* C3PValue::_mem_take(const uint32_t LEN) {
+  return ((nullptr != _allocator) ? _allocator->take(LEN) : malloc(LEN));
+}
+
+/*
+* Returns memory to wherever it came from. The allocator will free() anything
+*   that it didn't issue, so this is also safe for buffers that were adopted.
+*/
+void C3PValue::_mem_give(void* mem) {
+  if (nullptr != _allocator) {  _allocator->give(mem);  }
+  else {                        free(mem);              }
+}
+
 /**
 * We are being asked to inflate a C3PValue object from an unknown string of a
 *   known format.
@@ -136,7 +172,7 @@ C3PValue::C3PValue(const TCode TC, void* ptr, uint8_t mem_flgs)
       //   value-by-copy types must be fixed-length.
       const uint32_t TYPE_STORAGE_SIZE = t_helper->length(nullptr);
       if (0 < TYPE_STORAGE_SIZE) {
-        _target_mem = malloc(TYPE_STORAGE_SIZE);
+        _target_mem = _mem_take(TYPE_STORAGE_SIZE);
         if (nullptr != _target_mem) {
           reapValue(true);  // We will free this memory upon our own destruction.
           if (nullptr == ptr) {
@@ -161,7 +197,7 @@ C3PValue::C3PValue(const TCode TC, void* ptr, uint8_t mem_flgs)
       // The compound pointer-length types (BINARY, CBOR, etc) will have an
       //   indirected shim object to consolidate their parameter space into a
       //   single reference. That shim will be heap allocated.
-      _target_mem = malloc(sizeof(C3PBinBinder));
+      _target_mem = _mem_take(sizeof(C3PBinBinder));
       if (nullptr != _target_mem) {
         //((C3PBinBinder*) _target_mem)->tcode = TC;
         _set_flags(true, C3PVAL_MEM_FLAG_VALUE_BY_REF);
@@ -222,22 +258,22 @@ C3PValue::~C3PValue() {
       //   construe reapValue() to refer to the data itself, and not the shim.
       //   We will always free the shim.
       if (reapValue()) {
-        free(((C3PBinBinder*) _target_mem)->buf);  // We might be responsible for this.
+        _mem_give(((C3PBinBinder*) _target_mem)->buf);  // We might be responsible for this.
       }
-      free(_target_mem);  // We are always responsible for this.
+      _mem_give(_target_mem);  // We are always responsible for this.
     }
     else if (!_is_val_by_ref()) {
       if (!_is_ptr_punned()) {
         // In cases where we allocated the memory by this class for the sake of
         //   facilitating value-by-copy, we will free it, regardless of what
         //   reapValue() has to say about it.
-        free(_target_mem);
+        _mem_give(_target_mem);
       }
     }
     else if (reapValue()) {
       C3PType* t_helper = getTypeHelper(_TCODE);
       if ((nullptr == t_helper) || (0 > t_helper->destruct(_target_mem))) {
-        free(_target_mem);  // No destructor semantics. Just free.
+        _mem_give(_target_mem);  // No destructor semantics. Just free.
       }
     }
     _target_mem = nullptr;
@@ -266,7 +302,7 @@ C3PValue::C3PValue(float val) : C3PValue(TCode::FLOAT, nullptr) {
 C3PValue::C3PValue(char* val) : C3PValue(TCode::STR, nullptr) {
   if (nullptr != val) {
     const uint32_t VAL_LENGTH = strlen(val);
-    _target_mem = malloc(VAL_LENGTH + 1);
+    _target_mem = _mem_take(VAL_LENGTH + 1);
     if (nullptr != _target_mem) {
       memcpy(_target_mem, val, VAL_LENGTH);
       *((char*)_target_mem + VAL_LENGTH) = 0;
@@ -896,7 +932,7 @@ C3PValue* C3PValueDecoder::_next(uint32_t* offset) {
 
       case 2:  // Raw bytes
         if (HAVE_EXTRA_LEN) {
-          uint8_t* new_buf = (uint8_t*) malloc(_length_extra32);
+          uint8_t* new_buf = (uint8_t*) C3PValue::_mem_take(_length_extra32);
           if (nullptr != new_buf) {
             if ((int32_t) _length_extra32 == _in->copyToBuffer(new_buf, _length_extra32, local_offset)) {
               value = new C3PValue(new_buf, _length_extra32);
@@ -906,7 +942,7 @@ C3PValue* C3PValueDecoder::_next(uint32_t* offset) {
               }
             }
             if (nullptr == value) {
-              free(new_buf);  // Clean up any malloc() mess.
+              C3PValue::_mem_give(new_buf);  // Clean up any allocation mess.
             }
           }
         }
@@ -100,6 +100,7 @@ class StringBuilder;
 class KeyValuePair;
 class Identity;
 class C3PValueDecoder;
+class SlabAllocator;
 #include "../Vector3.h"  // Templates are more onerous...
 
 /* Image support costs code size. Don't support it unless requested. */
@@ -288,6 +289,11 @@ class C3PValue {
 
     static C3PValue* deserialize(StringBuilder*, const TCode FORMAT);
 
+    // An optional source for the memory that values allocate for themselves.
+    //   Refused while the current one has blocks out.
+    static int8_t allocator(SlabAllocator*);
+    static inline SlabAllocator* allocator() {         return _allocator;   };
+
 
   protected:
     /*
@@ -314,6 +320,9 @@ class C3PValue {
 
     C3PValue(const TCode, void*, uint8_t mem_flgs = 0);
 
+    static SlabAllocator* _allocator;
+    static void* _mem_take(const uint32_t LEN);
+    static void  _mem_give(void*);
 
     KeyValuePair* _next_sib_with_key();
     void _reap_existing_value();
@@ -0,0 +1,386 @@
+/*
+File:   ConcurrentElementPool.h
+Author: J. Ian Lindsay
+Date:   2026.10.16
+
+Copyright 2016 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Template for a preallocated pool manager that is safe to share between threads.
+
+This has the same API and constraints as ElementPool, and can be swapped in
+  for it wherever take() and give() might be called from more than one thread.
+
+Concurrency: Free elements are kept in a Treiber stack of indices. The head of
+  the stack is a 64-bit word that packs the index of the top element with a
+  counter that changes on every push and pop, so a stale CAS can never succeed
+  (the ABA problem). Elements are never freed, so following the links of a
+  stale stack is harmless.
+  In front of the stack are a small number of magazines. Each thread is mapped
+  to a magazine, which it refills from (or spills to) the stack in batches of
+  half its depth, with a single CAS. A magazine is guarded by a try-lock: a
+  thread that finds its magazine busy goes to the stack instead of waiting.
+  Before a take() overdraws, it will try to steal from the other magazines.
+
+Statistics: The count of free elements is kept in a single atomic, which is
+  raised before an element is made visible to takers, and lowered after an
+  element is taken. So available() and lowWaterMark() never under-report. Both
+  overdraw counters are atomic.
+
+NOTE: MAG_DEPTH is the number of elements each magazine can hold. Magazines can
+  collectively hold more elements than the pool has.
+NOTE: Pool allocation happens on first use, as with ElementPool. If several
+  threads race to be first, the losers will overdraw until the winner is done.
+*/
+
+#ifndef __C3P_CONCURRENT_ELEMENT_POOL_H
+#define __C3P_CONCURRENT_ELEMENT_POOL_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <new>
+#include "StringBuilder.h"
+
+#define C3P_CEP_NIL_IDX     0xFFFFFFFF
+
+/* A per-thread cache of free elements. */
+template <unsigned int N> struct PoolMagazine {
+  uint8_t  busy;       // Try-lock for the magazine.
+  uint32_t count;      // How many indices are held.
+  uint32_t idx[N];     // Indices of free elements.
+  #if defined(__BUILD_HAS_THREADS)
+    uint8_t _pad[64];  // Keep neighboring magazines off of each other's cache lines.
+  #endif
+};
+
+
+template <class T, unsigned int MAG_DEPTH = 8> class ConcurrentElementPool {
+  public:
+    ConcurrentElementPool(const uint32_t COUNT, const uint32_t OD_LIMIT = 0, T* POOL_PTR = nullptr, const uint8_t MAGAZINES = 4);
+    ~ConcurrentElementPool();
+
+    bool    allocated();
+    bool    inPool(T*);
+    int8_t  give(T*);
+    T*      take();
+
+    inline void     overdrawLimit(uint32_t x) {  _overdraw_limit = x;      };
+    inline uint32_t overdrawLimit() {            return _overdraw_limit;   };
+    inline uint32_t overdraws() {         return __atomic_load_n(&_overdraws, __ATOMIC_RELAXED);        };
+    inline uint32_t overdrawsFreed() {    return __atomic_load_n(&_overdraws_freed, __ATOMIC_RELAXED);  };
+    inline uint32_t lowWaterMark() {      return __atomic_load_n(&_low_watermark, __ATOMIC_RELAXED);    };
+    inline uint32_t capacity() {          return _COUNT;                                                };
+    inline uint32_t available() {         return __atomic_load_n(&_free, __ATOMIC_RELAXED);             };
+    inline uint8_t  magazines() {         return _MAG_COUNT;                                            };
+
+    void printDebug(StringBuilder* output) {
+      output->concatf("ConcurrentElementPool (%sReady)\n", allocated() ? "" : "Not ");
+      output->concatf("\tPool(%p): %u bytes\n", (uintptr_t) _pool, (_COUNT * sizeof(T)));
+      output->concatf("\tCapacity:       %u/%u\n\tLow Watermark:  %u\n", available(), _COUNT, lowWaterMark());
+      output->concatf("\tMagazines:      %u x %u\n", _MAG_COUNT, MAG_DEPTH);
+      if (_overdraw_limit > 0) {
+        output->concatf("\tStarves/Frees:  %u/%u\n", overdraws(), overdrawsFreed());
+      }
+      else {
+        output->concat("\tOverdraw is disallowed.\n");
+      }
+    };
+
+
+  private:
+    const uint32_t _COUNT;        // How many elements are in the pool.
+    const uint8_t  _MAG_COUNT;    // How many magazines sit in front of the stack.
+    T*       _pool;               // A pointer to the memory pool.
+    uint32_t* _next;              // Stack links, by element index.
+    PoolMagazine<MAG_DEPTH>* _mags;
+    uint64_t _head;               // Top-of-stack index (low word), and ABA tag (high word).
+    uint32_t _free;               // How many elements are not in-use.
+    uint32_t _overdraw_limit;     // Constrains heap growth against runaway overdraw.
+    uint32_t _overdraws;          // How many overdraws have happened?
+    uint32_t _overdraws_freed;    // How many overdraws have come back for destruction?
+    uint32_t _low_watermark;      // The minimum level of our pool.
+    uint8_t  _state;              // 0: Not allocated. 1: Being allocated. 2: Ready.
+    bool     _we_own_the_pool;    // Set if this class was asked to handle pool allocation.
+
+    void     _stack_push(const uint32_t first, const uint32_t last);
+    uint32_t _stack_pop(uint32_t* out, const uint32_t MAX);
+    uint32_t _steal(PoolMagazine<MAG_DEPTH>* mine);
+    void     _lower_watermark(const uint32_t level);
+
+    inline PoolMagazine<MAG_DEPTH>* _my_magazine() {
+      return &_mags[_thread_slot() % _MAG_COUNT];
+    };
+
+    static inline bool _mag_lock(PoolMagazine<MAG_DEPTH>* mag) {
+      return (0 == __atomic_exchange_n(&mag->busy, 1, __ATOMIC_ACQUIRE));
+    };
+
+    static inline void _mag_unlock(PoolMagazine<MAG_DEPTH>* mag) {
+      __atomic_store_n(&mag->busy, 0, __ATOMIC_RELEASE);
+    };
+
+    /* Each thread gets a small integer on first use, which picks its magazine. */
+    static uint32_t _thread_slot() {
+      static uint32_t next_slot = 0;
+      static thread_local uint32_t slot = __atomic_fetch_add(&next_slot, 1, __ATOMIC_RELAXED);
+      return slot;
+    };
+};
+
+
+
+/**
+* Constructor
+*/
+template <class T, unsigned int MAG_DEPTH> ConcurrentElementPool<T, MAG_DEPTH>::ConcurrentElementPool(const uint32_t COUNT, const uint32_t OD_LIMIT, T* _mem, const uint8_t MAGAZINES) :
+  _COUNT(COUNT), _MAG_COUNT((0 == MAGAZINES) ? 1 : MAGAZINES),
+  _pool(_mem), _next(nullptr), _mags(nullptr), _head(C3P_CEP_NIL_IDX), _free(0),
+  _overdraw_limit(OD_LIMIT), _overdraws(0), _overdraws_freed(0),
+  _low_watermark(COUNT), _state(0), _we_own_the_pool(false) {}
+
+
+/**
+* Destructor. Not safe to call while other threads might be using the pool.
+*/
+template <class T, unsigned int MAG_DEPTH> ConcurrentElementPool<T, MAG_DEPTH>::~ConcurrentElementPool() {
+  if (_we_own_the_pool & (nullptr != _pool)) {
+    free(_pool);
+    _pool = nullptr;
+  }
+  if (nullptr != _next) {  free(_next);  }
+  if (nullptr != _mags) {  free(_mags);  }
+  _next = nullptr;
+  _mags = nullptr;
+}
+
+
+/**
+* This class follows an allocate-on-demand pattern. This function will attempt
+*   pool allocation and initial population of the free stack, if necessary.
+* Only one thread will do the work. Others will see false until it is finished.
+*
+* @return true if the pool is ready for use. False otherwise.
+*/
+template <class T, unsigned int MAG_DEPTH> bool ConcurrentElementPool<T, MAG_DEPTH>::allocated() {
+  if (2 == __atomic_load_n(&_state, __ATOMIC_ACQUIRE)) {
+    return true;
+  }
+  uint8_t expected = 0;
+  if ((0 == _COUNT) || !__atomic_compare_exchange_n(&_state, &expected, 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+    return false;   // Some other thread is doing the work.
+  }
+
+  bool ret = true;
+  if (nullptr == _pool) {
+    // Try to allocate the pool from the heap.
+    _pool = (T*) malloc(_COUNT * sizeof(T));
+    ret = (nullptr != _pool);
+    _we_own_the_pool = ret;
+  }
+  if (ret) {
+    _next = (uint32_t*) malloc(_COUNT * sizeof(uint32_t));
+    _mags = (PoolMagazine<MAG_DEPTH>*) malloc(_MAG_COUNT * sizeof(PoolMagazine<MAG_DEPTH>));
+    ret = ((nullptr != _next) & (nullptr != _mags));
+  }
+  if (ret) {
+    memset((void*) _mags, 0, (_MAG_COUNT * sizeof(PoolMagazine<MAG_DEPTH>)));
+    for (uint32_t i = 0; i < _COUNT; i++) {
+      // Whatever the type is, we should initialize the memory by doing an
+      //   in-place constructor call, and link it into the free stack.
+      new (_pool + i) T();
+      _next[i] = (i + 1);
+    }
+    _next[_COUNT - 1] = C3P_CEP_NIL_IDX;
+    __atomic_store_n(&_head, (uint64_t) 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&_free, _COUNT, __ATOMIC_RELAXED);
+    __atomic_store_n(&_state, 2, __ATOMIC_RELEASE);
+  }
+  else {
+    if (nullptr != _next) {  free(_next);  }
+    if (nullptr != _mags) {  free(_mags);  }
+    _next = nullptr;
+    _mags = nullptr;
+    __atomic_store_n(&_state, 0, __ATOMIC_RELEASE);
+  }
+  return ret;
+}
+
+
+/**
+* Reclaims the given object so its memory can be re-used.
+*
+* @param T* obj is the pointer to the object to be reclaimed.
+* @return 1 if the object was returned to the pool, or 0 if it was free()'d.
+*/
+template <class T, unsigned int MAG_DEPTH> int8_t ConcurrentElementPool<T, MAG_DEPTH>::give(T* e) {
+  if (inPool(e)) {
+    // Count the element as free before anyone else can take it, so that the
+    //   count never dips below what is really there.
+    const uint32_t IDX = (uint32_t) (e - _pool);
+    __atomic_add_fetch(&_free, 1, __ATOMIC_RELAXED);
+    PoolMagazine<MAG_DEPTH>* mag = _my_magazine();
+    if (_mag_lock(mag)) {
+      if (MAG_DEPTH <= mag->count) {
+        // Full magazine. Spill the older half of it to the stack as one chain.
+        const uint32_t SPILL = ((MAG_DEPTH + 1) >> 1);
+        for (uint32_t i = 0; i < (SPILL - 1); i++) {
+          __atomic_store_n(&_next[mag->idx[i]], mag->idx[i + 1], __ATOMIC_RELAXED);
+        }
+        _stack_push(mag->idx[0], mag->idx[SPILL - 1]);
+        memmove(&mag->idx[0], &mag->idx[SPILL], ((mag->count - SPILL) * sizeof(uint32_t)));
+        mag->count -= SPILL;
+      }
+      mag->idx[mag->count++] = IDX;
+      _mag_unlock(mag);
+    }
+    else {
+      _stack_push(IDX, IDX);
+    }
+    return 1;
+  }
+  else {
+    // We were created because our prealloc was starved. we are therefore a transient heap object.
+    __atomic_add_fetch(&_overdraws_freed, 1, __ATOMIC_RELAXED);
+    delete e;
+    return 0;
+  }
+}
+
+
+/**
+* Like ElementPool, membership is decided by address range. Nothing is in the
+*   pool until it is allocated.
+*
+* @return true if the given element is part of this preallocation pool.
+*/
+template <class T, unsigned int MAG_DEPTH> bool ConcurrentElementPool<T, MAG_DEPTH>::inPool(T* e) {
+  if (2 != __atomic_load_n(&_state, __ATOMIC_ACQUIRE)) {
+    return false;
+  }
+  const uintptr_t obj_addr = ((uintptr_t) e);
+  const uintptr_t pre_min  = ((uintptr_t) _pool);
+  const uintptr_t pre_max  = pre_min + (uintptr_t) (_COUNT * sizeof(T));
+  return ((obj_addr < pre_max) & (obj_addr >= pre_min));
+}
+
+
+/**
+* Remove an item from the preallocation pool an return it. If the pool is
+*   empty, the item will be created on the heap.
+*
+* @return a reference to the element.
+*/
+template <class T, unsigned int MAG_DEPTH> T* ConcurrentElementPool<T, MAG_DEPTH>::take() {
+  T* ret = nullptr;
+  if (allocated()) {
+    uint32_t idx = C3P_CEP_NIL_IDX;
+    PoolMagazine<MAG_DEPTH>* mag = _my_magazine();
+    if (_mag_lock(mag)) {
+      if (0 == mag->count) {
+        // Empty magazine. Refill half of it from the stack with one CAS.
+        mag->count = _stack_pop(mag->idx, ((MAG_DEPTH + 1) >> 1));
+      }
+      if (0 < mag->count) {
+        idx = mag->idx[--mag->count];
+      }
+      _mag_unlock(mag);
+    }
+    if (C3P_CEP_NIL_IDX == idx) {
+      if (0 == _stack_pop(&idx, 1)) {
+        idx = _steal(mag);
+      }
+    }
+    if (C3P_CEP_NIL_IDX != idx) {
+      ret = (_pool + idx);
+      _lower_watermark(__atomic_sub_fetch(&_free, 1, __ATOMIC_RELAXED));
+    }
+  }
+  if (nullptr == ret) {
+    ret = new T();
+    __atomic_add_fetch(&_overdraws, 1, __ATOMIC_RELAXED);
+    _lower_watermark(available());
+  }
+  return ret;
+}
+
+
+/*
+* Push a chain of elements that has already been linked from first to last.
+*/
+template <class T, unsigned int MAG_DEPTH> void ConcurrentElementPool<T, MAG_DEPTH>::_stack_push(const uint32_t first, const uint32_t last) {
+  uint64_t old_head = __atomic_load_n(&_head, __ATOMIC_RELAXED);
+  uint64_t nu_head  = 0;
+  do {
+    __atomic_store_n(&_next[last], (uint32_t) old_head, __ATOMIC_RELAXED);
+    nu_head = ((((old_head >> 32) + 1) << 32) | (uint64_t) first);
+  } while (!__atomic_compare_exchange_n(&_head, &old_head, nu_head, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+
+/*
+* Pop up to MAX elements from the stack with a single CAS.
+*
+* @return the number of indices written to out.
+*/
+template <class T, unsigned int MAG_DEPTH> uint32_t ConcurrentElementPool<T, MAG_DEPTH>::_stack_pop(uint32_t* out, const uint32_t MAX) {
+  uint64_t old_head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+  while (true) {
+    uint32_t cur = (uint32_t) old_head;
+    uint32_t ret = 0;
+    // If the head changes while we walk, the links we read might be nonsense.
+    //   But they will always be valid indices, and the CAS will fail.
+    while ((ret < MAX) && (C3P_CEP_NIL_IDX != cur)) {
+      out[ret++] = cur;
+      cur = __atomic_load_n(&_next[cur], __ATOMIC_RELAXED);
+    }
+    if (0 == ret) {
+      return 0;
+    }
+    const uint64_t NU_HEAD = ((((old_head >> 32) + 1) << 32) | (uint64_t) cur);
+    if (__atomic_compare_exchange_n(&_head, &old_head, NU_HEAD, true, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+      return ret;
+    }
+  }
+}
+
+
+/*
+* Take a single element from any magazine but our own.
+*/
+template <class T, unsigned int MAG_DEPTH> uint32_t ConcurrentElementPool<T, MAG_DEPTH>::_steal(PoolMagazine<MAG_DEPTH>* mine) {
+  uint32_t ret = C3P_CEP_NIL_IDX;
+  for (uint8_t i = 0; (i < _MAG_COUNT) && (C3P_CEP_NIL_IDX == ret); i++) {
+    PoolMagazine<MAG_DEPTH>* mag = &_mags[i];
+    if ((mag != mine) && _mag_lock(mag)) {
+      if (0 < mag->count) {
+        ret = mag->idx[--mag->count];
+      }
+      _mag_unlock(mag);
+    }
+  }
+  return ret;
+}
+
+
+/*
+* Lower the low watermark, if the given level is beneath it.
+*/
+template <class T, unsigned int MAG_DEPTH> void ConcurrentElementPool<T, MAG_DEPTH>::_lower_watermark(const uint32_t level) {
+  uint32_t mark = __atomic_load_n(&_low_watermark, __ATOMIC_RELAXED);
+  while ((level < mark) && !__atomic_compare_exchange_n(&_low_watermark, &mark, level, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+}
+
+#endif // __C3P_CONCURRENT_ELEMENT_POOL_H
@@ -193,7 +193,7 @@ template <class T> bool ElementPool<T>::inPool(T* e) {
 * @return a reference to the preallocated element.
 */
 template <class T> T* ElementPool<T>::take() {
-  T* ret = _list.get();
+  T* ret = (allocated() ? _list.get() : nullptr);
   if (nullptr == ret) {
     ret = new T();
     _overdraws++;
@@ -90,7 +90,7 @@ template <class T> class EnumDef {
     const uint8_t CONTEXT;
     const char* const STR;
 
-    EnumDef(const T EVAL, const char* const STR_REP, const uint8_t EFLAGS = 0, const uint8_t CNTXT = 0)
+    constexpr EnumDef(const T EVAL, const char* const STR_REP, const uint8_t EFLAGS = 0, const uint8_t CNTXT = 0)
       : VAL(EVAL), FLAGS(EFLAGS), CONTEXT(CNTXT), STR(STR_REP) {};
 };
 
@@ -98,21 +98,24 @@ template <class T> class EnumDef {
 /*
 * A list of the above-defined objects. Like EnumDef<t>, instances of this template
 *   ought to be able to be easilly relegated to flash.
+* If the list is given in strictly ascending order of value, lookups by value
+*   will be binary searches. Otherwise, they will be linear.
 */
 template <class T> class EnumDefList {
   public:
     const EnumDef<T>* const LIST_PTR;
     const uint32_t COUNT;
     const char* const LIST_NAME;
+    const bool SORTED;     // Are the values in strictly ascending order?
 
     /**
     * Constructor
     */
-    EnumDefList(
+    constexpr EnumDefList(
       const EnumDef<T>* const DEFS,    // A pointer to the first item in the list.
       const uint32_t DEF_COUNT,        // The size of the list must be explicit.
       const char* const LNAME = ""     // An optional name for this list?
-    ) : LIST_PTR(DEFS), COUNT(DEF_COUNT), LIST_NAME(LNAME) {};
+    ) : LIST_PTR(DEFS), COUNT(DEF_COUNT), LIST_NAME(LNAME), SORTED(_sorted(DEFS, 0, DEF_COUNT)) {};
 
     /**
     * Is the supplied argument in the enum list? We have to ask, because the
@@ -124,11 +127,8 @@ template <class T> class EnumDefList {
     * @return true if so. False otherwise.
     */
     const bool enumValid(const T ENUM_TO_TEST) const {
-      for (uint32_t i = 0; i < COUNT; i++) {
-        const EnumDef<T>* DEF = (LIST_PTR + i);
-        if (DEF->VAL == ENUM_TO_TEST) return !(DEF->FLAGS & ENUM_WRAPPER_FLAG_IS_INVALID);
-      }
-      return false;
+      const EnumDef<T>* DEF = enumDef(ENUM_TO_TEST);
+      return ((nullptr != DEF) && !(DEF->FLAGS & ENUM_WRAPPER_FLAG_IS_INVALID));
     };
 
 
@@ -141,10 +141,8 @@ template <class T> class EnumDefList {
     * @return Always returns a valid string.
     */
     const char* const enumStr(const T ENUM) const {  // Also: const
-      for (uint32_t i = 0; i < COUNT; i++) {
-        if ((LIST_PTR + i)->VAL == ENUM) return (LIST_PTR + i)->STR;
-      }
-      return "<NO ENUM>";
+      const EnumDef<T>* DEF = enumDef(ENUM);
+      return ((nullptr != DEF) ? DEF->STR : "<NO ENUM>");
     };
 
 
@@ -186,10 +184,8 @@ template <class T> class EnumDefList {
     * @return The requested context byte, or 0 on failed lookup.
     */
     const uint8_t enumExtra(const T ENUM) const {
-      for (uint32_t i = 0; i < COUNT; i++) {
-        if ((LIST_PTR + i)->VAL == ENUM) return (LIST_PTR + i)->CONTEXT;
-      }
-      return 0;
+      const EnumDef<T>* DEF = enumDef(ENUM);
+      return ((nullptr != DEF) ? DEF->CONTEXT : 0);
     };
 
 
@@ -201,6 +197,16 @@ template <class T> class EnumDefList {
     * @return The definition container for the matching enum (if found), or nullptr.
     */
     const EnumDef<T>* enumDef(const T ENUM) const {
+      if (SORTED) {
+        uint32_t lo = 0;
+        uint32_t hi = COUNT;
+        while (lo < hi) {
+          const uint32_t MID = ((lo + hi) >> 1);
+          if ((LIST_PTR + MID)->VAL < ENUM) {  lo = MID + 1;  }
+          else {                               hi = MID;      }
+        }
+        return (((lo < COUNT) && ((LIST_PTR + lo)->VAL == ENUM)) ? (LIST_PTR + lo) : nullptr);
+      }
       for (uint32_t i = 0; i < COUNT; i++) {
         if ((LIST_PTR + i)->VAL == ENUM) return (LIST_PTR + i);
       }
@@ -273,6 +279,15 @@ template <class T> class EnumDefList {
         return (LIST_PTR + (COUNT-1))->VAL;
       }
     };
+
+
+  private:
+    /* Divide and conquer, so that the recursion stays shallow at compile time. */
+    static constexpr bool _sorted(const EnumDef<T>* const DEFS, const uint32_t LO, const uint32_t HI) {
+      return (((HI - LO) < 2) ||
+        (((DEFS + ((LO + HI) >> 1) - 1)->VAL < (DEFS + ((LO + HI) >> 1))->VAL) &&
+         _sorted(DEFS, LO, ((LO + HI) >> 1)) && _sorted(DEFS, ((LO + HI) >> 1), HI)));
+    };
 };
 
 #endif  // __C3P_ENUM_WRAPPER
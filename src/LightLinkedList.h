@@ -24,12 +24,20 @@ TODO: This entire file should eventually contain all the linked-list fundamental
 Some functions are #pragma'd to stop the compiler from complaining about nullptr being
   interpreted as a non-pointer. This is to enable the use of this template to carry
   (doubles, floats, ints, etc) without polluting the build log.
+
+Node pools: By default, each node is malloc()'d on insertion and free()'d on
+  removal. A list may instead be given an ElementPool of nodes, which will be
+  used until it runs dry, and then overdrawn from the heap. A pool may be shared
+  by any number of lists of the same type, so long as they are all used from the
+  same thread. The pool's overdraw count is the number of pool misses. A list
+  can only change pools while it is empty, and the pool must outlive the list.
 */
 
 #ifndef __C3P_DAGS_H
 #define __C3P_DAGS_H
 
 #include "CppPotpourri.h"
+#include "ElementPool.h"
 
 /* This is a linked-list element with a slot for data. */
 template <class T> class Node{
@@ -85,7 +93,7 @@ template <class T> class PriorityNode{
 *******************************************************************************/
 template <class T> class LinkedList {
   public:
-    LinkedList(void);
+    LinkedList(ElementPool<Node<T>>* node_pool = nullptr);
     ~LinkedList(void);
 
     int size(void);                  // Returns the number of elements in this list.
@@ -102,24 +110,55 @@ template <class T> class LinkedList {
     int insertAtHead(T);             // Returns the ID of the data, or -1 on failure. Makes only a reference to the payload.
     //bool move(int old_position, int new_position);
 
+    int8_t nodePool(ElementPool<Node<T>>*);   // Returns -1 if the list isn't empty.
+    inline ElementPool<Node<T>>* nodePool() {   return _node_pool;   };
+
 
   private:
     Node<T>* root;
+    ElementPool<Node<T>>* _node_pool;
     Node<T>* getLast(void);          // Returns the last element in the list. Returns the WHOLE element, not just the data it holds.
     int element_count;               // Call this member if you are pressed for time and haven't changed the list recently.
     int count(void);                 // Counts the elements in the list without reliance on stored value. Slower...
+
+    inline Node<T>* _alloc_node() {
+      return ((nullptr != _node_pool) ? _node_pool->take() : (Node<T>*) malloc(sizeof(Node<T>)));
+    };
+    inline void _free_node(Node<T>* n) {
+      if (nullptr != _node_pool) {  _node_pool->give(n);  }
+      else {                        free(n);              }
+    };
 };
 
 
 /**
 * Constructor.
+*
+* @param node_pool is an optional pool to draw nodes from.
 */
-template <class T> LinkedList<T>::LinkedList() {
+template <class T> LinkedList<T>::LinkedList(ElementPool<Node<T>>* node_pool) {
   root = nullptr;
+  _node_pool = node_pool;
   element_count = 0;
 }
 
 
+/**
+* Sets the pool that nodes are drawn from. Nodes that came from one source must
+*   go back to the same source, so this is only allowed while the list is empty.
+*
+* @param node_pool is the new pool, or nullptr to use the heap.
+* @return 0 on success, or -1 if the list isn't empty.
+*/
+template <class T> int8_t LinkedList<T>::nodePool(ElementPool<Node<T>>* node_pool) {
+  if (nullptr != root) {
+    return -1;
+  }
+  _node_pool = node_pool;
+  return 0;
+}
+
+
 /**
 * Destructor. Empties the list.
 */
@@ -151,18 +190,18 @@ template <class T> int LinkedList<T>::clear(void) {
 * @return the position in the list that the data was inserted, or -1 on failure.
 */
 template <class T> int LinkedList<T>::insert(T d) {
-  Node<T> *current;
+  Node<T>* nu = _alloc_node();
+  if (nullptr == nu) {
+    return -1;
+  }
+  nu->next = nullptr;
+  nu->data = d;
   if (root == nullptr) {
-    root = (Node<T>*) malloc(sizeof(Node<T>));
-    current = root;
+    root = nu;
   }
   else {
-    current = getLast();
-    current->next = (Node<T>*) malloc(sizeof(Node<T>));
-    current = current->next;
+    getLast()->next = nu;
   }
-  current->next = nullptr;
-  current->data = d;
   element_count++;
   return 1;
 }
@@ -176,7 +215,7 @@ template <class T> int LinkedList<T>::insert(T d) {
 * @return the position in the list that the data was inserted, or -1 on failure.
 */
 template <class T> int LinkedList<T>::insertAtHead(T d) {
-  Node<T> *current = (Node<T>*) malloc(sizeof(Node<T>));
+  Node<T> *current = _alloc_node();
   if (current) {
     current->data = d;
     current->next = root;
@@ -242,7 +281,7 @@ template <class T> T LinkedList<T>::remove() {
   if (current != nullptr) {
     return_value = current->data;
     root = current->next;
-    free(current);
+    _free_node(current);
     element_count--;
   }
   return return_value;
@@ -269,7 +308,7 @@ template <class T> T LinkedList<T>::remove(int pos) {
         root = current->next;
       }
       return_value = current->data;
-      free(current);
+      _free_node(current);
       element_count--;
       return return_value;
     }
@@ -299,7 +338,7 @@ template <class T> bool LinkedList<T>::remove(T test_data) {
       else {
         root = current->next;
       }
-      free(current);
+      _free_node(current);
       element_count--;
       return_value = true;
       current = (nullptr == prior) ? nullptr : prior->next;
@@ -172,7 +172,7 @@ static int _contains_sync_pattern(StringBuilder* dat_in) {
 */
 M2MLink::M2MLink(const M2MLinkOpts* opts) :
   StateMachine<M2MLinkState>("M2MLink-FSM", &M2MLink::_FSM_STATES, M2MLinkState::UNINIT, M2MLINK_FSM_WAYPOINT_DEPTH),
-  _opts(opts), _flags(opts->default_flags)
+  _opts(opts), _outbound_messages(true), _flags(opts->default_flags)
 {
   for (int i = 0; i < CONFIG_C3PLINK_SERVICE_SLOTS; i++) {  _svc_list[i] = nullptr;  }
 }
@@ -957,6 +957,7 @@ int8_t M2MLink::_clear_waiting_send_by_id(uint32_t id) {
         temp->markACKd();
         _outbound_messages.remove(temp);
         ret = 1;
+        break;   // IDs are unique, and removal reorders the heap.
       }
     }
   }
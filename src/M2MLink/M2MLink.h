@@ -68,7 +68,7 @@ NOTE: This has been a mad binge to port over all this work from ManuvrOS. Five
 #include "../BusQueue/BusQueue.h"
 #include "../FlagContainer.h"
 #include "../FiniteStateMachine.h"
-#include "../PriorityQueue.h"
+#include "../PriorityHeap.h"
 #include "../ElementPool.h"
 #include "../Identity/Identity.h"
 
@@ -515,8 +515,8 @@ class M2MLink : public StateMachine<M2MLinkState>, public BufferCoDec {
     M2MLinkOpts    _opts;    // These are the application-provided options for the link.
     //M2MMsg                 _msg_pool[4];
     //ElementPool<M2MMsg*>   _preallocd(4, &_msg_pool);
-    PriorityQueue<M2MMsg*> _outbound_messages;   // Messages that are bound for the counterparty.
-    PriorityQueue<M2MMsg*> _inbound_messages;    // Messages that came from the counterparty.
+    PriorityHeap<M2MMsg*> _outbound_messages;    // Messages that are bound for the counterparty.
+    PriorityHeap<M2MMsg*> _inbound_messages;     // Messages that came from the counterparty.
     M2MService*     _svc_list[CONFIG_C3PLINK_SERVICE_SLOTS];  // A list of modules that transact on the link.
     FlagContainer32 _flags;
     uint8_t         _verbosity      = 0;        // By default, this class won't generate logs.
@@ -0,0 +1,271 @@
+/*
+File:   MPMCQueue.h
+Author: J. Ian Lindsay
+Date:   2026.10.16
+
+Copyright 2016 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Template for a bounded multi-producer/multi-consumer FIFO queue.
+
+This is for handing small things (usually pointers) between threads. Where
+  RingBuffer is safe for exactly one producer and one consumer, MPMCQueue is
+  safe for any number of each, without a mutex.
+
+Concurrency: Every cell carries a sequence number that says whose turn it is.
+  A producer claims a cell by advancing the enqueue position with a CAS, fills
+  it, and then bumps the cell's sequence to hand it to consumers. Consumers do
+  the mirror image with the dequeue position. Threads only contend on the
+  position they are advancing, and a slow thread only holds up the one cell it
+  claimed. The design is Dmitry Vyukov's bounded MPMC queue.
+
+NOTE: Capacity is rounded up to a power of two (minimum of 2).
+NOTE: Like RingBuffer, elements are moved with memcpy(), so T should be
+  trivially copyable. The queue does not own anything T might point to.
+NOTE: Ordering is FIFO with respect to the enqueue position. Two producers that
+  race will have their elements ordered by whichever claimed a cell first.
+NOTE: Contention counters are statistics, and are updated with relaxed atomics.
+*/
+
+#ifndef __DS_MPMC_QUEUE_H
+#define __DS_MPMC_QUEUE_H
+
+#include <stdlib.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+#include "CppPotpourri.h"
+
+/* One slot in the queue. */
+template <class T> struct MPMCCell {
+  unsigned int seq;   // Whose turn it is to touch this cell.
+  T            data;
+};
+
+
+template <class T> class MPMCQueue {
+  public:
+    /*
+    * Constructor takes the number of slots as its sole argument.
+    */
+    MPMCQueue(const unsigned int c) :
+      _MASK(_round_capacity(c) - 1),
+      _cells(nullptr), _enq(0), _deq(0),
+      _push_retries(0), _pop_retries(0), _full_count(0), _empty_count(0) {};
+    ~MPMCQueue();
+
+    bool allocated();
+    bool tryPush(const T);        // Add an element. False if the queue was full.
+    bool tryPop(T*);              // Take an element. False if the queue was empty.
+    int  drain(T* buf, const unsigned int MAX);   // Take up to MAX elements.
+
+    inline unsigned int capacity() {   return (_MASK + 1);   };
+    inline unsigned int heap_use() {   return (sizeof(MPMCCell<T>) * (_MASK + 1));  };
+    unsigned int count();         // Only a snapshot if other threads are active.
+    inline bool  isEmpty() {           return (0 == count());  };
+
+    /* Contention counters. */
+    inline uint32_t pushRetries() {    return __atomic_load_n(&_push_retries, __ATOMIC_RELAXED);  };
+    inline uint32_t popRetries() {     return __atomic_load_n(&_pop_retries, __ATOMIC_RELAXED);   };
+    inline uint32_t fullCount() {      return __atomic_load_n(&_full_count, __ATOMIC_RELAXED);    };
+    inline uint32_t emptyCount() {     return __atomic_load_n(&_empty_count, __ATOMIC_RELAXED);   };
+    void resetCounters();
+
+
+  private:
+    const unsigned int _MASK;   // (Capacity - 1)
+    MPMCCell<T>* _cells;
+    #if defined(__BUILD_HAS_THREADS)
+      // Keep the positions on separate cache lines, so that producers and
+      //   consumers don't invalidate each other's caches.
+      uint8_t _pad0[64];
+    #endif
+    unsigned int _enq;          // The next position a producer will claim.
+    #if defined(__BUILD_HAS_THREADS)
+      uint8_t _pad1[64];
+    #endif
+    unsigned int _deq;          // The next position a consumer will claim.
+    #if defined(__BUILD_HAS_THREADS)
+      uint8_t _pad2[64];
+    #endif
+    uint32_t _push_retries;     // Times a producer lost a race for a cell.
+    uint32_t _pop_retries;      // Times a consumer lost a race for a cell.
+    uint32_t _full_count;       // Times tryPush() found the queue full.
+    uint32_t _empty_count;      // Times tryPop() found the queue empty.
+
+    static inline void _stat_inc(uint32_t* stat) {
+      __atomic_fetch_add(stat, 1, __ATOMIC_RELAXED);
+    };
+
+    static unsigned int _round_capacity(const unsigned int c) {
+      unsigned int ret = 2;
+      while (ret < c) {  ret = (ret << 1);  }
+      return ret;
+    };
+};
+
+
+/*
+* Destructor. Not safe to call while other threads might be using the queue.
+*/
+template <class T> MPMCQueue<T>::~MPMCQueue() {
+  if (nullptr != _cells) {  free(_cells);  }
+  _cells = nullptr;
+}
+
+
+/**
+* Allocation is done on first use. If several threads race to be first, only
+*   one allocation survives.
+*
+* @return true if the queue is ready for use.
+*/
+template <class T> bool MPMCQueue<T>::allocated() {
+  if (nullptr == __atomic_load_n(&_cells, __ATOMIC_ACQUIRE)) {
+    const unsigned int CAPAC = (_MASK + 1);
+    MPMCCell<T>* nu_cells = (MPMCCell<T>*) malloc(sizeof(MPMCCell<T>) * CAPAC);
+    if (nullptr == nu_cells) {
+      return false;
+    }
+    memset(nu_cells, 0, (sizeof(MPMCCell<T>) * CAPAC));
+    for (unsigned int i = 0; i < CAPAC; i++) {
+      nu_cells[i].seq = i;
+    }
+    MPMCCell<T>* expected = nullptr;
+    if (!__atomic_compare_exchange_n(&_cells, &expected, nu_cells, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+      free(nu_cells);   // Another thread won.
+    }
+  }
+  return true;
+}
+
+
+/**
+* Add an element to the back of the queue.
+*
+* @param d is the element to add.
+* @return true if the element was added. False if the queue was full.
+*/
+template <class T> bool MPMCQueue<T>::tryPush(const T d) {
+  if (!allocated()) {  return false;  }
+  unsigned int pos = __atomic_load_n(&_enq, __ATOMIC_RELAXED);
+  MPMCCell<T>* cell = nullptr;
+  while (true) {
+    cell = &_cells[pos & _MASK];
+    const unsigned int SEQ = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+    const int DIF = (int) (SEQ - pos);
+    if (0 == DIF) {
+      // The cell is free. Try to claim it. On failure, pos is refreshed.
+      if (__atomic_compare_exchange_n(&_enq, &pos, (pos + 1), true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        break;
+      }
+      _stat_inc(&_push_retries);
+    }
+    else if (0 > DIF) {
+      // The cell still holds an element from the last lap. We are full.
+      _stat_inc(&_full_count);
+      return false;
+    }
+    else {
+      // Another producer claimed this cell first.
+      _stat_inc(&_push_retries);
+      pos = __atomic_load_n(&_enq, __ATOMIC_RELAXED);
+    }
+  }
+  memcpy((void*) &cell->data, (const void*) &d, sizeof(T));
+  __atomic_store_n(&cell->seq, (pos + 1), __ATOMIC_RELEASE);   // Hand it to consumers.
+  return true;
+}
+
+
+/**
+* Take an element from the front of the queue.
+*
+* @param d will receive the element.
+* @return true if an element was taken. False if the queue was empty.
+*/
+template <class T> bool MPMCQueue<T>::tryPop(T* d) {
+  if ((nullptr == d) || !allocated()) {  return false;  }
+  unsigned int pos = __atomic_load_n(&_deq, __ATOMIC_RELAXED);
+  MPMCCell<T>* cell = nullptr;
+  while (true) {
+    cell = &_cells[pos & _MASK];
+    const unsigned int SEQ = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+    const int DIF = (int) (SEQ - (pos + 1));
+    if (0 == DIF) {
+      // The cell is full. Try to claim it. On failure, pos is refreshed.
+      if (__atomic_compare_exchange_n(&_deq, &pos, (pos + 1), true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        break;
+      }
+      _stat_inc(&_pop_retries);
+    }
+    else if (0 > DIF) {
+      // No producer has filled this cell yet. We are empty.
+      _stat_inc(&_empty_count);
+      return false;
+    }
+    else {
+      // Another consumer claimed this cell first.
+      _stat_inc(&_pop_retries);
+      pos = __atomic_load_n(&_deq, __ATOMIC_RELAXED);
+    }
+  }
+  memcpy((void*) d, (const void*) &cell->data, sizeof(T));
+  __atomic_store_n(&cell->seq, (pos + _MASK + 1), __ATOMIC_RELEASE);   // Hand it back to producers, one lap later.
+  return true;
+}
+
+
+/**
+* Take as many elements as are waiting, up to a limit. Other consumers may
+*   interleave with the caller, so the elements taken might not be consecutive.
+*
+* @param buf will receive the elements.
+* @param MAX is the most elements that will be taken.
+* @return the number of elements taken, or -1 on bad arguments.
+*/
+template <class T> int MPMCQueue<T>::drain(T* buf, const unsigned int MAX) {
+  if ((nullptr == buf) || (0 == MAX)) {  return -1;  }
+  unsigned int ret = 0;
+  while ((ret < MAX) && tryPop(buf + ret)) {
+    ret++;
+  }
+  return (int) ret;
+}
+
+
+/**
+* @return the number of elements in the queue at the moment of the call.
+*/
+template <class T> unsigned int MPMCQueue<T>::count() {
+  const unsigned int DEQ = __atomic_load_n(&_deq, __ATOMIC_ACQUIRE);
+  const unsigned int ENQ = __atomic_load_n(&_enq, __ATOMIC_ACQUIRE);
+  const int DIF = (int) (ENQ - DEQ);
+  // The positions are read at different times, so clamp the result.
+  return (unsigned int) strict_min((int32_t) strict_max((int32_t) DIF, (int32_t) 0), (int32_t) (_MASK + 1));
+}
+
+
+/*
+* Zero the contention counters.
+*/
+template <class T> void MPMCQueue<T>::resetCounters() {
+  __atomic_store_n(&_push_retries, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&_pop_retries,  0, __ATOMIC_RELAXED);
+  __atomic_store_n(&_full_count,   0, __ATOMIC_RELAXED);
+  __atomic_store_n(&_empty_count,  0, __ATOMIC_RELAXED);
+}
+
+#endif  // __DS_MPMC_QUEUE_H
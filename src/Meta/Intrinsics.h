@@ -543,4 +543,820 @@ static inline int32_t substract_32_saturate(uint32_t a, uint32_t b)
 
 #endif
 
+
+/*******************************************************************************
+* Byte-wise kernels for string handling.
+*
+* These are portable, and do not depend on the platform case-off above. Each
+*   kernel works a machine word at a time (SWAR), and SSE2 or NEON take over
+*   where the compiler says they exist. A plain byte loop finishes the tail,
+*   and is the whole implementation if CONFIG_C3P_SCALAR_BYTE_KERNELS is
+*   defined.
+* Only ASCII is considered. Bytes with the high bit set are never changed or
+*   matched, which agrees with the ctype functions in the "C" locale.
+*******************************************************************************/
+#include <string.h>
+#if !defined(CONFIG_C3P_SCALAR_BYTE_KERNELS)
+  #if defined(__SSE2__)
+    #include <emmintrin.h>
+  #elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+  #endif
+#endif
+
+#if (64 == __BUILD_ALU_WIDTH)
+  typedef uint64_t swar_word_t;
+#else
+  typedef uint32_t swar_word_t;
+#endif
+
+static const swar_word_t SWAR_ONES  = (((swar_word_t) ~((swar_word_t) 0)) / 0xFF);  // 0x0101...
+static const swar_word_t SWAR_HIGHS = (SWAR_ONES * 0x80);                            // 0x8080...
+
+static inline swar_word_t swar_load(const uint8_t* SRC) {
+  swar_word_t w;
+  memcpy(&w, SRC, sizeof(swar_word_t));   // Unaligned-safe. Compiles to a load.
+  return w;
+}
+
+static inline void swar_store(uint8_t* dest, const swar_word_t W) {
+  memcpy(dest, &W, sizeof(swar_word_t));
+}
+
+// Sets the high bit of each byte of W that is in [LO, HI]. LO and HI must be ASCII.
+static inline swar_word_t swar_range_mask(const swar_word_t W, const uint8_t LO, const uint8_t HI) {
+  const swar_word_t LOW7  = (W & ~SWAR_HIGHS);
+  const swar_word_t GE_LO = (LOW7 + (SWAR_ONES * (uint8_t) (0x80 - LO)));
+  const swar_word_t GT_HI = (LOW7 + (SWAR_ONES * (uint8_t) (0x7F - HI)));
+  return (GE_LO & ~GT_HI & ~W & SWAR_HIGHS);
+}
+
+static inline bool ascii_is_whitespace(const uint8_t C) {
+  return ((0x20 == C) | ((0x09 <= C) & (C <= 0x0D)));
+}
+
+static inline swar_word_t swar_whitespace_mask(const swar_word_t W) {
+  return (swar_range_mask(W, 0x09, 0x0D) | swar_range_mask(W, 0x20, 0x20));
+}
+
+// Returns the value of a hex digit, or -1 if C is not a hex digit.
+static inline int8_t ascii_hex_nybble(const uint8_t C) {
+  if ((uint8_t) (C - '0') < 10) {              return (int8_t) (C - '0');         }
+  if ((uint8_t) ((C | 0x20) - 'a') < 6) {      return (int8_t) ((C | 0x20) - 'a' + 10);  }
+  return -1;
+}
+
+
+/*
+* Flip the case of every ASCII letter of the other case.
+*
+* @param buf is the buffer to convert in place.
+* @param LEN is the length of buf.
+* @param TO_UPPER selects the target case.
+*/
+static inline void ascii_case_shift(uint8_t* buf, const int LEN, const bool TO_UPPER) {
+  const uint8_t LO = (TO_UPPER ? 'a' : 'A');
+  const uint8_t HI = (TO_UPPER ? 'z' : 'Z');
+  int i = 0;
+  #if !defined(CONFIG_C3P_SCALAR_BYTE_KERNELS)
+    #if defined(__SSE2__)
+      // Signed comparison excludes bytes with the high bit set for free.
+      const __m128i V_LO  = _mm_set1_epi8((char) (LO - 1));
+      const __m128i V_HI  = _mm_set1_epi8((char) (HI + 1));
+      const __m128i V_BIT = _mm_set1_epi8(0x20);
+      for (; (i + 16) <= LEN; i += 16) {
+        const __m128i V = _mm_loadu_si128((const __m128i*) (buf + i));
+        const __m128i IN_RANGE = _mm_and_si128(_mm_cmpgt_epi8(V, V_LO), _mm_cmplt_epi8(V, V_HI));
+        _mm_storeu_si128((__m128i*) (buf + i), _mm_xor_si128(V, _mm_and_si128(IN_RANGE, V_BIT)));
+      }
+    #elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+      const uint8x16_t V_LO  = vdupq_n_u8(LO);
+      const uint8x16_t V_HI  = vdupq_n_u8(HI);
+      const uint8x16_t V_BIT = vdupq_n_u8(0x20);
+      for (; (i + 16) <= LEN; i += 16) {
+        const uint8x16_t V = vld1q_u8(buf + i);
+        const uint8x16_t IN_RANGE = vandq_u8(vcgeq_u8(V, V_LO), vcleq_u8(V, V_HI));
+        vst1q_u8((buf + i), veorq_u8(V, vandq_u8(IN_RANGE, V_BIT)));
+      }
+    #endif
+    for (; (i + (int) sizeof(swar_word_t)) <= LEN; i += sizeof(swar_word_t)) {
+      const swar_word_t W = swar_load(buf + i);
+      swar_store((buf + i), (W ^ (swar_range_mask(W, LO, HI) >> 2)));  // 0x80 >> 2 is the case bit.
+    }
+  #endif
+  for (; i < LEN; i++) {
+    if ((LO <= buf[i]) & (buf[i] <= HI)) {
+      buf[i] ^= 0x20;
+    }
+  }
+}
+
+
+/*
+* @return the number of whitespace bytes at the front of buf.
+*/
+static inline int ascii_whitespace_span(const uint8_t* buf, const int LEN) {
+  int i = 0;
+  #if !defined(CONFIG_C3P_SCALAR_BYTE_KERNELS)
+    #if defined(__SSE2__)
+      const __m128i V_SPACE = _mm_set1_epi8(0x20);
+      const __m128i V_LO    = _mm_set1_epi8(0x08);
+      const __m128i V_HI    = _mm_set1_epi8(0x0E);
+      for (; (i + 16) <= LEN; i += 16) {
+        const __m128i V = _mm_loadu_si128((const __m128i*) (buf + i));
+        const __m128i WS = _mm_or_si128(_mm_cmpeq_epi8(V, V_SPACE), _mm_and_si128(_mm_cmpgt_epi8(V, V_LO), _mm_cmplt_epi8(V, V_HI)));
+        if (0xFFFF != _mm_movemask_epi8(WS)) {
+          break;
+        }
+      }
+    #endif
+    for (; (i + (int) sizeof(swar_word_t)) <= LEN; i += sizeof(swar_word_t)) {
+      if (SWAR_HIGHS != swar_whitespace_mask(swar_load(buf + i))) {
+        break;
+      }
+    }
+  #endif
+  while ((i < LEN) && ascii_is_whitespace(buf[i])) {
+    i++;
+  }
+  return i;
+}
+
+
+/*
+* @return the number of whitespace bytes at the end of buf.
+*/
+static inline int ascii_whitespace_rspan(const uint8_t* buf, const int LEN) {
+  int i = 0;
+  #if !defined(CONFIG_C3P_SCALAR_BYTE_KERNELS)
+    for (; (i + (int) sizeof(swar_word_t)) <= LEN; i += sizeof(swar_word_t)) {
+      if (SWAR_HIGHS != swar_whitespace_mask(swar_load(buf + (LEN - i - sizeof(swar_word_t))))) {
+        break;
+      }
+    }
+  #endif
+  while ((i < LEN) && ascii_is_whitespace(buf[LEN - i - 1])) {
+    i++;
+  }
+  return i;
+}
+
+
+/*
+* @return the number of printable ASCII bytes (0x20 through 0x7E) at the front of buf.
+*/
+static inline int ascii_printable_span(const uint8_t* buf, const int LEN) {
+  int i = 0;
+  #if !defined(CONFIG_C3P_SCALAR_BYTE_KERNELS)
+    #if defined(__SSE2__)
+      const __m128i V_LO = _mm_set1_epi8(0x1F);
+      const __m128i V_HI = _mm_set1_epi8(0x7F);
+      for (; (i + 16) <= LEN; i += 16) {
+        const __m128i V = _mm_loadu_si128((const __m128i*) (buf + i));
+        if (0xFFFF != _mm_movemask_epi8(_mm_and_si128(_mm_cmpgt_epi8(V, V_LO), _mm_cmplt_epi8(V, V_HI)))) {
+          break;
+        }
+      }
+    #elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+      const uint8x16_t V_LO = vdupq_n_u8(0x20);
+      const uint8x16_t V_HI = vdupq_n_u8(0x7E);
+      for (; (i + 16) <= LEN; i += 16) {
+        const uint8x16_t V = vld1q_u8(buf + i);
+        const uint64x2_t OK = vreinterpretq_u64_u8(vandq_u8(vcgeq_u8(V, V_LO), vcleq_u8(V, V_HI)));
+        if (~((uint64_t) 0) != (vgetq_lane_u64(OK, 0) & vgetq_lane_u64(OK, 1))) {
+          break;
+        }
+      }
+    #endif
+    for (; (i + (int) sizeof(swar_word_t)) <= LEN; i += sizeof(swar_word_t)) {
+      if (SWAR_HIGHS != swar_range_mask(swar_load(buf + i), 0x20, 0x7E)) {
+        break;
+      }
+    }
+  #endif
+  while ((i < LEN) && (0x20 <= buf[i]) && (buf[i] <= 0x7E)) {
+    i++;
+  }
+  return i;
+}
+
+
+/*
+* Render bytes as hex. Exactly (2 * LEN) characters are written, and no
+*   terminator.
+*/
+static inline void hex_encode_bytes(const uint8_t* src, const int LEN, char* dest, const bool UPPER = false) {
+  const char* const DIGITS = (UPPER ? "0123456789ABCDEF" : "0123456789abcdef");
+  const uint8_t ALPHA_ADJ  = (UPPER ? ('A' - '9' - 1) : ('a' - '9' - 1));
+  (void) ALPHA_ADJ;   // Unused if there is no wide path.
+  int i = 0;
+  #if !defined(CONFIG_C3P_SCALAR_BYTE_KERNELS)
+    #if defined(__SSE2__)
+      const __m128i V_0F  = _mm_set1_epi8(0x0F);
+      const __m128i V_9   = _mm_set1_epi8(9);
+      const __m128i V_ZRO = _mm_set1_epi8('0');
+      const __m128i V_ADJ = _mm_set1_epi8(ALPHA_ADJ);
+      for (; (i + 8) <= LEN; i += 8) {
+        const __m128i V   = _mm_loadl_epi64((const __m128i*) (src + i));
+        const __m128i NYB = _mm_unpacklo_epi8(_mm_and_si128(_mm_srli_epi16(V, 4), V_0F), _mm_and_si128(V, V_0F));
+        const __m128i CHR = _mm_add_epi8(_mm_add_epi8(NYB, V_ZRO), _mm_and_si128(_mm_cmpgt_epi8(NYB, V_9), V_ADJ));
+        _mm_storeu_si128((__m128i*) (dest + (i << 1)), CHR);
+      }
+    #elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+      const uint8x8_t  V_0F  = vdup_n_u8(0x0F);
+      const uint8x16_t V_9   = vdupq_n_u8(9);
+      const uint8x16_t V_ZRO = vdupq_n_u8('0');
+      const uint8x16_t V_ADJ = vdupq_n_u8(ALPHA_ADJ);
+      for (; (i + 8) <= LEN; i += 8) {
+        const uint8x8_t   V   = vld1_u8(src + i);
+        const uint8x8x2_t ZIP = vzip_u8(vshr_n_u8(V, 4), vand_u8(V, V_0F));
+        const uint8x16_t  NYB = vcombine_u8(ZIP.val[0], ZIP.val[1]);
+        const uint8x16_t  CHR = vaddq_u8(vaddq_u8(NYB, V_ZRO), vandq_u8(vcgtq_u8(NYB, V_9), V_ADJ));
+        vst1q_u8((uint8_t*) (dest + (i << 1)), CHR);
+      }
+    #elif (64 == __BUILD_ALU_WIDTH) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+      // Four bytes become eight characters in one word.
+      for (; (i + 4) <= LEN; i += 4) {
+        uint32_t in;
+        memcpy(&in, (src + i), 4);
+        uint64_t w = (((uint64_t) in | ((uint64_t) in << 16)) & 0x0000FFFF0000FFFFULL);
+        w = ((w | (w << 8)) & 0x00FF00FF00FF00FFULL);   // Each byte now has an empty byte after it.
+        const uint64_t NYB = (((w >> 4) & 0x000F000F000F000FULL) | ((w & 0x000F000F000F000FULL) << 8));
+        const uint64_t IS_ALPHA = (((NYB + (SWAR_ONES * 6)) >> 4) & SWAR_ONES);
+        const uint64_t CHR = (NYB + (SWAR_ONES * '0') + (IS_ALPHA * ALPHA_ADJ));
+        memcpy((dest + (i << 1)), &CHR, 8);
+      }
+    #endif
+  #endif
+  for (; i < LEN; i++) {
+    *(dest + (i << 1))     = DIGITS[*(src + i) >> 4];
+    *(dest + (i << 1) + 1) = DIGITS[*(src + i) & 0x0F];
+  }
+}
+
+
+/*
+* Parse leading pairs of hex digits into bytes. Parsing stops at the first
+*   character that isn't a hex digit, at an unpaired final digit, or when dest
+*   is full.
+*
+* @return the number of bytes written to dest (which is half of the characters consumed).
+*/
+static inline int hex_decode_pairs(const uint8_t* src, const int LEN, uint8_t* dest, const int DEST_LEN) {
+  int n = 0;
+  #if !defined(CONFIG_C3P_SCALAR_BYTE_KERNELS)
+    #if defined(__SSE2__)
+      const __m128i V_0F    = _mm_set1_epi8(0x0F);
+      const __m128i V_20    = _mm_set1_epi8(0x20);
+      const __m128i V_9     = _mm_set1_epi8(9);
+      const __m128i V_DIG_L = _mm_set1_epi8('0' - 1);
+      const __m128i V_DIG_H = _mm_set1_epi8('9' + 1);
+      const __m128i V_ALP_L = _mm_set1_epi8('a' - 1);
+      const __m128i V_ALP_H = _mm_set1_epi8('f' + 1);
+      const __m128i V_HI_MASK = _mm_set1_epi16(0x00F0);
+      for (; (((n << 1) + 16) <= LEN) && ((n + 8) <= DEST_LEN); n += 8) {
+        const __m128i V     = _mm_loadu_si128((const __m128i*) (src + (n << 1)));
+        const __m128i LOWER = _mm_or_si128(V, V_20);
+        const __m128i DIGIT = _mm_and_si128(_mm_cmpgt_epi8(V, V_DIG_L), _mm_cmplt_epi8(V, V_DIG_H));
+        const __m128i ALPHA = _mm_and_si128(_mm_cmpgt_epi8(LOWER, V_ALP_L), _mm_cmplt_epi8(LOWER, V_ALP_H));
+        if (0xFFFF != _mm_movemask_epi8(_mm_or_si128(DIGIT, ALPHA))) {
+          break;
+        }
+        const __m128i NYB   = _mm_add_epi8(_mm_and_si128(V, V_0F), _mm_and_si128(ALPHA, V_9));
+        const __m128i BYTES = _mm_or_si128(_mm_and_si128(_mm_slli_epi16(NYB, 4), V_HI_MASK), _mm_srli_epi16(NYB, 8));
+        _mm_storel_epi64((__m128i*) (dest + n), _mm_packus_epi16(BYTES, BYTES));
+      }
+    #elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+      const uint8x8_t V_20    = vdup_n_u8(0x20);
+      const uint8x8_t V_0F    = vdup_n_u8(0x0F);
+      const uint8x8_t V_9     = vdup_n_u8(9);
+      for (; (((n << 1) + 16) <= LEN) && ((n + 8) <= DEST_LEN); n += 8) {
+        const uint8x8x2_t PAIRS = vld2_u8(src + (n << 1));   // Even and odd characters.
+        uint8x8_t nyb[2];
+        uint8x8_t valid = vdup_n_u8(0xFF);
+        for (int k = 0; k < 2; k++) {
+          const uint8x8_t V     = PAIRS.val[k];
+          const uint8x8_t LOWER = vorr_u8(V, V_20);
+          const uint8x8_t DIGIT = vand_u8(vcge_u8(V, vdup_n_u8('0')), vcle_u8(V, vdup_n_u8('9')));
+          const uint8x8_t ALPHA = vand_u8(vcge_u8(LOWER, vdup_n_u8('a')), vcle_u8(LOWER, vdup_n_u8('f')));
+          valid  = vand_u8(valid, vorr_u8(DIGIT, ALPHA));
+          nyb[k] = vadd_u8(vand_u8(V, V_0F), vand_u8(ALPHA, V_9));
+        }
+        if (~((uint64_t) 0) != vget_lane_u64(vreinterpret_u64_u8(valid), 0)) {
+          break;
+        }
+        vst1_u8((dest + n), vorr_u8(vshl_n_u8(nyb[0], 4), nyb[1]));
+      }
+    #elif defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+      // A word of characters becomes half a word of bytes.
+      const swar_word_t ONES_16 = (SWAR_ONES & (((swar_word_t) ~((swar_word_t) 0)) / 0xFFFF));  // 0x0001...
+      const int CHARS = (int) sizeof(swar_word_t);
+      for (; (((n << 1) + CHARS) <= LEN) && ((n + (CHARS >> 1)) <= DEST_LEN); n += (CHARS >> 1)) {
+        const swar_word_t W     = swar_load(src + (n << 1));
+        const swar_word_t DIGIT = swar_range_mask(W, '0', '9');
+        const swar_word_t ALPHA = swar_range_mask((W | (SWAR_ONES * 0x20)), 'a', 'f');
+        if (SWAR_HIGHS != (DIGIT | ALPHA)) {
+          break;
+        }
+        const swar_word_t NYB = ((W & (SWAR_ONES * 0x0F)) + ((ALPHA >> 7) * 9));
+        swar_word_t x = (((NYB << 4) & (ONES_16 * 0x00F0)) | ((NYB >> 8) & (ONES_16 * 0x000F)));
+        x = ((x | (x >> 8)) & (((swar_word_t) ~((swar_word_t) 0)) / 0x10001));  // Gather the even bytes.
+        #if (64 == __BUILD_ALU_WIDTH)
+          x = ((x | (x >> 16)) & 0xFFFFFFFFULL);
+        #endif
+        memcpy((dest + n), &x, (CHARS >> 1));
+      }
+    #endif
+  #endif
+  for (; (((n << 1) + 2) <= LEN) && (n < DEST_LEN); n++) {
+    const int8_t HI = ascii_hex_nybble(*(src + (n << 1)));
+    const int8_t LO = ascii_hex_nybble(*(src + (n << 1) + 1));
+    if ((0 > HI) | (0 > LO)) {
+      break;
+    }
+    *(dest + n) = (uint8_t) ((HI << 4) | LO);
+  }
+  return n;
+}
+
+
+/*******************************************************************************
+* Reduction kernels for blocks of numbers.
+*
+* A single pass over a block gives its minimum, maximum, sum, and sum of
+*   squares. The sums are kept in the accumulator type ACC, which the caller
+*   chooses. C3PReductionAccumulator gives the default for each element type:
+*   exact 64-bit integers for narrow integers, and double for everything else.
+*
+* The common pairings of element and accumulator are vectorized with SSE2 (and
+*   AVX2, if the compiler is allowed to use it) or NEON. Float and double
+*   accumulators are summed in a different order than a plain loop would, so
+*   may differ from it in the last few bits. Every other pairing, and all
+*   pairings if CONFIG_C3P_SCALAR_REDUCTION_KERNELS is defined, use a plain
+*   loop. NaNs are not considered.
+*******************************************************************************/
+#if !defined(CONFIG_C3P_SCALAR_REDUCTION_KERNELS)
+  #if defined(__AVX2__)
+    #include <immintrin.h>
+  #elif defined(__SSE2__)
+    #include <emmintrin.h>
+  #elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+  #endif
+#endif
+
+template <class T> struct C3PReductionAccumulator {  typedef double type;   };
+template <> struct C3PReductionAccumulator<int8_t>   {  typedef int64_t type;  };
+template <> struct C3PReductionAccumulator<uint8_t>  {  typedef int64_t type;  };
+template <> struct C3PReductionAccumulator<int16_t>  {  typedef int64_t type;  };
+template <> struct C3PReductionAccumulator<uint16_t> {  typedef int64_t type;  };
+
+template <class T, class ACC> struct C3PReduction {
+  T   min_value;
+  T   max_value;
+  ACC sum;
+  ACC sum_sq;
+};
+
+
+/* Folds SRC[i] through SRC[N-1] into a reduction that is already seeded. */
+template <class T, class ACC> inline void _c3p_reduce_tail(const T* SRC, const uint32_t N, uint32_t i, C3PReduction<T, ACC>* r) {
+  for (; i < N; i++) {
+    const T V = SRC[i];
+    if (V < r->min_value) r->min_value = V;
+    if (r->max_value < V) r->max_value = V;
+    r->sum    += (ACC) V;
+    r->sum_sq += ((ACC) V * (ACC) V);
+  }
+}
+
+/* Folds the lanes of vector accumulators into a reduction. */
+template <class T, class ACC, class L> inline void _c3p_reduce_lanes(C3PReduction<T, ACC>* r, const T* MINS, const T* MAXS, const uint32_t MM_LANES, const L* SUMS, const L* SQS, const uint32_t SUM_LANES) {
+  for (uint32_t j = 0; j < MM_LANES; j++) {
+    if (MINS[j] < r->min_value) r->min_value = MINS[j];
+    if (r->max_value < MAXS[j]) r->max_value = MAXS[j];
+  }
+  for (uint32_t j = 0; j < SUM_LANES; j++) {
+    r->sum    += (ACC) SUMS[j];
+    r->sum_sq += (ACC) SQS[j];
+  }
+}
+
+
+/*
+* Reduce a block of numbers in one pass.
+* Integer accumulators are exact, but will overflow silently if the sum of
+*   squares doesn't fit. int64_t is safe for 16-bit elements in blocks of up to
+*   2^33 elements, but not for 32-bit elements of arbitrary magnitude.
+*
+* @param SRC is the block.
+* @param N is the number of elements in the block.
+* @param r will hold the result.
+* @return 0 on success, or -1 on bad arguments.
+*/
+template <class T, class ACC> inline int8_t c3p_reduce(const T* SRC, const uint32_t N, C3PReduction<T, ACC>* r) {
+  if ((nullptr == SRC) | (0 == N) | (nullptr == r)) {
+    return -1;
+  }
+  r->min_value = SRC[0];
+  r->max_value = SRC[0];
+  r->sum       = ACC(0);
+  r->sum_sq    = ACC(0);
+  _c3p_reduce_tail(SRC, N, 0, r);
+  return 0;
+}
+
+
+#if !defined(CONFIG_C3P_SCALAR_REDUCTION_KERNELS) && (defined(__SSE2__) || defined(__ARM_NEON) || defined(__ARM_NEON__))
+
+/* float elements with float sums. Fastest, and least precise. */
+template <> inline int8_t c3p_reduce<float, float>(const float* SRC, const uint32_t N, C3PReduction<float, float>* r) {
+  if ((nullptr == SRC) | (0 == N) | (nullptr == r)) {
+    return -1;
+  }
+  r->min_value = SRC[0];
+  r->max_value = SRC[0];
+  r->sum       = 0.0f;
+  r->sum_sq    = 0.0f;
+  uint32_t i = 0;
+  float mins[4];
+  float maxs[4];
+  float sums[4];
+  float sqs[4];
+  #if defined(__SSE2__)
+    __m128 v_min = _mm_set1_ps(SRC[0]);
+    __m128 v_max = v_min;
+    __m128 v_sum = _mm_setzero_ps();
+    __m128 v_sq  = _mm_setzero_ps();
+    #if defined(__AVX2__)
+      __m256 w_min = _mm256_set1_ps(SRC[0]);
+      __m256 w_max = w_min;
+      __m256 w_sum = _mm256_setzero_ps();
+      __m256 w_sq  = _mm256_setzero_ps();
+      for (; (i + 8) <= N; i += 8) {
+        const __m256 V = _mm256_loadu_ps(SRC + i);
+        w_min = _mm256_min_ps(w_min, V);
+        w_max = _mm256_max_ps(w_max, V);
+        w_sum = _mm256_add_ps(w_sum, V);
+        w_sq  = _mm256_add_ps(w_sq, _mm256_mul_ps(V, V));
+      }
+      v_min = _mm_min_ps(_mm256_castps256_ps128(w_min), _mm256_extractf128_ps(w_min, 1));
+      v_max = _mm_max_ps(_mm256_castps256_ps128(w_max), _mm256_extractf128_ps(w_max, 1));
+      v_sum = _mm_add_ps(_mm256_castps256_ps128(w_sum), _mm256_extractf128_ps(w_sum, 1));
+      v_sq  = _mm_add_ps(_mm256_castps256_ps128(w_sq), _mm256_extractf128_ps(w_sq, 1));
+    #endif
+    for (; (i + 4) <= N; i += 4) {
+      const __m128 V = _mm_loadu_ps(SRC + i);
+      v_min = _mm_min_ps(v_min, V);
+      v_max = _mm_max_ps(v_max, V);
+      v_sum = _mm_add_ps(v_sum, V);
+      v_sq  = _mm_add_ps(v_sq, _mm_mul_ps(V, V));
+    }
+    _mm_storeu_ps(mins, v_min);
+    _mm_storeu_ps(maxs, v_max);
+    _mm_storeu_ps(sums, v_sum);
+    _mm_storeu_ps(sqs, v_sq);
+  #else
+    float32x4_t v_min = vdupq_n_f32(SRC[0]);
+    float32x4_t v_max = v_min;
+    float32x4_t v_sum = vdupq_n_f32(0.0f);
+    float32x4_t v_sq  = v_sum;
+    for (; (i + 4) <= N; i += 4) {
+      const float32x4_t V = vld1q_f32(SRC + i);
+      v_min = vminq_f32(v_min, V);
+      v_max = vmaxq_f32(v_max, V);
+      v_sum = vaddq_f32(v_sum, V);
+      v_sq  = vmlaq_f32(v_sq, V, V);
+    }
+    vst1q_f32(mins, v_min);
+    vst1q_f32(maxs, v_max);
+    vst1q_f32(sums, v_sum);
+    vst1q_f32(sqs, v_sq);
+  #endif
+  _c3p_reduce_lanes(r, mins, maxs, 4, sums, sqs, 4);
+  _c3p_reduce_tail(SRC, N, i, r);
+  return 0;
+}
+
+
+/* int16_t elements with exact sums. */
+template <> inline int8_t c3p_reduce<int16_t, int64_t>(const int16_t* SRC, const uint32_t N, C3PReduction<int16_t, int64_t>* r) {
+  if ((nullptr == SRC) | (0 == N) | (nullptr == r)) {
+    return -1;
+  }
+  r->min_value = SRC[0];
+  r->max_value = SRC[0];
+  r->sum       = 0;
+  r->sum_sq    = 0;
+  uint32_t i = 0;
+  int16_t mins[8];
+  int16_t maxs[8];
+  int64_t sums[2];
+  int64_t sqs[2];
+  #if defined(__SSE2__)
+    // Adjacent pairs are summed into 32-bit lanes by madd, and widened to 64
+    //   bits on every pass. A pair of squares can reach 2^31, so those are
+    //   widened as unsigned.
+    const __m128i ONES  = _mm_set1_epi16(1);
+    const __m128i ZERO  = _mm_setzero_si128();
+    __m128i v_min = _mm_set1_epi16(SRC[0]);
+    __m128i v_max = v_min;
+    __m128i v_sum = ZERO;
+    __m128i v_sq  = ZERO;
+    #if defined(__AVX2__)
+      const __m256i W_ONES = _mm256_set1_epi16(1);
+      const __m256i W_ZERO = _mm256_setzero_si256();
+      __m256i w_min = _mm256_set1_epi16(SRC[0]);
+      __m256i w_max = w_min;
+      __m256i w_sum = W_ZERO;
+      __m256i w_sq  = W_ZERO;
+      for (; (i + 16) <= N; i += 16) {
+        const __m256i V     = _mm256_loadu_si256((const __m256i*) (SRC + i));
+        const __m256i PAIRS = _mm256_madd_epi16(V, W_ONES);
+        const __m256i SIGNS = _mm256_srai_epi32(PAIRS, 31);
+        const __m256i SQS   = _mm256_madd_epi16(V, V);
+        w_min = _mm256_min_epi16(w_min, V);
+        w_max = _mm256_max_epi16(w_max, V);
+        w_sum = _mm256_add_epi64(w_sum, _mm256_add_epi64(_mm256_unpacklo_epi32(PAIRS, SIGNS), _mm256_unpackhi_epi32(PAIRS, SIGNS)));
+        w_sq  = _mm256_add_epi64(w_sq, _mm256_add_epi64(_mm256_unpacklo_epi32(SQS, W_ZERO), _mm256_unpackhi_epi32(SQS, W_ZERO)));
+      }
+      v_min = _mm_min_epi16(_mm256_castsi256_si128(w_min), _mm256_extracti128_si256(w_min, 1));
+      v_max = _mm_max_epi16(_mm256_castsi256_si128(w_max), _mm256_extracti128_si256(w_max, 1));
+      v_sum = _mm_add_epi64(_mm256_castsi256_si128(w_sum), _mm256_extracti128_si256(w_sum, 1));
+      v_sq  = _mm_add_epi64(_mm256_castsi256_si128(w_sq), _mm256_extracti128_si256(w_sq, 1));
+    #endif
+    for (; (i + 8) <= N; i += 8) {
+      const __m128i V     = _mm_loadu_si128((const __m128i*) (SRC + i));
+      const __m128i PAIRS = _mm_madd_epi16(V, ONES);
+      const __m128i SIGNS = _mm_srai_epi32(PAIRS, 31);
+      const __m128i SQS   = _mm_madd_epi16(V, V);
+      v_min = _mm_min_epi16(v_min, V);
+      v_max = _mm_max_epi16(v_max, V);
+      v_sum = _mm_add_epi64(v_sum, _mm_add_epi64(_mm_unpacklo_epi32(PAIRS, SIGNS), _mm_unpackhi_epi32(PAIRS, SIGNS)));
+      v_sq  = _mm_add_epi64(v_sq, _mm_add_epi64(_mm_unpacklo_epi32(SQS, ZERO), _mm_unpackhi_epi32(SQS, ZERO)));
+    }
+    _mm_storeu_si128((__m128i*) mins, v_min);
+    _mm_storeu_si128((__m128i*) maxs, v_max);
+    _mm_storeu_si128((__m128i*) sums, v_sum);
+    _mm_storeu_si128((__m128i*) sqs, v_sq);
+  #else
+    int16x8_t v_min = vdupq_n_s16(SRC[0]);
+    int16x8_t v_max = v_min;
+    int64x2_t v_sum = vdupq_n_s64(0);
+    int64x2_t v_sq  = v_sum;
+    for (; (i + 8) <= N; i += 8) {
+      const int16x8_t V  = vld1q_s16(SRC + i);
+      const int16x4_t LO = vget_low_s16(V);
+      const int16x4_t HI = vget_high_s16(V);
+      v_min = vminq_s16(v_min, V);
+      v_max = vmaxq_s16(v_max, V);
+      v_sum = vpadalq_s32(v_sum, vpaddlq_s16(V));
+      v_sq  = vpadalq_s32(v_sq, vmull_s16(LO, LO));
+      v_sq  = vpadalq_s32(v_sq, vmull_s16(HI, HI));
+    }
+    vst1q_s16(mins, v_min);
+    vst1q_s16(maxs, v_max);
+    vst1q_s64(sums, v_sum);
+    vst1q_s64(sqs, v_sq);
+  #endif
+  _c3p_reduce_lanes(r, mins, maxs, 8, sums, sqs, 2);
+  _c3p_reduce_tail(SRC, N, i, r);
+  return 0;
+}
+
+#endif  // SSE2 or NEON
+
+
+#if !defined(CONFIG_C3P_SCALAR_REDUCTION_KERNELS) && (defined(__SSE2__) || defined(__aarch64__))
+// The pairings below need vectors of doubles, which 32-bit NEON lacks.
+
+/* float elements with double sums. */
+template <> inline int8_t c3p_reduce<float, double>(const float* SRC, const uint32_t N, C3PReduction<float, double>* r) {
+  if ((nullptr == SRC) | (0 == N) | (nullptr == r)) {
+    return -1;
+  }
+  r->min_value = SRC[0];
+  r->max_value = SRC[0];
+  r->sum       = 0.0;
+  r->sum_sq    = 0.0;
+  uint32_t i = 0;
+  float  mins[4];
+  float  maxs[4];
+  double sums[2];
+  double sqs[2];
+  #if defined(__SSE2__)
+    __m128  v_min = _mm_set1_ps(SRC[0]);
+    __m128  v_max = v_min;
+    __m128d v_sum = _mm_setzero_pd();
+    __m128d v_sq  = _mm_setzero_pd();
+    #if defined(__AVX2__)
+      __m256  w_min = _mm256_set1_ps(SRC[0]);
+      __m256  w_max = w_min;
+      __m256d w_sum = _mm256_setzero_pd();
+      __m256d w_sq  = _mm256_setzero_pd();
+      for (; (i + 8) <= N; i += 8) {
+        const __m256  V  = _mm256_loadu_ps(SRC + i);
+        const __m256d LO = _mm256_cvtps_pd(_mm256_castps256_ps128(V));
+        const __m256d HI = _mm256_cvtps_pd(_mm256_extractf128_ps(V, 1));
+        w_min = _mm256_min_ps(w_min, V);
+        w_max = _mm256_max_ps(w_max, V);
+        w_sum = _mm256_add_pd(w_sum, _mm256_add_pd(LO, HI));
+        w_sq  = _mm256_add_pd(w_sq, _mm256_add_pd(_mm256_mul_pd(LO, LO), _mm256_mul_pd(HI, HI)));
+      }
+      v_min = _mm_min_ps(_mm256_castps256_ps128(w_min), _mm256_extractf128_ps(w_min, 1));
+      v_max = _mm_max_ps(_mm256_castps256_ps128(w_max), _mm256_extractf128_ps(w_max, 1));
+      v_sum = _mm_add_pd(_mm256_castpd256_pd128(w_sum), _mm256_extractf128_pd(w_sum, 1));
+      v_sq  = _mm_add_pd(_mm256_castpd256_pd128(w_sq), _mm256_extractf128_pd(w_sq, 1));
+    #endif
+    for (; (i + 4) <= N; i += 4) {
+      const __m128  V  = _mm_loadu_ps(SRC + i);
+      const __m128d LO = _mm_cvtps_pd(V);
+      const __m128d HI = _mm_cvtps_pd(_mm_movehl_ps(V, V));
+      v_min = _mm_min_ps(v_min, V);
+      v_max = _mm_max_ps(v_max, V);
+      v_sum = _mm_add_pd(v_sum, _mm_add_pd(LO, HI));
+      v_sq  = _mm_add_pd(v_sq, _mm_add_pd(_mm_mul_pd(LO, LO), _mm_mul_pd(HI, HI)));
+    }
+    _mm_storeu_ps(mins, v_min);
+    _mm_storeu_ps(maxs, v_max);
+    _mm_storeu_pd(sums, v_sum);
+    _mm_storeu_pd(sqs, v_sq);
+  #else
+    float32x4_t v_min = vdupq_n_f32(SRC[0]);
+    float32x4_t v_max = v_min;
+    float64x2_t v_sum = vdupq_n_f64(0.0);
+    float64x2_t v_sq  = v_sum;
+    for (; (i + 4) <= N; i += 4) {
+      const float32x4_t V  = vld1q_f32(SRC + i);
+      const float64x2_t LO = vcvt_f64_f32(vget_low_f32(V));
+      const float64x2_t HI = vcvt_high_f64_f32(V);
+      v_min = vminq_f32(v_min, V);
+      v_max = vmaxq_f32(v_max, V);
+      v_sum = vaddq_f64(v_sum, vaddq_f64(LO, HI));
+      v_sq  = vaddq_f64(v_sq, vaddq_f64(vmulq_f64(LO, LO), vmulq_f64(HI, HI)));
+    }
+    vst1q_f32(mins, v_min);
+    vst1q_f32(maxs, v_max);
+    vst1q_f64(sums, v_sum);
+    vst1q_f64(sqs, v_sq);
+  #endif
+  _c3p_reduce_lanes(r, mins, maxs, 4, sums, sqs, 2);
+  _c3p_reduce_tail(SRC, N, i, r);
+  return 0;
+}
+
+
+/* double elements with double sums. */
+template <> inline int8_t c3p_reduce<double, double>(const double* SRC, const uint32_t N, C3PReduction<double, double>* r) {
+  if ((nullptr == SRC) | (0 == N) | (nullptr == r)) {
+    return -1;
+  }
+  r->min_value = SRC[0];
+  r->max_value = SRC[0];
+  r->sum       = 0.0;
+  r->sum_sq    = 0.0;
+  uint32_t i = 0;
+  double mins[2];
+  double maxs[2];
+  double sums[2];
+  double sqs[2];
+  #if defined(__SSE2__)
+    __m128d v_min = _mm_set1_pd(SRC[0]);
+    __m128d v_max = v_min;
+    __m128d v_sum = _mm_setzero_pd();
+    __m128d v_sq  = _mm_setzero_pd();
+    #if defined(__AVX2__)
+      __m256d w_min = _mm256_set1_pd(SRC[0]);
+      __m256d w_max = w_min;
+      __m256d w_sum = _mm256_setzero_pd();
+      __m256d w_sq  = _mm256_setzero_pd();
+      for (; (i + 4) <= N; i += 4) {
+        const __m256d V = _mm256_loadu_pd(SRC + i);
+        w_min = _mm256_min_pd(w_min, V);
+        w_max = _mm256_max_pd(w_max, V);
+        w_sum = _mm256_add_pd(w_sum, V);
+        w_sq  = _mm256_add_pd(w_sq, _mm256_mul_pd(V, V));
+      }
+      v_min = _mm_min_pd(_mm256_castpd256_pd128(w_min), _mm256_extractf128_pd(w_min, 1));
+      v_max = _mm_max_pd(_mm256_castpd256_pd128(w_max), _mm256_extractf128_pd(w_max, 1));
+      v_sum = _mm_add_pd(_mm256_castpd256_pd128(w_sum), _mm256_extractf128_pd(w_sum, 1));
+      v_sq  = _mm_add_pd(_mm256_castpd256_pd128(w_sq), _mm256_extractf128_pd(w_sq, 1));
+    #endif
+    for (; (i + 2) <= N; i += 2) {
+      const __m128d V = _mm_loadu_pd(SRC + i);
+      v_min = _mm_min_pd(v_min, V);
+      v_max = _mm_max_pd(v_max, V);
+      v_sum = _mm_add_pd(v_sum, V);
+      v_sq  = _mm_add_pd(v_sq, _mm_mul_pd(V, V));
+    }
+    _mm_storeu_pd(mins, v_min);
+    _mm_storeu_pd(maxs, v_max);
+    _mm_storeu_pd(sums, v_sum);
+    _mm_storeu_pd(sqs, v_sq);
+  #else
+    float64x2_t v_min = vdupq_n_f64(SRC[0]);
+    float64x2_t v_max = v_min;
+    float64x2_t v_sum = vdupq_n_f64(0.0);
+    float64x2_t v_sq  = v_sum;
+    for (; (i + 2) <= N; i += 2) {
+      const float64x2_t V = vld1q_f64(SRC + i);
+      v_min = vminq_f64(v_min, V);
+      v_max = vmaxq_f64(v_max, V);
+      v_sum = vaddq_f64(v_sum, V);
+      v_sq  = vaddq_f64(v_sq, vmulq_f64(V, V));
+    }
+    vst1q_f64(mins, v_min);
+    vst1q_f64(maxs, v_max);
+    vst1q_f64(sums, v_sum);
+    vst1q_f64(sqs, v_sq);
+  #endif
+  _c3p_reduce_lanes(r, mins, maxs, 2, sums, sqs, 2);
+  _c3p_reduce_tail(SRC, N, i, r);
+  return 0;
+}
+
+
+/* int32_t elements with double sums. */
+template <> inline int8_t c3p_reduce<int32_t, double>(const int32_t* SRC, const uint32_t N, C3PReduction<int32_t, double>* r) {
+  if ((nullptr == SRC) | (0 == N) | (nullptr == r)) {
+    return -1;
+  }
+  r->min_value = SRC[0];
+  r->max_value = SRC[0];
+  r->sum       = 0.0;
+  r->sum_sq    = 0.0;
+  uint32_t i = 0;
+  int32_t mins[4];
+  int32_t maxs[4];
+  double  sums[2];
+  double  sqs[2];
+  #if defined(__SSE2__)
+    __m128i v_min = _mm_set1_epi32(SRC[0]);
+    __m128i v_max = v_min;
+    __m128d v_sum = _mm_setzero_pd();
+    __m128d v_sq  = _mm_setzero_pd();
+    #if defined(__AVX2__)
+      __m256i w_min = _mm256_set1_epi32(SRC[0]);
+      __m256i w_max = w_min;
+      __m256d w_sum = _mm256_setzero_pd();
+      __m256d w_sq  = _mm256_setzero_pd();
+      for (; (i + 8) <= N; i += 8) {
+        const __m256i V  = _mm256_loadu_si256((const __m256i*) (SRC + i));
+        const __m256d LO = _mm256_cvtepi32_pd(_mm256_castsi256_si128(V));
+        const __m256d HI = _mm256_cvtepi32_pd(_mm256_extracti128_si256(V, 1));
+        w_min = _mm256_min_epi32(w_min, V);
+        w_max = _mm256_max_epi32(w_max, V);
+        w_sum = _mm256_add_pd(w_sum, _mm256_add_pd(LO, HI));
+        w_sq  = _mm256_add_pd(w_sq, _mm256_add_pd(_mm256_mul_pd(LO, LO), _mm256_mul_pd(HI, HI)));
+      }
+      // SSE2 has no 32-bit min or max. Spill the lanes, and let the fold take them.
+      int32_t w_mins[8];
+      int32_t w_maxs[8];
+      _mm256_storeu_si256((__m256i*) w_mins, w_min);
+      _mm256_storeu_si256((__m256i*) w_maxs, w_max);
+      _c3p_reduce_lanes(r, w_mins, w_maxs, 8, (const double*) nullptr, (const double*) nullptr, 0);
+      v_sum = _mm_add_pd(_mm256_castpd256_pd128(w_sum), _mm256_extractf128_pd(w_sum, 1));
+      v_sq  = _mm_add_pd(_mm256_castpd256_pd128(w_sq), _mm256_extractf128_pd(w_sq, 1));
+    #endif
+    for (; (i + 4) <= N; i += 4) {
+      const __m128i V  = _mm_loadu_si128((const __m128i*) (SRC + i));
+      const __m128d LO = _mm_cvtepi32_pd(V);
+      const __m128d HI = _mm_cvtepi32_pd(_mm_shuffle_epi32(V, 0xEE));
+      const __m128i LT = _mm_cmplt_epi32(V, v_min);
+      const __m128i GT = _mm_cmpgt_epi32(V, v_max);
+      v_min = _mm_or_si128(_mm_and_si128(LT, V), _mm_andnot_si128(LT, v_min));
+      v_max = _mm_or_si128(_mm_and_si128(GT, V), _mm_andnot_si128(GT, v_max));
+      v_sum = _mm_add_pd(v_sum, _mm_add_pd(LO, HI));
+      v_sq  = _mm_add_pd(v_sq, _mm_add_pd(_mm_mul_pd(LO, LO), _mm_mul_pd(HI, HI)));
+    }
+    _mm_storeu_si128((__m128i*) mins, v_min);
+    _mm_storeu_si128((__m128i*) maxs, v_max);
+    _mm_storeu_pd(sums, v_sum);
+    _mm_storeu_pd(sqs, v_sq);
+  #else
+    int32x4_t   v_min = vdupq_n_s32(SRC[0]);
+    int32x4_t   v_max = v_min;
+    float64x2_t v_sum = vdupq_n_f64(0.0);
+    float64x2_t v_sq  = v_sum;
+    for (; (i + 4) <= N; i += 4) {
+      const int32x4_t   V  = vld1q_s32(SRC + i);
+      const float64x2_t LO = vcvtq_f64_s64(vmovl_s32(vget_low_s32(V)));
+      const float64x2_t HI = vcvtq_f64_s64(vmovl_high_s32(V));
+      v_min = vminq_s32(v_min, V);
+      v_max = vmaxq_s32(v_max, V);
+      v_sum = vaddq_f64(v_sum, vaddq_f64(LO, HI));
+      v_sq  = vaddq_f64(v_sq, vaddq_f64(vmulq_f64(LO, LO), vmulq_f64(HI, HI)));
+    }
+    vst1q_s32(mins, v_min);
+    vst1q_s32(maxs, v_max);
+    vst1q_f64(sums, v_sum);
+    vst1q_f64(sqs, v_sq);
+  #endif
+  _c3p_reduce_lanes(r, mins, maxs, 4, sums, sqs, 2);
+  _c3p_reduce_tail(SRC, N, i, r);
+  return 0;
+}
+
+#endif  // SSE2 or AArch64
+
 #endif  // C3P_INTRINSICS_META_HEADER
@@ -288,6 +288,23 @@ C3P wants the following capabilities, which will probably implicate this file.
 *   fail the build if this header has not been pulled in to the compile.
 *******************************************************************************/
 
+// StringBuilder fragments that are created by small streaming appends (single
+//   bytes, and concatf() output) are allocated with at least this much string
+//   capacity, so that the appends that follow can be written into the slack
+//   rather than each costing an allocation. Set to 0 to disable.
+#ifndef CONFIG_C3P_STRLL_INLINE_LEN
+  #define CONFIG_C3P_STRLL_INLINE_LEN  32
+#endif
+
+// If CONFIG_C3P_STRLL_POOL is defined, StringBuilder fragments of up to 256
+//   bytes (header included) are drawn from preallocated pools in three size
+//   classes that are shared by every instance. Fragments that don't fit, or that
+//   find the pools empty, fall back to the heap. This is the count of elements
+//   in each size class.
+#if defined(CONFIG_C3P_STRLL_POOL) && !defined(CONFIG_C3P_STRLL_POOL_COUNT)
+  #define CONFIG_C3P_STRLL_POOL_COUNT  32
+#endif
+
 #if defined(CONFIG_C3P_IMG_SUPPORT)
   // Do some pre-processor work to not waste memory on storing pixel addresses.
   // Some programs only need 8x8 pixel images, and some are desktop applications.
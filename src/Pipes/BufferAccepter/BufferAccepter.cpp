@@ -62,24 +62,27 @@ int8_t BufferAccepterFork::pushBuffer(StringBuilder* buf) {
   const int32_t BYTES_OFFERED = buf->length();
   const int32_t BYTES_TO_TAKE = strict_min(bufferAvailable(), BYTES_OFFERED);
   if (0 < BYTES_TO_TAKE) {
-    // We could be risky at this point, but we do a pedantic deep-copy instead.
+    // Each side of the fork gets its own string that shares the offered bytes
+    //   copy-on-write, so neither side can see what the other does with them.
     // Note the drift distance for each side of the fork.
     const int32_t LEFT_OFFER_LEN  = (BYTES_TO_TAKE - _left_drift);
     const int32_t RIGHT_OFFER_LEN = (BYTES_TO_TAKE - _right_drift);
     int32_t left_range_covered  = BYTES_TO_TAKE;
     int32_t right_range_covered = BYTES_TO_TAKE;
     if ((nullptr != _left_hand) & (LEFT_OFFER_LEN > 0)) {
-      StringBuilder deep_copy(buf->string() + _left_drift, LEFT_OFFER_LEN);
-      _left_hand->pushBuffer(&deep_copy);
-      left_range_covered -= deep_copy.length();
+      StringBuilder shared_copy;
+      shared_copy.concatShared(buf, _left_drift, LEFT_OFFER_LEN);
+      _left_hand->pushBuffer(&shared_copy);
+      left_range_covered -= shared_copy.length();
     }
     if ((nullptr != _right_hand) & (RIGHT_OFFER_LEN > 0)) {
-      StringBuilder deep_copy(buf->string() + _right_drift, RIGHT_OFFER_LEN);
-      _right_hand->pushBuffer(&deep_copy);
-      right_range_covered -= deep_copy.length();
+      StringBuilder shared_copy;
+      shared_copy.concatShared(buf, _right_drift, RIGHT_OFFER_LEN);
+      _right_hand->pushBuffer(&shared_copy);
+      right_range_covered -= shared_copy.length();
     }
     const int32_t TOTAL_TAKEN = strict_min(left_range_covered, right_range_covered);
-    buf->cull(TOTAL_TAKEN);
+    buf->consume(TOTAL_TAKEN);
     _left_drift  = (TOTAL_TAKEN - left_range_covered);
     _right_drift = (TOTAL_TAKEN - right_range_covered);
 
@@ -0,0 +1,605 @@
+/*
+File:   PriorityHeap.h
+Author: J. Ian Lindsay
+Date:   2026.10.16
+
+Copyright 2016 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Template for a priority queue implemented on top of an array-backed d-ary heap.
+
+This is the drop-in for PriorityQueue where queues get deep. Insertion and
+  removal are O(log n) and allocation-free (once the array has grown to fit),
+  rather than a linear walk and a malloc() per element.
+
+Ordering: Higher priorities come out first. Among equal priorities, elements
+  come out in the order they were inserted. This matches PriorityQueue.
+
+Handles: insert() returns a handle to the element, which stays valid until
+  the element leaves the heap. A handle allows the element's priority to be
+  changed (in either direction), or the element to be removed, in O(log n).
+
+Index: If constructed with INDEXED set, the heap keeps a companion hash set of
+  its elements. That makes contains(), insertIfAbsent(), and remove(T) O(1)
+  instead of a linear scan. It costs one int per slot of the hash table.
+
+NOTE: get(int) and getPriority(int) index the heap's storage, not the order in
+  which things will be dequeued. Only position 0 is certain to be the top.
+  Removals reorder the storage.
+NOTE: Like PriorityQueue, this class holds a recursive mutex on linux, and each
+  call is atomic. Sequences of calls are not. To hand work between threads
+  without a lock, use MPMCQueue.
+*/
+
+#ifndef __C3P_PRIORITY_HEAP_H__
+#define __C3P_PRIORITY_HEAP_H__
+
+#include <stdlib.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+#include "CppPotpourri.h"
+
+#if defined(__MANUVR_LINUX)
+  #include <pthread.h>
+#endif
+
+/* One element in the heap. */
+template <class T> struct PriorityHeapEntry {
+  T        data;
+  int      priority;
+  uint32_t seq;       // Insertion order, for FIFO among equal priorities.
+  int      handle;
+};
+
+
+template <class T, unsigned int D = 4> class PriorityHeap {
+  public:
+    PriorityHeap(const bool INDEXED = false, const unsigned int INITIAL_CAPACITY = 8) :
+      _INDEXED(INDEXED), _heap(nullptr), _pos(nullptr), _index(nullptr),
+      _capac(strict_max((uint32_t) INITIAL_CAPACITY, (uint32_t) 2)), _count(0),
+      _handles_issued(0), _free_handle(-1), _index_capac(0), _index_tombs(0), _next_seq(0) {
+      #if defined(__MANUVR_LINUX)
+        #if defined (PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP)
+        _mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+        #else
+        _mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER;
+        #endif
+      #endif
+    };
+    ~PriorityHeap();
+
+    int  insert(T, int priority = 0);          // Returns a handle to the element, or -1 on failure.
+    int  insertIfAbsent(T, int priority = 0);  // Same as above, but fails if the heap already has the element.
+
+    inline int  size() {        return (int) _count;   };
+    inline bool hasNext() {     return (0 < _count);   };
+    inline bool isIndexed() {   return _INDEXED;       };
+
+    T    dequeue();               // Removes the top element. Returns T(0) if the heap is empty.
+    T    get();                   // Returns the top element without removing it.
+    T    get(int position);       // Returns the element at the given storage position.
+    int  getPriority(int position);  // Returns the priority at the given storage position, or -1.
+    bool contains(T);
+    bool remove(T);               // Removes all elements equal to the argument.
+    int  clear();                 // Returns the number of elements purged.
+
+    /* Handle API. */
+    int    find(T);                                           // Returns the handle of an element, or -1.
+    T      getByHandle(const int HANDLE);
+    int    priority(const int HANDLE);                        // Returns -1 if the handle is invalid.
+    int8_t setPriority(const int HANDLE, const int PRIORITY); // O(log n) in either direction.
+    bool   removeByHandle(const int HANDLE);
+
+    inline bool validHandle(const int HANDLE) {
+      _lock();
+      const bool RET = _valid_handle(HANDLE);
+      _unlock();
+      return RET;
+    };
+
+    /* Same semantics as PriorityQueue. */
+    bool incrementPriority(T);
+    bool decrementPriority(T);
+
+
+  private:
+    const bool _INDEXED;
+    PriorityHeapEntry<T>* _heap;    // The heap itself.
+    int*         _pos;              // Heap position by handle. Negative for free handles.
+    int*         _index;            // Hash set of handles, keyed by element.
+    unsigned int _capac;            // Slots in _heap and _pos.
+    unsigned int _count;            // Elements in the heap.
+    unsigned int _handles_issued;   // High-water mark of handles.
+    int          _free_handle;      // Head of the free-handle chain, threaded through _pos.
+    unsigned int _index_capac;      // Slots in _index. Always a power of two.
+    unsigned int _index_tombs;      // Deleted slots in _index.
+    uint32_t     _next_seq;
+    #if defined(__MANUVR_LINUX)
+      // If we are on linux, we control for concurrency with a mutex...
+      pthread_mutex_t _mutex;
+    #endif
+
+    inline void _lock() {
+      #if defined(__MANUVR_LINUX)
+        pthread_mutex_lock(&_mutex);
+      #endif
+    };
+    inline void _unlock() {
+      #if defined(__MANUVR_LINUX)
+        pthread_mutex_unlock(&_mutex);
+      #endif
+    };
+
+    inline bool _valid_handle(const int HANDLE) {
+      return ((0 <= HANDLE) && (HANDLE < (int) _handles_issued) && (0 <= _pos[HANDLE]));
+    };
+
+    bool _reserve(const unsigned int);
+    int  _insert(T, int priority);
+    int  _find(T);
+    bool _rebuild_index(const unsigned int);
+    void _index_add(const int HANDLE);
+    void _index_drop(const int HANDLE);
+    int  _index_find(T);
+    void _remove_at(const unsigned int);
+    void _sift_up(unsigned int);
+    void _sift_down(unsigned int);
+
+    /* Does entry A come out of the heap before entry B? */
+    static inline bool _before(const PriorityHeapEntry<T>* A, const PriorityHeapEntry<T>* B) {
+      if (A->priority != B->priority) {  return (A->priority > B->priority);  }
+      return (0 > (int32_t) (A->seq - B->seq));   // Safe across wrap of the counter.
+    };
+
+    inline void _place(const unsigned int IDX, const PriorityHeapEntry<T>* ENTRY) {
+      _heap[IDX] = *ENTRY;
+      _pos[ENTRY->handle] = (int) IDX;
+    };
+
+    /* Free handles are chained through _pos as -(next + 2), so that -1 ends the chain. */
+    inline void _free_handle_push(const int HANDLE) {
+      _pos[HANDLE] = -(_free_handle + 2);
+      _free_handle = HANDLE;
+    };
+
+    static uint32_t _hash(const T* D_PTR) {
+      const uint8_t* bytes = (const uint8_t*) D_PTR;
+      uint32_t h = 2166136261u;   // FNV-1a
+      for (unsigned int i = 0; i < sizeof(T); i++) {
+        h = (h ^ bytes[i]) * 16777619u;
+      }
+      return (h ^ (h >> 16));
+    };
+};
+
+
+/*
+* Destructor. The heap only holds copies of T, and does not free what they point to.
+*/
+template <class T, unsigned int D> PriorityHeap<T, D>::~PriorityHeap() {
+  if (nullptr != _heap) {   free(_heap);   }
+  if (nullptr != _pos) {    free(_pos);    }
+  if (nullptr != _index) {  free(_index);  }
+  _heap  = nullptr;
+  _pos   = nullptr;
+  _index = nullptr;
+  #if defined(__MANUVR_LINUX)
+    pthread_mutex_destroy(&_mutex);
+  #endif
+}
+
+
+/**
+* Inserts the given datum into the heap.
+*
+* @param  d         The data to insert.
+* @param  priority  The priority of the element.
+* @return a handle to the element, or -1 on failure.
+*/
+template <class T, unsigned int D> int PriorityHeap<T, D>::insert(T d, int priority) {
+  _lock();
+  const int RET = _insert(d, priority);
+  _unlock();
+  return RET;
+}
+
+
+/**
+* Inserts the given datum into the heap, unless it is already present.
+*
+* @param  d         The data to insert.
+* @param  priority  The priority of the element.
+* @return a handle to the element, or -1 on failure or if it was already present.
+*/
+template <class T, unsigned int D> int PriorityHeap<T, D>::insertIfAbsent(T d, int priority) {
+  _lock();
+  const int RET = ((0 <= _find(d)) ? -1 : _insert(d, priority));
+  _unlock();
+  return RET;
+}
+
+
+#if __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6)
+#pragma GCC diagnostic push
+#endif
+#pragma GCC diagnostic ignored "-Wconversion-null"
+template <class T, unsigned int D> T PriorityHeap<T, D>::dequeue() {
+  T return_value = T(0);
+  _lock();
+  if (0 < _count) {
+    return_value = _heap[0].data;
+    _remove_at(0);
+  }
+  _unlock();
+  return return_value;
+}
+
+
+template <class T, unsigned int D> T PriorityHeap<T, D>::get() {
+  _lock();
+  const T RET = ((0 < _count) ? _heap[0].data : T(0));
+  _unlock();
+  return RET;
+}
+
+
+template <class T, unsigned int D> T PriorityHeap<T, D>::get(int position) {
+  _lock();
+  const T RET = (((0 <= position) && (position < (int) _count)) ? _heap[position].data : T(0));
+  _unlock();
+  return RET;
+}
+
+
+template <class T, unsigned int D> T PriorityHeap<T, D>::getByHandle(const int HANDLE) {
+  _lock();
+  const T RET = (_valid_handle(HANDLE) ? _heap[_pos[HANDLE]].data : T(0));
+  _unlock();
+  return RET;
+}
+#if __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6)
+#pragma GCC diagnostic pop
+#endif
+
+
+template <class T, unsigned int D> int PriorityHeap<T, D>::getPriority(int position) {
+  _lock();
+  const int RET = (((0 <= position) && (position < (int) _count)) ? _heap[position].priority : -1);
+  _unlock();
+  return RET;
+}
+
+
+template <class T, unsigned int D> int PriorityHeap<T, D>::priority(const int HANDLE) {
+  _lock();
+  const int RET = (_valid_handle(HANDLE) ? _heap[_pos[HANDLE]].priority : -1);
+  _unlock();
+  return RET;
+}
+
+
+template <class T, unsigned int D> bool PriorityHeap<T, D>::contains(T test_data) {
+  _lock();
+  const bool RET = (0 <= _find(test_data));
+  _unlock();
+  return RET;
+}
+
+
+/**
+* @return the handle of the first element found equal to the argument, or -1.
+*/
+template <class T, unsigned int D> int PriorityHeap<T, D>::find(T test_data) {
+  _lock();
+  const int RET = _find(test_data);
+  _unlock();
+  return RET;
+}
+
+
+template <class T, unsigned int D> bool PriorityHeap<T, D>::remove(T test_data) {
+  bool return_value = false;
+  _lock();
+  int handle = _find(test_data);
+  while (0 <= handle) {
+    _remove_at((unsigned int) _pos[handle]);
+    return_value = true;
+    handle = _find(test_data);
+  }
+  _unlock();
+  return return_value;
+}
+
+
+template <class T, unsigned int D> bool PriorityHeap<T, D>::removeByHandle(const int HANDLE) {
+  _lock();
+  const bool RET = _valid_handle(HANDLE);
+  if (RET) {
+    _remove_at((unsigned int) _pos[HANDLE]);
+  }
+  _unlock();
+  return RET;
+}
+
+
+template <class T, unsigned int D> int PriorityHeap<T, D>::clear() {
+  _lock();
+  const int return_value = (int) _count;
+  _count          = 0;
+  _handles_issued = 0;
+  _free_handle    = -1;
+  if (nullptr != _index) {
+    memset(_index, 0xFF, (_index_capac * sizeof(int)));   // All slots to -1.
+    _index_tombs = 0;
+  }
+  _unlock();
+  return return_value;
+}
+
+
+/**
+* Changes the priority of an element, and restores the heap order.
+*
+* @param HANDLE is the element's handle.
+* @param PRIORITY is the new priority.
+* @return 0 on success, or -1 if the handle is invalid.
+*/
+template <class T, unsigned int D> int8_t PriorityHeap<T, D>::setPriority(const int HANDLE, const int PRIORITY) {
+  _lock();
+  if (!_valid_handle(HANDLE)) {
+    _unlock();
+    return -1;
+  }
+  const unsigned int IDX = (unsigned int) _pos[HANDLE];
+  const int OLD_PRIORITY = _heap[IDX].priority;
+  _heap[IDX].priority = PRIORITY;
+  if (PRIORITY > OLD_PRIORITY) {
+    _sift_up(IDX);
+  }
+  else if (PRIORITY < OLD_PRIORITY) {
+    _sift_down(IDX);
+  }
+  _unlock();
+  return 0;
+}
+
+
+template <class T, unsigned int D> bool PriorityHeap<T, D>::incrementPriority(T test_data) {
+  _lock();
+  const int HANDLE = _find(test_data);
+  const bool RET = ((0 <= HANDLE) && (0 == setPriority(HANDLE, priority(HANDLE) + 1)));
+  _unlock();
+  return RET;
+}
+
+
+template <class T, unsigned int D> bool PriorityHeap<T, D>::decrementPriority(T test_data) {
+  _lock();
+  const int HANDLE = _find(test_data);
+  const bool RET = ((0 <= HANDLE) && (0 == setPriority(HANDLE, priority(HANDLE) - 1)));
+  _unlock();
+  return RET;
+}
+
+
+/*******************************************************************************
+* Private implementations details.
+*******************************************************************************/
+
+template <class T, unsigned int D> int PriorityHeap<T, D>::_insert(T d, int priority) {
+  if (!_reserve(_count + 1)) {
+    return -1;
+  }
+  int handle = _free_handle;
+  if (0 <= handle) {
+    _free_handle = -(_pos[handle] + 2);
+  }
+  else {
+    handle = (int) _handles_issued++;
+  }
+  PriorityHeapEntry<T> nu;
+  nu.data     = d;
+  nu.priority = priority;
+  nu.seq      = _next_seq++;
+  nu.handle   = handle;
+  _place(_count++, &nu);
+  _sift_up(_count - 1);
+  if (_INDEXED) {
+    _index_add(handle);
+  }
+  return handle;
+}
+
+
+template <class T, unsigned int D> int PriorityHeap<T, D>::_find(T test_data) {
+  if (_INDEXED) {
+    return _index_find(test_data);
+  }
+  for (unsigned int i = 0; i < _count; i++) {
+    if (_heap[i].data == test_data) {
+      return _heap[i].handle;
+    }
+  }
+  return -1;
+}
+
+
+/*
+* Make sure there is room for at least N elements. Allocation is done on first
+*   use, and growth is by doubling.
+*/
+template <class T, unsigned int D> bool PriorityHeap<T, D>::_reserve(const unsigned int N) {
+  if ((nullptr != _heap) && (N <= _capac)) {
+    return true;
+  }
+  unsigned int nu_capac = _capac;
+  while (nu_capac < N) {  nu_capac = (nu_capac << 1);  }
+  PriorityHeapEntry<T>* nu_heap = (PriorityHeapEntry<T>*) realloc(_heap, (nu_capac * sizeof(PriorityHeapEntry<T>)));
+  if (nullptr == nu_heap) {
+    return false;
+  }
+  _heap = nu_heap;
+  int* nu_pos = (int*) realloc(_pos, (nu_capac * sizeof(int)));
+  if (nullptr == nu_pos) {
+    return false;
+  }
+  _pos   = nu_pos;
+  _capac = nu_capac;
+  if (_INDEXED) {
+    // Keep the hash set no more than half full.
+    unsigned int nu_index_capac = 16;
+    while (nu_index_capac < (_capac << 1)) {  nu_index_capac = (nu_index_capac << 1);  }
+    if (nu_index_capac > _index_capac) {
+      return _rebuild_index(nu_index_capac);
+    }
+  }
+  return true;
+}
+
+
+/*
+* Reallocate the hash set at the given size, and fill it from the heap. This
+*   also clears out tombstones.
+*/
+template <class T, unsigned int D> bool PriorityHeap<T, D>::_rebuild_index(const unsigned int NU_CAPAC) {
+  int* nu_index = (int*) malloc(NU_CAPAC * sizeof(int));
+  if (nullptr == nu_index) {
+    return false;
+  }
+  if (nullptr != _index) {  free(_index);  }
+  _index       = nu_index;
+  _index_capac = NU_CAPAC;
+  _index_tombs = 0;
+  memset(_index, 0xFF, (_index_capac * sizeof(int)));   // All slots to -1.
+  for (unsigned int i = 0; i < _count; i++) {
+    _index_add(_heap[i].handle);
+  }
+  return true;
+}
+
+
+/*
+* Hash set slots hold a handle, -1 if empty, or -2 if deleted. Probing is linear.
+*/
+template <class T, unsigned int D> void PriorityHeap<T, D>::_index_add(const int HANDLE) {
+  const unsigned int MASK = (_index_capac - 1);
+  unsigned int slot = (_hash(&_heap[_pos[HANDLE]].data) & MASK);
+  while (0 <= _index[slot]) {
+    slot = ((slot + 1) & MASK);
+  }
+  if (-2 == _index[slot]) {
+    _index_tombs--;
+  }
+  _index[slot] = HANDLE;
+}
+
+
+template <class T, unsigned int D> void PriorityHeap<T, D>::_index_drop(const int HANDLE) {
+  const unsigned int MASK = (_index_capac - 1);
+  unsigned int slot = (_hash(&_heap[_pos[HANDLE]].data) & MASK);
+  while (-1 != _index[slot]) {
+    if (HANDLE == _index[slot]) {
+      _index[slot] = -2;
+      _index_tombs++;
+      break;
+    }
+    slot = ((slot + 1) & MASK);
+  }
+}
+
+
+template <class T, unsigned int D> int PriorityHeap<T, D>::_index_find(T test_data) {
+  if (nullptr == _index) {
+    return -1;
+  }
+  const unsigned int MASK = (_index_capac - 1);
+  unsigned int slot = (_hash(&test_data) & MASK);
+  while (-1 != _index[slot]) {
+    const int HANDLE = _index[slot];
+    if ((0 <= HANDLE) && (_heap[_pos[HANDLE]].data == test_data)) {
+      return HANDLE;
+    }
+    slot = ((slot + 1) & MASK);
+  }
+  return -1;
+}
+
+
+/*
+* Remove the element at the given heap position, and free its handle.
+*/
+template <class T, unsigned int D> void PriorityHeap<T, D>::_remove_at(const unsigned int IDX) {
+  const int HANDLE = _heap[IDX].handle;
+  if (_INDEXED) {
+    _index_drop(HANDLE);
+  }
+  _count--;
+  if (IDX < _count) {
+    // Move the last element into the hole, and let it find its place.
+    const PriorityHeapEntry<T> LAST = _heap[_count];
+    _place(IDX, &LAST);
+    if ((0 < IDX) && _before(&_heap[IDX], &_heap[(IDX - 1) / D])) {
+      _sift_up(IDX);
+    }
+    else {
+      _sift_down(IDX);
+    }
+  }
+  _free_handle_push(HANDLE);
+  if (_INDEXED && ((_count + _index_tombs) > (_index_capac >> 1))) {
+    _rebuild_index(_index_capac);   // Too many tombstones make for long probes.
+  }
+}
+
+
+template <class T, unsigned int D> void PriorityHeap<T, D>::_sift_up(unsigned int idx) {
+  const PriorityHeapEntry<T> MOVING = _heap[idx];
+  while (0 < idx) {
+    const unsigned int PARENT = ((idx - 1) / D);
+    if (!_before(&MOVING, &_heap[PARENT])) {
+      break;
+    }
+    _place(idx, &_heap[PARENT]);
+    idx = PARENT;
+  }
+  _place(idx, &MOVING);
+}
+
+
+template <class T, unsigned int D> void PriorityHeap<T, D>::_sift_down(unsigned int idx) {
+  const PriorityHeapEntry<T> MOVING = _heap[idx];
+  while (true) {
+    const unsigned int FIRST_CHILD = ((idx * D) + 1);
+    if (FIRST_CHILD >= _count) {
+      break;
+    }
+    const unsigned int LAST_CHILD = strict_min((uint32_t) (FIRST_CHILD + D), (uint32_t) _count);
+    unsigned int best = FIRST_CHILD;
+    for (unsigned int c = (FIRST_CHILD + 1); c < LAST_CHILD; c++) {
+      if (_before(&_heap[c], &_heap[best])) {
+        best = c;
+      }
+    }
+    if (!_before(&_heap[best], &MOVING)) {
+      break;
+    }
+    _place(idx, &_heap[best]);
+    idx = best;
+  }
+  _place(idx, &MOVING);
+}
+
+#endif   // __C3P_PRIORITY_HEAP_H__
@@ -21,6 +21,9 @@ limitations under the License.
 Template for a priority queue implemented on top of a linked-list.
 Highest-priority nodes are stored closest to the beginning of the list.
 
+Like LinkedList, a PriorityQueue may be given an ElementPool of nodes to use
+  instead of the heap. See LightLinkedList.h for the constraints.
+
 */
 
 #ifndef __C3P_PRIORITY_QUEUE_H__
@@ -44,7 +47,7 @@ Highest-priority nodes are stored closest to the beginning of the list.
 */
 template <class T> class PriorityQueue {
   public:
-    PriorityQueue(void);
+    PriorityQueue(ElementPool<PriorityNode<T>>* node_pool = nullptr);
     ~PriorityQueue(void);
 
     int insert(T, int priority);  // Returns the ID of the data, or -1 on failure. Makes only a reference to the payload.
@@ -73,9 +76,13 @@ template <class T> class PriorityQueue {
     bool incrementPriority(T);    // Finds the given T and increments its priority by one.
     bool decrementPriority(T);    // Finds the given T and decrements its priority by one.
 
+    int8_t nodePool(ElementPool<PriorityNode<T>>*);   // Returns -1 if the queue isn't empty.
+    inline ElementPool<PriorityNode<T>>* nodePool() {   return _node_pool;   };
+
 
   private:
     PriorityNode<T> *root;        // The root of the queue. Is also the highest-priority.
+    ElementPool<PriorityNode<T>>* _node_pool;
     int element_count;
     #if defined(__MANUVR_LINUX)
       // If we are on linux, we control for concurrency with a mutex...
@@ -100,14 +107,25 @@ template <class T> class PriorityQueue {
     int insert(PriorityNode<T>*);    // Returns the ID of the data, or -1 on failure.
     int count(void);                 // Counts the elements in the list without reliance on stored value. Slower...
     void enforce_priorities(void);   // Need to call this after changing a priority to ensure position reflects priority.
+
+    inline PriorityNode<T>* _alloc_node() {
+      return ((nullptr != _node_pool) ? _node_pool->take() : (PriorityNode<T>*) malloc(sizeof(PriorityNode<T>)));
+    };
+    inline void _free_node(PriorityNode<T>* n) {
+      if (nullptr != _node_pool) {  _node_pool->give(n);  }
+      else {                        free(n);              }
+    };
 };
 
 
 /**
 * Constructor.
+*
+* @param node_pool is an optional pool to draw nodes from.
 */
-template <class T> PriorityQueue<T>::PriorityQueue() {
+template <class T> PriorityQueue<T>::PriorityQueue(ElementPool<PriorityNode<T>>* node_pool) {
   root = nullptr;
+  _node_pool = node_pool;
   element_count = 0;
   #ifdef __MANUVR_LINUX
     #if defined (PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP)
@@ -135,6 +153,22 @@ template <class T> PriorityQueue<T>::~PriorityQueue() {
 }
 
 
+/**
+* Sets the pool that nodes are drawn from. Nodes that came from one source must
+*   go back to the same source, so this is only allowed while the queue is empty.
+*
+* @param node_pool is the new pool, or nullptr to use the heap.
+* @return 0 on success, or -1 if the queue isn't empty.
+*/
+template <class T> int8_t PriorityQueue<T>::nodePool(ElementPool<PriorityNode<T>>* node_pool) {
+  if (nullptr != root) {
+    return -1;
+  }
+  _node_pool = node_pool;
+  return 0;
+}
+
+
 /**
 * Inserts the given dataum into the queue.
 *
@@ -191,7 +225,7 @@ template <class T> int PriorityQueue<T>::insertIfAbsent(T d, int nu_pri) {
     current = current->next;
   }
 
-  PriorityNode<T> *nu = (PriorityNode<T>*) malloc(sizeof(PriorityNode<T>));
+  PriorityNode<T> *nu = _alloc_node();
   if (nullptr == nu) {
     return_value = -1;      // Failed to allocate memory.
   }
@@ -237,7 +271,7 @@ template <class T> int PriorityQueue<T>::insertIfAbsent(T d) {
 */
 template <class T> int PriorityQueue<T>::insert(T d, int nu_pri) {
   int return_value = -1;
-  PriorityNode<T>* nu = (PriorityNode<T>*) malloc(sizeof(PriorityNode<T>));
+  PriorityNode<T>* nu = _alloc_node();
   if (nu == nullptr) {
     return return_value;      // Failed to allocate memory.
   }
@@ -448,7 +482,7 @@ template <class T> T PriorityQueue<T>::dequeue() {
     // This is safe because we only store references. Not the actual data.
     return_value = current->data;
     root = current->next;
-    free(current);
+    _free_node(current);
     element_count--;
   }
   #ifdef __MANUVR_LINUX
@@ -523,7 +557,7 @@ template <class T> bool PriorityQueue<T>::remove(int pos) {
       else {
         root = current->next;
       }
-      free(current);
+      _free_node(current);
       element_count--;
       return true;
     }
@@ -547,7 +581,7 @@ template <class T> bool PriorityQueue<T>::remove(T test_data) {
       else {
         root = current->next;
       }
-      free(current);
+      _free_node(current);
       element_count--;
       return_value = true;
       current = (nullptr == prior) ? nullptr : prior->next;
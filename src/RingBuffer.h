@@ -20,8 +20,22 @@ limitations under the License.
 
 Template for a ring buffer.
 
-TODO: Rework modulus operations into bit mask, and make element count pow(2).
-TODO: Audit for best-practices for a lock-free design.
+Concurrency: RingBuffer is lock-free for a single producer and a single consumer
+  (which might be an ISR and the main loop, or a pair of threads). The producer
+  may call insert(). The consumer may call get(), peek(), cull(), and contains().
+  Either may call count(), vacancy(), and isEmpty(). Where atomics are used
+  (see C3P_RINGBUFFER_ATOMICS), allocated() is safe to race. Otherwise, call it
+  before the ISR side starts.
+  clear() must not be called while the other side might be active.
+  The read and write indices are each written by only one side, and run over
+  twice the capacity so that a full ring can be told from an empty one without
+  a shared count. If the capacity is a power of two, wraparound is a bit mask.
+
+Zero-copy: The producer may reserve() space, write into it in place (by DMA,
+  read(), or otherwise), and then commit() what it wrote. The consumer may scan
+  what is waiting with peekContiguous(), and then consume() what it used. Either
+  way, the ring is presented as at most two spans of contiguous memory, since
+  the data might wrap around the end.
 
 NOTE: RingBuffer will not allow excursions past its declared buffer limit. Nor
   will it overwrite previously-written values that have not been read. In the
@@ -35,8 +49,25 @@ NOTE: RingBuffer will not allow excursions past its declared buffer limit. Nor
 #include <stdlib.h>
 #include <inttypes.h>
 #include <stdint.h>
+#include <string.h>
 #include "CppPotpourri.h"
 
+/*
+* The indices are handed between the two sides with atomics if threads demand
+*   it, or if the core can do them inline anyway. Cores that can't (ARMv6-M,
+*   AVR) would need libatomic, so they take the plain path instead.
+*/
+#if defined(__BUILD_HAS_THREADS) || ((2 == __GCC_ATOMIC_INT_LOCK_FREE) && (2 == __GCC_ATOMIC_POINTER_LOCK_FREE))
+  #define C3P_RINGBUFFER_ATOMICS
+#endif
+
+/* A run of contiguous elements within a RingBuffer. */
+template <class T> struct RingBufferSpan {
+  T*           ptr;
+  unsigned int len;
+};
+
+
 template <class T> class RingBuffer {
   public:
     /*
@@ -44,7 +75,8 @@ template <class T> class RingBuffer {
     */
     RingBuffer(const unsigned int c) :
       _CAPAC(c), _E_SIZE(sizeof(T)),
-      _count(0), _w(0), _r(0), _pool(nullptr) {};
+      _MASK(((0 != c) && (0 == (c & (c - 1)))) ? ((c << 1) - 1) : 0),
+      _w(0), _r(0), _pool(nullptr) {};
     ~RingBuffer();
 
     bool allocated();
@@ -54,9 +86,9 @@ template <class T> class RingBuffer {
 
     inline unsigned int capacity() {   return _CAPAC;              };
     inline unsigned int heap_use() {   return (_E_SIZE * _CAPAC);  };
-    inline unsigned int vacancy() {    return (_CAPAC - _count);   };
-    inline unsigned int count() {      return _count;              };
-    inline bool         isEmpty() {    return (0 == _count);       };
+    inline unsigned int vacancy() {    return (_CAPAC - count());  };
+    inline unsigned int count() {      return _used(_acquire(&_w), _acquire(&_r));  };
+    inline bool         isEmpty() {    return (_acquire(&_w) == _acquire(&_r));     };
 
     int  insert(T);           // Insert an element.
     int  insert(T*, unsigned int len);   // Insert many elements.
@@ -68,16 +100,71 @@ template <class T> class RingBuffer {
     T    peek(unsigned int idx, bool absolute_index = false);
     int  peek(T*, unsigned int len);  // Get many elements.
 
+    /* Zero-copy API. Each function takes an array of two spans to fill. */
+    int  reserve(RingBufferSpan<T> spans[2], const unsigned int N);    // Producer: find space for N elements.
+    int  commit(const unsigned int N);                                  // Producer: publish N reserved elements.
+    int  peekContiguous(RingBufferSpan<T> spans[2], const unsigned int N = 0);  // Consumer: find up to N waiting elements.
+    inline int consume(const unsigned int N) {  return cull(N);  };     // Consumer: release N elements.
+
 
   private:
     const unsigned int _CAPAC;
     const unsigned int _E_SIZE;
-    unsigned int _count;
-    unsigned int _w;
-    unsigned int _r;
+    const unsigned int _MASK;   // Index mask if _CAPAC is a power of two. Zero otherwise.
+    unsigned int _w;            // Written only by the producer. Runs over [0, 2 * _CAPAC).
+    unsigned int _r;            // Written only by the consumer. Runs over [0, 2 * _CAPAC).
     uint8_t* _pool;
 
     T _get(bool also_remove);
+
+    /*
+    * Index hand-off between the two sides. Without atomics, the other side can
+    *   only be an ISR on the same core, so a volatile access that the compiler
+    *   can't reorder is enough.
+    */
+    static inline unsigned int _acquire(const unsigned int* idx) {
+      #if defined(C3P_RINGBUFFER_ATOMICS)
+        return __atomic_load_n(idx, __ATOMIC_ACQUIRE);
+      #else
+        const unsigned int VAL = *((const volatile unsigned int*) idx);
+        asm volatile("" ::: "memory");
+        return VAL;
+      #endif
+    };
+    static inline void _release(unsigned int* idx, const unsigned int VAL) {
+      #if defined(C3P_RINGBUFFER_ATOMICS)
+        __atomic_store_n(idx, VAL, __ATOMIC_RELEASE);
+      #else
+        asm volatile("" ::: "memory");
+        *((volatile unsigned int*) idx) = VAL;
+      #endif
+    };
+
+    /* Move an index forward by N, which must not exceed _CAPAC. */
+    inline unsigned int _advance(const unsigned int IDX, const unsigned int N) {
+      const unsigned int NXT = (IDX + N);
+      if (0 != _MASK) {  return (NXT & _MASK);  }
+      return ((NXT >= (_CAPAC << 1)) ? (NXT - (_CAPAC << 1)) : NXT);
+    };
+
+    /* The memory slot that an index refers to. */
+    inline unsigned int _slot(const unsigned int IDX) {
+      if (0 != _MASK) {  return (IDX & (_MASK >> 1));  }
+      return ((IDX >= _CAPAC) ? (IDX - _CAPAC) : IDX);
+    };
+
+    /* The number of elements between a read index and a write index. */
+    inline unsigned int _used(const unsigned int W, const unsigned int R) {
+      return ((W >= R) ? (W - R) : ((W + (_CAPAC << 1)) - R));
+    };
+
+    inline uint8_t* _slot_ptr(const unsigned int IDX) {
+      return (_pool + (_slot(IDX) * _E_SIZE));
+    };
+
+    int  _spans(RingBufferSpan<T> spans[2], const unsigned int IDX, const unsigned int LEN);
+    void _copy_in(const unsigned int IDX, const T* buf, const unsigned int LEN);
+    void _copy_out(T* buf, const unsigned int IDX, const unsigned int LEN);
 };
 
 
@@ -85,21 +172,43 @@ template <class T> class RingBuffer {
 * Destructor
 */
 template <class T> RingBuffer<T>::~RingBuffer() {
-  _count = 0;
+  _w = 0;
+  _r = 0;
   if (nullptr != _pool) {  free(_pool);  }
   _pool = nullptr;
 }
 
+
+/**
+* Allocation is done on first use. If both sides of the ring race to be first,
+*   only one allocation survives. Without atomics there is no compare-and-swap
+*   to lean on, so allocate before an ISR can touch the ring.
+*
+* @return true if the ring is ready for use.
+*/
 template <class T> bool RingBuffer<T>::allocated() {
-  if (nullptr == _pool) {
+  #if defined(C3P_RINGBUFFER_ATOMICS)
+    uint8_t* const CURRENT = __atomic_load_n(&_pool, __ATOMIC_ACQUIRE);
+  #else
+    uint8_t* const CURRENT = *((uint8_t* volatile*) &_pool);
+  #endif
+  if (nullptr == CURRENT) {
     const unsigned int s = _E_SIZE * _CAPAC;
-    _pool = (uint8_t*) malloc(s);
-    if (nullptr == _pool) {
+    uint8_t* nu_pool = (uint8_t*) malloc(s);
+    if (nullptr == nu_pool) {
       return false;
     }
-    for (unsigned int i = 0; i < s; i++) {
-      *((uint8_t*) _pool + i) = 0x00;
-    }
+    memset(nu_pool, 0, s);
+    #if defined(C3P_RINGBUFFER_ATOMICS)
+      uint8_t* expected = nullptr;
+      if (!__atomic_compare_exchange_n(&_pool, &expected, nu_pool, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        free(nu_pool);   // The other side won.
+      }
+    #else
+      asm volatile("" ::: "memory");
+      if (nullptr == *((uint8_t* volatile*) &_pool)) {  _pool = nu_pool;  }
+      else {                                            free(nu_pool);    }
+    #endif
   }
   return true;
 }
@@ -107,17 +216,13 @@ template <class T> bool RingBuffer<T>::allocated() {
 
 /**
 * Drop all items from the buffer. Zeros all memory, if it is allocated.
+* Not safe to call while the other side of the ring might be active.
 */
 template <class T> void RingBuffer<T>::clear() {
-  _w = 0;
-  _r = 0;
-  _count = 0;
+  _release(&_w, 0);
+  _release(&_r, 0);
   if (allocated()) {
-    for (unsigned int i = 0; i < (_E_SIZE * _CAPAC); i++) {
-      // TODO: We were almost certainly allocated on an alignment we
-      // can write longwords over...
-      *((uint8_t*) _pool + i) = 0x00;
-    }
+    memset(_pool, 0, (_E_SIZE * _CAPAC));
   }
 }
 
@@ -131,9 +236,9 @@ template <class T> void RingBuffer<T>::clear() {
 */
 template <class T> int RingBuffer<T>::cull(const unsigned int CULL_COUNT) {
   if (!allocated() || (0 == CULL_COUNT)) {  return -1;  }
-  const uint32_t SAFE_CULL_COUNT = strict_min((uint32_t) CULL_COUNT, (uint32_t) _count);
-  _r = ((_r + SAFE_CULL_COUNT) % _CAPAC);
-  _count -= SAFE_CULL_COUNT;
+  const unsigned int R = _r;
+  const uint32_t SAFE_CULL_COUNT = strict_min((uint32_t) CULL_COUNT, (uint32_t) _used(_acquire(&_w), R));
+  _release(&_r, _advance(R, SAFE_CULL_COUNT));
   return SAFE_CULL_COUNT;
 }
 
@@ -145,17 +250,15 @@ template <class T> int RingBuffer<T>::cull(const unsigned int CULL_COUNT) {
 * @return 0 on success, or negative on error.
 */
 template <class T> int RingBuffer<T>::insert(T d) {
-  if (!allocated() || (_count >= _CAPAC)) {
+  if (!allocated()) {
     return -1;
   }
-  T* ref = &d;
-
-  unsigned int offset = _E_SIZE * _w;
-  for (unsigned int i = 0; i < _E_SIZE; i++) {
-    *((uint8_t*) _pool + offset + i) = *((uint8_t*)ref + i);
+  const unsigned int W = _w;
+  if (_used(W, _acquire(&_r)) >= _CAPAC) {
+    return -1;
   }
-  _w = ((_w + 1) % _CAPAC);   // TODO: Convert to pow(2) later and convert to bitmask.
-  _count++;
+  memcpy(_slot_ptr(W), (uint8_t*) &d, _E_SIZE);
+  _release(&_w, _advance(W, 1));   // Publish the element.
   return 0;
 }
 
@@ -172,21 +275,15 @@ template <class T> int RingBuffer<T>::insert(T d) {
 */
 template <class T> int RingBuffer<T>::insert(T* d_ptr, unsigned int added_elements) {
   if ((nullptr == d_ptr) | (0 >= added_elements)) {  return -1;   }  // Parameter sanity.
-  if (!allocated() || (_count >= _CAPAC)) {          return -1;   }  // Allocation and capacity.
-
-  const uint32_t COUNT_TO_TAKE = strict_min((uint32_t) added_elements, (uint32_t) vacancy());
-  int count_taken = 0;
-  // TODO: It would be marginally more efficient to copy the inner-loop into
-  //   this function, and re-write it to handle chunks of multiples of _E_SIZE
-  //   up to the boundaries of the ring. That way, an insertion of any number
-  //   of elements would make two calls to memcpy(), at most. And no outer loop.
-  //   Until someone cares, we keep with an outer loop (the one below), and wrap
-  //   our byte-wise function.
-  for (uint32_t i = 0; i < COUNT_TO_TAKE; i++) {
-    if (0 != insert(*(d_ptr + i))) {   break;   }
-    else {    count_taken++;    }
-  }
-  return count_taken;
+  if (!allocated()) {                                return -1;   }  // Allocation.
+  const unsigned int W = _w;
+  const unsigned int VACANCY = (_CAPAC - _used(W, _acquire(&_r)));
+  if (0 == VACANCY) {                                return -1;   }  // Capacity.
+
+  const uint32_t COUNT_TO_TAKE = strict_min((uint32_t) added_elements, (uint32_t) VACANCY);
+  _copy_in(W, d_ptr, COUNT_TO_TAKE);
+  _release(&_w, _advance(W, COUNT_TO_TAKE));   // Publish all of the elements at once.
+  return (int) COUNT_TO_TAKE;
 }
 
 
@@ -197,20 +294,15 @@ template <class T> int RingBuffer<T>::insert(T* d_ptr, unsigned int added_elemen
 */
 template <class T> bool RingBuffer<T>::contains(T d) {
   bool found = false;
-  if (allocated() && (0 < _count)) {
+  if (allocated()) {
     unsigned int cur_idx = _r;
+    const unsigned int COUNT = _used(_acquire(&_w), cur_idx);
     uint8_t* compare = (uint8_t*) &d;
     uint32_t elements_tested = 0;
 
-    while (!found & (elements_tested < _count)) {
-      uint8_t* current = (uint8_t*) (_pool + (cur_idx * _E_SIZE));
-      bool current_is_compare = true;
-      for (uint32_t i = 0; i < _E_SIZE; i++) {
-        current_is_compare &= (*(current + i) == *(compare + i));
-      }
-      found |= current_is_compare;
-
-      cur_idx = ((cur_idx + 1) % _CAPAC);   // TODO: Convert to pow(2) later and convert to bitmask.
+    while (!found & (elements_tested < COUNT)) {
+      found = (0 == memcmp(_slot_ptr(cur_idx), compare, _E_SIZE));
+      cur_idx = _advance(cur_idx, 1);
       elements_tested++;
     }
   }
@@ -224,15 +316,16 @@ template <class T> bool RingBuffer<T>::contains(T d) {
 * @return T(0) on failure, or the data at the front of the ring.
 */
 template <class T> T RingBuffer<T>::_get(bool also_remove) {
-  if (!allocated() || (0 == _count)) {
+  const unsigned int R = _r;
+  if (!allocated() || (0 == _used(_acquire(&_w), R))) {
     return (T)0;
   }
-  T* return_value = (T*) (_pool + (_r * _E_SIZE));
+  // The element must be copied out before the slot is handed back.
+  T return_value = *((T*) _slot_ptr(R));
   if (also_remove) {
-    _r = ((_r + 1) % _CAPAC);   // TODO: Convert to pow(2) later and convert to bitmask.
-    _count--;
+    _release(&_r, _advance(R, 1));
   }
-  return *return_value;
+  return return_value;
 }
 
 
@@ -244,11 +337,11 @@ template <class T> T RingBuffer<T>::_get(bool also_remove) {
 * @return T(0) on failure, or the data at the given index.
 */
 template <class T> T RingBuffer<T>::peek(unsigned int idx, bool absolute_index) {
-  if (!allocated() || (0 == _count) || (idx > _CAPAC)) {
+  if (!allocated() || isEmpty() || (idx > _CAPAC)) {
     return (T)0;
   }
-  T* return_value = (T*) (_pool + ((((absolute_index ? 0 : _r) + idx) % _CAPAC) * _E_SIZE));
-  return *return_value;
+  const unsigned int SLOT = (absolute_index ? ((idx >= _CAPAC) ? (idx - _CAPAC) : idx) : _slot(_advance(_r, idx)));
+  return *((T*) (_pool + (SLOT * _E_SIZE)));
 }
 
 
@@ -263,10 +356,10 @@ template <class T> int RingBuffer<T>::get(T* buf, unsigned int len) {
   if (!allocated() || (0 == len) || (nullptr == buf)) {
     return -1;
   }
-  const uint32_t XFER_LEN = strict_min((uint32_t) _count, (uint32_t) len);
-  for (uint32_t i = 0; i < XFER_LEN; i++) {
-    *(buf + i) = get();   // TODO: This could be made much faster.
-  }
+  const unsigned int R = _r;
+  const uint32_t XFER_LEN = strict_min((uint32_t) _used(_acquire(&_w), R), (uint32_t) len);
+  _copy_out(buf, R, XFER_LEN);
+  _release(&_r, _advance(R, XFER_LEN));   // Hand back all of the slots at once.
   return (int) XFER_LEN;
 }
 
@@ -282,11 +375,101 @@ template <class T> int RingBuffer<T>::peek(T* buf, unsigned int len) {
   if (!allocated() || (0 == len) || (nullptr == buf)) {
     return -1;
   }
-  const uint32_t XFER_LEN = strict_min((uint32_t) _count, (uint32_t) len);
-  for (uint32_t i = 0; i < XFER_LEN; i++) {
-    *(buf + i) = peek(i);   // TODO: This could be made much faster.
-  }
+  const unsigned int R = _r;
+  const uint32_t XFER_LEN = strict_min((uint32_t) _used(_acquire(&_w), R), (uint32_t) len);
+  _copy_out(buf, R, XFER_LEN);
   return (int) XFER_LEN;
 }
 
+
+/**
+* Find contiguous space for the producer to write into without copying. Nothing
+*   is visible to the consumer until commit() is called.
+*
+* @param spans will be filled with the space found. The second span is only
+*   used if the space wraps around the end of the ring. Otherwise its length is 0.
+* @param N is the number of elements the caller would like to write.
+* @return the number of elements of space found, which may be less than N, or negative on error.
+*/
+template <class T> int RingBuffer<T>::reserve(RingBufferSpan<T> spans[2], const unsigned int N) {
+  if (!allocated() || (nullptr == spans)) {
+    return -1;
+  }
+  const unsigned int W = _w;
+  const uint32_t VACANCY = (_CAPAC - _used(W, _acquire(&_r)));
+  return _spans(spans, W, strict_min((uint32_t) N, VACANCY));
+}
+
+
+/**
+* Publish elements that the producer wrote into space given by reserve().
+*
+* @param N is the number of elements to publish.
+* @return N on success, or negative if there isn't that much space.
+*/
+template <class T> int RingBuffer<T>::commit(const unsigned int N) {
+  if (!allocated()) {
+    return -1;
+  }
+  const unsigned int W = _w;
+  if (N > (_CAPAC - _used(W, _acquire(&_r)))) {
+    return -1;
+  }
+  _release(&_w, _advance(W, N));
+  return (int) N;
+}
+
+
+/**
+* Find the waiting elements, so that the consumer can use them in place. The
+*   elements stay in the ring until consume() is called.
+*
+* @param spans will be filled with the waiting elements. The second span is only
+*   used if they wrap around the end of the ring. Otherwise its length is 0.
+* @param N is the maximum number of elements wanted, or 0 for all of them.
+* @return the number of elements found, or negative on error.
+*/
+template <class T> int RingBuffer<T>::peekContiguous(RingBufferSpan<T> spans[2], const unsigned int N) {
+  if (!allocated() || (nullptr == spans)) {
+    return -1;
+  }
+  const unsigned int R = _r;
+  const uint32_t WAITING = _used(_acquire(&_w), R);
+  return _spans(spans, R, ((0 == N) ? WAITING : strict_min((uint32_t) N, WAITING)));
+}
+
+
+/* Describe LEN elements starting at ring index IDX as (at most) two spans. */
+template <class T> int RingBuffer<T>::_spans(RingBufferSpan<T> spans[2], const unsigned int IDX, const unsigned int LEN) {
+  const unsigned int SLOT  = _slot(IDX);
+  const unsigned int FIRST = strict_min((uint32_t) LEN, (uint32_t) (_CAPAC - SLOT));
+  spans[0].ptr = (T*) (_pool + (SLOT * _E_SIZE));
+  spans[0].len = FIRST;
+  spans[1].ptr = (T*) _pool;
+  spans[1].len = (LEN - FIRST);
+  return (int) LEN;
+}
+
+
+/* Copy LEN elements into the ring at index IDX. At most two memcpy() calls. */
+template <class T> void RingBuffer<T>::_copy_in(const unsigned int IDX, const T* buf, const unsigned int LEN) {
+  RingBufferSpan<T> spans[2];
+  _spans(spans, IDX, LEN);
+  memcpy((uint8_t*) spans[0].ptr, (const uint8_t*) buf, (spans[0].len * _E_SIZE));
+  if (0 < spans[1].len) {
+    memcpy((uint8_t*) spans[1].ptr, (const uint8_t*) (buf + spans[0].len), (spans[1].len * _E_SIZE));
+  }
+}
+
+
+/* Copy LEN elements out of the ring from index IDX. At most two memcpy() calls. */
+template <class T> void RingBuffer<T>::_copy_out(T* buf, const unsigned int IDX, const unsigned int LEN) {
+  RingBufferSpan<T> spans[2];
+  _spans(spans, IDX, LEN);
+  memcpy((uint8_t*) buf, (const uint8_t*) spans[0].ptr, (spans[0].len * _E_SIZE));
+  if (0 < spans[1].len) {
+    memcpy((uint8_t*) (buf + spans[0].len), (const uint8_t*) spans[1].ptr, (spans[1].len * _E_SIZE));
+  }
+}
+
 #endif // __DS_RING_BUFFER_H
@@ -0,0 +1,352 @@
+/*
+File:   SlabAllocator.cpp
+Author: J. Ian Lindsay
+Date:   2026.10.16
+
+Copyright 2016 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "SlabAllocator.h"
+#include "CppPotpourri.h"
+#include <stddef.h>
+#include <string.h>
+
+
+/*******************************************************************************
+* Static members and initializers should be located here.
+*******************************************************************************/
+
+/**
+* How large must an arena be to hold the given classes?
+* This is a bit larger than the blocks, to allow for the per-block bookkeeping
+*   and the alignment of the first block.
+*
+* @param BLOCK_COUNTS is the number of blocks in each class, smallest first.
+* @param CLASS_COUNT is the length of BLOCK_COUNTS.
+* @param MIN_SHIFT is log2 of the smallest class size.
+* @return the required arena size, in bytes.
+*/
+uint32_t SlabAllocator::arenaSize(const uint16_t* BLOCK_COUNTS, const uint8_t CLASS_COUNT, const uint8_t MIN_SHIFT) {
+  uint32_t ret = C3P_SLAB_MAX_ALIGN;
+  const uint8_t CLASSES = strict_min(CLASS_COUNT, (uint8_t) C3P_SLAB_MAX_CLASSES);
+  const uint8_t SHIFT   = strict_max(MIN_SHIFT, (uint8_t) 4);
+  for (uint8_t c = 0; c < CLASSES; c++) {
+    ret += ((uint32_t) BLOCK_COUNTS[c] << (SHIFT + c));
+    ret += ((uint32_t) BLOCK_COUNTS[c] * sizeof(uint32_t));
+  }
+  return ret;
+}
+
+
+/*******************************************************************************
+*   ___ _              ___      _ _              _      _
+*  / __| |__ _ ______ | _ ) ___(_) |___ _ _ _ __| |__ _| |_ ___
+* | (__| / _` (_-<_-< | _ \/ _ \ | / -_) '_| '_ \ / _` |  _/ -_)
+*  \___|_\__,_/__/__/ |___/\___/_|_\___|_| | .__/_\__,_|\__\___|
+*                                          |_|
+* Constructors/destructors, class initialization functions and so-forth...
+*******************************************************************************/
+
+/**
+* Constructor
+*
+* @param BLOCK_COUNTS is the number of blocks in each class, smallest first.
+* @param CLASS_COUNT is the length of BLOCK_COUNTS.
+* @param MIN_SHIFT is log2 of the smallest class size. No less than 4.
+* @param ARENA is optional memory of at least arenaSize() bytes.
+*/
+SlabAllocator::SlabAllocator(const uint16_t* BLOCK_COUNTS, const uint8_t CLASS_COUNT, const uint8_t MIN_SHIFT, uint8_t* ARENA) :
+  _MIN_SHIFT(strict_max(MIN_SHIFT, (uint8_t) 4)),
+  _class_count(strict_min(CLASS_COUNT, (uint8_t) C3P_SLAB_MAX_CLASSES)),
+  _heap_fallback(true), _we_own_the_arena(false), _busy(false),
+  _arena(ARENA), _blocks_lo(nullptr), _blocks_hi(nullptr),
+  _overdraws(0), _overdraws_freed(0), _failures(0)
+{
+  memset(_classes, 0, sizeof(_classes));
+  for (uint8_t c = 0; c < C3P_SLAB_MAX_CLASSES; c++) {
+    _counts[c] = ((c < _class_count) ? BLOCK_COUNTS[c] : 0);
+    _classes[c].size  = ((uint32_t) 1 << (_MIN_SHIFT + c));
+    _classes[c].count = _counts[c];
+  }
+}
+
+
+/**
+* Destructor. Memory still held by callers is invalidated.
+*/
+SlabAllocator::~SlabAllocator() {
+  if (_we_own_the_arena & (nullptr != _arena)) {
+    free(_arena);
+  }
+  _arena     = nullptr;
+  _blocks_lo = nullptr;
+  _blocks_hi = nullptr;
+}
+
+
+/*******************************************************************************
+* Exposed member functions.
+*******************************************************************************/
+
+/**
+* This class follows an allocate-on-demand pattern. This function will attempt
+*   arena allocation and carving, if necessary.
+*
+* @return true if the allocator is ready for use. False otherwise.
+*/
+bool SlabAllocator::allocated() {
+  _lock();
+  const bool RET = _carve();
+  _unlock();
+  return RET;
+}
+
+
+/**
+* @return true if the given memory is a block in the arena.
+*/
+bool SlabAllocator::inPool(void* ptr) {
+  return (((uint8_t*) ptr >= _blocks_lo) & ((uint8_t*) ptr < _blocks_hi));
+}
+
+
+/**
+* Take memory from the smallest class that fits, and isn't empty.
+*
+* @param LEN is the number of bytes required.
+* @param ALIGN is the required alignment (a power of two), or 0 for no preference.
+* @return the memory, or nullptr on failure.
+*/
+void* SlabAllocator::take(const uint32_t LEN, const uint32_t ALIGN) {
+  if ((0 == LEN) || (0 != (ALIGN & (ALIGN - 1))) || (C3P_SLAB_MAX_ALIGN < ALIGN)) {
+    _failures++;
+    return nullptr;
+  }
+  const uint32_t NEED = strict_max(LEN, ALIGN);
+  void* ret = nullptr;
+  _lock();
+  if (_carve()) {
+    bool passed_over = false;
+    for (uint8_t c = 0; (c < _class_count) && (nullptr == ret); c++) {
+      SlabClass* slab = &_classes[c];
+      if (slab->size >= NEED) {
+        if (nullptr != slab->free_list) {
+          ret = slab->free_list;
+          slab->free_list = *((void**) ret);
+          slab->req_len[((uint8_t*) ret - slab->base) / slab->size] = LEN;
+          slab->req_bytes += LEN;
+          slab->in_use++;
+          if (slab->high_water < slab->in_use) {
+            slab->high_water = slab->in_use;
+          }
+          if (passed_over) {
+            slab->spills++;
+          }
+        }
+        passed_over = true;
+      }
+    }
+  }
+  if (nullptr == ret) {
+    if (_heap_fallback & (alignof(max_align_t) >= ALIGN)) {
+      ret = malloc(LEN);
+    }
+    if (nullptr != ret) {  _overdraws++;  }
+    else {                 _failures++;   }
+  }
+  _unlock();
+  return ret;
+}
+
+
+/**
+* Reclaims the given memory.
+*
+* @param ptr is the memory to be reclaimed.
+* @return 1 if the memory was returned to the arena, 0 if it was free()'d, or
+*   -1 if the pointer was null, or inside the arena but not at a block.
+*/
+int8_t SlabAllocator::give(void* ptr) {
+  int8_t ret = -1;
+  if (nullptr == ptr) {
+    return ret;
+  }
+  _lock();
+  SlabClass* slab = _class_for(ptr);
+  if (nullptr != slab) {
+    const uint32_t OFFSET = (uint32_t) ((uint8_t*) ptr - slab->base);
+    const uint32_t IDX    = (OFFSET / slab->size);
+    if ((0 == (OFFSET % slab->size)) && (0 < slab->req_len[IDX])) {
+      slab->req_bytes -= slab->req_len[IDX];
+      slab->req_len[IDX] = 0;
+      slab->in_use--;
+      *((void**) ptr) = slab->free_list;
+      slab->free_list = ptr;
+      ret = 1;
+    }
+  }
+  else if (!inPool(ptr)) {
+    // This memory was never ours, or came from the heap fallback.
+    _overdraws_freed++;
+    free(ptr);
+    ret = 0;
+  }
+  _unlock();
+  return ret;
+}
+
+
+/**
+* @return the number of bytes that may be used at the given block, or 0 if it
+*   did not come from the arena.
+*/
+uint32_t SlabAllocator::usableSize(void* ptr) {
+  SlabClass* slab = _class_for(ptr);
+  return ((nullptr != slab) ? slab->size : 0);
+}
+
+
+/**
+* Internal fragmentation of a class is the fraction of the bytes in taken
+*   blocks that the callers did not ask for.
+*
+* @return the fragmentation of the given class, in percent.
+*/
+uint8_t SlabAllocator::fragmentation(uint8_t c) {
+  uint8_t ret = 0;
+  if (c < _class_count) {
+    const uint64_t BYTES_TAKEN = ((uint64_t) _classes[c].in_use * _classes[c].size);
+    if (0 < BYTES_TAKEN) {
+      ret = (uint8_t) (((BYTES_TAKEN - _classes[c].req_bytes) * 100) / BYTES_TAKEN);
+    }
+  }
+  return ret;
+}
+
+
+/**
+* @return the number of blocks currently taken from the arena, across all
+*   classes. Heap overdraws are not counted.
+*/
+uint32_t SlabAllocator::blocksInUse() {
+  uint32_t ret = 0;
+  _lock();
+  for (uint8_t c = 0; c < _class_count; c++) {  ret += _classes[c].in_use;  }
+  _unlock();
+  return ret;
+}
+
+
+/**
+* Render the state of every class.
+* The numbers are copied out first, since the output might come from us.
+*
+* @param output is the buffer to receive the report.
+*/
+void SlabAllocator::printDebug(StringBuilder* output) {
+  SlabClass snapshot[C3P_SLAB_MAX_CLASSES];
+  uint8_t   frag[C3P_SLAB_MAX_CLASSES];
+  _lock();
+  const bool READY = _carve();
+  memcpy(snapshot, _classes, sizeof(snapshot));
+  for (uint8_t c = 0; c < _class_count; c++) {  frag[c] = fragmentation(c);  }
+  const uint32_t OVERDRAWS       = _overdraws;
+  const uint32_t OVERDRAWS_FREED = _overdraws_freed;
+  const uint32_t FAILURES        = _failures;
+  _unlock();
+
+  output->concatf("SlabAllocator (%sReady)\n", READY ? "" : "Not ");
+  output->concatf("\tArena(%p): %u bytes%s\n", (uintptr_t) _arena, arenaSize(), (_we_own_the_arena ? "" : " (external)"));
+  output->concat("\t   Size | Blocks | In use | High water | Spills | Frag\n");
+  output->concat("\t--------+--------+--------+------------+--------+-----\n");
+  for (uint8_t c = 0; c < _class_count; c++) {
+    output->concatf(
+      "\t %6u | %6u | %6u | %10u | %6u | %3u%%\n",
+      snapshot[c].size, snapshot[c].count, snapshot[c].in_use,
+      snapshot[c].high_water, snapshot[c].spills, frag[c]
+    );
+  }
+  if (_heap_fallback) {
+    output->concatf("\tHeap overdraws/frees:  %u/%u\n", OVERDRAWS, OVERDRAWS_FREED);
+  }
+  else {
+    output->concat("\tHeap fallback is disallowed.\n");
+  }
+  output->concatf("\tFailures:              %u\n", FAILURES);
+}
+
+
+/*******************************************************************************
+* Private functions
+*******************************************************************************/
+
+/*
+* Allocates the arena (if needed) and carves it into classes. The largest class
+*   goes first, so that every class lands on a multiple of its own block size
+*   (up to C3P_SLAB_MAX_ALIGN). The length ledgers go after the blocks.
+* Must be called with the lock held.
+*/
+bool SlabAllocator::_carve() {
+  if (nullptr != _blocks_hi) {
+    return true;
+  }
+  if (nullptr == _arena) {
+    _arena = (uint8_t*) malloc(arenaSize());
+    if (nullptr == _arena) {
+      return false;
+    }
+    _we_own_the_arena = true;
+  }
+
+  const uintptr_t ALIGN_MASK = (uintptr_t) (C3P_SLAB_MAX_ALIGN - 1);
+  uint8_t* cursor = (uint8_t*) (((uintptr_t) _arena + ALIGN_MASK) & ~ALIGN_MASK);
+  _blocks_lo = cursor;
+  for (int c = (_class_count - 1); c >= 0; c--) {
+    SlabClass* slab = &_classes[c];
+    slab->base      = cursor;
+    slab->free_list = nullptr;
+    // Link the blocks so that the lowest address is taken first.
+    for (int i = (slab->count - 1); i >= 0; i--) {
+      void* block = (void*) (slab->base + ((uint32_t) i * slab->size));
+      *((void**) block) = slab->free_list;
+      slab->free_list = block;
+    }
+    cursor += ((uint32_t) slab->count * slab->size);
+  }
+  uint8_t* blocks_end = cursor;
+  for (uint8_t c = 0; c < _class_count; c++) {
+    _classes[c].req_len = (uint32_t*) cursor;
+    memset(cursor, 0, (_classes[c].count * sizeof(uint32_t)));
+    cursor += (_classes[c].count * sizeof(uint32_t));
+  }
+  _blocks_hi = blocks_end;
+  return true;
+}
+
+
+/*
+* @return the class that owns the given memory, or nullptr if none does.
+*/
+SlabClass* SlabAllocator::_class_for(void* ptr) {
+  if (inPool(ptr)) {
+    for (uint8_t c = 0; c < _class_count; c++) {
+      SlabClass* slab = &_classes[c];
+      if (((uint8_t*) ptr >= slab->base) && ((uint8_t*) ptr < (slab->base + ((uint32_t) slab->count * slab->size)))) {
+        return slab;
+      }
+    }
+  }
+  return nullptr;
+}
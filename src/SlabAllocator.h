@@ -0,0 +1,130 @@
+/*
+File:   SlabAllocator.h
+Author: J. Ian Lindsay
+Date:   2026.10.16
+
+Copyright 2016 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+A preallocated allocator for variable-length memory, with power-of-two size
+  classes.
+
+ElementPool handles one fixed type. This class handles raw bytes of any length
+  up to its largest size class. Each class is a run of equal blocks carved from
+  a single arena, and a request is served from the smallest class that fits. If
+  that class is empty, the next larger one is tried. If every suitable class is
+  empty, the request either falls back to the heap (by default), or fails.
+
+Constraints:
+--------------------------------------------------------------------------------
+1) The arena can be supplied by the caller (see arenaSize()), or will be
+    malloc()'d on first use. Either way, it is the only allocation this class
+    will make, apart from heap fallback.
+2) Blocks are aligned to their own size, up to C3P_SLAB_MAX_ALIGN bytes.
+3) give() will free() anything that did not come from the arena, so it is safe
+    to pass it memory that came from the heap fallback, or from malloc().
+4) If heap fallback is disabled, memory use is fixed and deterministic. Callers
+    must then handle nullptr from take().
+5) All classes share a lock if the build has threads.
+*/
+
+#ifndef __C3P_SLAB_ALLOCATOR_H
+#define __C3P_SLAB_ALLOCATOR_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "StringBuilder.h"
+
+#define C3P_SLAB_MAX_CLASSES   12   // 16 bytes to 32KiB, with the default MIN_SHIFT.
+#define C3P_SLAB_MAX_ALIGN     64   // The largest alignment that take() will honor.
+
+/* The bookkeeping for a single size class. */
+typedef struct {
+  uint8_t*  base;         // The first block of this class.
+  uint32_t* req_len;      // The requested length of each block. Zero if free.
+  void*     free_list;    // Intrusive list of free blocks.
+  uint32_t  size;         // Bytes per block.
+  uint32_t  req_bytes;    // Sum of requested lengths of blocks in use.
+  uint32_t  spills;       // Requests served here because smaller classes were empty.
+  uint16_t  count;        // Blocks in this class.
+  uint16_t  in_use;       // Blocks currently taken.
+  uint16_t  high_water;   // The most blocks that have ever been taken at once.
+} SlabClass;
+
+
+class SlabAllocator {
+  public:
+    SlabAllocator(const uint16_t* BLOCK_COUNTS, const uint8_t CLASS_COUNT, const uint8_t MIN_SHIFT = 4, uint8_t* ARENA = nullptr);
+    ~SlabAllocator();
+
+    bool     allocated();
+    bool     inPool(void*);
+    void*    take(const uint32_t LEN, const uint32_t ALIGN = 0);
+    int8_t   give(void*);
+    uint32_t usableSize(void*);    // The block size, or 0 if not from the arena.
+
+    inline uint8_t  classCount() {             return _class_count;                 };
+    inline uint32_t classSize(uint8_t c) {     return ((c < _class_count) ? _classes[c].size : 0);  };
+    inline uint32_t capacity(uint8_t c) {      return ((c < _class_count) ? _classes[c].count : 0);  };
+    inline uint32_t inUse(uint8_t c) {         return ((c < _class_count) ? _classes[c].in_use : 0);  };
+    inline uint32_t highWater(uint8_t c) {     return ((c < _class_count) ? _classes[c].high_water : 0);  };
+    inline uint32_t spills(uint8_t c) {        return ((c < _class_count) ? _classes[c].spills : 0);  };
+    uint8_t  fragmentation(uint8_t c);   // Percent of the class's in-use bytes that were not asked for.
+    uint32_t blocksInUse();              // Blocks currently taken, across all classes.
+
+    inline void     heapFallback(bool x) {     _heap_fallback = x;       };
+    inline bool     heapFallback() {           return _heap_fallback;    };
+    inline uint32_t overdraws() {              return _overdraws;        };
+    inline uint32_t overdrawsFreed() {         return _overdraws_freed;  };
+    inline uint32_t failures() {               return _failures;         };
+    inline uint32_t arenaSize() {              return arenaSize(_counts, _class_count, _MIN_SHIFT);  };
+
+    void printDebug(StringBuilder*);
+
+    static uint32_t arenaSize(const uint16_t* BLOCK_COUNTS, const uint8_t CLASS_COUNT, const uint8_t MIN_SHIFT = 4);
+
+
+  private:
+    const uint8_t _MIN_SHIFT;
+    uint8_t   _class_count;
+    bool      _heap_fallback;       // Should take() use malloc() when the arena can't serve?
+    bool      _we_own_the_arena;
+    bool      _busy;                // Lock for threaded builds.
+    uint8_t*  _arena;               // The arena, as allocated or given.
+    uint8_t*  _blocks_lo;           // The aligned start of the blocks.
+    uint8_t*  _blocks_hi;           // The end of the blocks. Zero until carved.
+    uint32_t  _overdraws;           // Requests served by the heap.
+    uint32_t  _overdraws_freed;     // Heap memory that came back through give().
+    uint32_t  _failures;            // Requests that returned nullptr.
+    uint16_t  _counts[C3P_SLAB_MAX_CLASSES];
+    SlabClass _classes[C3P_SLAB_MAX_CLASSES];
+
+    bool       _carve();
+    SlabClass* _class_for(void*);
+
+    inline void _lock() {
+      #if defined(__BUILD_HAS_THREADS)
+        while (__atomic_test_and_set(&_busy, __ATOMIC_ACQUIRE)) {}
+      #endif
+    };
+
+    inline void _unlock() {
+      #if defined(__BUILD_HAS_THREADS)
+        __atomic_clear(&_busy, __ATOMIC_RELEASE);
+      #endif
+    };
+};
+
+#endif  // __C3P_SLAB_ALLOCATOR_H
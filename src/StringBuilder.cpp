@@ -20,6 +20,11 @@ limitations under the License.
 
 #include "StringBuilder.h"
 #include "CppPotpourri.h"
+#include "Meta/Intrinsics.h"
+#include "SlabAllocator.h"
+#if defined(CONFIG_C3P_STRLL_POOL)
+  #include "ElementPool.h"
+#endif
 
 
 /*******************************************************************************
@@ -33,6 +38,248 @@ limitations under the License.
 * Static members and initializers should be located here.
 *******************************************************************************/
 
+uint32_t StringBuilder::_stat_frag_allocs   = 0;
+uint32_t StringBuilder::_stat_inline_writes = 0;
+uint32_t StringBuilder::_stat_pool_hits     = 0;
+uint32_t StringBuilder::_stat_pool_misses   = 0;
+SlabAllocator* StringBuilder::_allocator    = nullptr;
+
+/*
+* Memory for string content that lives apart from its StrLL (shared or
+*   unshared bytes) comes from the same source as the fragments themselves.
+*/
+static inline void* _strll_mem_take(const uint32_t LEN) {
+  SlabAllocator* alloc = StringBuilder::allocator();
+  return ((nullptr != alloc) ? alloc->take(LEN) : malloc(LEN));
+}
+
+/* The allocator will free() anything that it didn't issue. */
+static inline void _strll_mem_give(void* mem) {
+  SlabAllocator* alloc = StringBuilder::allocator();
+  if (nullptr != alloc) {  alloc->give(mem);  }
+  else {                   free(mem);         }
+}
+
+/* The location of string content that was allocated along with its StrLL. */
+static inline uint8_t* _strll_base(StrLL* frag) {
+  return (((uint8_t*) frag) + sizeof(StrLL));
+}
+
+/* Shared fragments keep their StrLLShare in the ext member. */
+static inline StrLLShare* _strll_share(StrLL* frag) {
+  return ((STRLL_CAP_SHARED == frag->cap) ? ((StrLLShare*) frag->ext) : nullptr);
+}
+
+static inline uint32_t _strll_share_adjust(StrLLShare* share, const int32_t DELTA) {
+  #if defined(__BUILD_HAS_THREADS)
+    return __atomic_add_fetch(&share->refs, DELTA, __ATOMIC_ACQ_REL);
+  #else
+    share->refs += DELTA;
+    return share->refs;
+  #endif
+}
+
+/* Drops a reference, and frees the bytes if it was the last one. */
+static void _strll_share_release(StrLLShare* share) {
+  if (0 == _strll_share_adjust(share, -1)) {
+    if (share->buf != (((uint8_t*) share) + sizeof(StrLLShare))) {
+      _strll_mem_give(share->buf);   // Bytes that were adopted from a separate allocation.
+    }
+    _strll_mem_give(share);
+  }
+}
+
+/*
+* Convert a fragment to the shared form, if it isn't already. Bytes that were
+*   separately allocated are adopted without copying. Bytes that were merged
+*   with the fragment must be moved to an allocation that can outlive it.
+*
+* @return 0 on success, or -1 on allocation failure (which leaves the fragment as it was).
+*/
+static int8_t _strll_make_shared(StrLL* frag) {
+  if (STRLL_CAP_SHARED == frag->cap) {
+    return 0;
+  }
+  StrLLShare* share = nullptr;
+  if (nullptr != frag->ext) {
+    share = (StrLLShare*) _strll_mem_take(sizeof(StrLLShare));
+    if (nullptr == share) {
+      return -1;
+    }
+    share->buf = frag->ext;
+  }
+  else {
+    share = (StrLLShare*) _strll_mem_take(sizeof(StrLLShare) + frag->len + 1);
+    if (nullptr == share) {
+      return -1;
+    }
+    share->buf = (((uint8_t*) share) + sizeof(StrLLShare));
+    memcpy(share->buf, frag->str, frag->len);
+    *(share->buf + frag->len) = 0;   // Guard-rail.
+    frag->str = share->buf;
+  }
+  share->refs = 1;
+  frag->ext = (uint8_t*) share;
+  frag->cap = STRLL_CAP_SHARED;
+  return 0;
+}
+
+/*
+* Give a shared fragment its own copy of its bytes, so that it may be written.
+*   No-op for fragments that are not shared.
+*
+* @return 0 on success, or -1 on allocation failure (which leaves the fragment as it was).
+*/
+static int8_t _strll_unshare(StrLL* frag) {
+  StrLLShare* share = _strll_share(frag);
+  if (nullptr == share) {
+    return 0;
+  }
+  uint8_t* priv = (uint8_t*) _strll_mem_take(frag->len + 1);
+  if (nullptr == priv) {
+    return -1;
+  }
+  memcpy(priv, frag->str, frag->len);
+  *(priv + frag->len) = 0;   // Guard-rail.
+  _strll_share_release(share);
+  frag->str = priv;
+  frag->ext = priv;
+  frag->cap = frag->len;
+  return 0;
+}
+
+
+/*
+* Token parsers. These take a pointer and a length, and so do not require the
+*   token to be NUL-terminated. They back both the position_as_*() and the
+*   view_as_*() families.
+*/
+
+/* We only accept single-character tokens: (0/1), (n/y), (f/t). */
+static bool _token_as_bool(const uint8_t* tok, const int LEN) {
+  if (1 == LEN) {
+    switch (*tok) {
+      case '1':  case 'y':  case 'Y':  case 't':  case 'T':
+        return true;
+      default:
+        break;
+    }
+  }
+  return false;
+}
+
+/* Parses up to MAX_DIGITS hex digits, stopping at the first non-hex character. */
+static uint64_t _token_as_hex(const uint8_t* tok, const int LEN, const int MAX_DIGITS) {
+  uint64_t result = 0;
+  const int DIGITS = strict_min((int32_t) LEN, (int32_t) MAX_DIGITS);
+  for (int i = 0; i < DIGITS; i++) {
+    const int8_t NYBBLE = StringBuilder::hex_char_to_nybble((const char) *(tok + i));
+    if (0 > NYBBLE) {
+      break;
+    }
+    result = (result << 4) + NYBBLE;
+  }
+  return result;
+}
+
+/*
+* Parses a decimal number with the same leniency as strtoull(): leading
+*   whitespace and a sign are accepted, and parsing stops at the first
+*   character that is not a digit.
+*/
+static uint64_t _token_as_decimal(const uint8_t* tok, const int LEN, bool* negative) {
+  uint64_t result = 0;
+  int i = 0;
+  while ((i < LEN) && isspace(*(tok + i))) {  i++;  }
+  *negative = ((i < LEN) && ('-' == *(tok + i)));
+  if ((i < LEN) && (('-' == *(tok + i)) || ('+' == *(tok + i)))) {  i++;  }
+  while ((i < LEN) && isdigit(*(tok + i))) {
+    result = (result * 10) + (*(tok + i) - '0');
+    i++;
+  }
+  return result;
+}
+
+static int _token_as_int(const uint8_t* tok, const int LEN) {
+  if ((LEN > 2) && ('0' == *(tok)) && ('x' == *(tok + 1))) {
+    return (int) _token_as_hex((tok + 2), (LEN - 2), 8);
+  }
+  bool negative = false;
+  const int32_t MAGNITUDE = (int32_t) _token_as_decimal(tok, LEN, &negative);
+  return (negative ? -MAGNITUDE : MAGNITUDE);
+}
+
+static uint64_t _token_as_uint64(const uint8_t* tok, const int LEN) {
+  if ((LEN > 2) && ('0' == *(tok)) && ('x' == *(tok + 1))) {
+    return _token_as_hex((tok + 2), (LEN - 2), 16);
+  }
+  bool negative = false;
+  const uint64_t MAGNITUDE = _token_as_decimal(tok, LEN, &negative);
+  return (negative ? (0 - MAGNITUDE) : MAGNITUDE);
+}
+
+/*
+* The C library offers no length-bounded strtod(), so the token is copied to
+*   the stack. No legible double needs more than a few dozen characters.
+*/
+static double _token_as_double(const uint8_t* tok, const int LEN) {
+  char temp[48];
+  const int COPY_LEN = strict_min((int32_t) LEN, (int32_t) (sizeof(temp) - 1));
+  memcpy(temp, tok, COPY_LEN);
+  temp[COPY_LEN] = 0;
+  return atof(temp);
+}
+
+/*
+* Parse hex-encoded bytes. Whitespace is ignored, but realigns the nybble
+*   boundary.
+*
+* @return the number of bytes written to out, or -1 if the token has anything
+*   else in it, or doesn't fit.
+*/
+static int _token_hex_to_bytes(const uint8_t* tok, const int LEN, uint8_t* out, const int OUT_LEN) {
+  int byte_idx = 0;
+  uint8_t tmp_byte = 0;
+  bool high_nib = true;
+  for (int i = 0; i < LEN; i++) {
+    if (high_nib) {
+      // Runs of whole bytes are decoded in bulk.
+      const int DECODED = hex_decode_pairs((tok + i), (LEN - i), (out + byte_idx), (OUT_LEN - byte_idx));
+      byte_idx += DECODED;
+      i += (DECODED << 1);
+      if (i >= LEN) {
+        break;
+      }
+    }
+    const int8_t TMP_NIB = StringBuilder::hex_char_to_nybble((const char) *(tok + i));
+    if (0 <= TMP_NIB) {
+      tmp_byte = (tmp_byte << 4);
+      tmp_byte |= TMP_NIB;
+      if (!high_nib) {
+        // If this was the last of a byte boundary, store the byte.
+        if (byte_idx >= OUT_LEN) {
+          return -1;
+        }
+        out[byte_idx++] = tmp_byte;
+        tmp_byte = 0;
+      }
+      high_nib = !high_nib;
+    }
+    else {
+      switch (*(tok + i)) {
+        case ' ':   // Most whitespace is ignored, but resets bit counter.
+        case '\t':
+        case '\r':
+          high_nib = true;
+          break;
+        default:
+          return -1;
+      }
+    }
+  }
+  return byte_idx;
+}
+
 /*
 * Trim the whitespace from the beginning and end of the input string.
 *
@@ -43,13 +290,12 @@ limitations under the License.
 *   should be retained if memory management is required.
 */
 char* StringBuilder::trim(char* str) {
-  char* end;
-  while(isspace(*str)) str++;
-  if(*str == 0) return str;
-  end = str + strlen(str) - 1;
-  while(end > str && isspace(*end)) end--;
-  *(end+1) = '\0';
-  return str;
+  const int LEN     = strlen(str);
+  const int LEADING = ascii_whitespace_span((const uint8_t*) str, LEN);
+  if (LEADING < LEN) {
+    *(str + (LEN - ascii_whitespace_rspan((const uint8_t*) str, LEN))) = '\0';
+  }
+  return (str + LEADING);
 }
 
 
@@ -128,24 +374,7 @@ char* StringBuilder::deep_copy(const char* src, const unsigned int MAX_COPY_LEN)
 
 
 int8_t StringBuilder::hex_char_to_nybble(const char C) {
-  int8_t ret = -1;
-  switch (C) {
-    case '0':  case '1':  case '2':  case '3':  case '4':
-    case '5':  case '6':  case '7':  case '8':  case '9':
-      ret = (C - 0x30);
-      break;
-    case 'a':  case 'b':  case 'c':  case 'd':
-    case 'e':  case 'f':
-      ret = (10 + (C - 0x61));
-      break;
-    case 'A':  case 'B':  case 'C':  case 'D':
-    case 'E':  case 'F':
-      ret = (10 + (C - 0x41));
-      break;
-    default:
-      break;  // Any other character
-  }
-  return ret;
+  return ascii_hex_nybble((const uint8_t) C);
 }
 
 /**
@@ -158,26 +387,50 @@ int8_t StringBuilder::hex_char_to_nybble(const char C) {
 */
 void StringBuilder::printBuffer(StringBuilder* output, uint8_t* buf, uint32_t len, const char* indent) {
   if ((nullptr != buf) & (len > 0)) {
-    uint32_t i = 0;
-    while (len >= 16) {
-      output->concatf("%s0x%04x: %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x\n",
-        indent, i,
-        *(buf + i +  0), *(buf + i +  1), *(buf + i +  2), *(buf + i +  3),
-        *(buf + i +  4), *(buf + i +  5), *(buf + i +  6), *(buf + i +  7),
-        *(buf + i +  8), *(buf + i +  9), *(buf + i + 10), *(buf + i + 11),
-        *(buf + i + 12), *(buf + i + 13), *(buf + i + 14), *(buf + i + 15)
-      );
-      i += 16;
-      len -= 16;
-    }
-    if (len > 0) {
-      output->concatf("%s0x%04x: ", indent, i);
-      while (len > 0) {
-        output->concatf("%02x ", *(buf + i));
-        i++;
-        len--;
+    // The output length is known ahead of time, so we claim it all at once and
+    //   render in place, rather than taking a trip through concatf() for each
+    //   line and byte.
+    const uint32_t INDENT_LEN = strlen(indent);
+    uint32_t total_len = 0;
+    for (uint32_t i = 0; i < len; i += 16) {
+      const uint32_t LINE_BYTES = strict_min((uint32_t) (len - i), (uint32_t) 16);
+      uint32_t offset_digits = 4;
+      while ((offset_digits < 8) && (0 != (i >> (offset_digits << 2)))) {  offset_digits++;  }
+      total_len += (INDENT_LEN + offset_digits + 5 + (LINE_BYTES * 3) - ((16 == LINE_BYTES) ? 1 : 0));
+    }
+
+    uint8_t* dest = nullptr;
+    switch (output->_claim_tail_space((int) total_len, &dest, true)) {
+      case 0:
+        break;
+      case 1:
+        {
+          StrLL* nu_element = output->_create_str_ll((int) total_len, nullptr, nullptr, (int) total_len);
+          if (nullptr == nu_element) {
+            return;
+          }
+          dest = nu_element->str;
+          output->_stack_str_onto_list(nu_element);
+        }
+        break;
+      default:
+        return;   // Refused by the arena.
+    }
+
+    for (uint32_t i = 0; i < len; i += 16) {
+      const uint32_t LINE_BYTES = strict_min((uint32_t) (len - i), (uint32_t) 16);
+      memcpy(dest, indent, INDENT_LEN);
+      dest += INDENT_LEN;
+      dest += sprintf((char*) dest, "0x%04x: ", (unsigned int) i);
+      for (uint32_t n = 0; n < LINE_BYTES; n++) {
+        hex_encode_bytes((buf + i + n), 1, (char*) dest);
+        *(dest + 2) = ' ';
+        dest += 3;
       }
-      output->concat("\n");
+      if (16 == LINE_BYTES) {
+        dest--;   // Complete lines have no trailing space.
+      }
+      *dest++ = '\n';
     }
   }
   else {
@@ -234,7 +487,8 @@ void StringBuilder::styleHeader2(StringBuilder* output, const char* text) {
 /**
 * Vanilla constructor.
 */
-StringBuilder::StringBuilder() : _root(nullptr) {
+StringBuilder::StringBuilder() : _root(nullptr), _arena(nullptr), _index(nullptr),
+  _views(nullptr), _view_count(0), _view_cap(0), _flags(0) {
   #if defined(__BUILD_HAS_PTHREADS)
     #if defined (PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP)
     _mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
@@ -275,6 +529,12 @@ StringBuilder::~StringBuilder() {
     _destroy_str_ll(_root);
     _root = nullptr;
   }
+  if ((nullptr != _arena) && _flags.value(STRBLDR_FLAG_ARENA_OURS)) {
+    free(_arena);
+  }
+  _arena = nullptr;
+  indexFragments(false);
+  dropViews();
   #if defined(__BUILD_HAS_PTHREADS)
     pthread_mutex_destroy(&_mutex);
   #endif
@@ -292,6 +552,9 @@ StringBuilder::~StringBuilder() {
 */
 int StringBuilder::length() {
   int return_value = 0;
+  if (_index_ready()) {
+    return ((0 < _index->count) ? _index->ends[_index->count - 1] : 0);
+  }
   if (_root != nullptr) {
     return_value += _total_str_len(_root);
   }
@@ -329,6 +592,9 @@ bool StringBuilder::isEmpty(const bool strict) {
 * @return The number of linked-lists that are being used to hold this string
 */
 unsigned short StringBuilder::count() {
+  if (_index_ready()) {
+    return (unsigned short) _index->count;
+  }
   unsigned short return_value = 0;
   StrLL* current = _root;
   while (current != nullptr) {
@@ -404,6 +670,7 @@ void StringBuilder::clear() {
   #endif
   if (_root != nullptr) _destroy_str_ll(_root);
   _root = nullptr;
+  _flags.clear(STRBLDR_FLAG_ARENA_OVERFLOW);  // Nothing is missing from an empty string.
   #if defined(__BUILD_HAS_CONCURRENT_STRINGBUILDER)
     // TODO: Unlock with semaphore.
   #endif
@@ -416,9 +683,10 @@ void StringBuilder::clear() {
 void StringBuilder::toUpper() {
   StrLL *current = _root;
   while (current != nullptr) {   // Process the fragments (if any).
-    for (int i = 0; i < current->len; i++) {
-      *(current->str + i) = toupper(*(current->str + i));
+    if (0 != _strll_unshare(current)) {
+      return;
     }
+    ascii_case_shift(current->str, current->len, true);
     current = current->next;
   }
 }
@@ -430,9 +698,10 @@ void StringBuilder::toUpper() {
 void StringBuilder::toLower() {
   StrLL *current = _root;
   while (current != nullptr) {   // Process the fragments (if any).
-    for (int i = 0; i < current->len; i++) {
-      *(current->str + i) = tolower(*(current->str + i));
+    if (0 != _strll_unshare(current)) {
+      return;
     }
+    ascii_case_shift(current->str, current->len, false);
     current = current->next;
   }
 }
@@ -445,13 +714,13 @@ void StringBuilder::toLower() {
 * @return A pointer to the requested token, or nullptr on failure.
 */
 char* StringBuilder::position(int pos) {
-  StrLL* current = _root;
-  int i = 0;
-  while ((i != pos) & (nullptr != current)){
-    current = current->next;
-    i++;
+  StrLL* current = _position(pos);
+  // The caller may write to what we return, and will expect it to end in a NUL.
+  //   A shared fragment gives neither assurance, so it gets its own copy.
+  if ((nullptr != current) && (0 == _strll_unshare(current))) {
+    return (char*) current->str;
   }
-  return ((nullptr != current) ? (char*)current->str : (char*) "");
+  return (char*) "";
 }
 
 
@@ -464,31 +733,8 @@ char* StringBuilder::position(int pos) {
 * @return Parsed boolean value, or false on failure.
 */
 bool StringBuilder::position_as_bool(int pos) {
-  const char* temp = (const char*) position(pos);
-  if (nullptr != temp) {
-    // We only accept single-character tokens.
-    if (1 == strlen(temp)) {
-      switch (*temp) {
-        case '1':
-        case 'y':
-        case 'Y':
-        case 't':
-        case 'T':
-          return true;
-
-        case '0':
-        case 'n':
-        case 'N':
-        case 'f':
-        case 'F':
-          return false;
-
-        default:
-          break;
-      }
-    }
-  }
-  return false;
+  StrLL* current = _position(pos);
+  return ((nullptr != current) && _token_as_bool(current->str, current->len));
 }
 
 
@@ -506,46 +752,23 @@ int StringBuilder::hex_to_bin(int pos) {
   StrLL* current = _position(pos);
   if (current != nullptr) {
   //while (current != nullptr) {
-    const uint8_t* temp = current->str;
     const int LEN = current->len;
-
     if (0 < LEN) {
       uint8_t tmp_bytes[(LEN >> 1) + (LEN & 1)] = {0};
-      int byte_idx = 0;
-      uint8_t tmp_byte = 0;
-      int8_t tmp_nib  = 0;
-      bool high_nib = true;
-
-      for (int i = 0; i < LEN; i++) {
-        tmp_nib = hex_char_to_nybble((const char)*(temp + i));
-        if (0 <= tmp_nib) {
-          tmp_byte = (tmp_byte << 4);
-          tmp_byte |= tmp_nib;
-          if (!high_nib) {
-            // If this was the last of a byte boundary, store the byte.
-            tmp_bytes[byte_idx++] = tmp_byte;
-            tmp_byte = 0;
-          }
-          high_nib = !high_nib;
-        }
-        else {
-          switch (*(temp + i)) {
-            case ' ':   // Most whitespace is ignored, but resets bit counter.
-            case '\t':
-            case '\r':
-              high_nib = true;
-              break;
-            default:
-              return result;  // Any other character aborts the parse.
-          }
-        }
+      const int BYTE_COUNT = _token_hex_to_bytes(current->str, LEN, tmp_bytes, sizeof(tmp_bytes));
+      if (0 > BYTE_COUNT) {
+        return result;  // Any character outside of the hex alphabet aborts the parse.
       }
       // Execution arriving here implies the entire token was composed of characters
       //   in the hex alphabet. So we can now re-write the token's content and length
       //   to reflect so.
+      if (0 != _strll_unshare(current)) {
+        return result;
+      }
       result++;
-      memcpy(current->str, tmp_bytes, byte_idx);
-      current->len = byte_idx;
+      memcpy(current->str, tmp_bytes, BYTE_COUNT);
+      current->len = BYTE_COUNT;
+      _index_stale();
     }
     //current = current->next;
   }
@@ -560,40 +783,8 @@ int StringBuilder::hex_to_bin(int pos) {
 * @return atoi()'s attempt at parsing the string at the given pos as an int.
 */
 int StringBuilder::position_as_int(int pos) {
-  const char* temp = (const char*) position(pos);
-  if (temp != nullptr) {
-    int len = strlen(temp);
-    if ((len > 2) && (*(temp) == '0') && (*(temp + 1) == 'x')) {
-      // Possibly dealing with a hex representation. Try to convert....
-      uint32_t result = 0;
-      len -= 2;
-      temp += 2;
-      // Only so big an int we can handle...
-      int max_bytes = (len > 8) ? 8 : len;
-      for (int i = 0; i < max_bytes; i++) {
-        switch (*(temp + i)) {
-          case '0':  case '1':  case '2':  case '3':  case '4':
-          case '5':  case '6':  case '7':  case '8':  case '9':
-            result = (result << 4) + (*(temp + i) - 0x30);
-            break;
-          case 'a':  case 'b':  case 'c':  case 'd':
-          case 'e':  case 'f':
-            result = (result << 4) + 10 + (*(temp + i) - 0x61);
-            break;
-          case 'A':  case 'B':  case 'C':  case 'D':
-          case 'E':  case 'F':
-            result = (result << 4) + 10 + (*(temp + i) - 0x41);
-            break;
-          default: return result;
-        }
-      }
-      return result;
-    }
-    else {
-      return atoi(temp);
-    }
-  }
-  return 0;
+  StrLL* current = _position(pos);
+  return ((nullptr != current) ? _token_as_int(current->str, current->len) : 0);
 }
 
 
@@ -604,41 +795,8 @@ int StringBuilder::position_as_int(int pos) {
 * @return atoi()'s attempt at parsing the string at the given pos as an int.
 */
 uint64_t StringBuilder::position_as_uint64(int pos) {
-  const char* temp = (const char*) position(pos);
-  if (temp != nullptr) {
-    int len = strlen(temp);
-    if ((len > 2) && (*(temp) == '0') && (*(temp + 1) == 'x')) {
-      // Possibly dealing with a hex representation. Try to convert....
-      uint64_t result = 0;
-      len -= 2;
-      temp += 2;
-      // Only so big an int we can handle...
-      int max_bytes = (len > 16) ? 8 : len;
-      for (int i = 0; i < max_bytes; i++) {
-        switch (*(temp + i)) {
-          case '0':  case '1':  case '2':  case '3':  case '4':
-          case '5':  case '6':  case '7':  case '8':  case '9':
-            result = (result << 4) + (*(temp + i) - 0x30);
-            break;
-          case 'a':  case 'b':  case 'c':  case 'd':
-          case 'e':  case 'f':
-            result = (result << 4) + 10 + (*(temp + i) - 0x61);
-            break;
-          case 'A':  case 'B':  case 'C':  case 'D':
-          case 'E':  case 'F':
-            result = (result << 4) + 10 + (*(temp + i) - 0x41);
-            break;
-          default: return result;
-        }
-      }
-      return result;
-    }
-    else {
-      char* end = nullptr;
-      return strtoull(temp, &end, 10);
-    }
-  }
-  return 0;
+  StrLL* current = _position(pos);
+  return ((nullptr != current) ? _token_as_uint64(current->str, current->len) : 0);
 }
 
 
@@ -649,16 +807,16 @@ uint64_t StringBuilder::position_as_uint64(int pos) {
 * @return atof()'s attempt at parsing the string at the given pos as a double.
 */
 double StringBuilder::position_as_double(int pos) {
-  const char* temp = (const char*) position(pos);
-  if (temp != nullptr) {
-    return atof(temp);
-  }
-  return 0.0;
+  StrLL* current = _position(pos);
+  return ((nullptr != current) ? _token_as_double(current->str, current->len) : (double) 0);
 }
 
 
 
 StrLL* StringBuilder::_position(const int POS) {
+  if (_index_ready()) {
+    return (((0 <= POS) & (POS < _index->count)) ? _index->frags[POS] : nullptr);
+  }
   StrLL* current = _root;
   int i = 0;
   while ((i != POS) && (nullptr != current)){
@@ -676,8 +834,12 @@ StrLL* StringBuilder::_position(const int POS) {
 */
 uint8_t* StringBuilder::position(int pos, int *pos_len) {
   StrLL* current = _position(pos);
-  *pos_len = (nullptr != current) ? current->len : 0;
-  return ((nullptr != current) ? current->str : (uint8_t*)"");
+  if ((nullptr != current) && (0 == _strll_unshare(current))) {
+    *pos_len = current->len;
+    return current->str;
+  }
+  *pos_len = 0;
+  return (uint8_t*) "";
 }
 
 
@@ -686,13 +848,7 @@ char* StringBuilder::position_trimmed(int pos){
   if (str == nullptr) {
     return (char*) "";
   }
-  char *end;
-  while(isspace(*str)) str++;
-  if(*str == 0) return str;
-  end = str + strlen(str) - 1;
-  while(end > str && isspace(*end)) end--;
-  *(end+1) = 0;
-  return str;
+  return trim(str);
 }
 
 
@@ -745,9 +901,10 @@ void StringBuilder::concatHandoff(StringBuilder* donar) {
     pthread_mutex_lock(&_mutex);
     pthread_mutex_lock(&nu->_mutex);
   #endif
-  if ((nullptr != donar) && (!donar->isEmpty(true))) {
+  if ((nullptr != donar) && (!donar->isEmpty(true)) && (0 == donar->_arena_release())) {
     _stack_str_onto_list(donar->_root);
     donar->_root = nullptr;  // Inform the donar instance...
+    donar->_index_stale();
   }
   #if defined(__BUILD_HAS_PTHREADS)
     // TODO: Both this instance, as well as the argument instance must be unlocked.
@@ -773,7 +930,7 @@ int StringBuilder::concatHandoffPositions(StringBuilder* donar, unsigned int pos
     pthread_mutex_lock(&_mutex);
     pthread_mutex_lock(&donar->_mutex);
   #endif
-  if (nullptr != donar) {
+  if ((nullptr != donar) && (0 == donar->_arena_release())) {
     const uint32_t FRAG_COUNT = strict_min((uint32_t) count, ((uint32_t) donar->count() - pos));
     if (0 < FRAG_COUNT) {
       // Find the first frag to be moved and the donar frag that points to it.
@@ -791,6 +948,7 @@ int StringBuilder::concatHandoffPositions(StringBuilder* donar, unsigned int pos
           current = current->next;
         }
         *donar_splice = current->next;  // Inform the donar instance...
+        donar->_index_stale();
         current->next = nullptr    ;    // Sever the chain of fragments.
         _stack_str_onto_list(move_first);
       }
@@ -815,9 +973,10 @@ void StringBuilder::concatHandoffLimit(StringBuilder* donar, unsigned int len_li
     pthread_mutex_lock(&_mutex);
     pthread_mutex_lock(&donar->_mutex);
   #endif
-  if ((0 < len_limit) && (nullptr != donar) && (!donar->isEmpty(true))) {
+  if ((0 < len_limit) && (nullptr != donar) && (!donar->isEmpty(true)) && (0 == donar->_arena_release())) {
     StrLL* old_root = donar->_root;  // We'll take this for the moment...
     donar->_root = nullptr;          // Inform the donar instance...
+    donar->_index_stale();
     int offset = (len_limit - 1);    // Get the StrLL containing the last byte to be transfered.
     StrLL* ll_with_byte = _get_ll_containing_offset(old_root, &offset);
     if ((nullptr != ll_with_byte) & (0 < offset)) {
@@ -840,8 +999,13 @@ void StringBuilder::concatHandoffLimit(StringBuilder* donar, unsigned int len_li
         const int32_t LEN_LEFT     = (ll_with_byte->len - LEN_RIGHT);
         StrLL* split_left = _create_str_ll(LEN_LEFT, ll_with_byte);
         if (nullptr != split_left) {
-          for (int i = 0; i < LEN_RIGHT; i++) {
-            *(ll_with_byte->str + i) = *(ll_with_byte->str + i + LEN_LEFT);
+          if (STRLL_CAP_SHARED == ll_with_byte->cap) {
+            ll_with_byte->str += LEN_LEFT;   // Shared bytes can't be shifted, but they can be skipped.
+          }
+          else {
+            for (int i = 0; i < LEN_RIGHT; i++) {
+              *(ll_with_byte->str + i) = *(ll_with_byte->str + i + LEN_LEFT);
+            }
           }
           ll_with_byte->len = LEN_RIGHT;
           donar->_root = ll_with_byte;    // Inform the donar instance...
@@ -918,7 +1082,7 @@ void StringBuilder::concatLimit(StringBuilder* donar, unsigned int len_limit) {
 *       to overlook it on accident.
 */
 void StringBuilder::prependHandoff(StringBuilder* donar) {
-  if (nullptr != donar) {
+  if ((nullptr != donar) && (0 == donar->_arena_release())) {
     #if defined(__BUILD_HAS_CONCURRENT_STRINGBUILDER)
       // TODO: Lock with semaphore.
     #endif
@@ -933,6 +1097,8 @@ void StringBuilder::prependHandoff(StringBuilder* donar) {
       // Replace our own root and formally take it from the origin instance.
       _root = new_root;
       donar->_root = nullptr;
+      _index_stale();
+      donar->_index_stale();
     }
     #if defined(__BUILD_HAS_CONCURRENT_STRINGBUILDER)
       // TODO: Unlock with semaphore.
@@ -959,7 +1125,9 @@ void StringBuilder::concatHandoff(uint8_t* buf, int len) {
     StrLL* nu_element = _create_str_ll(4);   // Allocate a stub.
     if (nu_element) {
       nu_element->str = buf;  // By doing this, we will cause destroy to do a
-      nu_element->len = len;  //   separate free() on this member.
+      nu_element->ext = buf;  //   separate free() on this member.
+      nu_element->len = len;
+      nu_element->cap = 0;    // We don't know the true size of the buffer.
       _stack_str_onto_list(nu_element);
     }
     #if defined(__BUILD_HAS_PTHREADS)
@@ -970,6 +1138,61 @@ void StringBuilder::concatHandoff(uint8_t* buf, int len) {
 }
 
 
+/**
+* Append a range of another string by reference, rather than by copy. The
+*   source string's fragments are converted to the shared form (which may cost
+*   one copy of bytes that were merged with their fragment), and this string
+*   gets new fragments that reference the same bytes. Neither string's content
+*   changes, and either may be mutated or destroyed without affecting the other.
+* Pieces no longer than CONFIG_C3P_STRLL_INLINE_LEN, and pieces of the source's
+*   arena, are copied.
+*
+* @param src is the string to share bytes with.
+* @param START_OFFSET is the offset in src at which to begin.
+* @param LEN is the number of bytes to take. Negative means "to the end".
+* @return the number of bytes appended, or -1 on bad parameters or allocation failure.
+*/
+int StringBuilder::concatShared(StringBuilder* src, const int START_OFFSET, const int LEN) {
+  if ((nullptr == src) || (this == src) || (0 > START_OFFSET)) {
+    return -1;
+  }
+  const int SRC_AVAILABLE = (src->length() - START_OFFSET);
+  const int TAKE_LEN = ((0 > LEN) ? SRC_AVAILABLE : strict_min((int32_t) LEN, (int32_t) SRC_AVAILABLE));
+  int taken = 0;
+  int offset = START_OFFSET;
+  StrLL* current = ((0 < TAKE_LEN) ? src->_get_ll_containing_offset(src->_root, &offset) : nullptr);
+  while ((nullptr != current) && (taken < TAKE_LEN)) {
+    const int PIECE_LEN = strict_min((int32_t) (current->len - offset), (int32_t) (TAKE_LEN - taken));
+    if (0 < PIECE_LEN) {
+      StrLL* nu_element = nullptr;
+      const bool SHARE = (PIECE_LEN > CONFIG_C3P_STRLL_INLINE_LEN) && (src->_arena != current);
+      if (SHARE && (0 == _strll_make_shared(current))) {
+        nu_element = _create_str_ll(4);   // Allocate a stub.
+        if (nullptr != nu_element) {
+          StrLLShare* share = _strll_share(current);
+          _strll_share_adjust(share, 1);
+          nu_element->str = (current->str + offset);
+          nu_element->ext = (uint8_t*) share;
+          nu_element->len = PIECE_LEN;
+          nu_element->cap = STRLL_CAP_SHARED;
+        }
+      }
+      else {
+        nu_element = _create_str_ll(PIECE_LEN, (current->str + offset));
+      }
+      if (nullptr == nu_element) {
+        return -1;
+      }
+      _stack_str_onto_list(nu_element);
+      taken += PIECE_LEN;
+    }
+    offset = 0;
+    current = current->next;
+  }
+  return taken;
+}
+
+
 /*
 */
 int StringBuilder::cloneClobber(StringBuilder* src_obj) {
@@ -999,6 +1222,26 @@ int StringBuilder::cloneClobber(StringBuilder* src_obj) {
 */
 void StringBuilder::prepend(uint8_t* buf, int len) {
   if ((nullptr != buf) && (len > 0)) {
+    if (nullptr == _root) {
+      concat(buf, len);   // Prepending to nothing is appending.
+      return;
+    }
+    _index_stale();
+    if ((nullptr != _arena) && (_root == _arena)) {
+      // If the arena is holding the front of the string, try to keep it there.
+      const int NEEDED = (_arena->len + len);
+      if ((NEEDED <= _arena->cap) || (0 == _arena_grow(NEEDED))) {
+        memmove((_arena->str + len), _arena->str, _arena->len);
+        memcpy(_arena->str, buf, len);
+        _arena->len = NEEDED;
+        *(_arena->str + NEEDED) = 0;
+        return;
+      }
+      _flags.set(STRBLDR_FLAG_ARENA_OVERFLOW);
+      if (!_flags.value(STRBLDR_FLAG_ARENA_SPILL)) {
+        return;
+      }
+    }
     StrLL* nu_element = _create_str_ll(len, buf, _root);
     if (nullptr != nu_element) {
       _root = nu_element;
@@ -1013,10 +1256,21 @@ void StringBuilder::concat(uint8_t* buf, int len) {
       //pthread_mutex_lock(&_mutex);
     #elif defined(__BUILD_HAS_FREERTOS)
     #endif
-    StrLL* nu_element = _create_str_ll(len, buf);
-
-    if (nu_element != nullptr) {
-      _stack_str_onto_list(nu_element);
+    uint8_t* dest = nullptr;
+    switch (_claim_tail_space(len, &dest)) {
+      case 0:
+        memcpy(dest, buf, len);
+        break;
+      case 1:
+        {
+          StrLL* nu_element = _create_str_ll(len, buf);
+          if (nu_element != nullptr) {
+            _stack_str_onto_list(nu_element);
+          }
+        }
+        break;
+      default:
+        break;   // Refused by the arena.
     }
     #if defined(__BUILD_HAS_PTHREADS)
       //pthread_mutex_unlock(&_mutex);
@@ -1027,11 +1281,12 @@ void StringBuilder::concat(uint8_t* buf, int len) {
 
 
 void StringBuilder::concat(uint8_t nu) {
-  concat(&nu, 1);
+  _concat_stream(&nu, 1);
 }
 void StringBuilder::concat(char nu) {
-  char temp[2] = {nu, 0};
-  concat(temp);
+  if (0 != nu) {   // A char is treated as a string, which would have no length.
+    _concat_stream((const uint8_t*) &nu, 1);
+  }
 }
 void StringBuilder::concat(int nu) {
   char temp[24];
@@ -1064,16 +1319,28 @@ void StringBuilder::concat(StringBuilder* nu) {
   if (nu != nullptr) {
     const uint32_t DONAR_LENGTH = nu->length();
     if (DONAR_LENGTH > 0) {
-      StrLL* frag = _create_str_ll(DONAR_LENGTH, nu->_root, 0);
-      if (nullptr != frag) {
-        _stack_str_onto_list(frag);
+      uint8_t* dest = nullptr;
+      switch (_claim_tail_space(DONAR_LENGTH, &dest)) {
+        case 0:
+          nu->copyToBuffer(dest, DONAR_LENGTH);
+          break;
+        case 1:
+          {
+            StrLL* frag = _create_str_ll(DONAR_LENGTH, nu->_root, 0);
+            if (nullptr != frag) {
+              _stack_str_onto_list(frag);
+            }
+          }
+          break;
+        default:
+          break;   // Refused by the arena.
       }
     }
   }
 }
 
 /**
-* Variadic. No mutex required because all working memory is confined to stack.
+* Variadic. Semantics are the same as printf.
 *
 * @param format is the printf-style formatting string.
 * @param ... are the optional variadics.
@@ -1090,23 +1357,64 @@ int StringBuilder::concatf(const char* format, ...) {
 
 
 /**
-* Variadic. No mutex required because all working memory is confined to stack.
+* Variadic. The output is measured first, and then formatted into memory that
+*   this string does not yet use: a stack buffer for short output, or a new
+*   fragment otherwise. An argument might point into this string, so nothing
+*   here may be moved or written until formatting is done. The result is then
+*   appended as any other write would be.
 *
 * @param format is the printf-style formatting string.
 * @param args is a discrete parameter that contains the optional variadics.
 * @return the byte count written to this StringBuilder, or negative on failure.
 */
 int StringBuilder::concatf(const char* format, va_list args) {
-  int len = strlen(format);
-  unsigned short f_codes = 0;  // Count how many format codes are in use...
-  for (unsigned short i = 0; i < len; i++) {  if (*(format+i) == '%') f_codes++; }
-  // Allocate (hopefully) more space than we will need....
-  const int est_len = len + 512 + (f_codes * 15);   // TODO: Iterate on failure of vsprintf().
-  char temp[est_len];
-  memset(temp, 0, est_len);
-  int ret = 0;
-  ret = vsprintf(temp, format, args);
-  if (ret > 0) concat((char *) temp);
+  va_list args_measured;
+  va_copy(args_measured, args);   // Each pass consumes its own va_list.
+  int ret = vsnprintf(nullptr, 0, format, args_measured);
+  va_end(args_measured);
+  if (0 < ret) {
+    char temp[CONFIG_C3P_STRLL_INLINE_LEN + 1];
+    StrLL* nu_element = nullptr;
+    const uint8_t* formatted = (const uint8_t*) temp;
+    if (ret < (int) sizeof(temp)) {
+      vsnprintf(temp, sizeof(temp), format, args);
+    }
+    else {
+      // The extra byte given to vsnprintf() is for its terminator, which will
+      //   land on the guard-rail that every fragment has.
+      nu_element = _create_str_ll(ret, nullptr, nullptr, ret);
+      if (nullptr == nu_element) {
+        return -1;
+      }
+      vsnprintf((char*) nu_element->str, (ret + 1), format, args);
+      formatted = nu_element->str;
+    }
+
+    uint8_t* dest = nullptr;
+    const int8_t CLAIM = (((nullptr == nu_element) || (nullptr != _arena)) ? _claim_tail_space(ret, &dest, true) : 1);
+    switch (CLAIM) {
+      case 0:
+        memcpy(dest, formatted, ret);
+        break;
+      case 1:
+        if (nullptr == nu_element) {
+          const int CAP = strict_max((int32_t) ret, (int32_t) CONFIG_C3P_STRLL_INLINE_LEN);
+          nu_element = _create_str_ll(ret, (uint8_t*) temp, nullptr, CAP);
+          if (nullptr == nu_element) {
+            return -1;
+          }
+        }
+        _stack_str_onto_list(nu_element);
+        nu_element = nullptr;   // Now owned by the list.
+        break;
+      default:
+        ret = -1;   // Refused by the arena.
+        break;
+    }
+    if (nullptr != nu_element) {
+      _destroy_str_ll(nu_element);
+    }
+  }
   return ret;
 }
 
@@ -1156,6 +1464,71 @@ int StringBuilder::copyToBuffer(uint8_t* buf, const uint32_t LIMIT_LEN, const ui
 }
 
 
+/**
+* Fill an array with the spans of memory that hold the string, in order,
+*   starting from the given offset. No copies are made, and the string is not
+*   mutated. The spans are valid until this object is next mutated.
+* If the string has more fragments than MAX_VECS, the caller can call again
+*   with an offset that accounts for the spans already taken.
+*
+* @param vecs is the array to fill.
+* @param MAX_VECS is the number of elements in the array.
+* @param START_OFFSET is the offset in the string where the first span starts.
+* @return The number of spans written to the array.
+*/
+int StringBuilder::toIOVec(SBIOVec* vecs, const int MAX_VECS, const int START_OFFSET) {
+  int ret = 0;
+  if ((nullptr != _root) && (nullptr != vecs) && (0 < MAX_VECS) && (0 <= START_OFFSET)) {
+    int    idx     = START_OFFSET;
+    StrLL* current = _get_ll_containing_offset(_root, &idx);
+    while ((nullptr != current) && (ret < MAX_VECS)) {
+      if (idx < current->len) {   // Zero-length fragments are skipped.
+        vecs[ret].iov_base = (void*) (current->str + idx);
+        vecs[ret].iov_len  = (size_t) (current->len - idx);
+        ret++;
+      }
+      idx     = 0;
+      current = current->next;
+    }
+  }
+  return ret;
+}
+
+
+/**
+* Discard bytes from the front of the string without copying anything. Whole
+*   fragments are freed, and a fragment that is partially consumed will simply
+*   begin further into its memory, which is reclaimed when it is freed.
+* Unlike cull(), this does not collapse the string.
+*
+* @param LEN The number of bytes to discard.
+* @return The number of bytes discarded.
+*/
+int StringBuilder::consume(const int LEN) {
+  int ret = 0;
+  _index_stale();
+  while ((nullptr != _root) && (ret < LEN)) {
+    const int REMAINING = (LEN - ret);
+    if (_root->len <= REMAINING) {
+      StrLL* drop = _root;
+      _root      = drop->next;
+      drop->next = nullptr;
+      ret += drop->len;
+      _destroy_str_ll(drop);
+    }
+    else {
+      _root->str += REMAINING;
+      _root->len -= REMAINING;
+      if (0 < _root->cap) {   // Unknown capacity stays unknown.
+        _root->cap -= REMAINING;
+      }
+      ret += REMAINING;
+    }
+  }
+  return ret;
+}
+
+
 /**
 * Given an offset and a length, will throw away any part of the string that
 *   falls outside of the given range.
@@ -1169,11 +1542,19 @@ void StringBuilder::cull(int offset, int new_length) {
   #elif defined(__BUILD_HAS_FREERTOS)
   #endif
   const int CURRENT_LENGTH = length();
+  _index_stale();
   if (0 == new_length) {    // If this is a complicated way to clear
     clear();                //   the string, do that instead.
   }
   else if (offset >= 0) {                           // If the offset is positive...
     if (CURRENT_LENGTH >= (offset + new_length)) {  // ...and the range exists...
+      if ((nullptr != _arena) && (0 == _collapse()) && (_root == _arena)) {
+        // The string is held by the arena. Shuffle it in place.
+        memmove(_arena->str, (_arena->str + offset), new_length);
+        _arena->len = new_length;
+        *(_arena->str + new_length) = 0;
+        return;
+      }
       StrLL* culled_str_ll = _create_str_ll(new_length);
       if (nullptr != culled_str_ll) {
         // TODO: Prepend the collapsed string into the list, and eat fragments.
@@ -1208,12 +1589,20 @@ void StringBuilder::cull(int x) {
     #elif defined(__BUILD_HAS_FREERTOS)
     #endif
     const int CURRENT_LENGTH = length();
+    _index_stale();
     if (0 < CURRENT_LENGTH) {
       if (x >= CURRENT_LENGTH) {    // If this is a complicated way to clear
         clear();                    //   the string, do that instead.
       }
       else {                        // The given range exists.
         const int REMAINING_LENGTH = (CURRENT_LENGTH - x);
+        if ((nullptr != _arena) && (0 == _collapse()) && (_root == _arena)) {
+          // The string is held by the arena. Shuffle it in place.
+          memmove(_arena->str, (_arena->str + x), REMAINING_LENGTH);
+          _arena->len = REMAINING_LENGTH;
+          *(_arena->str + REMAINING_LENGTH) = 0;
+          return;
+        }
         StrLL* culled_str_ll = _create_str_ll(REMAINING_LENGTH);
         if (nullptr != culled_str_ll) {
           // TODO: Prepend the collapsed string into the list, and eat fragments.
@@ -1238,15 +1627,62 @@ void StringBuilder::cull(int x) {
 * Trims whitespace from the ends of the string and replaces it.
 */
 void StringBuilder::trim() {
-  _collapse();
-  // TODO: How have I not needed this yet? Add it...
-  //    ---J. Ian Lindsay   Thu Dec 17 03:22:01 MST 2015
+  if ((nullptr != _root) && (0 == _collapse())) {
+    const int LEN     = _root->len;
+    const int LEADING = ascii_whitespace_span(_root->str, LEN);
+    if (LEADING == LEN) {
+      clear();   // Nothing but whitespace.
+    }
+    else {
+      const int TRAILING = ascii_whitespace_rspan(_root->str, LEN);
+      if (0 < (LEADING + TRAILING)) {
+        cull(LEADING, (LEN - (LEADING + TRAILING)));
+      }
+    }
+  }
+}
+
+
+
+/*
+* Helpers for searching across fragments without collapsing them. A position in
+*   the string is given by a fragment, and an index within it.
+*/
+
+/* Move a position forward by N bytes. Zero-length fragments are skipped. */
+static void _strll_advance(StrLL** frag, int* idx, const int N) {
+  *idx += N;
+  while ((nullptr != *frag) && (*idx >= (*frag)->len)) {
+    *idx -= (*frag)->len;
+    *frag = (*frag)->next;
+  }
 }
 
+/* Compare LEN bytes at the given position, spanning fragments as necessary. */
+static bool _strll_match(StrLL* frag, int idx, const uint8_t* NEEDLE, const int LEN) {
+  int matched = 0;
+  while ((nullptr != frag) && (matched < LEN)) {
+    const int CHUNK = strict_min((int32_t) (frag->len - idx), (int32_t) (LEN - matched));
+    if (0 < CHUNK) {
+      if (0 != memcmp((frag->str + idx), (NEEDLE + matched), CHUNK)) {
+        return false;
+      }
+      matched += CHUNK;
+    }
+    frag = frag->next;
+    idx  = 0;
+  }
+  return (matched == LEN);
+}
 
 
 /**
-* Search the string for the given sequence.
+* Search the string for the given sequence. The fragments are searched in
+*   place, and the string is not mutated.
+* Short needles are found by scanning for their first byte with memchr() (which
+*   is vectorized by most C libraries), and checking each hit. Long needles use
+*   Boyer-Moore-Horspool, which skips through the haystack by up to the length
+*   of the needle for each comparison.
 *
 * @param NEEDLE The string to search for.
 * @param NEEDLE_LEN The length of the string to search for.
@@ -1254,39 +1690,77 @@ void StringBuilder::trim() {
 * @return the offset of the specified needle.
 */
 int StringBuilder::locate(const uint8_t* NEEDLE, int NEEDLE_LEN, int start_offset) {
+  // Below this length, the cost of building the Horspool table isn't recovered.
+  const int HORSPOOL_MIN_NEEDLE_LEN = 8;
   int ret = -1;
-  if ((nullptr != _root) & (nullptr != NEEDLE) & (NEEDLE_LEN > 0)) {
-    int match_length   = 0;
-    int search_offset  = start_offset;
-    int strll_offset   = start_offset;
-    StrLL* src_ll      = _get_ll_containing_offset(_root, &strll_offset);
-    StrLL* retrace_ll  = src_ll;
-    int retrace_offset = start_offset;
-    while ((nullptr != src_ll) & (-1 == ret)) {
-      if (*(src_ll->str + strll_offset) == *(NEEDLE + match_length++)) {
-        if (match_length == NEEDLE_LEN) {
-          ret = (search_offset);  // Search concludes with a find.
+  if ((nullptr != _root) & (nullptr != NEEDLE) & (NEEDLE_LEN > 0) & (start_offset >= 0)) {
+    // The last offset at which a match could begin.
+    const int LAST_START = (length() - NEEDLE_LEN);
+    int    idx  = start_offset;
+    StrLL* frag = ((start_offset <= LAST_START) ? _get_ll_containing_offset(_root, &idx) : nullptr);
+    int    pos  = start_offset;
+
+    if (nullptr == frag) {
+      // Nothing to search.
+    }
+    else if (NEEDLE_LEN < HORSPOOL_MIN_NEEDLE_LEN) {
+      const int FIRST_BYTE = *NEEDLE;
+      int frag_base = (start_offset - idx);   // Offset of the first byte in frag.
+      while ((nullptr != frag) & (-1 == ret)) {
+        const uint8_t* hit = (const uint8_t*) memchr((frag->str + idx), FIRST_BYTE, (frag->len - idx));
+        if (nullptr == hit) {
+          frag_base += frag->len;
+          frag = frag->next;
+          idx  = 0;
+        }
+        else {
+          idx = (hit - frag->str);
+          pos = (frag_base + idx);
+          if (pos > LAST_START) {
+            break;   // There isn't enough haystack left for a match.
+          }
+          if (_strll_match(frag, idx, NEEDLE, NEEDLE_LEN)) {
+            ret = pos;
+          }
+          else if (++idx >= frag->len) {
+            frag_base += frag->len;
+            frag = frag->next;
+            idx  = 0;
+          }
         }
-        else if (1 == match_length) {
-          // First hit on the needle. Store the current search state just in
-          //   case we need to roll back to it after a failure to find a long needle.
-          retrace_ll  = src_ll;
-          retrace_offset = search_offset;
+        if (frag_base > LAST_START) {
+          break;
         }
       }
-      else {
-        if (match_length > 1) {
-          search_offset = retrace_offset;
-          strll_offset  = search_offset;
-          src_ll = _get_ll_containing_offset(retrace_ll, &strll_offset);
-        }
-        search_offset++;
-        match_length  = 0;
+    }
+    else {
+      // Shift distances are kept in 16-bits to keep the table small on the
+      //   stack. Shifting by less than the maximum is always safe.
+      uint16_t shift_table[256];
+      const uint16_t MAX_SHIFT = (uint16_t) strict_min((int32_t) NEEDLE_LEN, (int32_t) 0xFFFF);
+      for (int i = 0; i < 256; i++) {  shift_table[i] = MAX_SHIFT;  }
+      for (int i = 0; i < (NEEDLE_LEN - 1); i++) {
+        shift_table[*(NEEDLE + i)] = (uint16_t) strict_min((int32_t) ((NEEDLE_LEN - 1) - i), (int32_t) 0xFFFF);
       }
-      strll_offset++;
-      if (strll_offset >= src_ll->len) {
-        strll_offset = 0;
-        src_ll = src_ll->next;
+      const uint8_t LAST_BYTE = *(NEEDLE + (NEEDLE_LEN - 1));
+
+      // Track both ends of the window. Each only ever moves forward.
+      StrLL* tail_frag = frag;
+      int    tail_idx  = idx;
+      _strll_advance(&tail_frag, &tail_idx, (NEEDLE_LEN - 1));
+      while ((pos <= LAST_START) & (-1 == ret)) {
+        const uint8_t TAIL_BYTE = *(tail_frag->str + tail_idx);
+        if ((LAST_BYTE == TAIL_BYTE) && _strll_match(frag, idx, NEEDLE, (NEEDLE_LEN - 1))) {
+          ret = pos;
+        }
+        else {
+          const int SHIFT = shift_table[TAIL_BYTE];
+          pos += SHIFT;
+          if (pos <= LAST_START) {
+            _strll_advance(&frag, &idx, SHIFT);
+            _strll_advance(&tail_frag, &tail_idx, SHIFT);
+          }
+        }
       }
     }
   }
@@ -1322,8 +1796,26 @@ bool StringBuilder::contains(const char* needle) {
 
 
 /**
-* Compares two binary strings on a byte-by-byte basis.
-* Returns 1 if the values match. 0 otherwise.
+* Checks that the string consists only of printable ASCII (0x20 through 0x7E).
+*   Does not collapse the string. An empty string is trivially printable.
+*
+* @return true if no byte of the string is a control character or non-ASCII.
+*/
+bool StringBuilder::isPrintable() {
+  StrLL* current = _root;
+  while (nullptr != current) {
+    if (current->len != ascii_printable_span(current->str, current->len)) {
+      return false;
+    }
+    current = current->next;
+  }
+  return true;
+}
+
+
+/**
+* Compares two binary strings on a byte-by-byte basis.
+* Returns 1 if the values match. 0 otherwise.
 * Collapses the buffer prior to comparing.
 * Will compare ONLY the first len bytes, or the length of our present string. Whichever is less.
 * TODO: This had a glaring bug. Unit tests need to be done to this one.
@@ -1617,12 +2109,21 @@ int StringBuilder::split(const char* delims) {
   if ((nullptr != _root) && (0 < _root->len)) {
     _collapse();
     char* temp_str = strtok((char*) _root->str, delims);
+    _index_stale();
     if (nullptr != temp_str) {
+      // Tokens are allocated directly, rather than by concat(), so that they
+      //   are never written into an arena that is still being tokenized.
       StrLL* old_root = _root;
+      StrLL* tail     = nullptr;
       _root = nullptr;
       while (nullptr != temp_str) {
-        concat(temp_str);
-        return_value++;
+        StrLL* token = _create_str_ll(strlen(temp_str), (uint8_t*) temp_str);
+        if (nullptr != token) {
+          if (nullptr == tail) {  _root = token;        }
+          else {                  tail->next = token;   }
+          tail = token;
+          return_value++;
+        }
         temp_str = strtok(nullptr, delims);
       }
       _destroy_str_ll(old_root);    // Free the source memory.
@@ -1635,6 +2136,313 @@ int StringBuilder::split(const char* delims) {
 }
 
 
+/*******************************************************************************
+* Zero-copy tokenization
+*******************************************************************************/
+
+/**
+* Tokenize the string in place. The tokens are the same as those split() would
+*   produce (maximal runs of bytes not in the delimiter set), but the string
+*   is only collapsed, and not cut up. The tokens can then be had with view()
+*   and the view_as_*() accessors.
+*
+* @param delims is the set of delimiter characters.
+* @return the number of tokens found, or -1 on allocation failure.
+*/
+int StringBuilder::splitViews(const char* delims) {
+  _view_count = 0;
+  if ((nullptr == delims) || (0 != _collapse())) {
+    return -1;
+  }
+  if (nullptr != _root) {
+    const uint8_t* STR = _root->str;
+    const int LEN = _root->len;
+    int token_start = -1;
+    for (int i = 0; i <= LEN; i++) {
+      const bool IS_DELIM = ((i == LEN) || ((0 != *(STR + i)) && (nullptr != strchr(delims, *(STR + i)))));
+      if (IS_DELIM) {
+        if (0 <= token_start) {
+          if (0 != _view_push(token_start, (i - token_start))) {
+            return -1;
+          }
+          token_start = -1;
+        }
+      }
+      else if (0 > token_start) {
+        token_start = i;
+      }
+    }
+  }
+  return _view_count;
+}
+
+
+/**
+* Tokenize the string in place into views of uniform length. The last view
+*   holds the remainder.
+*
+* @param CSIZE is the length of each view.
+* @return the number of tokens, or -1 on bad parameters or allocation failure.
+*/
+int StringBuilder::chunkViews(const int CSIZE) {
+  _view_count = 0;
+  if ((0 >= CSIZE) || (0 != _collapse())) {
+    return -1;
+  }
+  const int LEN = length();
+  for (int offset = 0; offset < LEN; offset += CSIZE) {
+    if (0 != _view_push(offset, strict_min((int32_t) CSIZE, (int32_t) (LEN - offset)))) {
+      return -1;
+    }
+  }
+  return _view_count;
+}
+
+
+/**
+* @param pos is the index of the desired token.
+* @param view_len will be set to the length of the token (or zero).
+* @return a pointer to the token, or nullptr if there is no such token. The
+*   token is not NUL-terminated.
+*/
+uint8_t* StringBuilder::view(int pos, int* view_len) {
+  uint8_t* ret = nullptr;
+  *view_len = 0;
+  if ((0 <= pos) & (pos < _view_count) & (nullptr != _root)) {
+    ret = (_root->str + _views[pos].offset);
+    *view_len = _views[pos].len;
+  }
+  return ret;
+}
+
+
+bool StringBuilder::view_as_bool(int pos) {
+  int len = 0;
+  const uint8_t* tok = view(pos, &len);
+  return ((nullptr != tok) && _token_as_bool(tok, len));
+}
+
+
+int StringBuilder::view_as_int(int pos) {
+  int len = 0;
+  const uint8_t* tok = view(pos, &len);
+  return ((nullptr != tok) ? _token_as_int(tok, len) : 0);
+}
+
+
+uint64_t StringBuilder::view_as_uint64(int pos) {
+  int len = 0;
+  const uint8_t* tok = view(pos, &len);
+  return ((nullptr != tok) ? _token_as_uint64(tok, len) : 0);
+}
+
+
+double StringBuilder::view_as_double(int pos) {
+  int len = 0;
+  const uint8_t* tok = view(pos, &len);
+  return ((nullptr != tok) ? _token_as_double(tok, len) : (double) 0);
+}
+
+
+/**
+* Parse a token of hex characters into bytes, without changing the string.
+*
+* @param pos is the index of the desired token.
+* @param buf is the buffer to receive the bytes.
+* @param BUF_LEN is the size of buf.
+* @return the number of bytes written, or -1 on a bad token or short buffer.
+*/
+int StringBuilder::view_as_bin(int pos, uint8_t* buf, const int BUF_LEN) {
+  int len = 0;
+  const uint8_t* tok = view(pos, &len);
+  if ((nullptr == tok) || (nullptr == buf)) {
+    return -1;
+  }
+  return _token_hex_to_bytes(tok, len, buf, BUF_LEN);
+}
+
+
+/**
+* Discard the token views, and free their memory.
+*/
+void StringBuilder::dropViews() {
+  if (nullptr != _views) {
+    free(_views);
+    _views = nullptr;
+  }
+  _view_count = 0;
+  _view_cap   = 0;
+}
+
+
+/**
+* Add a token view, growing the list if necessary.
+*
+* @return 0 on success, or -1 on allocation failure (which discards all views).
+*/
+int8_t StringBuilder::_view_push(const int OFFSET, const int LEN) {
+  if (_view_count >= _view_cap) {
+    const int NEW_CAP = strict_max((int32_t) 8, (int32_t) (_view_cap << 1));
+    StrLLSpan* nu_views = (StrLLSpan*) realloc(_views, (NEW_CAP * sizeof(StrLLSpan)));
+    if (nullptr == nu_views) {
+      dropViews();
+      return -1;
+    }
+    _views    = nu_views;
+    _view_cap = NEW_CAP;
+  }
+  _views[_view_count].offset = OFFSET;
+  _views[_view_count].len    = LEN;
+  _view_count++;
+  return 0;
+}
+
+
+/*******************************************************************************
+* Fragment index
+*******************************************************************************/
+
+/**
+* Enable or disable the fragment index. The index costs two words of heap per
+*   fragment, and is worth having for strings with many fragments that are
+*   accessed by position or offset (such as the product of split()).
+*
+* @param ENABLE will create the index if true, or free it if false.
+* @return 0 on success, or -1 on allocation failure.
+*/
+int8_t StringBuilder::indexFragments(const bool ENABLE) {
+  if (ENABLE) {
+    if (nullptr == _index) {
+      _index = (StrLLIndex*) malloc(sizeof(StrLLIndex));
+      if (nullptr == _index) {
+        return -1;
+      }
+      _index->frags    = nullptr;
+      _index->ends     = nullptr;
+      _index->count    = 0;
+      _index->capacity = 0;
+      _index->valid    = false;   // Built on first use.
+    }
+  }
+  else if (nullptr != _index) {
+    if (nullptr != _index->frags) {  free(_index->frags);  }
+    if (nullptr != _index->ends) {   free(_index->ends);   }
+    free(_index);
+    _index = nullptr;
+  }
+  return 0;
+}
+
+
+/*******************************************************************************
+* StrLLIterator
+*******************************************************************************/
+
+StrLLIterator::StrLLIterator(StringBuilder* sb) : _current((nullptr != sb) ? sb->_root : nullptr) {}
+
+
+/**
+* Get the next fragment of the string. Zero-length fragments are skipped.
+*
+* @param buf will be set to the first byte of the fragment.
+* @param len will be set to the length of the fragment.
+* @return true if buf and len are valid, or false if there are no more fragments.
+*/
+bool StrLLIterator::next(const uint8_t** buf, int* len) {
+  while ((nullptr != _current) && (0 >= _current->len)) {
+    _current = _current->next;
+  }
+  if (nullptr == _current) {
+    return false;
+  }
+  *buf = _current->str;
+  *len = _current->len;
+  _current = _current->next;
+  return true;
+}
+
+
+/*******************************************************************************
+* Arena memory model
+*******************************************************************************/
+
+/**
+* Bind this instance to a caller-supplied buffer. The buffer will hold both the
+*   fragment header and the string, and must outlive the binding. It will never
+*   be free()'d by this class. Any existing content will be copied into it.
+*
+* @param buf is the memory to use as the arena.
+* @param BUF_LEN is the size of the buffer.
+* @param POLICY decides what happens to writes that won't fit. GROW is invalid here.
+* @return 0 on success, -1 on bad parameters, or -2 if existing content didn't fit.
+*/
+int8_t StringBuilder::bindArena(uint8_t* buf, const int BUF_LEN, const SBArenaPolicy POLICY) {
+  if ((nullptr == buf) || (SBArenaPolicy::GROW == POLICY)) {
+    return -1;
+  }
+  // The fragment header occupies the front of the buffer, on its natural alignment.
+  const int PAD = (int) ((alignof(StrLL) - (((uintptr_t) buf) % alignof(StrLL))) % alignof(StrLL));
+  const int CAP = (BUF_LEN - (PAD + (int) sizeof(StrLL) + 1));
+  if (0 >= CAP) {
+    return -1;
+  }
+  const uint8_t FLAGS = ((SBArenaPolicy::SPILL == POLICY) ? STRBLDR_FLAG_ARENA_SPILL : 0);
+  return _arena_bind((StrLL*) (buf + PAD), CAP, FLAGS);
+}
+
+
+/**
+* Bind this instance to an arena on the heap, which will be grown as needed.
+*   Any existing content will be copied into it.
+*
+* @param INITIAL_LEN is the initial string capacity of the arena.
+* @return 0 on success, -1 on bad parameters, or -2 on allocation failure.
+*/
+int8_t StringBuilder::bindArena(const int INITIAL_LEN) {
+  if (0 >= INITIAL_LEN) {
+    return -1;
+  }
+  const int CAP = strict_max((int32_t) INITIAL_LEN, (int32_t) length());
+  StrLL* arena = (StrLL*) malloc(sizeof(StrLL) + CAP + 1);
+  if (nullptr == arena) {
+    return -2;
+  }
+  const int8_t ret = _arena_bind(arena, CAP, (STRBLDR_FLAG_ARENA_OURS | STRBLDR_FLAG_ARENA_GROW));
+  if (0 != ret) {
+    free(arena);
+  }
+  return ret;
+}
+
+
+/**
+* Release the arena. Any content it held will be copied to the heap first.
+*
+* @return 0 on success, or -1 on allocation failure (in which case, nothing changes).
+*/
+int8_t StringBuilder::unbindArena() {
+  if (nullptr != _arena) {
+    if (0 != _arena_release()) {
+      return -1;
+    }
+    if (_flags.value(STRBLDR_FLAG_ARENA_OURS)) {
+      free(_arena);
+    }
+    _arena = nullptr;
+    _flags.clear(STRBLDR_FLAG_ARENA_MASK);
+  }
+  return 0;
+}
+
+
+/**
+* @return The number of string bytes the arena can hold, or 0 if no arena is bound.
+*/
+int StringBuilder::arenaCapacity() {
+  return ((nullptr != _arena) ? (_arena->cap + (_arena->str - _strll_base(_arena))) : 0);
+}
+
+
 /**
 * This method prints a minimal ASCII representations of the bytes this instance
 *   contains.
@@ -1647,12 +2455,29 @@ void StringBuilder::printDebug(StringBuilder* output) {
   int temp_len  = length();
 
   if ((temp != nullptr) && (temp_len > 0)) {
-    StringBuilder tmp;
+    // Render in place, in space claimed the same way as printBuffer().
+    const int TOTAL_LEN = (temp_len * 3);
+    uint8_t* dest = nullptr;
+    switch (output->_claim_tail_space(TOTAL_LEN, &dest, true)) {
+      case 0:
+        break;
+      case 1:
+        {
+          StrLL* nu_element = output->_create_str_ll(TOTAL_LEN, nullptr, nullptr, TOTAL_LEN);
+          if (nullptr == nu_element) {
+            return;
+          }
+          dest = nu_element->str;
+          output->_stack_str_onto_list(nu_element);
+        }
+        break;
+      default:
+        return;   // Refused by the arena.
+    }
     for (int i = 0; i < temp_len; i++) {
-      tmp.concatf("%02x ", *(temp + i));
+      hex_encode_bytes((temp + i), 1, (char*) (dest + (i * 3)));
+      *(dest + (i * 3) + 2) = ' ';
     }
-    tmp.string();
-    output->concatHandoff(&tmp);
   }
 }
 
@@ -1660,6 +2485,128 @@ void StringBuilder::printDebug(StringBuilder* output) {
 /*******************************************************************************
 * Private functions below this block
 *******************************************************************************/
+
+/*
+* Fragment pool.
+* Fragments are allocated with their header and content together, so a pool
+*   element is a slab of one of a few fixed sizes. The pools are shared by every
+*   StringBuilder, and are never torn down, since static destruction order would
+*   otherwise leave long-lived strings holding pool memory with no pool.
+*/
+#if defined(CONFIG_C3P_STRLL_POOL)
+template <unsigned int N> struct StrLLSlab {
+  StrLL   head;
+  uint8_t content[N - sizeof(StrLL)];
+};
+
+template <unsigned int N> static ElementPool<StrLLSlab<N>>* _strll_pool() {
+  static ElementPool<StrLLSlab<N>>* pool = new ElementPool<StrLLSlab<N>>(CONFIG_C3P_STRLL_POOL_COUNT);
+  return pool;
+}
+
+/* Returns an element of the N-byte class, or nullptr if there are none left. */
+template <unsigned int N> static StrLL* _strll_pool_take() {
+  ElementPool<StrLLSlab<N>>* pool = _strll_pool<N>();
+  // The pool would overdraw by calling new. We would rather malloc() and count it.
+  if (pool->allocated() && (0 < pool->available())) {
+    return (StrLL*) pool->take();
+  }
+  return nullptr;
+}
+
+/* Returns true if the fragment belonged to the N-byte class, and was returned to it. */
+template <unsigned int N> static bool _strll_pool_give(StrLL* frag) {
+  ElementPool<StrLLSlab<N>>* pool = _strll_pool<N>();
+  if (pool->inPool((StrLLSlab<N>*) frag)) {
+    pool->give((StrLLSlab<N>*) frag);
+    return true;
+  }
+  return false;
+}
+
+static volatile bool _strll_pool_busy = false;
+
+static inline void _strll_pool_lock() {
+  #if defined(__BUILD_HAS_THREADS)
+    while (__atomic_test_and_set(&_strll_pool_busy, __ATOMIC_ACQUIRE)) {}
+  #endif
+}
+
+static inline void _strll_pool_unlock() {
+  #if defined(__BUILD_HAS_THREADS)
+    __atomic_clear(&_strll_pool_busy, __ATOMIC_RELEASE);
+  #endif
+}
+#endif  // CONFIG_C3P_STRLL_POOL
+
+
+/**
+* Choke-point for fragment memory. If the pool is enabled, the smallest size
+*   class that fits (and isn't empty) is used. Otherwise, the allocator (if one
+*   was given), or the heap.
+*
+* @param SIZE is the total byte count, including the StrLL.
+* @return the memory, or nullptr on failure.
+*/
+StrLL* StringBuilder::_strll_alloc(const int SIZE) {
+  #if defined(CONFIG_C3P_STRLL_POOL)
+    StrLL* ret = nullptr;
+    _strll_pool_lock();
+    if (SIZE <= 64) {                          ret = _strll_pool_take<64>();    }
+    if ((nullptr == ret) && (SIZE <= 128)) {   ret = _strll_pool_take<128>();   }
+    if ((nullptr == ret) && (SIZE <= 256)) {   ret = _strll_pool_take<256>();   }
+    if (nullptr != ret) {  _stat_pool_hits++;    }
+    else {                 _stat_pool_misses++;  }
+    _strll_pool_unlock();
+    if (nullptr != ret) {
+      return ret;
+    }
+  #endif
+  if (nullptr != _allocator) {
+    return (StrLL*) _allocator->take(SIZE);
+  }
+  return (StrLL*) malloc(SIZE);
+}
+
+
+/**
+* Sets the optional source for fragment memory. Memory is returned to whichever
+*   allocator is set when it is freed, so this will not change the allocator
+*   while the current one still has blocks out.
+*
+* @param x is the allocator to use, or nullptr for the heap.
+* @return 0 on success, or -1 if the current allocator has blocks in use.
+*/
+int8_t StringBuilder::allocator(SlabAllocator* x) {
+  if ((nullptr != _allocator) && (x != _allocator) && (0 < _allocator->blocksInUse())) {
+    return -1;
+  }
+  _allocator = x;
+  return 0;
+}
+
+
+/**
+* Returns fragment memory taken from _strll_alloc() to wherever it came from.
+*
+* @param frag is the fragment to free.
+*/
+void StringBuilder::_strll_free(StrLL* frag) {
+  #if defined(CONFIG_C3P_STRLL_POOL)
+    _strll_pool_lock();
+    const bool POOLED = (_strll_pool_give<64>(frag) || _strll_pool_give<128>(frag) || _strll_pool_give<256>(frag));
+    _strll_pool_unlock();
+    if (POOLED) {
+      return;
+    }
+  #endif
+  if (nullptr != _allocator) {
+    _allocator->give(frag);   // This will free() anything it didn't issue.
+    return;
+  }
+  free(frag);
+}
+
 /**
 * Recursive function to get the length of string material starting from any
 *   particular node. Does not consider the collapsed buffer.
@@ -1687,6 +2634,24 @@ int StringBuilder::_total_str_len(StrLL* node) {
 StrLL* StringBuilder::_get_ll_containing_offset(StrLL* str_ll, int* offset) {
   StrLL* ret = nullptr;
   const int STACKED_OFFSET = *offset;
+  if ((str_ll == _root) && _index_ready()) {
+    // Binary search for the first fragment that ends after the offset.
+    int lo = 0;
+    int hi = _index->count;
+    while (lo < hi) {
+      const int MID = ((lo + hi) >> 1);
+      if (_index->ends[MID] > STACKED_OFFSET) {  hi = MID;      }
+      else {                                      lo = MID + 1;  }
+    }
+    if ((0 <= STACKED_OFFSET) & (lo < _index->count)) {
+      ret = _index->frags[lo];
+      *offset = (STACKED_OFFSET - (_index->ends[lo] - ret->len));
+    }
+    else {
+      *offset = -1;
+    }
+    return ret;
+  }
   if (STACKED_OFFSET < str_ll->len) {    // If we weren't asked for an offset
     ret = str_ll;                        //   past the end our bounds, we're
   }                                      //   it. Otherwise, return nullptr.
@@ -1767,7 +2732,17 @@ StrLL* StringBuilder::_stack_str_onto_list(StrLL* nu) {
     //pthread_mutex_lock(&_mutex);
   #elif defined(__BUILD_HAS_FREERTOS)
   #endif
-  if (nullptr == _root) {
+  if (_index_ready()) {
+    // The index knows the tail, so we needn't walk to it.
+    return_value = ((0 < _index->count) ? _index->frags[_index->count - 1] : nullptr);
+    if (nullptr == return_value) {  _root = nu;                }
+    else {                          return_value->next = nu;   }
+    while (nullptr != nu) {
+      _index_push(nu);
+      nu = nu->next;
+    }
+  }
+  else if (nullptr == _root) {
     _root  = nu;
     return_value = _root;
   }
@@ -1788,22 +2763,27 @@ StrLL* StringBuilder::_stack_str_onto_list(StrLL* nu) {
 *
 * @param content_len The length of the data to allocate for, and is required.
 * @param content_buf Is optional, and contains the content to be copied in.
-* @param content_len The length of the data to copy.
+* @param nxt_ll Is optional, and will be the next fragment in the list.
+* @param cap Is optional, and is the string capacity, if more than content_len.
 * @return The StrLL reference that precedes the parameter nu in the list.
 */
-StrLL* StringBuilder::_create_str_ll(int content_len, uint8_t* content_buf, StrLL* nxt_ll) {
+StrLL* StringBuilder::_create_str_ll(int content_len, uint8_t* content_buf, StrLL* nxt_ll, int cap) {
   StrLL* ret = nullptr;
   if (content_len > 0) {
-    // Over-allocate by content_len to give space for the content in the same allocation.
+    const int CAPACITY = strict_max((int32_t) cap, (int32_t) content_len);
+    // Over-allocate by CAPACITY to give space for the content in the same allocation.
     // Over-allocate by one byte to ensure we have a null-terminator.
-    const int TOTAL_MALLOC_SIZE = (sizeof(StrLL) + content_len + 1);
-    ret = (StrLL*) malloc(TOTAL_MALLOC_SIZE);
+    const int TOTAL_MALLOC_SIZE = (sizeof(StrLL) + CAPACITY + 1);
+    ret = _strll_alloc(TOTAL_MALLOC_SIZE);
     if (nullptr != ret) {
+      _stat_frag_allocs++;
       // The str pointer should point to the first byte after the StrLL it is
       //   member to.
       ret->len  = content_len;  // Do not report our silent addition of null.
+      ret->cap  = CAPACITY;
       ret->next = nxt_ll;
-      ret->str  = (((uint8_t*) ret) + sizeof(StrLL));   // Derive content ptr.
+      ret->str  = _strll_base(ret);   // Derive content ptr.
+      ret->ext  = nullptr;
       if (nullptr != content_buf) {
         memcpy(ret->str, content_buf, content_len);     // Copy content, if provided.
         *(ret->str + content_len) = 0;                  // Assign guard-rail.
@@ -1853,16 +2833,27 @@ void StringBuilder::_destroy_str_ll(StrLL* r_node) {
     //pthread_mutex_lock(&_mutex);
   #elif defined(__BUILD_HAS_FREERTOS)
   #endif
+  _index_stale();
   if (r_node != nullptr) {
     if (r_node->next != nullptr) {
       _destroy_str_ll(r_node->next);
       r_node->next  = nullptr;
     }
-    const bool WAS_MERGED_MALLOC = (r_node->str == (((uint8_t*) r_node) + sizeof(StrLL)));
-    if (!WAS_MERGED_MALLOC) {
-      free(r_node->str);
+    if (r_node == _arena) {
+      // The arena is never freed here. It is only emptied.
+      _arena_rebase();
+      r_node->len = 0;
+      *(r_node->str) = 0;
+      if (r_node == _root) _root = nullptr;
+      return;
+    }
+    if (STRLL_CAP_SHARED == r_node->cap) {
+      _strll_share_release(_strll_share(r_node));
+    }
+    else if (nullptr != r_node->ext) {   // Was the string separately allocated?
+      _strll_mem_give(r_node->ext);
     }
-    free(r_node);
+    _strll_free(r_node);
     if (r_node == _root) _root = nullptr;
   }
   #if defined(__BUILD_HAS_PTHREADS)
@@ -1888,11 +2879,19 @@ int8_t StringBuilder::_collapse() {
 
   StrLL* current = _root;
   if (nullptr != current) {
-    if (_fragged()) {
+    if (!_fragged()) {
+      // A lone shared fragment might be viewing the middle of its bytes, and
+      //   the caller may write to what we return. So it gets its own copy.
+      ret = _strll_unshare(current);
+    }
+    else {
       // If the string is frag'd, we know that (length > 0), and that we
       //   have work to do.
       // Spike the heap usage briefly to create our new allocation...
       const int TOTAL_STR_LEN = _total_str_len(_root);
+      if ((nullptr != _arena) && (0 == _arena_collapse(TOTAL_STR_LEN))) {
+        return ret;   // Flattened into the arena without allocation.
+      }
       StrLL* collapsesd_str_ll = _create_str_ll(TOTAL_STR_LEN);
       if (nullptr != collapsesd_str_ll) {
         // If that allocation worked, we aren't going to fail.
@@ -1922,6 +2921,365 @@ int8_t StringBuilder::_collapse() {
 }
 
 
+/**
+* Find the tail of the fragment list.
+*
+* @return The last fragment, or nullptr if the string is empty.
+*/
+StrLL* StringBuilder::_get_tail() {
+  if (_index_ready()) {
+    return ((0 < _index->count) ? _index->frags[_index->count - 1] : nullptr);
+  }
+  StrLL* current = _root;
+  if (nullptr != current) {
+    while (nullptr != current->next) {  current = current->next;  }
+  }
+  return current;
+}
+
+
+/**
+* Find space for LEN bytes at the end of the string without allocating a new
+*   fragment. If space is found, the fragment that holds it will be lengthened
+*   to include it, and given a new guard-rail. The caller must then fill it.
+* Space is taken from the arena if it is either the tail or presently unused.
+*   If USE_SLACK is set, the spare capacity of any other tail fragment will be
+*   used first.
+*
+* @param LEN is the number of bytes the caller intends to write.
+* @param dest will be set to the location the caller should write to.
+* @param USE_SLACK allows the write to join the tail fragment, rather than becoming its own token.
+* @return 0 if dest is valid, 1 if the caller should allocate, or -1 if the write was refused.
+*/
+int8_t StringBuilder::_claim_tail_space(const int LEN, uint8_t** dest, const bool USE_SLACK) {
+  StrLL* tail = nullptr;
+  bool arena_linked = false;
+  if (nullptr == _arena) {
+    tail = _get_tail();
+  }
+  else {
+    // We also need to know if the arena is anywhere in the list.
+    tail = _root;
+    arena_linked = (nullptr != _arena) && (_root == _arena);
+    if (nullptr != tail) {
+      while (nullptr != tail->next) {
+        tail = tail->next;
+        arena_linked |= (tail == _arena);
+      }
+    }
+  }
+  bool linked_arena = false;
+  StrLL* target = nullptr;
+  if (USE_SLACK && (nullptr != tail) && (_arena != tail) && (LEN <= (tail->cap - tail->len))) {
+    target = tail;
+  }
+  else if ((nullptr != _arena) && ((tail == _arena) || !arena_linked)) {
+    const int NEEDED = (LEN + (arena_linked ? _arena->len : 0));
+    if ((NEEDED > _arena->cap) && (0 != _arena_grow(NEEDED))) {
+      _flags.set(STRBLDR_FLAG_ARENA_OVERFLOW);
+      return (_flags.value(STRBLDR_FLAG_ARENA_SPILL) ? 1 : -1);
+    }
+    if (!arena_linked) {
+      // The arena was idle. It becomes the new tail.
+      _arena->len  = 0;
+      _arena->next = nullptr;
+      if (nullptr == tail) {  _root = _arena;        }
+      else {                  tail->next = _arena;   }
+      linked_arena = true;
+    }
+    target = _arena;
+  }
+
+  if (nullptr == target) {
+    return 1;
+  }
+  *dest = (target->str + target->len);
+  target->len += LEN;
+  *(target->str + target->len) = 0;   // Guard-rail.
+  _stat_inline_writes++;
+  if ((nullptr != _index) && _index->valid) {   // Keep the index current.
+    if (linked_arena) {  _index_push(_arena);                         }
+    else {               _index->ends[_index->count - 1] += LEN;      }
+  }
+  return 0;
+}
+
+
+/**
+* Append path for small writes that need not be their own tokens. The bytes
+*   are written into the tail fragment's slack if possible. Otherwise, they go
+*   into a new fragment that has slack for the writes that follow.
+*
+* @param buf is the content to append.
+* @param LEN is the length of the content.
+*/
+void StringBuilder::_concat_stream(const uint8_t* buf, const int LEN) {
+  uint8_t* dest = nullptr;
+  switch (_claim_tail_space(LEN, &dest, true)) {
+    case 0:
+      memcpy(dest, buf, LEN);
+      break;
+    case 1:
+      {
+        const int CAP = strict_max((int32_t) LEN, (int32_t) CONFIG_C3P_STRLL_INLINE_LEN);
+        StrLL* nu_element = _create_str_ll(LEN, (uint8_t*) buf, nullptr, CAP);
+        if (nullptr != nu_element) {
+          _stack_str_onto_list(nu_element);
+        }
+      }
+      break;
+    default:
+      break;   // Refused by the arena.
+  }
+}
+
+
+/**
+* Adopt the given memory as an arena, and copy any existing content into it.
+*
+* @param arena is the memory to use for the arena fragment.
+* @param CAP is the string capacity of the arena.
+* @param FLAGS are the arena flags to apply.
+* @return 0 on success, or -2 if the existing content doesn't fit.
+*/
+int8_t StringBuilder::_arena_bind(StrLL* arena, const int CAP, const uint8_t FLAGS) {
+  const int CURRENT_LEN = length();
+  _index_stale();
+  if (CURRENT_LEN > CAP) {
+    return -2;
+  }
+  if (0 != unbindArena()) {
+    return -2;
+  }
+  arena->next = nullptr;
+  arena->len  = 0;
+  arena->cap  = CAP;
+  arena->str  = _strll_base(arena);
+  arena->ext  = nullptr;
+  if (0 < CURRENT_LEN) {
+    arena->len = copyToBuffer(arena->str, CURRENT_LEN);
+    _destroy_str_ll(_root);
+    _root = arena;
+  }
+  *(arena->str + arena->len) = 0;
+  _arena = arena;
+  _flags.clear(STRBLDR_FLAG_ARENA_MASK);
+  _flags.set(FLAGS);
+  return 0;
+}
+
+
+/**
+* If the policy allows it, realloc() the arena to hold at least MIN_CAP bytes.
+*   References to the arena within the fragment list are updated.
+*
+* @param MIN_CAP is the string length the arena must be able to hold.
+* @return 0 on success, -1 if the policy forbids growth, or -2 on allocation failure.
+*/
+int8_t StringBuilder::_arena_grow(const int MIN_CAP) {
+  if (!_flags.value(STRBLDR_FLAG_ARENA_GROW)) {
+    return -1;
+  }
+  // The arena is about to move. The index holds pointers, and must be rebuilt.
+  //   But views are offsets into the string, which moves intact.
+  const int VIEW_COUNT = _view_count;
+  _index_stale();
+  _view_count = VIEW_COUNT;
+  // Find the fragment that refers to the arena (if any) before it moves.
+  StrLL* prior   = nullptr;
+  StrLL* current = _root;
+  while ((nullptr != current) && (_arena != current)) {
+    prior   = current;
+    current = current->next;
+  }
+  // Anything consume()'d from the front of the arena is reclaimed first.
+  if (_strll_base(_arena) != _arena->str) {
+    memmove(_strll_base(_arena), _arena->str, (_arena->len + 1));
+    _arena_rebase();
+  }
+  const int NEW_CAP = strict_max((int32_t) MIN_CAP, (int32_t) (_arena->cap << 1));
+  StrLL* nu = (StrLL*) realloc(_arena, (sizeof(StrLL) + NEW_CAP + 1));
+  if (nullptr == nu) {
+    return -2;
+  }
+  nu->str = _strll_base(nu);
+  nu->cap = NEW_CAP;
+  if (nullptr != current) {
+    if (nullptr == prior) {  _root = nu;         }
+    else {                   prior->next = nu;   }
+  }
+  _arena = nu;
+  return 0;
+}
+
+
+/**
+* Flatten the string into the arena. Content already in the arena is shifted
+*   into its final position, and all other fragments are copied and freed.
+*
+* @param TOTAL_LEN is the length of the string.
+* @return 0 on success, or -1 if the string won't fit.
+*/
+int8_t StringBuilder::_arena_collapse(const int TOTAL_LEN) {
+  if ((TOTAL_LEN > arenaCapacity()) && (0 != _arena_grow(TOTAL_LEN))) {
+    _flags.set(STRBLDR_FLAG_ARENA_OVERFLOW);
+    return -1;
+  }
+  _index_stale();
+  int prefix_len = 0;
+  StrLL* current = _root;
+  while ((nullptr != current) && (_arena != current)) {
+    prefix_len += current->len;
+    current = current->next;
+  }
+  if (nullptr != current) {
+    // Shift the arena's content to its final position, which also reclaims
+    //   anything consume()'d from its front.
+    uint8_t* content = _arena->str;
+    _arena_rebase();
+    if (content != (_arena->str + prefix_len)) {
+      memmove((_arena->str + prefix_len), content, _arena->len);
+    }
+  }
+  else {
+    _arena_rebase();
+  }
+  int offset = 0;
+  current = _root;
+  while (nullptr != current) {
+    StrLL* next_ll = current->next;
+    const int FRAG_LEN = current->len;
+    if (_arena != current) {
+      memcpy((_arena->str + offset), current->str, FRAG_LEN);
+      current->next = nullptr;
+      _destroy_str_ll(current);
+    }
+    offset += FRAG_LEN;
+    current = next_ll;
+  }
+  _arena->next = nullptr;
+  _arena->len  = TOTAL_LEN;
+  *(_arena->str + TOTAL_LEN) = 0;
+  _root = _arena;
+  return 0;
+}
+
+
+/**
+* If the arena holds part of the string, replace it with a heap copy. This is
+*   done before the fragment list changes hands, since an arena cannot.
+*
+* @return 0 on success, or -1 on allocation failure.
+*/
+int8_t StringBuilder::_arena_release() {
+  if (nullptr == _arena) {
+    return 0;
+  }
+  StrLL* prior   = nullptr;
+  StrLL* current = _root;
+  while ((nullptr != current) && (_arena != current)) {
+    prior   = current;
+    current = current->next;
+  }
+  if (nullptr != current) {
+    _index_stale();
+    StrLL* replacement = _arena->next;
+    if (0 < _arena->len) {
+      replacement = _create_str_ll(_arena->len, _arena->str, _arena->next);
+      if (nullptr == replacement) {
+        return -1;
+      }
+    }
+    if (nullptr == prior) {  _root = replacement;         }
+    else {                   prior->next = replacement;   }
+    _arena->next = nullptr;
+    _arena->len  = 0;
+    _arena_rebase();
+    *(_arena->str) = 0;
+  }
+  return 0;
+}
+
+
+/**
+* Restore the arena's string pointer to the start of its memory, returning any
+*   space that was consume()'d from its front to its capacity. This does not
+*   move the content, so the caller must do that if it matters.
+*/
+void StringBuilder::_arena_rebase() {
+  const int CONSUMED = (_arena->str - _strll_base(_arena));
+  _arena->str  = _strll_base(_arena);
+  _arena->cap += CONSUMED;
+}
+
+
+
+/**
+* If the index is enabled but stale, rebuild it.
+*
+* @return true if the index is enabled and current.
+*/
+bool StringBuilder::_index_ready() {
+  if (nullptr == _index) {
+    return false;
+  }
+  if (!_index->valid) {
+    _index_rebuild();
+  }
+  return _index->valid;
+}
+
+
+/**
+* Rebuild the index from the fragment list.
+*
+* @return 0 on success, or -1 on allocation failure (which leaves the index stale).
+*/
+int8_t StringBuilder::_index_rebuild() {
+  _index->valid = false;
+  _index->count = 0;
+  StrLL* current = _root;
+  while (nullptr != current) {
+    if (0 != _index_push(current)) {
+      return -1;
+    }
+    current = current->next;
+  }
+  _index->valid = true;
+  return 0;
+}
+
+
+/**
+* Add a fragment to the end of the index, growing it if necessary.
+*
+* @return 0 on success, or -1 on allocation failure (which leaves the index stale).
+*/
+int8_t StringBuilder::_index_push(StrLL* frag) {
+  if (_index->count >= _index->capacity) {
+    const int NEW_CAPACITY = strict_max((int32_t) 16, (int32_t) (_index->capacity << 1));
+    StrLL** nu_frags = (StrLL**) realloc(_index->frags, (NEW_CAPACITY * sizeof(StrLL*)));
+    if (nullptr != nu_frags) {
+      _index->frags = nu_frags;
+      int* nu_ends = (int*) realloc(_index->ends, (NEW_CAPACITY * sizeof(int)));
+      if (nullptr != nu_ends) {
+        _index->ends = nu_ends;
+        _index->capacity = NEW_CAPACITY;
+      }
+    }
+    if (_index->count >= _index->capacity) {
+      _index->valid = false;
+      return -1;
+    }
+  }
+  const int PRIOR_END = ((0 < _index->count) ? _index->ends[_index->count - 1] : 0);
+  _index->frags[_index->count] = frag;
+  _index->ends[_index->count]  = (PRIOR_END + frag->len);
+  _index->count++;
+  return 0;
+}
+
+
 /**
 * Return the RAM use of this string.
 * By passing true to deep, the return value will also factor in concealed heap
@@ -1940,21 +3298,79 @@ int StringBuilder::memoryCost(bool deep) {
   int32_t ret = OVERHEAD_PER_CLASS;
   StrLL* current = _root;
   while (nullptr != current) {
-    ret += (current->len + OVERHEAD_PER_FRAG);
-    const bool WAS_MERGED_MALLOC = (current->str == (((uint8_t*) current) + sizeof(StrLL)));
-    if (!WAS_MERGED_MALLOC) {
-      ret += 4;  // The heap handoff fxn will stub out 4 extra bytes.
-      ret += OVERHEAD_PER_MALLOC;  // Plus the extra malloc that had to be done.
+    StrLLShare* share = _strll_share(current);
+    if (nullptr != share) {
+      // Shared bytes are split evenly among the fragments that reference them.
+      const uint32_t REFS = strict_max((uint32_t) 1, (uint32_t) share->refs);
+      ret += (4 + OVERHEAD_PER_FRAG);
+      ret += ((current->len + sizeof(StrLLShare) + OVERHEAD_PER_MALLOC) / REFS);
     }
-    else {
-      ret += 1;   // Merged-allocation overdoes it by 1 byte.
+    else if (_arena != current) {   // The arena is counted once, below.
+      ret += (current->len + OVERHEAD_PER_FRAG);
+      const bool WAS_MERGED_MALLOC = (nullptr == current->ext);
+      if (!WAS_MERGED_MALLOC) {
+        ret += 4;  // The heap handoff fxn will stub out 4 extra bytes.
+        ret += OVERHEAD_PER_MALLOC;  // Plus the extra malloc that had to be done.
+        ret += (current->str - current->ext);  // Plus anything consumed from the front.
+      }
+      else {
+        ret += 1;   // Merged-allocation overdoes it by 1 byte.
+        ret += strict_max((int32_t) 0, (int32_t) (current->cap - current->len));  // Slack.
+        ret += (current->str - _strll_base(current));  // Plus anything consumed from the front.
+      }
     }
     current = current->next;
   }
+  if (nullptr != _views) {
+    ret += ((_view_cap * sizeof(StrLLSpan)) + OVERHEAD_PER_MALLOC);
+  }
+  if (nullptr != _index) {
+    ret += (sizeof(StrLLIndex) + (_index->capacity * (sizeof(StrLL*) + sizeof(int))));
+    ret += (OVERHEAD_PER_MALLOC * 3);
+  }
+  if (nullptr != _arena) {
+    // A bound arena costs its full size, whether it is used or not.
+    ret += (sizeof(StrLL) + arenaCapacity() + 1);
+    if (_flags.value(STRBLDR_FLAG_ARENA_OURS)) {
+      ret += OVERHEAD_PER_MALLOC;
+    }
+  }
   return ret;
 }
 
 
+/**
+* Report on the allocation behavior of all StringBuilders since boot. Each
+*   append that was written into existing space saved a fragment allocation.
+*
+* @param output is the StringBuilder* that should receive this function's output
+*/
+void StringBuilder::printMemoryStats(StringBuilder* output) {
+  // Take a snapshot, since writing the report will change the numbers.
+  const uint32_t FRAG_ALLOCS   = _stat_frag_allocs;
+  const uint32_t INLINE_WRITES = _stat_inline_writes;
+  const uint32_t POOL_HITS     = _stat_pool_hits;
+  const uint32_t POOL_MISSES   = _stat_pool_misses;
+  const uint32_t BYTES_SAVED   = (INLINE_WRITES * (sizeof(StrLL) + sizeof(intptr_t) + 1));
+  StringBuilder::styleHeader2(output, "StringBuilder memory");
+  output->concatf("\tFragments allocated:    %u\n", FRAG_ALLOCS);
+  output->concatf("\tAllocation-free writes: %u\n", INLINE_WRITES);
+  output->concatf("\tOverhead avoided:       %u bytes\n", BYTES_SAVED);
+  output->concatf("\tPool hits/misses:       %u/%u\n", POOL_HITS, POOL_MISSES);
+  #if defined(CONFIG_C3P_STRLL_POOL)
+    output->concat("64-byte ");
+    _strll_pool<64>()->printDebug(output);
+    output->concat("128-byte ");
+    _strll_pool<128>()->printDebug(output);
+    output->concat("256-byte ");
+    _strll_pool<256>()->printDebug(output);
+  #endif
+  if (nullptr != _allocator) {
+    _allocator->printDebug(output);
+  }
+}
+
+
 /**
 * Is this string fragmented?
 * NOTE: This is the basis of Lemma #3.
@@ -31,6 +31,12 @@ This class has two modes of string storage: fragmented or collapsed, which are
 While fragmented, the string is stored as an ordered set of elements that are
   scattered across memory locations. These fragments ease heap loads during
   composition, make length calculation faster, and allows for arbitrary carving.
+Each fragment is a single allocation holding both the StrLL and its string.
+  Every concat() of a string or buffer produces a new fragment, which can be
+  addressed as a token with position(). But small streaming appends (single
+  bytes, and the output of concatf()) are written into the free space at the
+  end of the tail fragment if there is room, and otherwise into a new fragment
+  that is allocated with room to spare (CONFIG_C3P_STRLL_INLINE_LEN).
 While collapsed, the entire string is stored in the str member as a single
   contiguous allocation, and has a NULL root for its linked-list. That is: it
   has no fragments. This is a minimal-overhead means of storing the string, and
@@ -45,6 +51,25 @@ Strings are stored as fragments natively, and by invocation of the tokenizer.
   the string is being reorganized (in the worst case). So be aware of your
   memory usage.
 
+Arena mode:
+An instance may optionally be bound to a single contiguous arena, either
+  supplied by the caller (and never free()'d by this class), or allocated and
+  grown on the heap by the class itself. While an arena is bound, it is used as
+  a fragment whose capacity exceeds its length, and appends will be written
+  directly into its free space. Collapsing the string will be done within the
+  arena if possible, making string() free of allocation. What happens when a
+  write would overflow the arena is decided by the SBArenaPolicy given at bind
+  time, and overflow is sticky and reported by arenaOverflowed().
+The handoff functions still move fragments between instances without copying.
+  But an arena cannot change hands, so a donor's arena content will be copied
+  into a heap fragment before the transfer.
+Where the handoff functions move bytes, concatShared() shares them. Fragments
+  of a source string are given a reference count, and the destination string
+  gets new fragments that reference the same bytes. Shared bytes are never
+  written in place. Any function that would do so makes a private copy first.
+  Small fragments and arena content are simply copied, since a reference
+  would cost more than the bytes.
+
 ===< Useful lemmata >===========================================================
 1) A string that is fragmented is not collapsed, and vice-versa. (Seat of excluded middle).
 2) A string that is fragmented is ipso facto not empty.
@@ -60,9 +85,8 @@ TODO: This API badly needs return codes in the memory-allocating functions. It
 
 TODO: It might be desirable to break StringBuilder apart along one (or more)
   lines. Namely....
-  1) Memory model per-instance. Presently, this is a linked-list on the heap.
-      but it might be good to have avaialble the option of assigning a
-      pre-existing flat buffer space and only operating within it.
+  1) Memory model per-instance. Presently, this is a linked-list on the heap,
+      with an optional flat arena (see bindArena()).
   2) Formatting and tokenizing handled as seperate pieces?
   3) Static styling methods have always felt wrong here...
   4) If we stick with a linked-list, and merged allocation doesn't interfere,
@@ -83,6 +107,7 @@ TODO: Re-instate semaphores via the Semaphore class, rather than the ugly
 #include <inttypes.h>
 #include <stdarg.h>
 #include <string.h>
+#include "FlagContainer.h"
 
 #ifdef ARDUINO
   #include <Arduino.h>
@@ -112,9 +137,99 @@ int strcasestr(char *a, const char *b);
 typedef struct str_ll_t {
   struct str_ll_t* next;  // The next element.
   int              len;   // The length of this element.
+  int              cap;   // Bytes writable at str (excluding the guard-rail). Zero if unknown.
   uint8_t*         str;   // The string.
+  uint8_t*         ext;   // A separate allocation holding str, or nullptr if merged with this struct.
 } StrLL;
 
+/*
+* Fragments may share their bytes with fragments in other strings. Such a
+*   fragment has a cap of STRLL_CAP_SHARED, and its ext member points to a
+*   StrLLShare (rather than the bytes). Shared bytes are read-only, and are
+*   copied before any in-place mutation (copy-on-write). The last fragment to
+*   release its reference frees the bytes.
+*/
+#define STRLL_CAP_SHARED  -1
+
+typedef struct str_ll_share_t {
+  uint8_t*          buf;   // The shared bytes. Possibly merged with this struct.
+  volatile uint32_t refs;  // The number of fragments referencing buf.
+} StrLLShare;
+
+
+/*
+* An optional index of the fragments of a string. Each fragment's position in the
+*   list, and the offset of its end within the string, can be had without
+*   walking the list. The index is kept current by appends, and is marked stale
+*   by any other change to the list, after which it is rebuilt when next used.
+*/
+typedef struct str_ll_index_t {
+  StrLL**  frags;     // The fragments, in order.
+  int*     ends;      // The offset of the end of each fragment (cumulative length).
+  int      count;     // The number of fragments indexed.
+  int      capacity;  // The number of fragments that can be indexed without reallocation.
+  bool     valid;     // Is the index current?
+} StrLLIndex;
+
+
+/*
+* A token found by the zero-copy tokenizer, as a span of the collapsed string.
+*   Spans are kept as offsets, so they survive the string being moved.
+*/
+typedef struct str_ll_span_t {
+  int  offset;  // The offset of the token's first byte.
+  int  len;     // The length of the token.
+} StrLLSpan;
+
+
+/*
+* A read-only span of string, as exported for vectored I/O. The field order and
+*   types follow POSIX struct iovec, so an array of these can be given to
+*   writev() and its relatives.
+*/
+typedef struct sb_iovec_t {
+  void*  iov_base;  // The first byte of the span.
+  size_t iov_len;   // The length of the span.
+} SBIOVec;
+
+
+/*
+* Policies for writes that would overflow a bound arena.
+*/
+enum class SBArenaPolicy : uint8_t {
+  REFUSE = 0,  // The write is dropped, and the overflow flag is set.
+  SPILL  = 1,  // The write goes to a heap fragment, and the overflow flag is set.
+  GROW   = 2   // The arena is realloc()'d to fit. Only valid for heap arenas.
+};
+
+/* Class flags */
+#define STRBLDR_FLAG_ARENA_OURS      0x01  // The arena was allocated by this class.
+#define STRBLDR_FLAG_ARENA_SPILL     0x02  // Overflowing writes spill to the heap.
+#define STRBLDR_FLAG_ARENA_GROW      0x04  // Overflowing writes grow the arena.
+#define STRBLDR_FLAG_ARENA_OVERFLOW  0x08  // An arena write was refused or spilled.
+
+#define STRBLDR_FLAG_ARENA_MASK      0x0F  // All flags that pertain to the arena.
+
+
+class StringBuilder;
+class SlabAllocator;
+
+/*
+* A read-only, forward-only cursor over the fragments of a StringBuilder. No
+*   copies are made, and the StringBuilder is not mutated. The cursor is
+*   invalidated by any mutation of the StringBuilder.
+*/
+class StrLLIterator {
+  public:
+    StrLLIterator(StringBuilder*);
+    ~StrLLIterator() {};
+
+    bool next(const uint8_t** buf, int* len);  // Returns false when there are no more fragments.
+
+  private:
+    const StrLL* _current;
+};
+
 
 /* Class for dynamic strings and buffers. */
 class StringBuilder {
@@ -175,6 +290,10 @@ class StringBuilder {
        of responsibility for managing it. */
     void concatHandoff(uint8_t* buf, int len);
 
+    /* Appends references to the bytes of another string, which both strings
+       then share copy-on-write. The source string is not emptied. */
+    int  concatShared(StringBuilder* src, const int START_OFFSET = 0, const int LEN = -1);
+
     int cloneClobber(StringBuilder* src_obj);   // Makes a copy of the argument object.
     //int cloneAppend(StringBuilder* src_obj);   // Makes a copy of the argument object.
 
@@ -185,6 +304,16 @@ class StringBuilder {
     /* Same idea as above, but also consumes the given range. */
     //int  moveToBuffer(uint8_t* buf, unsigned int len_limit, unsigned int start_offset = 0);
 
+    /* Zero-copy export for vectored writes, and a zero-copy means of discarding
+       what was written. */
+    int  toIOVec(SBIOVec* vecs, const int MAX_VECS, const int START_OFFSET = 0);
+    int  consume(const int LEN);
+
+    /* An optional fragment index makes count(), length(), and position() run in
+       constant time, and lookups by offset run in logarithmic time. */
+    int8_t indexFragments(const bool ENABLE);
+    inline bool fragmentsIndexed() {  return (nullptr != _index);  };
+
     void cull(int offset, int length);  // Use to throw away all but the specified range of this string.
     void cull(int length);              // Use to discard the first X characters from the string.
     void trim();                        // Trim whitespace off the ends of the string.
@@ -209,19 +338,48 @@ class StringBuilder {
     int      maximumFragmentLength();
     bool     drop_position(unsigned int pos);   // And use this to reap the tokens that you've used.
 
+    /* Zero-copy tokenization. These functions collapse the string (once) and
+       record the tokens as spans of it, rather than cutting it into fragments.
+       Views are not NUL-terminated, and the typed accessors parse them in place.
+       Appends preserve the views. Any other mutation discards them. */
+    int      splitViews(const char*);   // Same tokens as split(const char*).
+    int      chunkViews(const int);     // Same tokens as chunk(const int).
+    uint8_t* view(int, int*);           // Returns the token and its length, or nullptr.
+    bool     view_as_bool(int);
+    int      view_as_int(int);
+    uint64_t view_as_uint64(int);
+    double   view_as_double(int);
+    int      view_as_bin(int, uint8_t* buf, const int BUF_LEN);  // Parse a hex token into bytes.
+    void     dropViews();
+    inline int viewCount() {  return _view_count;  };
+
     /* Comparison and search. */
     int  locate(const uint8_t*, int len, int start_offset = 0);  // Returns the offset of the given string.
     int  locate(const char*, int start_offset = 0);  // Returns the offset of the given string.
     bool contains(char);                // Does the buffer contain the given character?
     bool contains(const char*);         // Does the buffer contain the given string?
+    bool isPrintable();                 // Is every byte printable ASCII?
     int cmpBinString(uint8_t*, int);    // Compare byte-wise a given length.
     int replace(const char*, const char*); // Replace the former argument with the latter.
     // int cmpCaseless(const char* unknown);
 
     void printDebug(StringBuilder*);
-    //bool isPrintable();   // Returns true if the content is entirely low-ASCII.
 
     int memoryCost(bool deep = false);   // Get the memory use for this string.
+    static void printMemoryStats(StringBuilder*);  // Report on allocations made and avoided.
+    static inline uint32_t poolHits() {     return _stat_pool_hits;     };  // Fragments taken from the pool.
+    static inline uint32_t poolMisses() {   return _stat_pool_misses;   };  // Fragments that fell back to the heap.
+    // An optional source for fragment memory. Refused while the current one has blocks out.
+    static int8_t allocator(SlabAllocator*);
+    static inline SlabAllocator* allocator() {         return _allocator;   };
+
+    /* Arena memory model. */
+    int8_t bindArena(uint8_t* buf, const int BUF_LEN, const SBArenaPolicy POLICY = SBArenaPolicy::REFUSE);
+    int8_t bindArena(const int INITIAL_LEN);  // Heap-backed arena with the GROW policy.
+    int8_t unbindArena();
+    int    arenaCapacity();
+    inline bool arenaBound() {        return (nullptr != _arena);                        };
+    inline bool arenaOverflowed() {   return _flags.value(STRBLDR_FLAG_ARENA_OVERFLOW);  };
 
     /* Statics */
     static void printBuffer(StringBuilder* output, uint8_t* buf, uint32_t len, const char* indent = "\t");
@@ -238,6 +396,12 @@ class StringBuilder {
 
   private:
     StrLL*   _root;         // The root of the linked-list.
+    StrLL*   _arena;        // The arena fragment, if one is bound.
+    StrLLIndex* _index;     // The fragment index, if one is enabled.
+    StrLLSpan*  _views;     // Token views, if the string has been tokenized in place.
+    int      _view_count;
+    int      _view_cap;
+    FlagContainer8 _flags;  // Class flags.
     #if defined(__BUILD_HAS_CONCURRENT_STRINGBUILDER)
       // TODO: Do concurrency control with a semaphore if the build requested it.
     #endif
@@ -257,10 +421,37 @@ class StringBuilder {
     StrLL* _position(int);
     StrLL* _stack_str_onto_list(StrLL* current, StrLL* nu);
     StrLL* _stack_str_onto_list(StrLL*);
-    StrLL* _create_str_ll(int, uint8_t* buf = nullptr, StrLL* nxt_ll = nullptr);
+    StrLL* _create_str_ll(int, uint8_t* buf = nullptr, StrLL* nxt_ll = nullptr, int cap = 0);
     StrLL* _create_str_ll(int, StrLL* src, int initial_ll_offset = 0);
     void   _destroy_str_ll(StrLL*);
     int8_t _collapse();       // Flatten the string into a single allocation.
+    StrLL* _get_tail();
+    int8_t _claim_tail_space(const int LEN, uint8_t** dest, const bool USE_SLACK = false);
+    void   _concat_stream(const uint8_t* buf, const int LEN);
+    int8_t _arena_bind(StrLL*, const int CAP, const uint8_t FLAGS);
+    int8_t _arena_grow(const int MIN_CAP);
+    int8_t _arena_collapse(const int TOTAL_LEN);
+    int8_t _arena_release();  // Swap a linked arena for a heap copy.
+    void   _arena_rebase();
+    bool   _index_ready();    // Rebuilds a stale index, and returns true if it is usable.
+    int8_t _index_rebuild();
+    int8_t _index_push(StrLL*);
+    int8_t _view_push(const int OFFSET, const int LEN);
+    // Any change to the list, other than an append, comes through here.
+    inline void _index_stale() {
+      if (nullptr != _index) _index->valid = false;
+      _view_count = 0;   // Token views are not worth tracking through mutation.
+    };
+
+    friend class StrLLIterator;
+
+    static uint32_t _stat_frag_allocs;    // Fragments allocated, all instances.
+    static uint32_t _stat_inline_writes;  // Appends that needed no allocation, all instances.
+    static uint32_t _stat_pool_hits;      // Fragment allocations served by the pool.
+    static uint32_t _stat_pool_misses;    // Fragment allocations that went to the heap.
+    static SlabAllocator* _allocator;     // If set, fragments that miss the pool come from here.
+    static StrLL*   _strll_alloc(const int SIZE);
+    static void     _strll_free(StrLL*);
     bool   _fragged();        // Is the string fragmented?
 };
 #endif  // __C3P_STRING_BUILDER_H
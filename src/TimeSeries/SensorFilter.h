@@ -145,6 +145,10 @@ template <class T> class SensorFilter : public SensorFilterBase {
     double   _mean           = 0.0;
     double   _rms            = 0.0;
     double   _stdev          = 0.0;
+    C3PRunningMedian<T> _run_median;           // Built on the first median.
+    C3PSlidingMinMax<T> _run_minmax;           // Built on the first min or max.
+    bool     _stale_run_median = true;         // The running median must be rebuilt.
+    bool     _stale_run_minmax = true;         // The sliding min/max must be rebuilt.
 
     int8_t  _reallocate_sample_window(uint32_t);
     int8_t  _zero_samples();
@@ -204,6 +208,8 @@ template <class T> class SensorFilter3 : public SensorFilterBase {
     Vector3f64  _rms;
     Vector3f64  _stdev;
     //Vector3<double>  _snr;
+    C3PRunningMedian<T> _run_median[3];        // Built on the first median.
+    bool        _stale_run_median = true;      // The running median must be rebuilt.
 
     int8_t  _reallocate_sample_window(uint32_t);
     int8_t  _zero_samples();
@@ -254,6 +260,8 @@ template <class T> int8_t SensorFilter<T>::feedFilter() {
     _window_full = true;
     _sample_idx = 0;
     _samples_total += _window_size;
+    _stale_run_median = true;
+    _stale_run_minmax = true;
     invalidateStats();
     ret = 0;
   }
@@ -324,6 +332,8 @@ template <class T> int8_t SensorFilter<T>::_zero_samples() {
   _mean      = 0.0;
   _rms       = 0.0;
   _stdev     = 0.0;
+  _stale_run_median = true;
+  _stale_run_minmax = true;
   invalidateStats();
   _window_full = false;
   if (nullptr != samples) {
@@ -389,7 +399,15 @@ template <class T> int8_t SensorFilter<T>::feedFilter(T val) {
   int8_t ret = -1;
   if (initialized()) {
     if (_window_size > 1) {
-      samples[_sample_idx++] = val;
+      const T OLD_VAL = samples[_sample_idx];
+      samples[_sample_idx] = val;
+      if (!_stale_run_median) {
+        _run_median.replace(_sample_idx, OLD_VAL);
+      }
+      if (!_stale_run_minmax) {
+        _run_minmax.push(_sample_idx);
+      }
+      _sample_idx++;
       _samples_total++;
       if (_sample_idx >= _window_size) {
         // NOTE: Will run only on index overflow.
@@ -454,11 +472,23 @@ template <class T> T SensorFilter<T>::value() {
 */
 template <class T> void SensorFilter<T>::_calculate_minmax() {
   if (_filter_initd && _window_full) {
-    min_value = samples[0];   // Start with a baseline.
-    max_value = samples[0];   // Start with a baseline.
-    for (uint32_t i = 1; i < _window_size; i++) {
-      if (samples[i] > max_value) max_value = samples[i];
-      else if (samples[i] < min_value) min_value = samples[i];
+    if (_stale_run_minmax) {
+      // Scan the whole window to build the sliding min/max. Feeding keeps it
+      //   current after that, at amortized O(1) per sample.
+      _stale_run_minmax = (0 != _run_minmax.init(samples, _window_size, _sample_idx));
+    }
+    if (!_stale_run_minmax) {
+      min_value = _run_minmax.minValue();
+      max_value = _run_minmax.maxValue();
+    }
+    else {
+      // No memory for the deques. Scan the window every time.
+      min_value = samples[0];   // Start with a baseline.
+      max_value = samples[0];   // Start with a baseline.
+      for (uint32_t i = 1; i < _window_size; i++) {
+        if (samples[i] > max_value) max_value = samples[i];
+        else if (samples[i] < min_value) min_value = samples[i];
+      }
     }
     _stale_minmax = false;
   }
@@ -525,40 +555,30 @@ template <class T> double SensorFilter<T>::_calculate_stdev() {
 
 
 /**
-* Calulates the median value of the samples.
+* Calulates the median value of the samples. The first call builds a running
+*   median, at O(n log n). Feeding keeps it current after that, at O(log n)
+*   per sample, so that this call costs O(1).
 *
 * @return the median of the contents of the filter.
 */
 template <class T> T SensorFilter<T>::_calculate_median() {
-  T sorted[_window_size];
   T ret = T(0);
-  for (uint32_t i = 0; i < _window_size; i++) {
-    sorted[i] = samples[i];
-  }
-  // Selection sort.
-  uint32_t i  = 0;
-  T swap;
-  for (uint32_t c = 0; c < (_window_size - 1); c++) {
-    i = c;
-    for (uint32_t d = c + 1; d < _window_size; d++) {
-      if (sorted[i] > sorted[d]) i = d;
+  if ((nullptr != samples) && (_window_size > 0)) {
+    if (_stale_run_median) {
+      _stale_run_median = (0 != _run_median.init(samples, _window_size));
     }
-    if (i != c) {
-      swap = sorted[c];
-      sorted[c] = sorted[i];
-      sorted[i] = swap;
+    if (!_stale_run_median) {
+      ret = _run_median.median();
+    }
+    else {
+      // No memory for the heaps. Select from a copy of the window instead.
+      T* scratch = (T*) malloc(_window_size * sizeof(T));
+      if (nullptr != scratch) {
+        memcpy(scratch, samples, (_window_size * sizeof(T)));
+        ret = c3p_median(scratch, _window_size);
+        free(scratch);
+      }
     }
-  }
-
-  if (_window_size & 0x01) {
-    // If there are an odd number of samples...
-    ret = sorted[(_window_size-1) >> 1];
-  }
-  else {
-    // ...otherwise, we take the mean to the two middle values.
-    uint32_t lower = (_window_size-1) >> 1;
-    uint32_t upper = lower + 1;
-    ret = (sorted[upper] + sorted[lower]) / 2;
   }
   return ret;
 }
@@ -605,6 +625,7 @@ template <class T> int8_t SensorFilter3<T>::feedFilter() {
     _window_full = true;
     _sample_idx = 0;
     _samples_total += _window_size;
+    _stale_run_median = true;
     invalidateStats();
     ret = 0;
   }
@@ -658,6 +679,7 @@ template <class T> int8_t SensorFilter3<T>::_zero_samples() {
   _mean(T(0), T(0), T(0));
   _rms(T(0), T(0), T(0));
   _stdev(T(0), T(0), T(0));
+  _stale_run_median = true;
   if (nullptr != samples) {
     if (_window_size > 0) {
       ret = 0;
@@ -742,7 +764,14 @@ template <class T> int8_t SensorFilter3<T>::feedFilter(T x, T y, T z) {
   if (initialized()) {
     ret = 0;
     if (_window_size > 1) {
-      samples[_sample_idx++](x, y, z);
+      const Vector3<T> OLD_VAL(samples[_sample_idx].x, samples[_sample_idx].y, samples[_sample_idx].z);
+      samples[_sample_idx](x, y, z);
+      if (!_stale_run_median) {
+        _run_median[0].replace(_sample_idx, OLD_VAL.x);
+        _run_median[1].replace(_sample_idx, OLD_VAL.y);
+        _run_median[2].replace(_sample_idx, OLD_VAL.z);
+      }
+      _sample_idx++;
       _samples_total++;
       if (_sample_idx >= _window_size) {
         _window_full = true;
@@ -918,48 +947,56 @@ template <class T> int8_t SensorFilter3<T>::_calculate_stdev() {
 
 
 /*
-* Calulates the median of the samples.
+* Calulates the median of the samples, by way of a running median on each axis.
 */
 template <class T> int8_t SensorFilter3<T>::_calculate_median() {
-  double sorted[3][_window_size];
-  for (uint32_t i = 0; i < _window_size; i++) {
-    sorted[0][i] = samples[i].x;
-    sorted[1][i] = samples[i].y;
-    sorted[2][i] = samples[i].z;
-  }
-  // Selection sort.
-  uint32_t i = 0;
-  double swap;
-  for (uint8_t n = 0; n < 3; n++) {
-    for (uint32_t c = 0; c < (_window_size - 1); c++) {
-      i = c;
-      for (uint32_t d = c + 1; d < _window_size; d++) {
-        if (sorted[n][i] > sorted[n][d]) i = d;
+  static_assert((sizeof(Vector3<T>) == (3 * sizeof(T))), "Each axis is tracked in place, with a stride of 3.");
+  int8_t ret = -1;
+  if ((nullptr != samples) && (_window_size > 0)) {
+    if (_stale_run_median) {
+      bool built = true;
+      for (uint8_t a = 0; a < 3; a++) {
+        built = built && (0 == _run_median[a].init((((const T*) samples) + a), _window_size, 3));
       }
-      if (i != c) {
-        swap = sorted[n][c];
-        sorted[n][c] = sorted[n][i];
-        sorted[n][i] = swap;
+      _stale_run_median = !built;
+    }
+    double lower[3];
+    double upper[3];
+    if (!_stale_run_median) {
+      for (uint8_t a = 0; a < 3; a++) {
+        lower[a] = (double) _run_median[a].lowerMedian();
+        upper[a] = (double) _run_median[a].upperMedian();
       }
+      ret = 0;
+    }
+    else {
+      // No memory for the heaps. Select from a copy of each axis instead.
+      T* scratch = (T*) malloc(_window_size * sizeof(T));
+      if (nullptr != scratch) {
+        for (uint8_t a = 0; a < 3; a++) {
+          for (uint32_t i = 0; i < _window_size; i++) {
+            scratch[i] = ((const T*) samples)[(i * 3) + a];
+          }
+          T lo_val;
+          T hi_val;
+          c3p_select_middles(scratch, _window_size, &lo_val, &hi_val);
+          lower[a] = (double) lo_val;
+          upper[a] = (double) hi_val;
+        }
+        free(scratch);
+        ret = 0;
+      }
+    }
+    if (0 == ret) {
+      // For an odd count, the two middles are the same value.
+      last_value.set(
+        ((lower[0] + upper[0]) / 2),
+        ((lower[1] + upper[1]) / 2),
+        ((lower[2] + upper[2]) / 2)
+      );
     }
   }
-
-  if (_window_size & 0x01) {
-    // If there are an off number of samples...
-    uint32_t offset = (_window_size-1) >> 1;
-    last_value.set(sorted[0][offset], sorted[1][offset], sorted[2][offset]);
-  }
-  else {
-    // ...otherwise, we take the mean to the two middle values.
-    uint32_t lower = (_window_size-1) >> 1;
-    uint32_t upper = lower + 1;
-    last_value.set(
-      ((sorted[0][upper] + sorted[0][lower]) / 2),
-      ((sorted[1][upper] + sorted[1][lower]) / 2),
-      ((sorted[2][upper] + sorted[2][lower]) / 2)
-    );
-  }
-  return 0;
+  return ret;
 }
 
 
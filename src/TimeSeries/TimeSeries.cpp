@@ -23,6 +23,45 @@ limitations under the License.
 #include "../C3PValue/KeyValuePair.h"
 
 
+/******************************************************************************
+* TimeSeriesAccumulator
+******************************************************************************/
+
+/*
+* Add a value to the compensated sum. Neumaier's variant of Kahan summation, so
+*   that it holds up when the value is larger than the sum.
+*/
+void TimeSeriesAccumulator::addToSum(const double X) {
+  const double T = (_sum + X);
+  if (fabs(_sum) >= fabs(X)) {
+    _comp += ((_sum - T) + X);
+  }
+  else {
+    _comp += ((X - T) + _sum);
+  }
+  _sum = T;
+}
+
+
+/*
+* Replace one value in the window with another, and update the sum of squared
+*   deviations to match. Both means are needed for the update, which is
+*   M2 += (NEW - OLD) * ((NEW - new_mean) + (OLD - old_mean)).
+*
+* @param OLD_VAL is the value leaving the window.
+* @param NEW_VAL is the value entering the window.
+* @param N is the size of the window.
+*/
+void TimeSeriesAccumulator::replace(const double OLD_VAL, const double NEW_VAL, const uint32_t N) {
+  const double OLD_MEAN = mean(N);
+  addToSum(NEW_VAL);
+  addToSum(-OLD_VAL);
+  const double NEW_MEAN = mean(N);
+  _m2 += ((NEW_VAL - OLD_VAL) * ((NEW_VAL - NEW_MEAN) + (OLD_VAL - OLD_MEAN)));
+}
+
+
+
 /******************************************************************************
 * TimeSeriesBase
 ******************************************************************************/
@@ -35,6 +74,7 @@ limitations under the License.
 */
 TimeSeriesBase::TimeSeriesBase(const TCode TC, uint32_t ws, uint16_t flgs) :
   _window_size(ws), _samples_total(0), _sample_idx(0),
+  _exact_interval(0), _feeds_since_exact(0),
   _TCODE(TC), _flags(flgs), _last_trace(0),
   _name(nullptr), _units(nullptr) {}
 
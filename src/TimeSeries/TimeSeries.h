@@ -31,6 +31,9 @@ See the README.md file for module-level documentation.
 #include <stdint.h>
 #include "../Meta/Rationalizer.h"
 #include "../Vector3.h"
+#include "../C3PMedian.h"
+#include "../C3PSlidingMinMax.h"
+#include "../C3PDecimation.h"
 #include "../StringBuilder.h"
 #include "../EnumeratedTypeCodes.h"
 #include "../FlagContainer.h"
@@ -46,6 +49,10 @@ See the README.md file for module-level documentation.
 #define TIMESERIES_FLAG_VALID_RMS      0x20  // Statistical measurement is valid.
 #define TIMESERIES_FLAG_VALID_STDEV    0x40  // Statistical measurement is valid.
 #define TIMESERIES_FLAG_VALID_MEDIAN   0x80  // Statistical measurement is valid.
+#define TIMESERIES_FLAG_RUNNING_VALID  0x0100  // Running accumulators agree with the window.
+#define TIMESERIES_FLAG_RUNNING_MEDIAN 0x0200  // Running median agrees with the window.
+#define TIMESERIES_FLAG_RUNNING_MINMAX 0x0400  // Sliding min/max agrees with the window.
+#define TIMESERIES_FLAG_RUNNING_PYRAMID 0x0800  // Decimation pyramid agrees with the window.
 
 #define TIMESERIES_FLAG_MASK_ALL_STATS ( \
   TIMESERIES_FLAG_VALID_MINMAX | TIMESERIES_FLAG_VALID_MEAN | \
@@ -71,6 +78,38 @@ enum class TimeSeriesStat : uint8_t {
 };
 
 
+/******************************************************************************
+* Running accumulators for the mean and variance of a fixed-size window. Each
+*   new sample replaces the oldest one in O(1). The sum is compensated (Kahan-
+*   Babuska), and the sum of squared deviations is kept by Welford's method,
+*   adapted for a window that slides rather than grows. The mean square (for
+*   RMS) follows from those two, so it needs no accumulator of its own.
+* Rounding error still builds slowly, so owners may periodically rebuild these
+*   from the samples with addToSum() and setM2().
+******************************************************************************/
+class TimeSeriesAccumulator {
+  public:
+    inline void   reset() {                 _sum = 0.0;  _comp = 0.0;  _m2 = 0.0;  };
+    inline void   setM2(const double X) {   _m2 = X;                               };
+    inline double mean(const uint32_t N) {  return ((_sum + _comp) / N);           };
+    inline double variance(const uint32_t N) {  return ((_m2 > 0) ? (_m2 / N) : 0);  };
+    inline double meanSquare(const uint32_t N) {
+      const double MEAN = mean(N);
+      return (variance(N) + (MEAN * MEAN));
+    };
+
+    void addToSum(const double);
+    void replace(const double OLD_VAL, const double NEW_VAL, const uint32_t N);
+
+
+  private:
+    double _sum  = 0.0;
+    double _comp = 0.0;    // Low-order bits lost from _sum.
+    double _m2   = 0.0;    // Sum of squared deviations from the mean.
+};
+
+
+
 /******************************************************************************
 * Pure virtual base class that handles the basic meta for a timeseries.
 * The primary purpose here is to control template bloat, rather than provide a
@@ -106,6 +145,14 @@ class TimeSeriesBase {
     inline uint32_t windowSize() {         return (initialized() ? _window_size : 0);   };
     uint32_t indexIsWhichSample(const uint32_t MEM_IDX);
 
+    /*
+    * Mean, RMS, stdev, and SNR are kept current by running accumulators. This
+    *   sets how many samples may be fed between exact recalculations, to bound
+    *   rounding drift. Zero (the default) means only when needed.
+    */
+    inline void     exactInterval(uint32_t x) {   _exact_interval = x;     };
+    inline uint32_t exactInterval() {             return _exact_interval;  };
+
     virtual int8_t init() =0;
     //int8_t serializeRange(StringBuilder*, const uint32_t COUNT, const uint32_t OFFSET, const bool ABS_IDX);
 
@@ -132,6 +179,8 @@ class TimeSeriesBase {
     uint32_t  _window_size;    // The present size of the window.
     uint32_t  _samples_total;  // Total number of samples that have been ingested since purge().
     uint32_t  _sample_idx;     // The present sample index in the underlying memory pool.
+    uint32_t  _exact_interval;     // Samples between exact recalculations. Zero for never.
+    uint32_t  _feeds_since_exact;  // Samples fed since the accumulators were rebuilt.
 
     // TODO: Replicate the same pattern in use by StopWatch? This is the next logical step.
     //   But TimeSeries *isn't* StopWatch. TimeSeries might have a data field of
@@ -150,9 +199,24 @@ class TimeSeriesBase {
     inline bool _stale_stdev() {     return !(_chk_flags(TIMESERIES_FLAG_VALID_STDEV));   };
     inline bool _stale_median() {    return !(_chk_flags(TIMESERIES_FLAG_VALID_MEDIAN));  };
     inline bool _stale_snr() {       return !(_chk_flags(TIMESERIES_FLAG_VALID_SNR));     };
+    inline bool _running_valid() {   return _chk_flags(TIMESERIES_FLAG_RUNNING_VALID);    };
+    inline bool _running_median() {  return _chk_flags(TIMESERIES_FLAG_RUNNING_MEDIAN);   };
+    inline bool _running_minmax() {  return _chk_flags(TIMESERIES_FLAG_RUNNING_MINMAX);   };
+    inline bool _running_pyramid() { return _chk_flags(TIMESERIES_FLAG_RUNNING_PYRAMID);  };
     inline void _set_flags(bool x, const uint16_t MSK) {  _flags = (x ? (_flags | MSK) : (_flags & ~MSK)); };
     inline bool _chk_flags(const uint16_t MSK) {          return (MSK == (_flags & MSK));                  };
 
+    /* Bookkeeping for the running accumulators of the child classes. */
+    inline void _running_rebuilt() {
+      _feeds_since_exact = 0;
+      _set_flags(true, TIMESERIES_FLAG_RUNNING_VALID);
+    };
+    inline void _running_fed() {
+      if ((0 < _exact_interval) && (++_feeds_since_exact >= _exact_interval)) {
+        _set_flags(false, TIMESERIES_FLAG_RUNNING_VALID);
+      }
+    };
+
     /* Mandatory overrides for a child class. */
     virtual void*  _mem_raw_ptr() =0;
     virtual int8_t _reallocate_sample_window(uint32_t) =0;
@@ -168,7 +232,7 @@ class TimeSeriesBase {
 
   private:
     const TCode _TCODE;
-    uint8_t     _flags;       // Class behavior flags.
+    uint16_t    _flags;       // Class behavior flags.
     uint16_t    _last_trace;  // A slice of the _samples_total to track updates.
     char*       _name;        // An optional name for this TimeSeries.
     SIUnit*     _units;       // Optional unit specification.
@@ -195,6 +259,8 @@ template <class T> class TimeSeries : public TimeSeriesBase {
     int8_t copyValues(T* buf, const uint32_t COUNT, const bool ABS_IDX = true) {
       return copyValueRange(buf, COUNT, 0, ABS_IDX);
     };
+    int8_t downsample(C3PBucketSummary<T>*, const uint32_t COUNT);
+    int8_t downsampleLTTB(T* values, uint32_t* positions, const uint32_t COUNT);
 
 
     /* Value accessor inlines */
@@ -219,6 +285,10 @@ template <class T> class TimeSeries : public TimeSeriesBase {
     double   _rms       = 0.0d;
     double   _stdev     = 0.0d;
     double   _snr       = 0.0d;
+    TimeSeriesAccumulator _running;
+    C3PRunningMedian<T>   _run_median;   // Built on the first call to median().
+    C3PSlidingMinMax<T>   _run_minmax;   // Built on the first call to minValue() or maxValue().
+    C3PDecimationPyramid<T> _pyramid;    // Built on the first call to downsample() or downsampleLTTB().
 
     void*   _mem_raw_ptr() {    return ((void*) samples);    };
     int8_t  _reallocate_sample_window(uint32_t);
@@ -235,6 +305,8 @@ template <class T> class TimeSeries : public TimeSeriesBase {
     int8_t  _calculate_stdev();
     int8_t  _calculate_median();
     int8_t  _calculate_snr();
+    void    _rebuild_running();
+    void    _summarize(const uint32_t FIRST, const uint32_t END, C3PBucketSummary<T>*);
 };
 
 
@@ -276,6 +348,8 @@ template <class T> class TimeSeries3 : public TimeSeriesBase {
     Vector3f64  _rms;
     Vector3f64  _stdev;
     Vector3f64  _snr;
+    TimeSeriesAccumulator _running[3];
+    C3PRunningMedian<T>   _run_median[3];   // Built on the first call to median().
 
     void*   _mem_raw_ptr() {    return ((void*) samples);    };
     int8_t  _reallocate_sample_window(uint32_t);
@@ -292,6 +366,7 @@ template <class T> class TimeSeries3 : public TimeSeriesBase {
     int8_t  _calculate_stdev();
     int8_t  _calculate_median();
     int8_t  _calculate_snr();
+    void    _rebuild_running();
 };
 
 
@@ -355,6 +430,8 @@ template <class T> int8_t TimeSeries<T>::feedSeries() {
   int8_t ret = -1;
   if (initialized()) {
     _samples_total += _window_size;
+    // The buffer was changed behind our back.
+    _set_flags(false, (TIMESERIES_FLAG_RUNNING_VALID | TIMESERIES_FLAG_RUNNING_MEDIAN | TIMESERIES_FLAG_RUNNING_MINMAX | TIMESERIES_FLAG_RUNNING_PYRAMID));
     invalidateStats();
     ret = 1;
   }
@@ -420,6 +497,9 @@ template <class T> int8_t TimeSeries<T>::_zero_samples() {
   _rms           = 0.0d;
   _stdev         = 0.0d;
   _snr           = 0.0d;
+  _running.reset();             // A window of zeros needs no rebuild.
+  _running_rebuilt();
+  _set_flags(false, (TIMESERIES_FLAG_RUNNING_MEDIAN | TIMESERIES_FLAG_RUNNING_MINMAX | TIMESERIES_FLAG_RUNNING_PYRAMID));
 
   if (nullptr != samples) {
     if (_window_size > 0) {
@@ -465,7 +545,24 @@ template <class T> void TimeSeries<T>::_print_series(StringBuilder* output) {
 template <class T> int8_t TimeSeries<T>::feedSeries(T val) {
   int8_t ret = -1;
   if (initialized()) {
-    samples[_sample_idx++] = val;
+    const T OLD_VAL = samples[_sample_idx];
+    if (_running_valid()) {
+      // The window is always full of something (zeros, at first), so every
+      //   sample replaces another.
+      _running.replace((double) OLD_VAL, (double) val, _window_size);
+      _running_fed();
+    }
+    samples[_sample_idx] = val;
+    if (_running_median()) {
+      _run_median.replace(_sample_idx, OLD_VAL);
+    }
+    if (_running_minmax()) {
+      _run_minmax.push(_sample_idx);
+    }
+    if (_running_pyramid()) {
+      _pyramid.push(_sample_idx);
+    }
+    _sample_idx++;
     _samples_total++;
     if (_sample_idx >= _window_size) {
       // NOTE: Will run only on index overflow.
@@ -534,6 +631,129 @@ template <class T> int8_t TimeSeries<T>::copyValueRange(T* buf, const uint32_t C
 }
 
 
+/**
+* Summarizes the window in COUNT equal spans, oldest first. Each summary holds
+*   the min, max, and mean of its span. Extremes are given as positions in the
+*   window, where 0 is the oldest sample.
+* The first call builds a decimation pyramid over the window. Feeding keeps it
+*   current after that, so later calls cost O(COUNT), rather than O(window).
+*
+* @param buckets will hold COUNT summaries.
+* @param COUNT is the number of spans, which must not exceed the window size.
+* @return 0 on success, or -1 if the window isn't full, or on bad arguments.
+*/
+template <class T> int8_t TimeSeries<T>::downsample(C3PBucketSummary<T>* buckets, const uint32_t COUNT) {
+  int8_t ret = -1;
+  if ((nullptr != buckets) && (0 < COUNT) && (COUNT <= _window_size) && windowFull()) {
+    if (!_running_pyramid()) {
+      _set_flags((0 == _pyramid.init(samples, _window_size)), TIMESERIES_FLAG_RUNNING_PYRAMID);
+    }
+    markClean();
+    for (uint32_t i = 0; i < COUNT; i++) {
+      const uint32_t FIRST = (uint32_t) (((uint64_t) i * _window_size) / COUNT);
+      const uint32_t END   = (uint32_t) (((uint64_t) (i + 1) * _window_size) / COUNT);
+      _summarize(FIRST, END, (buckets + i));
+    }
+    ret = 0;
+  }
+  return ret;
+}
+
+
+/**
+* Reduces the window to exactly COUNT points with largest-triangle-three-buckets.
+*   The oldest and newest samples are always kept.
+* Rather than weigh every sample, the candidates are the minimum and maximum of
+*   (2 * COUNT) spans of the window, which are found with the same pyramid as
+*   downsample(). Small windows are given to LTTB whole.
+*
+* @param values will hold COUNT sample values, oldest first.
+* @param positions (optional) will hold the positions of those samples, where 0
+*   is the oldest sample in the window.
+* @param COUNT is the number of points. It must be at least 3, and must not
+*   exceed the window size.
+* @return 0 on success, or -1 if the window isn't full, on bad arguments, or if
+*   there is no memory for the candidates.
+*/
+template <class T> int8_t TimeSeries<T>::downsampleLTTB(T* values, uint32_t* positions, const uint32_t COUNT) {
+  int8_t ret = -1;
+  if ((nullptr != values) && (3 <= COUNT) && (COUNT <= _window_size) && windowFull()) {
+    const uint32_t N = _window_size;
+    const bool     PRESELECT = ((N / 4) > COUNT);
+    // Rounded up so that the positions that follow the values are aligned.
+    const uint32_t CAPACITY  = (((PRESELECT ? (2 + (COUNT << 2)) : N) + 3) & ~((uint32_t) 3));
+    T* cand_y = (T*) malloc(CAPACITY * (sizeof(T) + sizeof(uint32_t)));
+    if (nullptr != cand_y) {
+      uint32_t* cand_x = (uint32_t*) (cand_y + CAPACITY);
+      uint32_t cand_count = 0;
+      markClean();
+      if (PRESELECT) {
+        if (!_running_pyramid()) {
+          _set_flags((0 == _pyramid.init(samples, _window_size)), TIMESERIES_FLAG_RUNNING_PYRAMID);
+        }
+        // The spans divide the samples between the oldest and the newest.
+        const uint32_t SPANS = (COUNT << 1);
+        cand_x[cand_count]   = 0;
+        cand_y[cand_count++] = samples[_sample_idx];
+        for (uint32_t i = 0; i < SPANS; i++) {
+          C3PBucketSummary<T> span;
+          _summarize((1 + (uint32_t) (((uint64_t) i * (N - 2)) / SPANS)), (1 + (uint32_t) (((uint64_t) (i + 1) * (N - 2)) / SPANS)), &span);
+          if (0 < span.count) {
+            const bool MIN_FIRST = (span.min_idx <= span.max_idx);
+            cand_x[cand_count]   = (MIN_FIRST ? span.min_idx : span.max_idx);
+            cand_y[cand_count++] = (MIN_FIRST ? span.min_value : span.max_value);
+            if (span.min_idx != span.max_idx) {
+              cand_x[cand_count]   = (MIN_FIRST ? span.max_idx : span.min_idx);
+              cand_y[cand_count++] = (MIN_FIRST ? span.max_value : span.min_value);
+            }
+          }
+        }
+        cand_x[cand_count]   = (N - 1);
+        cand_y[cand_count++] = samples[((0 == _sample_idx) ? N : _sample_idx) - 1];
+        ret = c3p_lttb(cand_x, cand_y, cand_count, COUNT, positions, values);
+      }
+      else {
+        for (uint32_t i = 0; i < N; i++) {
+          cand_y[i] = samples[(_sample_idx + i) % N];
+        }
+        ret = c3p_lttb((const uint32_t*) nullptr, cand_y, N, COUNT, positions, values);
+      }
+      free(cand_y);
+    }
+  }
+  return ret;
+}
+
+
+/*
+* Summarizes the samples at positions [FIRST, END) of the window, where 0 is the
+*   oldest. The window is split where the ring wraps, so the pyramid is never
+*   asked about a range that straddles the write position.
+*/
+template <class T> void TimeSeries<T>::_summarize(const uint32_t FIRST, const uint32_t END, C3PBucketSummary<T>* out) {
+  const uint32_t OLDEST  = _sample_idx;
+  const uint32_t TO_WRAP = (_window_size - OLDEST);   // Positions before the ring wraps.
+  C3PBucketSummary<T> part;
+  c3p_bucket_clear(out);
+  if (FIRST < TO_WRAP) {
+    const uint32_t PART_END = ((END < TO_WRAP) ? END : TO_WRAP);
+    if (_running_pyramid()) {  _pyramid.summarize((OLDEST + FIRST), (OLDEST + PART_END), &part);       }
+    else {                     c3p_summarize(samples, (OLDEST + FIRST), (OLDEST + PART_END), &part);  }
+    c3p_bucket_merge(out, &part);
+  }
+  if (END > TO_WRAP) {
+    const uint32_t PART_FIRST = ((FIRST > TO_WRAP) ? FIRST : TO_WRAP);
+    if (_running_pyramid()) {  _pyramid.summarize((PART_FIRST - TO_WRAP), (END - TO_WRAP), &part);       }
+    else {                     c3p_summarize(samples, (PART_FIRST - TO_WRAP), (END - TO_WRAP), &part);  }
+    c3p_bucket_merge(out, &part);
+  }
+  if (0 < out->count) {
+    // Report the extremes by position, rather than by slot.
+    out->min_idx = ((out->min_idx >= OLDEST) ? (out->min_idx - OLDEST) : (out->min_idx + TO_WRAP));
+    out->max_idx = ((out->max_idx >= OLDEST) ? (out->max_idx - OLDEST) : (out->max_idx + TO_WRAP));
+  }
+}
+
 /**
 * Calulates the min/max over the entire sample window.
 * Updates the private cache variable.
@@ -544,11 +764,24 @@ template <class T> int8_t TimeSeries<T>::_calculate_minmax() {
   int8_t ret = -1;
   if (windowFull()) {
     ret = 0;
-    _min_value = samples[0];  // Start with a baseline.
-    _max_value = samples[0];  // Start with a baseline.
-    for (uint32_t i = 1; i < _window_size; i++) {
-      if (samples[i] > _max_value) _max_value = samples[i];
-      else if (samples[i] < _min_value) _min_value = samples[i];
+    if (!_running_minmax()) {
+      // Scan the whole window to build the sliding min/max. Feeding keeps it
+      //   current after that, at amortized O(1) per sample. Only the bulk
+      //   path (or purge()) will force another scan.
+      _set_flags((0 == _run_minmax.init(samples, _window_size, _sample_idx)), TIMESERIES_FLAG_RUNNING_MINMAX);
+    }
+    if (_running_minmax()) {
+      _min_value = _run_minmax.minValue();
+      _max_value = _run_minmax.maxValue();
+    }
+    else {
+      // No memory for the deques. Scan the window every time.
+      _min_value = samples[0];  // Start with a baseline.
+      _max_value = samples[0];  // Start with a baseline.
+      for (uint32_t i = 1; i < _window_size; i++) {
+        if (samples[i] > _max_value) _max_value = samples[i];
+        else if (samples[i] < _min_value) _min_value = samples[i];
+      }
     }
     _set_flags(true, TIMESERIES_FLAG_VALID_MINMAX);
   }
@@ -566,11 +799,8 @@ template <class T> int8_t TimeSeries<T>::_calculate_mean() {
   int8_t ret = -1;
   if (windowFull()) {
     ret = 0;
-    double summed_samples = 0.0;
-    for (uint32_t i = 0; i < _window_size; i++) {
-      summed_samples += (double) samples[i];
-    }
-    _mean = (summed_samples / _window_size);
+    if (!_running_valid()) _rebuild_running();
+    _mean = _running.mean(_window_size);
     _set_flags(true, TIMESERIES_FLAG_VALID_MEAN);
   }
   return ret;
@@ -587,11 +817,8 @@ template <class T> int8_t TimeSeries<T>::_calculate_rms() {
   int8_t ret = -1;
   if ((_window_size > 1) & windowFull()) {
     ret = 0;
-    double squared_samples = 0.0;
-    for (uint32_t i = 0; i < _window_size; i++) {
-      squared_samples += pow((double) samples[i], 2.0);
-    }
-    _rms = sqrt(squared_samples / _window_size);
+    if (!_running_valid()) _rebuild_running();
+    _rms = sqrt(_running.meanSquare(_window_size));
     _set_flags(true, TIMESERIES_FLAG_VALID_RMS);
   }
   return ret;
@@ -612,13 +839,8 @@ template <class T> int8_t TimeSeries<T>::_calculate_stdev() {
   int8_t ret = -1;
   if ((_window_size > 1) & windowFull()) {
     ret = 0;
-    double deviation_sum = 0.0;
-    double cached_mean = mean();
-    for (uint32_t i = 0; i < _window_size; i++) {
-      double tmp = ((double) samples[i] - cached_mean);
-      deviation_sum += pow((double) tmp, 2.0);
-    }
-    _stdev = sqrt(deviation_sum / _window_size);
+    if (!_running_valid()) _rebuild_running();
+    _stdev = sqrt(_running.variance(_window_size));
     _set_flags(true, TIMESERIES_FLAG_VALID_STDEV);
   }
   return ret;
@@ -634,37 +856,28 @@ template <class T> int8_t TimeSeries<T>::_calculate_stdev() {
 template <class T> int8_t TimeSeries<T>::_calculate_median() {
   int8_t ret = -1;
   if ((_window_size > 1) & windowFull()) {
-    ret = 0;
-    T sorted[_window_size];
-    for (uint32_t i = 0; i < _window_size; i++) {
-      sorted[i] = samples[i];
+    if (!_running_median()) {
+      // The first query pays O(n log n) to build the running median. Feeding
+      //   keeps it current after that, at O(log n) per sample.
+      _set_flags((0 == _run_median.init(samples, _window_size)), TIMESERIES_FLAG_RUNNING_MEDIAN);
     }
-    // Selection sort.
-    uint32_t i  = 0;
-    T swap;
-    for (uint32_t c = 0; c < (_window_size - 1); c++) {
-      i = c;
-      for (uint32_t d = c + 1; d < _window_size; d++) {
-        if (sorted[i] > sorted[d]) i = d;
-      }
-      if (i != c) {
-        swap = sorted[c];
-        sorted[c] = sorted[i];
-        sorted[i] = swap;
-      }
-    }
-
-    if (_window_size & 0x01) {
-      // If there are an odd number of samples...
-      _median = sorted[(_window_size-1) >> 1];
+    if (_running_median()) {
+      _median = _run_median.median();
+      ret = 0;
     }
     else {
-      // ...otherwise, we take the mean to the two middle values.
-      uint32_t lower = (_window_size-1) >> 1;
-      uint32_t upper = lower + 1;
-      _median = (sorted[upper] + sorted[lower]) / 2;
+      // No memory for the heaps. Select from a copy of the window instead.
+      T* scratch = (T*) malloc(_window_size * sizeof(T));
+      if (nullptr != scratch) {
+        memcpy(scratch, samples, (_window_size * sizeof(T)));
+        _median = c3p_median(scratch, _window_size);
+        free(scratch);
+        ret = 0;
+      }
+    }
+    if (0 == ret) {
+      _set_flags(true, TIMESERIES_FLAG_VALID_MEDIAN);
     }
-    _set_flags(true, TIMESERIES_FLAG_VALID_MEDIAN);
   }
   return ret;
 }
@@ -679,13 +892,36 @@ template <class T> int8_t TimeSeries<T>::_calculate_snr() {
   int8_t ret = -1;
   if ((_window_size > 1) & windowFull()) {
     ret = 0;
-    _snr = (pow(mean(), 2.0) / pow(stdev(), 2.0));
+    const double MEAN  = mean();
+    const double STDEV = stdev();
+    _snr = ((MEAN * MEAN) / (STDEV * STDEV));
     _set_flags(true, TIMESERIES_FLAG_VALID_SNR);
   }
   return ret;
 }
 
 
+/*
+* Recalculate the running accumulators from the samples, in two passes. This is
+*   the only O(n) path for mean, RMS, and stdev, and is taken after a bulk
+*   update, or when the exact interval has lapsed.
+*/
+template <class T> void TimeSeries<T>::_rebuild_running() {
+  _running.reset();
+  for (uint32_t i = 0; i < _window_size; i++) {
+    _running.addToSum((double) samples[i]);
+  }
+  const double MEAN = _running.mean(_window_size);
+  double m2 = 0.0;
+  for (uint32_t i = 0; i < _window_size; i++) {
+    const double DEV = ((double) samples[i] - MEAN);
+    m2 += (DEV * DEV);
+  }
+  _running.setM2(m2);
+  _running_rebuilt();
+}
+
+
 
 /*******************************************************************************
 * Vector3 variant
@@ -736,6 +972,8 @@ template <class T> int8_t TimeSeries3<T>::feedSeries() {
   if (initialized()) {
     _sample_idx = 0;
     _samples_total += _window_size;
+    // The buffer was changed behind our back.
+    _set_flags(false, (TIMESERIES_FLAG_RUNNING_VALID | TIMESERIES_FLAG_RUNNING_MEDIAN));
     invalidateStats();
     ret = 0;
   }
@@ -798,6 +1036,11 @@ template <class T> int8_t TimeSeries3<T>::_zero_samples() {
   _rms(0.0d, 0.0d, 0.0d);
   _stdev(0.0d, 0.0d, 0.0d);
   _snr(0.0d, 0.0d, 0.0d);
+  for (uint8_t a = 0; a < 3; a++) {
+    _running[a].reset();        // A window of zeros needs no rebuild.
+  }
+  _running_rebuilt();
+  _set_flags(false, TIMESERIES_FLAG_RUNNING_MEDIAN);
 
   if (nullptr != samples) {
     if (_window_size > 0) {
@@ -847,7 +1090,20 @@ template <class T> int8_t TimeSeries3<T>::feedSeries(T x, T y, T z) {
     ret = 0;
     Vector3<T> tmp_vect(x, y, z);
     if (_window_size > 0) {
-      samples[_sample_idx++](x, y, z);
+      const Vector3<T> OLD_VAL(samples[_sample_idx].x, samples[_sample_idx].y, samples[_sample_idx].z);
+      if (_running_valid()) {
+        _running[0].replace((double) OLD_VAL.x, (double) x, _window_size);
+        _running[1].replace((double) OLD_VAL.y, (double) y, _window_size);
+        _running[2].replace((double) OLD_VAL.z, (double) z, _window_size);
+        _running_fed();
+      }
+      samples[_sample_idx](x, y, z);
+      if (_running_median()) {
+        _run_median[0].replace(_sample_idx, OLD_VAL.x);
+        _run_median[1].replace(_sample_idx, OLD_VAL.y);
+        _run_median[2].replace(_sample_idx, OLD_VAL.z);
+      }
+      _sample_idx++;
       _samples_total++;
       if (_sample_idx >= _window_size) {
         _sample_idx = 0;
@@ -916,16 +1172,11 @@ template <class T> int8_t TimeSeries3<T>::_calculate_mean() {
   int8_t ret = -1;
   if (windowFull()) {
     ret = 0;
-    Vector3f64 summed_samples;
-    for (uint32_t i = 0; i < _window_size; i++) {
-      Vector3f64 tmp((double) samples[i].x, (double) samples[i].y, (double) samples[i].z);
-      summed_samples += tmp;
-    }
-    summed_samples /= _window_size;
+    if (!_running_valid()) _rebuild_running();
     _mean(
-      summed_samples.x,
-      summed_samples.y,
-      summed_samples.z
+      _running[0].mean(_window_size),
+      _running[1].mean(_window_size),
+      _running[2].mean(_window_size)
     );
     _set_flags(true, TIMESERIES_FLAG_VALID_MEAN);
   }
@@ -943,20 +1194,11 @@ template <class T> int8_t TimeSeries3<T>::_calculate_rms() {
   int8_t ret = -1;
   if ((_window_size > 0) & windowFull()) {
     ret = 0;
-    Vector3f64 squared_samples;
-    for (uint32_t i = 0; i < _window_size; i++) {
-      Vector3f64 tmp((double) samples[i].x, (double) samples[i].y, (double) samples[i].z);
-      squared_samples(
-        squared_samples.x + (tmp.x * tmp.x),
-        squared_samples.y + (tmp.y * tmp.y),
-        squared_samples.z + (tmp.z * tmp.z)
-      );
-    }
-    squared_samples /= _window_size;
+    if (!_running_valid()) _rebuild_running();
     _rms(
-      sqrt(squared_samples.x),
-      sqrt(squared_samples.y),
-      sqrt(squared_samples.z)
+      sqrt(_running[0].meanSquare(_window_size)),
+      sqrt(_running[1].meanSquare(_window_size)),
+      sqrt(_running[2].meanSquare(_window_size))
     );
     _set_flags(true, TIMESERIES_FLAG_VALID_RMS);
   }
@@ -974,22 +1216,11 @@ template <class T> int8_t TimeSeries3<T>::_calculate_stdev() {
   int8_t ret = -1;
   if ((_window_size > 1) & windowFull()) {
     ret = 0;
-    Vector3f64 deviation_sum;
-    if (_stale_mean()) _calculate_mean();
-    for (uint32_t i = 0; i < _window_size; i++) {
-      Vector3f64 temp{(double) samples[i].x, (double) samples[i].y, (double) samples[i].z};
-      temp -= _mean;
-      deviation_sum.set(
-        deviation_sum.x + (temp.x * temp.x),
-        deviation_sum.y + (temp.y * temp.y),
-        deviation_sum.z + (temp.z * temp.z)
-      );
-    }
-    deviation_sum /= _window_size;
+    if (!_running_valid()) _rebuild_running();
     _stdev(
-      sqrt(deviation_sum.x),
-      sqrt(deviation_sum.y),
-      sqrt(deviation_sum.z)
+      sqrt(_running[0].variance(_window_size)),
+      sqrt(_running[1].variance(_window_size)),
+      sqrt(_running[2].variance(_window_size))
     );
     _set_flags(true, TIMESERIES_FLAG_VALID_STDEV);
   }
@@ -1001,48 +1232,52 @@ template <class T> int8_t TimeSeries3<T>::_calculate_stdev() {
 * Calulates the median of the samples.
 */
 template <class T> int8_t TimeSeries3<T>::_calculate_median() {
+  static_assert((sizeof(Vector3<T>) == (3 * sizeof(T))), "Each axis is tracked in place, with a stride of 3.");
   int8_t ret = -1;
   if ((_window_size > 1) & windowFull()) {
-    ret = 0;
-    double sorted[3][_window_size];
-    for (uint32_t i = 0; i < _window_size; i++) {
-      sorted[0][i] = samples[i].x;
-      sorted[1][i] = samples[i].y;
-      sorted[2][i] = samples[i].z;
-    }
-    // Selection sort.
-    uint32_t i = 0;
-    double swap;
-    for (uint8_t n = 0; n < 3; n++) {
-      for (uint32_t c = 0; c < (_window_size - 1); c++) {
-        i = c;
-        for (uint32_t d = c + 1; d < _window_size; d++) {
-          if (sorted[n][i] > sorted[n][d]) i = d;
-        }
-        if (i != c) {
-          swap = sorted[n][c];
-          sorted[n][c] = sorted[n][i];
-          sorted[n][i] = swap;
-        }
+    if (!_running_median()) {
+      bool built = true;
+      for (uint8_t a = 0; a < 3; a++) {
+        built = built && (0 == _run_median[a].init((((const T*) samples) + a), _window_size, 3));
       }
+      _set_flags(built, TIMESERIES_FLAG_RUNNING_MEDIAN);
     }
-
-    if (_window_size & 0x01) {
-      // If there are an off number of samples...
-      uint32_t offset = (_window_size-1) >> 1;
-      _median.set(sorted[0][offset], sorted[1][offset], sorted[2][offset]);
+    double lower[3];
+    double upper[3];
+    if (_running_median()) {
+      for (uint8_t a = 0; a < 3; a++) {
+        lower[a] = (double) _run_median[a].lowerMedian();
+        upper[a] = (double) _run_median[a].upperMedian();
+      }
+      ret = 0;
     }
     else {
-      // ...otherwise, we take the mean to the two middle values.
-      uint32_t lower = (_window_size-1) >> 1;
-      uint32_t upper = lower + 1;
+      // No memory for the heaps. Select from a copy of each axis instead.
+      T* scratch = (T*) malloc(_window_size * sizeof(T));
+      if (nullptr != scratch) {
+        for (uint8_t a = 0; a < 3; a++) {
+          for (uint32_t i = 0; i < _window_size; i++) {
+            scratch[i] = ((const T*) samples)[(i * 3) + a];
+          }
+          T lo_val;
+          T hi_val;
+          c3p_select_middles(scratch, _window_size, &lo_val, &hi_val);
+          lower[a] = (double) lo_val;
+          upper[a] = (double) hi_val;
+        }
+        free(scratch);
+        ret = 0;
+      }
+    }
+    if (0 == ret) {
+      // For an odd count, the two middles are the same value.
       _median.set(
-        ((sorted[0][upper] + sorted[0][lower]) / 2),
-        ((sorted[1][upper] + sorted[1][lower]) / 2),
-        ((sorted[2][upper] + sorted[2][lower]) / 2)
+        ((lower[0] + upper[0]) / 2),
+        ((lower[1] + upper[1]) / 2),
+        ((lower[2] + upper[2]) / 2)
       );
+      _set_flags(true, TIMESERIES_FLAG_VALID_MEDIAN);
     }
-    _set_flags(true, TIMESERIES_FLAG_VALID_MEDIAN);
   }
   return ret;
 }
@@ -1066,4 +1301,36 @@ template <class T> int8_t TimeSeries3<T>::_calculate_snr() {
 }
 
 
+/*
+* Recalculate the running accumulators for each axis from the samples, in two
+*   passes.
+*/
+template <class T> void TimeSeries3<T>::_rebuild_running() {
+  for (uint8_t a = 0; a < 3; a++) {
+    _running[a].reset();
+  }
+  for (uint32_t i = 0; i < _window_size; i++) {
+    _running[0].addToSum((double) samples[i].x);
+    _running[1].addToSum((double) samples[i].y);
+    _running[2].addToSum((double) samples[i].z);
+  }
+  const double MEAN_X = _running[0].mean(_window_size);
+  const double MEAN_Y = _running[1].mean(_window_size);
+  const double MEAN_Z = _running[2].mean(_window_size);
+  double m2[3] = { 0.0, 0.0, 0.0 };
+  for (uint32_t i = 0; i < _window_size; i++) {
+    const double DEV_X = ((double) samples[i].x - MEAN_X);
+    const double DEV_Y = ((double) samples[i].y - MEAN_Y);
+    const double DEV_Z = ((double) samples[i].z - MEAN_Z);
+    m2[0] += (DEV_X * DEV_X);
+    m2[1] += (DEV_Y * DEV_Y);
+    m2[2] += (DEV_Z * DEV_Z);
+  }
+  for (uint8_t a = 0; a < 3; a++) {
+    _running[a].setM2(m2[a]);
+  }
+  _running_rebuilt();
+}
+
+
 #endif  // __C3P_TIMESERIES_H__